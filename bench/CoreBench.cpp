@@ -0,0 +1,263 @@
+// Google Benchmark suite for the trading hot paths: Renko brick formation and pattern
+// detection, pre-trade risk, order entry, log enqueue and feed JSON decoding.
+//
+//   CoreBench [--benchmark_filter=REGEX] [--benchmark_out=FILE --benchmark_out_format=json]
+//
+// The "bench" target runs it and compares against bench/baselines/CoreBench.json with
+// BenchCompare; "bench-baseline" rewrites that file from the current machine.
+
+#include <benchmark/benchmark.h>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "BinaryLog.h"
+#include "ExchangeConnector.h"
+#include "LatencyProbe.h"
+#include "Logger.h"
+#include "OrderManager.h"
+#include "RiskManager.h"
+#include "StrategyEngine.h"
+
+static const char *SYMBOLS[] = { "BTCUSD", "ETHUSD", "EURUSD", "GBPUSD", "XAUUSD", "USDJPY" };
+static const double MARKS[] = { 50000.0, 3000.0, 1.085, 1.27, 2300.0, 155.0 };
+static const int SYMBOL_COUNT = 6;
+
+static const int BENCH_FORMAT = BinaryLogFormats::add(Logger::LEVEL_INFO, "Bench %1 tick %2");
+
+// Repo config without the sections that open files (counter history, logs, journal)
+static QJsonObject benchConfig()
+{
+    QFile file(MMT_SOURCE_DIR "/config.json");
+    if (!file.open(QIODevice::ReadOnly)) return QJsonObject();
+    QJsonObject config = QJsonDocument::fromJson(file.readAll()).object();
+    config.remove("strategy");
+    config.remove("logging");
+    config.remove("journal");
+    return config;
+}
+
+static MarketData makeTick(const QString &symbol, double price, const QDateTime &timestamp)
+{
+    MarketData data;
+    data.symbol = symbol;
+    data.bid = price;
+    data.ask = price;
+    data.last = price;
+    data.volume = 1.0;
+    data.high24h = 0.0;
+    data.low24h = 0.0;
+    data.change24h = 0.0;
+    data.timestamp = timestamp;
+    data.receiveTimeNs = 0;
+    return data;
+}
+
+// StrategyEngine::onMarketData -> formRenkoBrick -> analyzeRenkoPattern. Each mode is a price
+// cycle relative to the last close, with a brick size of 10:
+//   0: +-3 jitter, no brick forms (the common tick)
+//   1: +10 / -10, one brick per tick and the pattern check misses
+//   2: -10, -10, +10, +10, +10: red, red, green fires Setup 1 and the third green Setup 2
+static void BM_StrategyTick(benchmark::State &state)
+{
+    static const double CYCLES[3][5] = { { 3.0, -3.0 }, { 10.0, -10.0 }, { -10.0, -10.0, 10.0, 10.0, 10.0 } };
+    static const int CYCLE_LENGTHS[3] = { 2, 2, 5 };
+    const int mode = static_cast<int>(state.range(0));
+    const int cycleLength = CYCLE_LENGTHS[mode];
+
+    StrategyEngine engine;
+    engine.setSymbol("BTCUSD");
+    engine.setBrickSize(10.0);
+    engine.start();
+    const QDateTime now = QDateTime::currentDateTime();
+    MarketData tick = makeTick("BTCUSD", 50000.0, now);
+    engine.onMarketData(tick);
+
+    double close = 50000.0;
+    int step = 0;
+    for (auto _ : state) {
+        const double move = CYCLES[mode][step];
+        tick.last = (mode == 0 ? 50000.0 : close) + move;
+        engine.onMarketData(tick);
+        if (mode != 0) close += move;
+        if (++step == cycleLength) step = 0;
+    }
+    state.counters["signals"] = engine.getTotalSignals();
+    state.SetLabel(mode == 0 ? "no brick" : mode == 1 ? "brick, no pattern" : "brick + signal");
+}
+BENCHMARK(BM_StrategyTick)->Arg(0)->Arg(1)->Arg(2);
+
+static void setupRisk(RiskManager &risk, int openPositions)
+{
+    risk.loadConfig(benchConfig());
+    // Keep the position-count limit out of the way so the full check runs
+    risk.setMaxOpenPositions(openPositions + 100);
+    for (int s = 0; s < SYMBOL_COUNT; ++s) risk.updateMarketPrice(SYMBOLS[s], MARKS[s]);
+    for (int i = 0; i < openPositions; ++i) {
+        const int s = i % SYMBOL_COUNT;
+        Position position;
+        position.symbol = SYMBOLS[s];
+        position.side = (i & 1) ? "SELL" : "BUY";
+        position.size = risk.calculateLotSize(position.symbol, 50.0, 0.5);
+        position.entryPrice = MARKS[s];
+        position.currentPrice = MARKS[s];
+        position.stopLoss = 0.0;
+        position.takeProfit = 0.0;
+        position.unrealizedPnL = 0.0;
+        position.realizedPnL = 0.0;
+        position.openTime = QDateTime::currentDateTime();
+        position.isOpen = true;
+        position.orderId = QString("bench-%1").arg(i);
+        position.symbolId = -1;
+        position.margin = 0.0;
+        risk.addPosition(position);
+    }
+}
+
+static void BM_RiskCalculateLotSize(benchmark::State &state)
+{
+    RiskManager risk;
+    setupRisk(risk, 0);
+    const QString symbol = "BTCUSD";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(risk.calculateLotSize(symbol, 50.0, 1.0));
+    }
+}
+BENCHMARK(BM_RiskCalculateLotSize);
+
+// Argument: open positions already on the book (drives the portfolio VaR term)
+static void BM_RiskCanOpenPosition(benchmark::State &state)
+{
+    RiskManager risk;
+    setupRisk(risk, static_cast<int>(state.range(0)));
+    const QString symbol = "ETHUSD";
+    const QString side = "BUY";
+    const double lot = risk.calculateLotSize(symbol, 50.0, 0.5);
+    int accepted = 0;
+    for (auto _ : state) {
+        accepted += risk.canOpenPosition(symbol, side, lot) ? 1 : 0;
+    }
+    state.counters["acceptRate"] = benchmark::Counter(accepted, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RiskCanOpenPosition)->Arg(0)->Arg(8)->Arg(64);
+
+// No connector attached: the order gate check and lock, nothing reaches a venue
+static void BM_OrderManagerPlaceOrderNullConnector(benchmark::State &state)
+{
+    OrderManager orders;
+    const QString symbol = "BTCUSD";
+    const QString side = "BUY";
+    for (auto _ : state) {
+        orders.placeOrder(symbol, side, 0.01, 50000.0);
+    }
+}
+BENCHMARK(BM_OrderManagerPlaceOrderNullConnector);
+
+// Gate closed (kill switch engaged): the reject path every order takes while halted
+static void BM_OrderManagerPlaceOrderGateClosed(benchmark::State &state)
+{
+    OrderManager orders;
+    orders.setOrderGateOpen(false);
+    const QString symbol = "BTCUSD";
+    const QString side = "BUY";
+    for (auto _ : state) {
+        orders.placeOrder(symbol, side, 0.01, 50000.0);
+    }
+}
+BENCHMARK(BM_OrderManagerPlaceOrderGateClosed);
+
+// Set up in main: the writer thread drains to real files in a temporary directory.
+// Entries the ring had no room for are counted, not waited on.
+static Logger *s_logger = nullptr;
+
+static void BM_LoggerText(benchmark::State &state)
+{
+    Logger *logger = s_logger;
+    const QString message = "BTCUSD tick 50000.00000: 3.00000 from last close 49997.00000, 0 brick(s)";
+    const quint64 droppedBefore = logger->droppedEntries();
+    for (auto _ : state) {
+        logger->info(message);
+    }
+    if (state.thread_index() == 0) {
+        state.counters["dropped"] = static_cast<double>(logger->droppedEntries() - droppedBefore);
+    }
+}
+BENCHMARK(BM_LoggerText)->Threads(1)->Threads(4);
+
+static void BM_LoggerBinary(benchmark::State &state)
+{
+    Logger *logger = s_logger;
+    const QString symbol = "BTCUSD";
+    const quint64 droppedBefore = logger->droppedEntries();
+    double price = 50000.0;
+    for (auto _ : state) {
+        logger->log(BENCH_FORMAT, symbol, price);
+        price += 0.5;
+    }
+    if (state.thread_index() == 0) {
+        state.counters["dropped"] = static_cast<double>(logger->droppedEntries() - droppedBefore);
+    }
+}
+BENCHMARK(BM_LoggerBinary)->Threads(1)->Threads(4);
+
+// A Binance bookTicker frame, decoded the way the connector receives it (QString) and
+// from the raw UTF-8 bytes, each down to a MarketData
+static const char TICK_FRAME[] =
+    "{\"u\":400900217,\"s\":\"BTCUSDT\",\"b\":\"50000.01000000\",\"B\":\"31.21000000\","
+    "\"a\":\"50000.02000000\",\"A\":\"40.66000000\"}";
+
+static void decodeTicker(const QJsonObject &object, MarketData &data)
+{
+    data.symbol = object["s"].toString();
+    data.bid = object["b"].toString().toDouble();
+    data.ask = object["a"].toString().toDouble();
+    data.volume = 0.0;
+}
+
+static void BM_TickJsonParse(benchmark::State &state)
+{
+    const QString frame = QString::fromUtf8(TICK_FRAME);
+    MarketData data = makeTick(QString(), 0.0, QDateTime());
+    for (auto _ : state) {
+        decodeTicker(QJsonDocument::fromJson(frame.toUtf8()).object(), data);
+        benchmark::DoNotOptimize(data.bid);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(sizeof(TICK_FRAME) - 1));
+}
+BENCHMARK(BM_TickJsonParse);
+
+static void BM_TickJsonParseUtf8(benchmark::State &state)
+{
+    const QByteArray frame(TICK_FRAME);
+    MarketData data = makeTick(QString(), 0.0, QDateTime());
+    for (auto _ : state) {
+        decodeTicker(QJsonDocument::fromJson(frame).object(), data);
+        benchmark::DoNotOptimize(data.bid);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(sizeof(TICK_FRAME) - 1));
+}
+BENCHMARK(BM_TickJsonParseUtf8);
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // Probes stay compiled in but off, so each benchmark measures the code path alone
+    LatencyProbes::setEnabled(false);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    QTemporaryDir logDir;
+    Logger logger;
+    logger.initialize(logDir.filePath("bench.log"));
+    logger.openBinaryLog(logDir.filePath("bench.blog"));
+    s_logger = &logger;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    s_logger = nullptr;
+    return 0;
+}
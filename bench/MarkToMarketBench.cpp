@@ -0,0 +1,100 @@
+// Mark-to-market benchmark: 10k open positions spread over a few hundred symbols.
+// Compares the SoA kernel with the per-Position loop it replaces and times a quote
+// burst that touches every symbol.
+
+#include "PositionBook.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int POSITION_COUNT = 10000;
+static const int SYMBOL_COUNT = 500;
+static const int ITERATIONS = 2000;
+
+// Array-of-structs layout matching what RiskManager revalued before
+struct LegacyPosition {
+    std::string symbol;
+    std::string side;
+    double size;
+    double entryPrice;
+    double currentPrice;
+    double unrealizedPnL;
+};
+
+template <class Fn>
+static double medianNs(Fn &&fn)
+{
+    std::vector<double> samples;
+    samples.reserve(ITERATIONS);
+    for (int i = 0; i < ITERATIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+int main()
+{
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> priceDist(10.0, 50000.0);
+    std::uniform_real_distribution<double> sizeDist(0.01, 5.0);
+    std::uniform_int_distribution<int> symbolDist(0, SYMBOL_COUNT - 1);
+
+    std::vector<double> prices(SYMBOL_COUNT);
+    for (auto &p : prices) p = priceDist(rng);
+
+    PositionBook book;
+    std::vector<LegacyPosition> legacy;
+    legacy.reserve(POSITION_COUNT);
+    for (int s = 0; s < SYMBOL_COUNT; ++s) book.setPrice(s, prices[s]);
+    for (int row = 0; row < POSITION_COUNT; ++row) {
+        int symbol = symbolDist(rng);
+        double size = sizeDist(rng);
+        double entry = prices[symbol] * (1.0 + (rng() % 200 - 100) / 10000.0);
+        int sign = (rng() & 1) ? 1 : -1;
+        book.setRow(row, symbol, size, entry, sign);
+        legacy.push_back({"SYM" + std::to_string(symbol), sign < 0 ? "SELL" : "BUY", size, entry, prices[symbol], 0.0});
+    }
+
+    volatile double sink = 0.0;
+
+    double legacyNs = medianNs([&]() {
+        double total = 0.0;
+        for (auto &position : legacy) {
+            double diff = position.currentPrice - position.entryPrice;
+            if (position.side == "SELL") diff = -diff;
+            position.unrealizedPnL = diff * position.size;
+            total += position.unrealizedPnL;
+        }
+        sink = total;
+    });
+
+    double kernelNs = medianNs([&]() { sink = book.revalue().unrealizedPnL; });
+
+    int tick = 0;
+    double burstNs = medianNs([&]() {
+        double bump = (++tick & 1) ? 1.0001 : 0.9999;
+        for (int s = 0; s < SYMBOL_COUNT; ++s) {
+            book.setPrice(s, book.price(s) * bump);
+        }
+        sink = book.totals().unrealizedPnL;
+    });
+
+    BookTotals running = book.totals();
+    BookTotals exact = book.revalue();
+
+    std::printf("positions=%d symbols=%d iterations=%d\n", POSITION_COUNT, SYMBOL_COUNT, ITERATIONS);
+    std::printf("legacy per-Position loop     : %10.0f ns\n", legacyNs);
+    std::printf("SoA revalue (10k rows)       : %10.0f ns\n", kernelNs);
+    std::printf("quote burst (%d setPrice)   : %10.0f ns\n", SYMBOL_COUNT, burstNs);
+    std::printf("running vs exact P&L drift   : %.3e\n", running.unrealizedPnL - exact.unrealizedPnL);
+    (void)sink;
+    return 0;
+}
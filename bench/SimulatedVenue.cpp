@@ -0,0 +1,562 @@
+#include "SimulatedVenue.h"
+#include "LatencyHistogram.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QWebSocket>
+#include <QWebSocketServer>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUrlQuery>
+#include <algorithm>
+
+static const double HALF_SPREAD = 0.25;
+
+SimulatedVenue::SimulatedVenue(QObject *parent)
+    : QObject(parent)
+    , m_feedServer(new QWebSocketServer("SimulatedVenue", QWebSocketServer::NonSecureMode, this))
+    , m_orderServer(new QTcpServer(this))
+    , m_feedTimer(new QTimer(this))
+    , m_symbol("BTCUSD")
+    , m_anchorPrice(50000.0)
+    , m_brickSize(10.0)
+    , m_signalEvery(50)
+    , m_ticksPerSecond(0)
+    , m_nextOrderId(0)
+    , m_ticksSent(0)
+    , m_subscriberCount(0)
+    , m_failOrders(0)
+{
+    m_feedTimer->setTimerType(Qt::PreciseTimer);
+    m_feedTimer->setInterval(1);
+    connect(m_feedServer, &QWebSocketServer::newConnection, this, &SimulatedVenue::onNewFeedClient);
+    connect(m_orderServer, &QTcpServer::newConnection, this, &SimulatedVenue::onNewOrderClient);
+    connect(m_feedTimer, &QTimer::timeout, this, &SimulatedVenue::pushTicks);
+}
+
+SimulatedVenue::~SimulatedVenue()
+{
+    close();
+}
+
+void SimulatedVenue::setSymbol(const QString &symbol)
+{
+    m_symbol = symbol;
+}
+
+void SimulatedVenue::setAnchorPrice(double price)
+{
+    m_anchorPrice = price;
+}
+
+void SimulatedVenue::setBrickSize(double brickSize)
+{
+    m_brickSize = brickSize;
+}
+
+void SimulatedVenue::setSignalEvery(int ticks)
+{
+    // The walk takes four ticks and needs quiet ticks around it; 0 disables signals
+    m_signalEvery = ticks >= 8 ? ticks : 0;
+}
+
+QString SimulatedVenue::restUrl() const
+{
+    return m_restUrl;
+}
+
+QString SimulatedVenue::webSocketUrl() const
+{
+    return m_webSocketUrl;
+}
+
+QList<SimulatedVenue::OrderArrival> SimulatedVenue::takeArrivals()
+{
+    QMutexLocker locker(&m_mutex);
+    QList<OrderArrival> arrivals;
+    arrivals.swap(m_arrivals);
+    return arrivals;
+}
+
+int SimulatedVenue::restingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_resting.size();
+}
+
+bool SimulatedVenue::listen()
+{
+    if (!m_feedServer->listen(QHostAddress::LocalHost, 0)) return false;
+    if (!m_orderServer->listen(QHostAddress::LocalHost, 0)) {
+        m_feedServer->close();
+        return false;
+    }
+    m_webSocketUrl = QString("ws://127.0.0.1:%1/ws").arg(m_feedServer->serverPort());
+    m_restUrl = QString("http://127.0.0.1:%1").arg(m_orderServer->serverPort());
+    return true;
+}
+
+void SimulatedVenue::close()
+{
+    stopFeed();
+    for (QWebSocket *client : m_subscribers) client->abort();
+    m_subscribers.clear();
+    m_depthSubscribers.clear();
+    for (QWebSocket *client : m_userStreams) client->abort();
+    m_userStreams.clear();
+    m_subscriberCount.store(0, std::memory_order_relaxed);
+    if (m_feedServer->isListening()) m_feedServer->close();
+    if (m_orderServer->isListening()) m_orderServer->close();
+}
+
+void SimulatedVenue::startFeed(int ticksPerSecond)
+{
+    m_ticksPerSecond = ticksPerSecond;
+    m_ticksSent.store(0, std::memory_order_relaxed);
+    m_feedClock.start();
+    m_feedTimer->start();
+}
+
+void SimulatedVenue::stopFeed()
+{
+    m_feedTimer->stop();
+}
+
+void SimulatedVenue::onNewFeedClient()
+{
+    while (m_feedServer->hasPendingConnections()) {
+        QWebSocket *client = m_feedServer->nextPendingConnection();
+        // /ws/<listen key> is a user-data stream; the key itself is not checked
+        if (client->requestUrl().path().startsWith("/ws/")) m_userStreams.append(client);
+        connect(client, &QWebSocket::textMessageReceived, this, [this, client](const QString &message) {
+            onFeedMessage(client, message);
+        });
+        connect(client, &QWebSocket::disconnected, this, [this, client]() {
+            m_userStreams.removeAll(client);
+            m_subscribers.removeAll(client);
+            m_depthSubscribers.removeAll(client);
+            m_subscriberCount.store(m_subscribers.size(), std::memory_order_relaxed);
+            client->deleteLater();
+        });
+    }
+}
+
+void SimulatedVenue::onFeedMessage(QWebSocket *client, const QString &message)
+{
+    // Any SUBSCRIBE gets this venue's single stream; only a @depth param adds the diffs
+    QJsonObject request = QJsonDocument::fromJson(message.toUtf8()).object();
+    const QString method = request["method"].toString();
+    bool depth = false;
+    for (const QJsonValue &param : request["params"].toArray()) {
+        if (param.toString().contains("@depth")) depth = true;
+    }
+    if (method == "SUBSCRIBE") {
+        if (!m_subscribers.contains(client)) m_subscribers.append(client);
+        if (depth && !m_depthSubscribers.contains(client)) m_depthSubscribers.append(client);
+    } else if (method == "UNSUBSCRIBE") {
+        m_subscribers.removeAll(client);
+        m_depthSubscribers.removeAll(client);
+    } else {
+        return;
+    }
+    m_subscriberCount.store(m_subscribers.size(), std::memory_order_relaxed);
+    QJsonObject reply;
+    reply["result"] = QJsonValue();
+    reply["id"] = request["id"];
+    client->sendTextMessage(QString::fromUtf8(QJsonDocument(reply).toJson(QJsonDocument::Compact)));
+    if (method == "SUBSCRIBE") emit clientSubscribed();
+}
+
+double SimulatedVenue::priceAt(quint64 tick) const
+{
+    if (m_signalEvery > 0) {
+        // Last four ticks of each cycle: red, red, green (Setup 1), green back to the anchor
+        static const double WALK[4] = { -1.0, -2.0, -1.0, 0.0 };
+        const quint64 phase = tick % static_cast<quint64>(m_signalEvery);
+        const quint64 walkStart = static_cast<quint64>(m_signalEvery - 4);
+        if (phase >= walkStart) return m_anchorPrice + WALK[phase - walkStart] * m_brickSize;
+    }
+    // The first tick sets the strategy's first brick on the anchor; jitter stays within
+    // 0.3 bricks of it so no brick forms in between
+    if (tick == 0) return m_anchorPrice;
+    return m_anchorPrice + static_cast<double>(static_cast<int>(tick * 37 % 61) - 30) / 100.0 * m_brickSize;
+}
+
+void SimulatedVenue::pushTicks()
+{
+    // Catch up to the schedule; past the per-wake cap the feed falls behind instead of stalling
+    const quint64 due = static_cast<quint64>(m_feedClock.nsecsElapsed()) * m_ticksPerSecond / 1000000000ULL;
+    quint64 sent = m_ticksSent.load(std::memory_order_relaxed);
+    for (int budget = MAX_TICKS_PER_WAKE; sent < due && budget > 0; --budget) {
+        const double mid = priceAt(sent);
+        const QString frame = QString("{\"u\":%1,\"s\":\"%2\",\"b\":\"%3\",\"B\":\"1.50000000\",\"a\":\"%4\",\"A\":\"2.25000000\"}")
+                                  .arg(sent + 1).arg(m_symbol)
+                                  .arg(mid - HALF_SPREAD, 0, 'f', 8).arg(mid + HALF_SPREAD, 0, 'f', 8);
+        for (QWebSocket *client : m_subscribers) client->sendTextMessage(frame);
+        if (!m_depthSubscribers.isEmpty()) {
+            // Update id n replaces tick n-1's one-level book with tick n's
+            const double previous = sent > 0 ? priceAt(sent - 1) : mid;
+            QString bids = QString("[\"%1\",\"1.50000000\"]").arg(mid - HALF_SPREAD, 0, 'f', 8);
+            QString asks = QString("[\"%1\",\"2.25000000\"]").arg(mid + HALF_SPREAD, 0, 'f', 8);
+            if (previous != mid) {
+                bids += QString(",[\"%1\",\"0.00000000\"]").arg(previous - HALF_SPREAD, 0, 'f', 8);
+                asks += QString(",[\"%1\",\"0.00000000\"]").arg(previous + HALF_SPREAD, 0, 'f', 8);
+            }
+            const QString diff = QString("{\"e\":\"depthUpdate\",\"s\":\"%1\",\"U\":%2,\"u\":%2,\"b\":[%3],\"a\":[%4]}")
+                                     .arg(m_symbol).arg(sent + 1).arg(bids, asks);
+            for (QWebSocket *client : m_depthSubscribers) client->sendTextMessage(diff);
+        }
+        ++sent;
+    }
+    m_ticksSent.store(sent, std::memory_order_relaxed);
+}
+
+void SimulatedVenue::onNewOrderClient()
+{
+    while (m_orderServer->hasPendingConnections()) {
+        QTcpSocket *socket = m_orderServer->nextPendingConnection();
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onOrderReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_requestStartNs.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void SimulatedVenue::onOrderReadyRead(QTcpSocket *socket)
+{
+    // Keep-alive: several requests may share one read, and one request may span reads
+    const qint64 now = LatencyClock::nowNs();
+    qint64 start = m_requestStartNs.value(socket, 0);
+    if (start == 0) start = now;
+    for (;;) {
+        const QByteArray pending = socket->peek(MAX_REQUEST_BYTES);
+        const int headerEnd = pending.indexOf("\r\n\r\n");
+        if (headerEnd < 0) {
+            if (pending.size() >= MAX_REQUEST_BYTES) {
+                socket->disconnectFromHost();
+                return;
+            }
+            break;
+        }
+        const QList<QByteArray> lines = pending.left(headerEnd).split('\n');
+        qint64 contentLength = 0;
+        for (int i = 1; i < lines.size(); ++i) {
+            const int colon = lines[i].indexOf(':');
+            if (colon > 0 && lines[i].left(colon).trimmed().toLower() == "content-length") {
+                contentLength = lines[i].mid(colon + 1).trimmed().toLongLong();
+            }
+        }
+        const qint64 total = headerEnd + 4 + contentLength;
+        if (total > MAX_REQUEST_BYTES) {
+            socket->write(response("413 Payload Too Large", "{\"code\":-1104,\"msg\":\"Request too large\"}"));
+            socket->disconnectFromHost();
+            return;
+        }
+        if (pending.size() < total) break;
+        const QByteArray request = socket->read(total);
+        const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+        socket->write(handleRequest(requestLine.value(0), requestLine.value(1), request.mid(headerEnd + 4), start));
+        start = now;
+    }
+    if (socket->bytesAvailable() > 0) m_requestStartNs[socket] = start;
+    else m_requestStartNs.remove(socket);
+}
+
+QByteArray SimulatedVenue::handleRequest(const QByteArray &method, const QByteArray &path, const QByteArray &body,
+                                         qint64 arrivalNs)
+{
+    const int queryStart = path.indexOf('?');
+    const QByteArray route = queryStart >= 0 ? path.left(queryStart) : path;
+    // Parameters may come in the query string, the form body or both
+    QByteArray form = body;
+    if (queryStart >= 0) form = path.mid(queryStart + 1) + '&' + body;
+    const QUrlQuery params(QString::fromUtf8(form));
+    if (method == "GET" && route == "/api/v3/depth") return depthSnapshot(params);
+    if (method == "POST" && route == "/api/v3/order") return placeOrder(params, arrivalNs);
+    if (method == "GET" && route == "/api/v3/order") return queryOrder(params);
+    if (method == "POST" && route == "/api/v3/order/oco") return placeOcoOrder(params, arrivalNs);
+    if (method == "DELETE" && route == "/api/v3/order") return cancelOrder(params, arrivalNs);
+    if (method == "DELETE" && route == "/api/v3/openOrders") return cancelOpenOrders(params, arrivalNs);
+    if (route == "/api/v3/userDataStream") {
+        // Keepalive and close just succeed
+        if (method != "POST") return response("200 OK", "{}");
+        return response("200 OK", QString("{\"listenKey\":\"simkey%1\"}").arg(++m_nextOrderId).toUtf8());
+    }
+    return response("404 Not Found", "{\"code\":-1100,\"msg\":\"Unknown endpoint\"}");
+}
+
+QByteArray SimulatedVenue::depthSnapshot(const QUrlQuery &params)
+{
+    // The book as of the last tick pushed; lastUpdateId is that tick's update id
+    if (params.queryItemValue("symbol") != m_symbol) {
+        return response("400 Bad Request", "{\"code\":-1121,\"msg\":\"Invalid symbol.\"}");
+    }
+    const quint64 sent = m_ticksSent.load(std::memory_order_relaxed);
+    const double mid = priceAt(sent > 0 ? sent - 1 : 0);
+    QJsonObject snapshot;
+    snapshot["lastUpdateId"] = static_cast<qint64>(sent);
+    snapshot["bids"] = QJsonArray{ QJsonArray{ QString::number(mid - HALF_SPREAD, 'f', 8), "1.50000000" } };
+    snapshot["asks"] = QJsonArray{ QJsonArray{ QString::number(mid + HALF_SPREAD, 'f', 8), "2.25000000" } };
+    return response("200 OK", QJsonDocument(snapshot).toJson(QJsonDocument::Compact));
+}
+
+QByteArray SimulatedVenue::placeOrder(const QUrlQuery &params, qint64 arrivalNs)
+{
+    const QString clientOrderId = params.queryItemValue("newClientOrderId");
+    const QString type = params.queryItemValue("type");
+    const double quantity = params.queryItemValue("quantity").toDouble();
+    if (clientOrderId.isEmpty() || type.isEmpty() || quantity <= 0.0) {
+        return response("400 Bad Request", "{\"code\":-1102,\"msg\":\"Mandatory parameter missing\"}");
+    }
+    bool fail = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_arrivals.append({ clientOrderId, type, arrivalNs });
+        if (m_orders.contains(clientOrderId)) {
+            return response("400 Bad Request", "{\"code\":-2010,\"msg\":\"Duplicate order sent.\"}");
+        }
+        if (m_failOrders > 0) {
+            --m_failOrders;
+            fail = true;
+        }
+    }
+    // MARKET fills in full; an IOC/FOK LIMIT fills in full if it reaches the touch and expires
+    // otherwise; anything else rests
+    const QString timeInForce = params.queryItemValue("timeInForce");
+    QString status = "NEW";
+    if (type == "MARKET") {
+        status = "FILLED";
+    } else if (type == "LIMIT" && (timeInForce == "IOC" || timeInForce == "FOK")) {
+        const quint64 sent = m_ticksSent.load(std::memory_order_relaxed);
+        const double mid = priceAt(sent > 0 ? sent - 1 : 0);
+        const double price = params.queryItemValue("price").toDouble();
+        const bool buy = params.queryItemValue("side") == "BUY";
+        const bool crosses = buy ? price >= mid + HALF_SPREAD : price <= mid - HALF_SPREAD;
+        status = crosses ? "FILLED" : "EXPIRED";
+    }
+    const double filled = status == "FILLED" ? quantity : 0.0;
+    const QJsonObject report = orderReport(params, clientOrderId, type, quantity, filled, status);
+    if (status == "NEW") {
+        QMutexLocker locker(&m_mutex);
+        m_resting.insert(clientOrderId, report);
+    }
+    pushExecutionReport(report);
+    if (fail) {
+        return response("503 Service Unavailable",
+                        "{\"code\":-1000,\"msg\":\"Unknown error, please check your request or try again later.\"}");
+    }
+    return response("200 OK", QJsonDocument(report).toJson(QJsonDocument::Compact));
+}
+
+QByteArray SimulatedVenue::queryOrder(const QUrlQuery &params)
+{
+    QJsonObject report;
+    {
+        QMutexLocker locker(&m_mutex);
+        report = m_orders.value(params.queryItemValue("origClientOrderId"));
+    }
+    if (report.isEmpty() || report["symbol"].toString() != params.queryItemValue("symbol")) {
+        return response("400 Bad Request", "{\"code\":-2013,\"msg\":\"Order does not exist.\"}");
+    }
+    return response("200 OK", QJsonDocument(report).toJson(QJsonDocument::Compact));
+}
+
+QByteArray SimulatedVenue::placeOcoOrder(const QUrlQuery &params, qint64 arrivalNs)
+{
+    // Both legs rest; a take-profit LIMIT_MAKER and a STOP_LOSS
+    const QString limitClientId = params.queryItemValue("limitClientOrderId");
+    const QString stopClientId = params.queryItemValue("stopClientOrderId");
+    const double quantity = params.queryItemValue("quantity").toDouble();
+    if (limitClientId.isEmpty() || stopClientId.isEmpty() || quantity <= 0.0
+        || params.queryItemValue("price").isEmpty() || params.queryItemValue("stopPrice").isEmpty()) {
+        return response("400 Bad Request", "{\"code\":-1102,\"msg\":\"Mandatory parameter missing\"}");
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_arrivals.append({ stopClientId, "STOP_LOSS", arrivalNs });
+        m_arrivals.append({ limitClientId, "LIMIT_MAKER", arrivalNs });
+    }
+    QJsonObject reply;
+    reply["orderListId"] = static_cast<qint64>(++m_nextOrderId);
+    reply["contingencyType"] = "OCO";
+    reply["listStatusType"] = "EXEC_STARTED";
+    reply["listOrderStatus"] = "EXECUTING";
+    reply["symbol"] = params.queryItemValue("symbol");
+    const QJsonObject stopReport = orderReport(params, stopClientId, "STOP_LOSS", quantity, 0.0, "NEW");
+    const QJsonObject limitReport = orderReport(params, limitClientId, "LIMIT_MAKER", quantity, 0.0, "NEW");
+    {
+        QMutexLocker locker(&m_mutex);
+        m_resting.insert(stopClientId, stopReport);
+        m_resting.insert(limitClientId, limitReport);
+        m_ocoSiblings.insert(stopClientId, limitClientId);
+        m_ocoSiblings.insert(limitClientId, stopClientId);
+    }
+    pushExecutionReport(stopReport);
+    pushExecutionReport(limitReport);
+    reply["orderReports"] = QJsonArray{ stopReport, limitReport };
+    return response("200 OK", QJsonDocument(reply).toJson(QJsonDocument::Compact));
+}
+
+QByteArray SimulatedVenue::cancelOrder(const QUrlQuery &params, qint64 arrivalNs)
+{
+    const QString clientOrderId = params.queryItemValue("origClientOrderId");
+    QJsonObject report;
+    QJsonObject sibling;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_arrivals.append({ clientOrderId, "CANCEL", arrivalNs });
+        report = m_resting.take(clientOrderId);
+        // Cancelling one leg of an OCO list cancels the list
+        const QString siblingId = m_ocoSiblings.take(clientOrderId);
+        if (!siblingId.isEmpty()) {
+            m_ocoSiblings.remove(siblingId);
+            sibling = m_resting.take(siblingId);
+        }
+    }
+    if (report.isEmpty() || report["symbol"].toString() != params.queryItemValue("symbol")) {
+        return response("400 Bad Request", "{\"code\":-2011,\"msg\":\"Unknown order sent.\"}");
+    }
+    const QJsonObject cancelled = cancelReport(report);
+    pushExecutionReport(cancelled);
+    if (!sibling.isEmpty()) pushExecutionReport(cancelReport(sibling));
+    return response("200 OK", QJsonDocument(cancelled).toJson(QJsonDocument::Compact));
+}
+
+QByteArray SimulatedVenue::cancelOpenOrders(const QUrlQuery &params, qint64 arrivalNs)
+{
+    const QString symbol = params.queryItemValue("symbol");
+    QJsonArray cancelled;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_arrivals.append({ symbol, "CANCEL_ALL", arrivalNs });
+        for (auto it = m_resting.begin(); it != m_resting.end();) {
+            if (it.value()["symbol"].toString() == symbol) {
+                cancelled.append(cancelReport(it.value()));
+                m_ocoSiblings.remove(it.key());
+                it = m_resting.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // As on Binance, a symbol with nothing open is an error rather than an empty list
+    if (cancelled.isEmpty()) {
+        return response("400 Bad Request", "{\"code\":-2011,\"msg\":\"Unknown order sent.\"}");
+    }
+    for (const QJsonValue &report : cancelled) pushExecutionReport(report.toObject());
+    return response("200 OK", QJsonDocument(cancelled).toJson(QJsonDocument::Compact));
+}
+
+QJsonObject SimulatedVenue::cancelReport(const QJsonObject &resting)
+{
+    // The cancel is a request of its own: the order's id moves to origClientOrderId
+    QJsonObject report = resting;
+    report["origClientOrderId"] = resting["clientOrderId"];
+    report["clientOrderId"] = QString("cancel-%1").arg(++m_nextOrderId);
+    report["status"] = "CANCELED";
+    return report;
+}
+
+bool SimulatedVenue::fillResting(const QString &clientOrderId, double quantity)
+{
+    QJsonObject report;
+    QJsonObject expired;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_resting.find(clientOrderId);
+        if (it == m_resting.end()) return false;
+        QJsonObject &order = it.value();
+        const double origQty = order["origQty"].toString().toDouble();
+        const double filled = std::min(origQty, order["executedQty"].toString().toDouble() + quantity);
+        const double price = order["price"].toString().toDouble();
+        order["executedQty"] = QString::number(filled, 'f', 8);
+        order["cummulativeQuoteQty"] = QString::number(filled * price, 'f', 8);
+        order["status"] = filled < origQty ? "PARTIALLY_FILLED" : "FILLED";
+        report = order;
+        if (filled >= origQty) m_resting.erase(it);
+        // As on Binance, the other leg of an OCO list expires once one leg trades
+        const QString siblingId = m_ocoSiblings.take(clientOrderId);
+        if (!siblingId.isEmpty()) {
+            m_ocoSiblings.remove(siblingId);
+            expired = m_resting.take(siblingId);
+            if (!expired.isEmpty()) expired["status"] = "EXPIRED";
+        }
+    }
+    pushExecutionReport(report);
+    if (!expired.isEmpty()) pushExecutionReport(expired);
+    return true;
+}
+
+void SimulatedVenue::failNextOrders(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_failOrders = count;
+}
+
+void SimulatedVenue::pushExecutionReport(const QJsonObject &report)
+{
+    {
+        // Every change to an order passes through here; a cancel carries the order's id as
+        // origClientOrderId
+        QJsonObject latest = report;
+        const QString origClientOrderId = report["origClientOrderId"].toString();
+        if (!origClientOrderId.isEmpty()) latest["clientOrderId"] = origClientOrderId;
+        latest.remove("origClientOrderId");
+        QMutexLocker locker(&m_mutex);
+        m_orders.insert(latest["clientOrderId"].toString(), latest);
+    }
+    if (m_userStreams.isEmpty()) return;
+    const QString status = report["status"].toString();
+    QJsonObject event;
+    event["e"] = "executionReport";
+    event["E"] = QDateTime::currentMSecsSinceEpoch();
+    event["s"] = report["symbol"];
+    event["c"] = report["clientOrderId"];
+    event["C"] = report["origClientOrderId"].toString();
+    event["S"] = report["side"];
+    event["o"] = report["type"];
+    event["q"] = report["origQty"];
+    event["p"] = report["price"];
+    event["x"] = status == "FILLED" || status == "PARTIALLY_FILLED" ? QString("TRADE") : status;
+    event["X"] = status;
+    event["i"] = report["orderId"];
+    event["z"] = report["executedQty"];
+    event["Z"] = report["cummulativeQuoteQty"];
+    const QString frame = QString::fromUtf8(QJsonDocument(event).toJson(QJsonDocument::Compact));
+    for (QWebSocket *client : m_userStreams) client->sendTextMessage(frame);
+}
+
+QJsonObject SimulatedVenue::orderReport(const QUrlQuery &params, const QString &clientOrderId, const QString &type,
+                                        double quantity, double filledQuantity, const QString &status)
+{
+    const quint64 sent = m_ticksSent.load(std::memory_order_relaxed);
+    const double mid = priceAt(sent > 0 ? sent - 1 : 0);
+    QJsonObject report;
+    report["symbol"] = params.queryItemValue("symbol");
+    report["orderId"] = static_cast<qint64>(++m_nextOrderId);
+    report["clientOrderId"] = clientOrderId;
+    report["transactTime"] = QDateTime::currentMSecsSinceEpoch();
+    report["type"] = type;
+    report["side"] = params.queryItemValue("side");
+    report["origQty"] = QString::number(quantity, 'f', 8);
+    report["price"] = params.queryItemValue(type == "STOP_LOSS" ? "stopPrice" : "price");
+    report["status"] = status;
+    report["executedQty"] = QString::number(filledQuantity, 'f', 8);
+    report["cummulativeQuoteQty"] = QString::number(filledQuantity * mid, 'f', 8);
+    return report;
+}
+
+QByteArray SimulatedVenue::response(const QByteArray &status, const QByteArray &body)
+{
+    QByteArray out;
+    out.reserve(body.size() + 128);
+    out.append("HTTP/1.1 ").append(status).append("\r\n");
+    out.append("Content-Type: application/json\r\n");
+    out.append("Content-Length: ").append(QByteArray::number(body.size())).append("\r\n\r\n");
+    out.append(body);
+    return out;
+}
@@ -0,0 +1,135 @@
+#ifndef SIMULATEDVENUE_H
+#define SIMULATEDVENUE_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <atomic>
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+class QUrlQuery;
+class QWebSocket;
+class QWebSocketServer;
+
+// Loopback stand-in for a Binance-style venue: a WebSocket stream that answers SUBSCRIBE
+// and pushes bookTicker frames at a fixed rate, plus depthUpdate diffs of the same one-level
+// book to clients that asked for a @depth stream, and an HTTP/1.1 keep-alive REST endpoint:
+// GET /api/v3/depth returns that book as a snapshot,
+// POST /api/v3/order fills MARKET orders and IOC/FOK limits that reach the touch at the
+// current mid, expires IOC/FOK limits that do not and rests the rest, refusing a client id it
+// has seen before as a duplicate, GET /api/v3/order returns an order's latest state,
+// POST /api/v3/order/oco rests both legs of an OCO list, and DELETE /api/v3/order and
+// DELETE /api/v3/openOrders cancel resting orders one at a time or per symbol.
+// POST /api/v3/userDataStream hands out a listen key; a stream opened on <ws>/<key> gets an
+// executionReport for every change to an order.
+//
+// The feed sits on an anchor price with sub-brick jitter, and every signalEvery ticks walks
+// down two bricks and back up two (red, red, green, green) so the Renko strategy fires one
+// Setup 1 signal per cycle. Every order is stamped with LatencyClock when its first bytes
+// are read; run the venue on its own thread so that stamp is not held up by the client.
+class SimulatedVenue : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct OrderArrival {
+        QString clientOrderId;
+        QString type;
+        qint64 arrivalTimeNs;
+    };
+
+    explicit SimulatedVenue(QObject *parent = nullptr);
+    ~SimulatedVenue();
+
+    void setSymbol(const QString &symbol);
+    void setAnchorPrice(double price);
+    void setBrickSize(double brickSize);
+    void setSignalEvery(int ticks);
+
+    // Valid once listen() has returned true
+    QString restUrl() const;
+    QString webSocketUrl() const;
+
+    // Safe from any thread. Cancels arrive as CANCEL (client id) and CANCEL_ALL (symbol)
+    QList<OrderArrival> takeArrivals();
+    int restingCount() const;
+    quint64 ticksSent() const { return m_ticksSent.load(std::memory_order_relaxed); }
+    int subscriberCount() const { return m_subscriberCount.load(std::memory_order_relaxed); }
+
+public slots:
+    // Loopback on ephemeral ports; call on the venue's thread
+    bool listen();
+    void close();
+    // Restarts the price path, so each run begins on the anchor
+    void startFeed(int ticksPerSecond);
+    void stopFeed();
+    // Fills part or all of a resting order at its price and reports it on the user-data
+    // stream; filling an OCO leg expires the other one. False if the order is not resting
+    bool fillResting(const QString &clientOrderId, double quantity);
+    // Takes the next count new orders as usual but answers each with a 503, as a venue does
+    // when it cannot tell whether the order went through
+    void failNextOrders(int count);
+
+signals:
+    void clientSubscribed();
+
+private slots:
+    void onNewFeedClient();
+    void onNewOrderClient();
+    void pushTicks();
+
+private:
+    void onFeedMessage(QWebSocket *client, const QString &message);
+    void onOrderReadyRead(QTcpSocket *socket);
+    QByteArray handleRequest(const QByteArray &method, const QByteArray &path, const QByteArray &body, qint64 arrivalNs);
+    QByteArray depthSnapshot(const QUrlQuery &params);
+    QByteArray placeOrder(const QUrlQuery &params, qint64 arrivalNs);
+    QByteArray queryOrder(const QUrlQuery &params);
+    QByteArray placeOcoOrder(const QUrlQuery &params, qint64 arrivalNs);
+    QByteArray cancelOrder(const QUrlQuery &params, qint64 arrivalNs);
+    QByteArray cancelOpenOrders(const QUrlQuery &params, qint64 arrivalNs);
+    QJsonObject cancelReport(const QJsonObject &resting);
+    void pushExecutionReport(const QJsonObject &report);
+    QJsonObject orderReport(const QUrlQuery &params, const QString &clientOrderId, const QString &type,
+                            double quantity, double filledQuantity, const QString &status);
+    double priceAt(quint64 tick) const;
+    static QByteArray response(const QByteArray &status, const QByteArray &body);
+
+    QWebSocketServer *m_feedServer;
+    QTcpServer *m_orderServer;
+    QTimer *m_feedTimer;
+    QList<QWebSocket *> m_subscribers;
+    QList<QWebSocket *> m_depthSubscribers;
+    QList<QWebSocket *> m_userStreams;
+    QHash<QTcpSocket *, qint64> m_requestStartNs; // first byte of a partially read request
+
+    QString m_restUrl;
+    QString m_webSocketUrl;
+    QString m_symbol;
+    double m_anchorPrice;
+    double m_brickSize;
+    int m_signalEvery;
+    int m_ticksPerSecond;
+    QElapsedTimer m_feedClock;
+    quint64 m_nextOrderId;
+    std::atomic<quint64> m_ticksSent;
+    std::atomic<int> m_subscriberCount;
+
+    mutable QMutex m_mutex;
+    QList<OrderArrival> m_arrivals;
+    QHash<QString, QJsonObject> m_resting; // client id -> report of an order still open
+    QHash<QString, QString> m_ocoSiblings; // client id -> the other leg of its OCO list
+    QHash<QString, QJsonObject> m_orders;  // client id -> latest report of every order taken
+    int m_failOrders;
+
+    static const int MAX_TICKS_PER_WAKE = 2000;
+    static const int MAX_REQUEST_BYTES = 64 * 1024;
+};
+
+#endif // SIMULATEDVENUE_H
@@ -0,0 +1,283 @@
+// End-to-end tick-to-order latency: a SimulatedVenue on its own thread streams bookTicker
+// frames to a live-mode TradingDaemon (WebSocket feed, REST orders, both on loopback) and
+// every bracket entry is traced from frame receipt to its arrival at the venue.
+//
+//   TickToOrderHarness [--rates 1000,10000,50000] [--duration SECONDS] [--signal-every TICKS]
+//                      [--json FILE]
+//
+// Segments, all LatencyClock on one host:
+//   feed->signal    frame handed to the connector -> StrategyEngine pattern detected
+//   signal->risk    detection -> RiskManager::canOpenPosition cleared
+//   risk->submit    risk cleared -> ExchangeConnector::placeOrder (OrderManager, journal, audit log)
+//   submit->venue   placeOrder -> first request bytes read by the venue (signing, HTTP, loopback)
+//   tick->order     the whole path
+// Each rate gets a fresh daemon, so the Renko state starts on the venue's anchor price.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QEventLoop>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+
+#include <cstdio>
+#include <memory>
+
+#include "ExchangeConnector.h"
+#include "LatencyHistogram.h"
+#include "SimulatedVenue.h"
+#include "StrategyEngine.h"
+#include "TradingDaemon.h"
+
+enum Segment { FEED_TO_SIGNAL, SIGNAL_TO_RISK, RISK_TO_SUBMIT, SUBMIT_TO_VENUE, TICK_TO_ORDER, SEGMENT_COUNT };
+static const char *SEGMENT_NAMES[SEGMENT_COUNT] = { "feed->signal", "signal->risk", "risk->submit",
+                                                    "submit->venue", "tick->order" };
+
+struct SubmittedEntry {
+    qint64 feedTimeNs;
+    qint64 signalTimeNs;
+    qint64 riskPassTimeNs;
+    qint64 submitTimeNs;
+};
+
+struct RunResult {
+    int rate;
+    double seconds;
+    quint64 ticks;
+    int signalCount;
+    int entries;
+    int unmatched; // entries submitted that never reached the venue
+    LatencyHistogram segments[SEGMENT_COUNT];
+};
+
+// Repo config pointed at the venue: live Binance transport, files under a temporary directory
+static QJsonObject harnessConfig(const SimulatedVenue &venue, const QTemporaryDir &dir)
+{
+    QFile file(MMT_SOURCE_DIR "/config.json");
+    QJsonObject config;
+    if (file.open(QIODevice::ReadOnly)) config = QJsonDocument::fromJson(file.readAll()).object();
+    config.remove("strategy");
+    config.remove("journal");
+
+    QJsonObject trading = config["trading"].toObject();
+    trading["defaultExchange"] = "Binance";
+    trading["paperTradingMode"] = false;
+    trading["autoStart"] = false;
+    config["trading"] = trading;
+
+    QJsonObject exchanges = config["exchanges"].toObject();
+    QJsonObject binance = exchanges["Binance"].toObject();
+    binance["testMode"] = false;
+    binance["baseUrl"] = venue.restUrl();
+    binance["wsUrl"] = venue.webSocketUrl();
+    // Non-empty so every order pays for the HMAC signature it would live
+    binance["apiKey"] = "harness";
+    binance["apiSecret"] = "harness";
+    exchanges["Binance"] = binance;
+    config["exchanges"] = exchanges;
+
+    // Nothing is filled back into the risk book here, but keep every cap out of the way
+    QJsonObject risk = config["risk"].toObject();
+    risk["maxOpenPositions"] = 1000000;
+    risk["maxTradesPerDay"] = 1000000;
+    risk["maxPortfolioVaR"] = 0.0;
+    risk["emergencyStop"] = false;
+    config["risk"] = risk;
+
+    QJsonObject logging = config["logging"].toObject();
+    logging["file"] = dir.filePath("harness.log");
+    logging["binaryFile"] = dir.filePath("harness.blog");
+    config["logging"] = logging;
+
+    QJsonObject metrics = config["metrics"].toObject();
+    metrics["enabled"] = false;
+    config["metrics"] = metrics;
+
+    QJsonObject daemon = config["daemon"].toObject();
+    daemon["socketName"] = QString("mmt-harness-%1").arg(QCoreApplication::applicationPid());
+    config["daemon"] = daemon;
+    return config;
+}
+
+static void waitFor(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+static bool run(SimulatedVenue *venue, int rate, int durationMs, RunResult &result)
+{
+    QTemporaryDir dir;
+    TradingDaemon daemon;
+    if (!daemon.initialize(harnessConfig(*venue, dir))) return false;
+    daemon.strategyEngine()->setBrickSize(10.0);
+
+    QHash<QString, SubmittedEntry> submitted;
+    QObject::connect(daemon.exchangeConnector(), &ExchangeConnector::orderSubmitted, &daemon,
+                     [&submitted](const OrderRequest &request) {
+        // Exit legs carry no feed stamp; only entries are on the tick-to-order path
+        if (request.feedTimeNs == 0) return;
+        submitted.insert(request.clientOrderId, { request.feedTimeNs, request.signalTimeNs,
+                                                  request.riskPassTimeNs, LatencyClock::nowNs() });
+    });
+
+    // Stragglers from the previous run (late exit legs) must not match this one
+    venue->takeArrivals();
+
+    // The previous daemon's stream may not have closed yet, so wait for this one's SUBSCRIBE
+    bool isSubscribed = false;
+    QEventLoop subscribing;
+    QObject::connect(venue, &SimulatedVenue::clientSubscribed, &subscribing, [&subscribing, &isSubscribed]() {
+        isSubscribed = true;
+        subscribing.quit();
+    });
+    QTimer::singleShot(5000, &subscribing, &QEventLoop::quit);
+    daemon.start();
+    subscribing.exec();
+    if (!isSubscribed) {
+        std::fprintf(stderr, "daemon never subscribed to the venue feed\n");
+        return false;
+    }
+
+    QMetaObject::invokeMethod(venue, "startFeed", Qt::BlockingQueuedConnection, Q_ARG(int, rate));
+    waitFor(durationMs);
+    QMetaObject::invokeMethod(venue, "stopFeed", Qt::BlockingQueuedConnection);
+    result.ticks = venue->ticksSent();
+    // Let the orders already on the wire land
+    waitFor(500);
+    daemon.shutdown();
+
+    result.rate = rate;
+    result.seconds = durationMs / 1000.0;
+    result.signalCount = daemon.strategyEngine()->getTotalSignals();
+    result.entries = submitted.size();
+    result.unmatched = submitted.size();
+    for (const SimulatedVenue::OrderArrival &arrival : venue->takeArrivals()) {
+        auto it = submitted.constFind(arrival.clientOrderId);
+        if (it == submitted.constEnd()) continue;
+        const SubmittedEntry &entry = it.value();
+        result.segments[FEED_TO_SIGNAL].record(entry.signalTimeNs - entry.feedTimeNs);
+        result.segments[SIGNAL_TO_RISK].record(entry.riskPassTimeNs - entry.signalTimeNs);
+        result.segments[RISK_TO_SUBMIT].record(entry.submitTimeNs - entry.riskPassTimeNs);
+        result.segments[SUBMIT_TO_VENUE].record(arrival.arrivalTimeNs - entry.submitTimeNs);
+        result.segments[TICK_TO_ORDER].record(arrival.arrivalTimeNs - entry.feedTimeNs);
+        --result.unmatched;
+    }
+    return true;
+}
+
+static void printResult(const RunResult &result)
+{
+    std::printf("\n%d ticks/s for %.1f s: %llu ticks (%.0f/s achieved), %d signals, %d entries, %d not at venue\n",
+                result.rate, result.seconds, static_cast<unsigned long long>(result.ticks),
+                result.ticks / result.seconds, result.signalCount, result.entries, result.unmatched);
+    std::printf("  %-14s %8s %10s %10s %10s %10s %10s %10s\n", "segment (us)", "count", "min", "p50", "p90",
+                "p99", "p99.9", "max");
+    for (int s = 0; s < SEGMENT_COUNT; ++s) {
+        const LatencyHistogram::Summary summary = result.segments[s].summary();
+        std::printf("  %-14s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", SEGMENT_NAMES[s],
+                    static_cast<unsigned long long>(summary.count), summary.min / 1e3, summary.p50 / 1e3,
+                    summary.p90 / 1e3, summary.p99 / 1e3, summary.p999 / 1e3, summary.max / 1e3);
+    }
+}
+
+static QJsonObject toJson(const RunResult &result)
+{
+    QJsonObject run;
+    run["rate"] = result.rate;
+    run["seconds"] = result.seconds;
+    run["ticks"] = static_cast<qint64>(result.ticks);
+    run["signals"] = result.signalCount;
+    run["entries"] = result.entries;
+    run["unmatched"] = result.unmatched;
+    QJsonObject segments;
+    for (int s = 0; s < SEGMENT_COUNT; ++s) {
+        const LatencyHistogram::Summary summary = result.segments[s].summary();
+        QJsonObject segment;
+        segment["count"] = static_cast<qint64>(summary.count);
+        segment["minNs"] = static_cast<qint64>(summary.min);
+        segment["meanNs"] = summary.mean;
+        segment["p50Ns"] = static_cast<qint64>(summary.p50);
+        segment["p90Ns"] = static_cast<qint64>(summary.p90);
+        segment["p99Ns"] = static_cast<qint64>(summary.p99);
+        segment["p999Ns"] = static_cast<qint64>(summary.p999);
+        segment["maxNs"] = static_cast<qint64>(summary.max);
+        segments[SEGMENT_NAMES[s]] = segment;
+    }
+    run["segments"] = segments;
+    return run;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Tick-to-order latency against a simulated venue");
+    parser.addHelpOption();
+    QCommandLineOption ratesOption("rates", "Comma-separated feed rates in ticks per second.", "list", "1000,10000,50000");
+    QCommandLineOption durationOption("duration", "Seconds of feed per rate.", "seconds", "10");
+    QCommandLineOption signalOption("signal-every", "Ticks per Setup 1 cycle (at least 8).", "ticks", "50");
+    QCommandLineOption jsonOption("json", "Also write the results as JSON.", "file");
+    parser.addOption(ratesOption);
+    parser.addOption(durationOption);
+    parser.addOption(signalOption);
+    parser.addOption(jsonOption);
+    parser.process(app);
+
+    QThread venueThread;
+    venueThread.setObjectName("venue");
+    SimulatedVenue *venue = new SimulatedVenue;
+    venue->setSymbol("BTCUSD");
+    venue->setAnchorPrice(50000.0);
+    venue->setBrickSize(10.0);
+    venue->setSignalEvery(parser.value(signalOption).toInt());
+    venue->moveToThread(&venueThread);
+    QObject::connect(&venueThread, &QThread::finished, venue, &QObject::deleteLater);
+    venueThread.start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(venue, "listen", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, listening));
+    if (!listening) {
+        std::fprintf(stderr, "simulated venue cannot listen on loopback\n");
+        venueThread.quit();
+        venueThread.wait();
+        return 1;
+    }
+    std::printf("venue: feed %s, orders %s\n", qPrintable(venue->webSocketUrl()), qPrintable(venue->restUrl()));
+
+    const int durationMs = qMax(1, parser.value(durationOption).toInt()) * 1000;
+    QJsonArray runs;
+    int exitCode = 0;
+    for (const QString &value : parser.value(ratesOption).split(',', Qt::SkipEmptyParts)) {
+        const int rate = value.trimmed().toInt();
+        if (rate <= 0) continue;
+        std::unique_ptr<RunResult> result(new RunResult());
+        if (!run(venue, rate, durationMs, *result)) {
+            exitCode = 1;
+            break;
+        }
+        printResult(*result);
+        runs.append(toJson(*result));
+    }
+
+    QMetaObject::invokeMethod(venue, "close", Qt::BlockingQueuedConnection);
+    venueThread.quit();
+    venueThread.wait();
+
+    if (parser.isSet(jsonOption)) {
+        QFile out(parser.value(jsonOption));
+        if (out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QJsonObject root;
+            root["runs"] = runs;
+            out.write(QJsonDocument(root).toJson());
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,164 @@
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+// Deferred-format logging. The hot path stores a format id plus raw arguments in a
+// fixed-size record; the text is only rendered later, by the Logger writer thread or
+// offline by BinaryLogDecoder from a .blog file. Qt-free so the decoder builds without Qt.
+
+enum BinaryLogArgType : uint8_t {
+    BLOG_INT = 1,
+    BLOG_DOUBLE = 2,
+    BLOG_STRING = 3,   // length byte + Latin-1 bytes, truncated to fit
+    BLOG_TIME = 4      // wall clock milliseconds
+};
+
+struct BinaryLogRecord {
+    static const int ARG_BYTES = 112;
+
+    int64_t timestampNs;      // wall clock
+    uint16_t formatId;
+    uint8_t level;
+    uint8_t size;             // bytes of args used
+    uint32_t threadId;        // index of the producing thread buffer
+    uint8_t args[ARG_BYTES];
+};
+
+// Timestamp argument, rendered as a date-time
+struct BinaryLogTime {
+    int64_t ms;
+};
+
+// Argument encoders. Anything that does not fit in the record is dropped from it
+inline void blogPutWord(BinaryLogRecord &record, int &pos, uint8_t type, const void *value)
+{
+    if (pos + 9 > BinaryLogRecord::ARG_BYTES) return;
+    record.args[pos] = type;
+    std::memcpy(record.args + pos + 1, value, 8);
+    pos += 9;
+}
+inline void blogPutInt(BinaryLogRecord &record, int &pos, int64_t value) { blogPutWord(record, pos, BLOG_INT, &value); }
+inline void blogPut(BinaryLogRecord &record, int &pos, int value) { blogPutInt(record, pos, value); }
+inline void blogPut(BinaryLogRecord &record, int &pos, long value) { blogPutInt(record, pos, value); }
+inline void blogPut(BinaryLogRecord &record, int &pos, long long value) { blogPutInt(record, pos, value); }
+inline void blogPut(BinaryLogRecord &record, int &pos, unsigned value) { blogPutInt(record, pos, value); }
+inline void blogPut(BinaryLogRecord &record, int &pos, unsigned long value) { blogPutInt(record, pos, static_cast<int64_t>(value)); }
+inline void blogPut(BinaryLogRecord &record, int &pos, unsigned long long value) { blogPutInt(record, pos, static_cast<int64_t>(value)); }
+inline void blogPut(BinaryLogRecord &record, int &pos, bool value) { blogPutInt(record, pos, value); }
+inline void blogPut(BinaryLogRecord &record, int &pos, double value) { blogPutWord(record, pos, BLOG_DOUBLE, &value); }
+inline void blogPut(BinaryLogRecord &record, int &pos, BinaryLogTime value) { blogPutWord(record, pos, BLOG_TIME, &value.ms); }
+
+inline void blogPutString(BinaryLogRecord &record, int &pos, const char *text, int length)
+{
+    int room = BinaryLogRecord::ARG_BYTES - pos - 2;
+    if (room < 0) return;
+    if (length > room) length = room;
+    if (length > 255) length = 255;
+    record.args[pos] = BLOG_STRING;
+    record.args[pos + 1] = static_cast<uint8_t>(length);
+    std::memcpy(record.args + pos + 2, text, length);
+    pos += 2 + length;
+}
+inline void blogPut(BinaryLogRecord &record, int &pos, const char *text)
+{
+    blogPutString(record, pos, text, static_cast<int>(std::strlen(text)));
+}
+
+// Process-wide format table. Formats use the QString::arg placeholders %1..%9 and are
+// normally registered once, from a file-static initialiser
+class BinaryLogFormats
+{
+public:
+    static const int MAX_FORMATS = 1024;
+
+    static int add(int level, const char *format);
+    static int count();
+    static const char *format(int id);
+    static int level(int id);
+};
+
+// Single-producer single-consumer ring of records owned by one thread
+class BinaryLogBuffer
+{
+public:
+    static const int CAPACITY = 1024;   // power of two
+
+    explicit BinaryLogBuffer(uint32_t threadId);
+    BinaryLogBuffer(const BinaryLogBuffer &) = delete;
+    BinaryLogBuffer &operator=(const BinaryLogBuffer &) = delete;
+
+    // Producer: claim() returns nullptr when full; publish() makes the claimed record visible
+    BinaryLogRecord *claim()
+    {
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead >= CAPACITY) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead >= CAPACITY) return nullptr;
+        }
+        BinaryLogRecord *record = &m_records[tail & (CAPACITY - 1)];
+        record->threadId = m_threadId;
+        return record;
+    }
+    void publish() { m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst); }
+
+    // Consumer
+    const BinaryLogRecord *peek() const
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return nullptr;
+        return &m_records[head & (CAPACITY - 1)];
+    }
+    void release() { m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+    bool isEmpty() const { return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_seq_cst); }
+
+private:
+    std::unique_ptr<BinaryLogRecord[]> m_records;
+    uint32_t m_threadId;
+    alignas(64) std::atomic<uint64_t> m_tail;
+    uint64_t m_cachedHead;
+    alignas(64) std::atomic<uint64_t> m_head;
+};
+
+// .blog layout: FileHeader, then frames. A frame is one kind byte followed by either a
+// format definition (uint16 id, uint8 level, uint16 length, text) written before the
+// first record that uses it, or a raw BinaryLogRecord. Host byte order.
+class BinaryLog
+{
+public:
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t reserved;
+    };
+
+    static constexpr char MAGIC[4] = { 'M', 'M', 'B', 'L' };
+    static const uint32_t FORMAT_VERSION = 1;
+    static const uint8_t FRAME_FORMAT = 'F';
+    static const uint8_t FRAME_RECORD = 'R';
+
+    static int64_t wallClockNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static FileHeader fileHeader();
+    static bool isValidHeader(const FileHeader &header);
+    // Appends a format-definition frame to out
+    static void appendFormatFrame(std::string &out, int id, int level, const char *format);
+
+    static const char *levelName(int level);
+    // Substitutes %1..%9 with the record's arguments
+    static std::string render(const char *format, const BinaryLogRecord &record);
+    // "yyyy-MM-dd hh:mm:ss.zzz", local time
+    static std::string formatTimestamp(int64_t ms);
+};
+
+#endif // BINARYLOG_H
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QString>
 #include <QMutex>
+#include <QJsonObject>
 #include <map>
 
 class CapitalAllocator : public QObject
@@ -14,12 +15,20 @@ public:
     explicit CapitalAllocator(QObject *parent = nullptr);
     ~CapitalAllocator() = default;
     
+    void loadConfig(const QJsonObject &config);
+    
+    // Base allocation; what callers get back is base * scale
     void setCapitalForSymbol(const QString &symbol, double capital);
     double getCapitalForSymbol(const QString &symbol) const;
     double getTotalCapital() const;
     
+    // Set at counter boundaries by the counter engine (1.0 = configured allocation)
+    void setScale(double scale);
+    double getScale() const;
+    
 private:
     std::map<QString, double> m_capitalAllocation;
+    double m_scale;
     mutable QMutex m_mutex;
 };
 
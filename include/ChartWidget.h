@@ -3,25 +3,19 @@
 
 #include <QWidget>
 #include <QVBoxLayout>
-// #include <QChart>
-// #include <QChartView>
-// #include <QLineSeries>
-// #include <QValueAxis>
-// #include <QDateTimeAxis>
 #include <QGroupBox>
 #include <QComboBox>
 #include <QPushButton>
+#include <QDateTime>
 
-// Forward declare Qt Charts classes - temporarily disabled
-/*
-QT_BEGIN_NAMESPACE
-class QChart;
-class QChartView;
-class QLineSeries;
-class QValueAxis;
-class QDateTimeAxis;
-QT_END_NAMESPACE
-*/
+// Qt Charts is optional; CMake defines MMT_HAVE_CHARTS when it is found
+#ifdef MMT_HAVE_CHARTS
+#include <QChart>
+#include <QChartView>
+#include <QLineSeries>
+#include <QValueAxis>
+#include <QDateTimeAxis>
+#endif
 
 class ChartWidget : public QWidget
 {
@@ -41,11 +35,13 @@ private:
     
     QVBoxLayout *m_layout;
     QGroupBox *m_groupBox;
-    // QChart *m_chart;
-    // QChartView *m_chartView;
-    // QLineSeries *m_priceSeries;
-    // QValueAxis *m_priceAxis;
-    // QDateTimeAxis *m_timeAxis;
+#ifdef MMT_HAVE_CHARTS
+    QChart *m_chart;
+    QChartView *m_chartView;
+    QLineSeries *m_priceSeries;
+    QValueAxis *m_priceAxis;
+    QDateTimeAxis *m_timeAxis;
+#endif
     QComboBox *m_symbolCombo;
     QPushButton *m_refreshButton;
 };
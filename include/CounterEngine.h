@@ -0,0 +1,110 @@
+#ifndef COUNTERENGINE_H
+#define COUNTERENGINE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QFile>
+#include <deque>
+
+class CapitalAllocator;
+
+// One batch of trades. Every field is maintained incrementally as trades close
+struct CounterStats {
+    int counterNumber;
+    int trades;
+    int wins;
+    int losses;
+    double startEquity;
+    double endEquity;
+    double netPnL;
+    double grossProfit;
+    double grossLoss;
+    double largestWin;
+    double largestLoss;
+    double peakPnL;        // running high of netPnL within the counter
+    double maxDrawdown;    // peak-to-trough of netPnL within the counter
+    qint64 startTimeMs;
+    qint64 endTimeMs;
+
+    double winRate() const { return trades > 0 ? static_cast<double>(wins) / trades * 100.0 : 0.0; }
+    double profitFactor() const { return grossLoss > 0.0 ? grossProfit / grossLoss : 0.0; }
+    double expectancy() const { return trades > 0 ? netPnL / trades : 0.0; }
+};
+
+// Aggregates over every completed counter, kept in the history file header
+struct CounterSummary {
+    int counters;
+    int profitableCounters;
+    int consecutiveLosing;
+    int lastCounterNumber;
+    double baseEquity;     // equity when the first counter started
+    double totalPnL;
+    double bestCounter;
+    double worstCounter;
+};
+
+// Per-counter capital reassessment. Trades are counted into the current counter; when
+// it reaches tradesPerCounter the batch is closed, appended to the history file and
+// the capital scale is recomputed:
+//   scale = endEquity / baseEquity * lossReduction ^ consecutiveLosingCounters
+// clamped to [minScale, maxScale] and applied to the CapitalAllocator.
+//
+// The history file is a fixed header plus fixed-size records. The header carries the
+// running summary, so a restart reads the header and the last `lookback` records
+// rather than the whole history. Not thread-safe; RiskManager calls it under its lock.
+class CounterEngine
+{
+public:
+    CounterEngine();
+    ~CounterEngine();
+
+    void setTradesPerCounter(int trades);
+    void setLookback(int counters);
+    void setReassessment(double lossReduction, double minScale, double maxScale);
+    void setCapitalAllocator(CapitalAllocator *allocator);
+
+    // Opens (or creates) the history file and restores the summary and recent counters
+    bool openHistory(const QString &path);
+    void closeHistory();
+
+    // Starts a fresh current counter; in-progress trades are discarded
+    void start(double equity, qint64 timeMs);
+    // Returns true when this trade completes the current counter
+    bool recordTrade(double pnl, double equity, qint64 timeMs);
+    // Closes the current counter, persists and reassesses it, and starts the next one
+    CounterStats finish(double equity, qint64 timeMs);
+
+    const CounterStats &current() const { return m_current; }
+    const std::deque<CounterStats> &history() const { return m_history; }
+    const CounterSummary &summary() const { return m_summary; }
+    double capitalScale() const { return m_capitalScale; }
+
+private:
+    void resetCurrent(int counterNumber, double equity, qint64 timeMs);
+    void fold(const CounterStats &stats);
+    void remember(const CounterStats &stats);
+    double reassess() const;
+    bool appendRecord(const CounterStats &stats);
+    bool writeHeader();
+
+    int m_tradesPerCounter;
+    int m_lookback;
+    double m_lossReduction;
+    double m_minScale;
+    double m_maxScale;
+    double m_capitalScale;
+    CapitalAllocator *m_allocator;
+
+    CounterStats m_current;
+    CounterSummary m_summary;
+    std::deque<CounterStats> m_history; // last m_lookback completed counters
+    QFile m_file;
+
+    static const int DEFAULT_TRADES_PER_COUNTER = 10;
+    static const int DEFAULT_LOOKBACK = 20;
+    static constexpr double DEFAULT_LOSS_REDUCTION = 0.75;
+    static constexpr double DEFAULT_MIN_SCALE = 0.25;
+    static constexpr double DEFAULT_MAX_SCALE = 2.0;
+};
+
+#endif // COUNTERENGINE_H
@@ -0,0 +1,42 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3, reflected 0xEDB88320), the checksum used by gzip and zip.
+// Incremental: feed the previous result back in as `crc` to extend it.
+class Crc32
+{
+public:
+    static uint32_t compute(const void *data, size_t length, uint32_t crc = 0)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        const uint32_t *table = Crc32::table();
+        crc = ~crc;
+        for (size_t i = 0; i < length; ++i) {
+            crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+private:
+    static const uint32_t *table()
+    {
+        struct Table {
+            uint32_t entries[256];
+            Table()
+            {
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    entries[i] = c;
+                }
+            }
+        };
+        static const Table instance;
+        return instance.entries;
+    }
+};
+
+#endif // CRC32_H
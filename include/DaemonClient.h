@@ -0,0 +1,41 @@
+#ifndef DAEMONCLIENT_H
+#define DAEMONCLIENT_H
+
+#include <QObject>
+#include <QString>
+#include <QJsonObject>
+
+class QLocalSocket;
+
+// GUI side of the TradingDaemon control channel: newline-delimited JSON over a local socket
+class DaemonClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DaemonClient(QObject *parent = nullptr);
+    ~DaemonClient();
+
+    void connectToDaemon(const QString &socketName);
+    void disconnectFromDaemon();
+    bool isConnected() const;
+    QString socketName() const { return m_socketName; }
+
+    void sendCommand(const QString &cmd, const QJsonObject &args = QJsonObject());
+
+signals:
+    void connected();
+    void disconnected();
+    void statusReceived(const QJsonObject &status);
+    void replyReceived(const QString &cmd, const QJsonObject &reply);
+    void errorOccurred(const QString &error);
+
+private slots:
+    void onReadyRead();
+
+private:
+    QLocalSocket *m_socket;
+    QString m_socketName;
+};
+
+#endif // DAEMONCLIENT_H
@@ -15,9 +15,14 @@
 #include <QWebSocket>
 #include <memory>
 #include <map>
+#include <vector>
+#include <functional>
+
+class QUrlQuery;
 
 // Include RiskManager.h to get Position struct definition
 #include "RiskManager.h"
+#include "OrderIdGenerator.h"
 
 enum class ExchangeType {
     BINANCE,
@@ -42,6 +47,14 @@ enum class OrderSide {
     SELL
 };
 
+// GTC rests until filled or cancelled; IOC fills what it can at once and expires the rest;
+// FOK fills in full at once or expires
+enum class TimeInForce {
+    GTC,
+    IOC,
+    FOK
+};
+
 enum class OrderStatus {
     PENDING,
     FILLED,
@@ -55,12 +68,25 @@ struct MarketData {
     QString symbol;
     double bid;
     double ask;
-    double last;
-    double volume;
+    double last;          // last trade price; quote-only updates carry it over
+    double volume;        // quantity traded in this update (one trade print); 0 for quote-only updates
     double high24h;
     double low24h;
     double change24h;
     QDateTime timestamp;
+    qint64 receiveTimeNs; // LatencyClock stamp when the frame came off the socket, 0 if not from a feed
+};
+
+struct OrderBookLevel {
+    double price;
+    double quantity;
+};
+
+struct OrderBook {
+    QString symbol;
+    std::vector<OrderBookLevel> bids; // best first
+    std::vector<OrderBookLevel> asks; // best first
+    QDateTime timestamp;
 };
 
 struct OrderRequest {
@@ -70,9 +96,12 @@ struct OrderRequest {
     double quantity;
     double price;
     double stopPrice;
-    double timeInForce;
+    TimeInForce timeInForce; // LIMIT orders only
     QString clientOrderId;
     QJsonObject metadata;
+    qint64 feedTimeNs;     // LatencyClock stamps carried for execution telemetry, 0 if unknown
+    qint64 signalTimeNs;
+    qint64 riskPassTimeNs;
 };
 
 struct OrderResponse {
@@ -109,20 +138,45 @@ public:
     void setExchange(ExchangeType exchange);
     void setApiCredentials(const QString &apiKey, const QString &apiSecret, const QString &passphrase = "");
     void setTestMode(bool enabled);
+    // Live mode: REST base URL for orders and the market-data stream URL. Without a
+    // stream URL connect() keeps the simulated session.
+    void setEndpoints(const QString &restUrl, const QString &webSocketUrl);
     
     bool connect();
     void disconnect();
     bool isConnected() const;
+    // Whether fills and cancels of resting orders are reported at all: always in test mode,
+    // on live Binance once the user-data stream is open. Without it nothing can react to an
+    // exit leg filling
+    bool hasOrderUpdates() const;
     
     // Market data
     void subscribeToMarketData(const QString &symbol);
     void unsubscribeFromMarketData(const QString &symbol);
+    // Empty (all zero) until the feed has quoted the symbol
     MarketData getMarketData(const QString &symbol) const;
+    // The simulated book, or the one kept from the depth stream; no levels while neither exists
+    OrderBook getOrderBook(const QString &symbol, int depth = 10);
+    // Test mode: fixed book the simulated venue quotes and fills against
+    void setSimulatedOrderBook(const OrderBook &book);
     
     // Trading operations
     QString placeOrder(const OrderRequest &request);
+    // Live Binance and test mode; the venue confirms with orderCancelled
     bool cancelOrder(const QString &orderId);
+    // Venue-native mass cancel; returns false if it could not be sent. The venue's
+    // confirmation arrives as allOrdersCancelled with the number of orders it cancelled,
+    // or as cancelAllFailed
+    bool cancelAllOrders();
+    // Test mode: delay before the simulated venue confirms a mass cancel
+    void setSimulatedCancelLatency(int ms);
     bool modifyOrder(const QString &orderId, double newPrice, double newQuantity = 0);
+    // Live Binance only; elsewhere OrderManager links the two exit legs itself
+    bool supportsNativeOco() const;
+    // Ids are the legs' client order ids; the venue's verdict arrives per leg as orderRejected,
+    // orderFilled or orderCancelled
+    bool placeOcoOrder(const OrderRequest &stopLeg, const OrderRequest &takeProfitLeg,
+                       QString &stopOrderId, QString &takeProfitOrderId);
     OrderResponse getOrderStatus(const QString &orderId);
     std::vector<OrderResponse> getOpenOrders(const QString &symbol = "");
     std::vector<OrderResponse> getOrderHistory(const QString &symbol = "", int limit = 100);
@@ -157,8 +211,15 @@ signals:
     void disconnected();
     void connectionError(const QString &error);
     void marketDataReceived(const MarketData &data);
+    // Emitted with the final request (client id assigned) just before it goes to the venue
+    void orderSubmitted(const OrderRequest &request);
+    // The venue accepted the order placeOrder returned orderId for; venueOrderId is the
+    // venue's own id for it. May repeat when both the REST reply and the stream report it
+    void orderAcknowledged(const QString &orderId, const QString &venueOrderId);
     void orderFilled(const OrderResponse &response);
     void orderCancelled(const QString &orderId);
+    void allOrdersCancelled(int count);
+    void cancelAllFailed(const QString &error);
     void orderRejected(const QString &orderId, const QString &reason);
     void positionUpdated(const Position &position);
     void accountUpdated(const AccountInfo &info);
@@ -166,14 +227,36 @@ signals:
 
 private slots:
     void onNetworkReplyFinished();
+    void onOcoReplyFinished();
+    void onCancelReplyFinished();
+    void onCancelAllReplyFinished();
     void onWebSocketConnected();
     void onWebSocketDisconnected();
     void onWebSocketTextMessageReceived(const QString &message);
     void onWebSocketError(QAbstractSocket::SocketError error);
     void onHeartbeatTimer();
     void onReconnectTimer();
+    void onListenKeyReplyFinished();
+    void onUserStreamConnected();
+    void onUserStreamDisconnected();
+    void onUserStreamTextMessageReceived(const QString &message);
+    void onListenKeyTimer();
+    void onDepthSnapshotFinished();
 
 private:
+    // Local book kept from the diff depth stream, seeded from a REST snapshot; diffs that
+    // arrive before the snapshot wait in pending
+    struct DepthBook {
+        std::map<double, double, std::greater<double>> bids;
+        std::map<double, double> asks;
+        qint64 lastUpdateId;
+        bool synced;
+        QDateTime timestamp;
+        std::vector<QJsonObject> pending;
+
+        DepthBook() : lastUpdateId(0), synced(false) {}
+    };
+
     // Exchange-specific implementations
     void connectBinance();
     void connectCoinbase();
@@ -183,22 +266,24 @@ private:
     void connectMetaTrader5();
     
     // API request methods
-    QNetworkRequest createRequest(const QString &endpoint, const QJsonObject &params = QJsonObject());
-    QJsonObject sendRequest(const QString &method, const QString &endpoint, const QJsonObject &params = QJsonObject());
     QString signRequest(const QString &queryString, const QString &secret);
     
     // WebSocket methods
     void setupWebSocket();
     void sendWebSocketMessage(const QJsonObject &message);
+    void subscribeOnVenue(const QString &symbol);
     void handleWebSocketMessage(const QJsonObject &message);
     
     // Order management
     QString generateClientOrderId();
+    bool simulateExecution(const OrderRequest &request, double &filledQuantity, double &averagePrice);
     void processOrderResponse(const QJsonObject &response);
     void updateOrderStatus(const QString &orderId, OrderStatus status);
     
     // Market data processing
     void processMarketData(const QJsonObject &data);
+    void processDepthUpdate(const QJsonObject &update);
+    static bool applyDepthUpdate(DepthBook &book, const QJsonObject &update);
     void updateMarketData(const QString &symbol, const MarketData &data);
     
     // Helper methods
@@ -206,24 +291,40 @@ private:
     double formatPrice(double price, const QString &symbol) const;
     double formatQuantity(double quantity, const QString &symbol) const;
     OrderStatus parseOrderStatus(const QString &status) const;
+    AccountInfo parseAccountInfo(const QJsonObject &account) const;
     
     // Binance specific methods
+    QNetworkReply *binanceSignedRequest(const QByteArray &verb, const QString &path, const QUrlQuery &params);
+    QNetworkReply *binanceUserStreamRequest(const QByteArray &verb);
+    void binanceStartUserStream();
+    void binanceStopUserStream();
+    void processExecutionReport(const QJsonObject &report);
     QString binancePlaceOrder(const OrderRequest &request);
+    // POST or GET /api/v3/order, signed afresh on each attempt; the reply goes to onNetworkReplyFinished
+    void binanceOrderRequest(const QByteArray &verb, const QUrlQuery &params, const QString &clientOrderId, int attempt);
+    bool binancePlaceOcoOrder(const OrderRequest &stopLeg, const OrderRequest &takeProfitLeg,
+                              QString &stopOrderId, QString &takeProfitOrderId);
+    bool binanceCancelOrder(const QString &orderId);
+    bool binanceCancelAllOrders();
     QJsonObject binanceGetAccountInfo();
     void binanceSubscribeMarketData(const QString &symbol);
+    void binanceRequestDepthSnapshot(const QString &symbol);
     
     // Coinbase specific methods
     QString coinbasePlaceOrder(const OrderRequest &request);
+    bool coinbaseCancelAllOrders();
     QJsonObject coinbaseGetAccountInfo();
     void coinbaseSubscribeMarketData(const QString &symbol);
     
     // Deribit specific methods
     QString deribitPlaceOrder(const OrderRequest &request);
+    bool deribitCancelAllOrders();
     QJsonObject deribitGetAccountInfo();
     void deribitSubscribeMarketData(const QString &symbol);
     
     // Delta Exchange specific methods
     QString deltaPlaceOrder(const OrderRequest &request);
+    bool deltaCancelAllOrders();
     QJsonObject deltaGetAccountInfo();
     void deltaSubscribeMarketData(const QString &symbol);
     
@@ -248,6 +349,8 @@ private:
     
     // Data storage
     std::map<QString, MarketData> m_marketData;
+    std::map<QString, OrderBook> m_simulatedBooks;
+    std::map<QString, DepthBook> m_depthBooks; // venue symbol -> book from the depth stream
     std::map<QString, OrderResponse> m_orders;
     std::map<QString, Position> m_positions;
     AccountInfo m_accountInfo;
@@ -260,6 +363,10 @@ private:
     
     // API endpoints (exchange-specific)
     std::map<QString, QString> m_apiEndpoints;
+    QString m_restUrl;
+    QString m_webSocketUrl;
+    std::vector<QString> m_subscriptions; // replayed on every (re)connect
+    qint64 m_frameTimeNs; // receive stamp of the frame being handled
     
     // Thread safety
     mutable QMutex m_mutex;
@@ -269,12 +376,39 @@ private:
     static const int RECONNECT_INTERVAL = 5000; // 5 seconds
     static const int MAX_RECONNECT_ATTEMPTS = 10;
     static const int REQUEST_TIMEOUT = 30000; // 30 seconds
+    static const int DEPTH_SNAPSHOT_LIMIT = 100;
+    static const int MAX_PENDING_DEPTH_UPDATES = 1000;
+    static const int MAX_ORDER_RETRIES = 3;
+    static const int ORDER_RETRY_BACKOFF = 250; // ms, doubled on each retry
     
     // Rate limiting
     QTimer *m_rateLimitTimer;
     int m_requestCount;
     QDateTime m_lastRequestTime;
     static const int MAX_REQUESTS_PER_SECOND = 10;
+
+    // Order ids: client ids for requests that arrive without one (tag distinct from
+    // OrderManager's), venue ids the test-mode venue assigns
+    OrderIdGenerator m_clientOrderIds;
+    OrderIdGenerator m_simulatedOrderIds;
+    std::map<QString, QString> m_clientOrderIndex; // clientOrderId -> orderId
+    int m_simulatedCancelLatencyMs;
+
+    // Live orders not yet final: client id -> venue symbol, which cancels must name
+    std::map<QString, QString> m_orderSymbols;
+    // Per-symbol mass cancel replies still outstanding, and what they have reported so far
+    int m_pendingMassCancels;
+    int m_massCancelCount;
+    QString m_massCancelError;
+    static const int BINANCE_UNKNOWN_ORDER = -2011;
+
+    // Binance user-data stream: executionReport events for every order on the account. Orders
+    // sent while it is open get their state from it alone; their REST replies report errors
+    QWebSocket *m_userStream;
+    QTimer *m_listenKeyTimer;
+    QString m_listenKey;
+    bool m_userStreamReady;
+    static const int LISTEN_KEY_KEEPALIVE_INTERVAL = 30 * 60 * 1000; // keys lapse after 60 minutes
 };
 
 #endif // EXCHANGECONNECTOR_H 
\ No newline at end of file
@@ -0,0 +1,123 @@
+#ifndef EXECUTIONALGOSCHEDULER_H
+#define EXECUTIONALGOSCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QMutex>
+#include <vector>
+#include <map>
+
+#include "ExchangeConnector.h"
+#include "TimerWheel.h"
+
+class OrderManager;
+
+enum class ExecutionAlgoType {
+    TWAP,
+    VWAP,
+    POV
+};
+
+enum class ExecutionAlgoState {
+    RUNNING,
+    COMPLETED,
+    CANCELLED
+};
+
+struct ExecutionAlgoParams {
+    ExecutionAlgoType type;
+    QString symbol;
+    OrderSide side;
+    double totalQuantity;
+    qint64 durationMs;       // TWAP/VWAP horizon; POV stops here even if unfilled
+    qint64 sliceIntervalMs;  // how often the algo wakes up
+    double participationRate; // POV only, 0.0 - 1.0
+    double minSliceQuantity;  // smaller slices are held back until the final one
+    double limitPrice;        // child orders rest as GTC limits at this price; 0 = market
+};
+
+struct ExecutionAlgoStatus {
+    quint64 algoId;
+    ExecutionAlgoParams params;
+    ExecutionAlgoState state;
+    double sentQuantity;
+    double observedVolume; // market volume printed since start (POV)
+    int slicesSent;
+    qint64 startMs;
+};
+
+class ExecutionAlgoScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ExecutionAlgoScheduler(QObject *parent = nullptr);
+    ~ExecutionAlgoScheduler();
+
+    void setOrderManager(OrderManager *orderManager);
+    void setTickInterval(int ms);
+
+    quint64 startAlgo(const ExecutionAlgoParams &params);
+    void cancelAlgo(quint64 algoId);
+    ExecutionAlgoStatus getAlgoStatus(quint64 algoId) const;
+    int getActiveAlgoCount() const;
+
+    // Historical intraday volume profile: weights per equal time-of-day bucket (e.g. 48 half
+    // hours). VWAP schedules on it and runs as TWAP for symbols that have none
+    void setVolumeProfile(const QString &symbol, const std::vector<double> &bucketWeights);
+    std::vector<double> getVolumeProfile(const QString &symbol) const;
+    // Volume printed so far today per bucket; persist it to load as the next session's profile
+    std::vector<double> getRecordedVolume(const QString &symbol) const;
+    // Profiles on disk as JSON, {symbol: [volume per bucket]}. Loading sets them as the VWAP
+    // profiles; saving writes today's recording, keeping the loaded volume for buckets this
+    // session saw no prints in, so a short session does not blank the rest of the day
+    bool loadVolumeProfiles(const QString &path);
+    bool saveVolumeProfiles(const QString &path) const;
+
+    // Drives the wheel to nowMs; the internal timer calls this with the monotonic clock
+    void advanceTo(qint64 nowMs);
+
+public slots:
+    // Live trade prints feed POV participation and the recorded volume profile
+    void onTradePrint(const QString &symbol, double price, double quantity);
+    void onMarketData(const MarketData &data);
+
+signals:
+    void childOrderRequested(quint64 algoId, const QString &symbol, OrderSide side, double quantity);
+    void algoCompleted(quint64 algoId, double sentQuantity);
+    void algoCancelled(quint64 algoId, double sentQuantity);
+
+private slots:
+    void onWheelTick();
+
+private:
+    struct VolumeProfile {
+        std::vector<double> weights;    // loaded from a previous session
+        std::vector<double> recorded;   // volume seen today per bucket
+    };
+
+    double runSlice(ExecutionAlgoStatus &algo, qint64 nowMs);
+    static OrderRequest sliceRequest(const ExecutionAlgoParams &params, double quantity);
+    double targetQuantity(const ExecutionAlgoStatus &algo, qint64 nowMs) const;
+    double profileFraction(const QString &symbol, qint64 fromMs, qint64 toMs) const;
+    static qint64 nowMs();
+    static qint64 msOfDay(qint64 monotonicMs, qint64 wallOffsetMs);
+
+    OrderManager *m_orderManager;
+    QTimer *m_wheelTimer;
+    TimerWheel m_wheel;
+    quint64 m_nextAlgoId;
+    qint64 m_wallOffsetMs; // wall clock - monotonic clock, fixed at construction
+
+    std::map<quint64, ExecutionAlgoStatus> m_algos;
+    std::map<QString, std::vector<quint64>> m_povBySymbol;
+    std::map<QString, VolumeProfile> m_profiles;
+    mutable QMutex m_mutex;
+
+    static const int DEFAULT_TICK_MS = 50;
+    static const int WHEEL_SLOTS = 1024;
+    static const int PROFILE_BUCKETS = 48;
+};
+
+#endif // EXECUTIONALGOSCHEDULER_H
@@ -0,0 +1,88 @@
+#ifndef EXECUTIONTELEMETRY_H
+#define EXECUTIONTELEMETRY_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QJsonObject>
+#include <memory>
+
+#include "ExchangeConnector.h"
+#include "LatencyHistogram.h"
+
+enum class OrderStage {
+    SIGNAL,
+    RISK_PASS,
+    WIRE_SEND,
+    ACK,
+    FILL
+};
+
+enum class LatencySegment {
+    SIGNAL_TO_RISK,
+    RISK_TO_WIRE,
+    WIRE_TO_ACK,
+    ACK_TO_FILL,
+    SIGNAL_TO_FILL
+};
+
+// Per-order monotonic stage timestamps (LatencyClock::nowNs); 0 means not reached
+struct OrderTimeline {
+    int64_t stamps[5];
+    ExchangeType venue;
+    OrderType type;
+
+    OrderTimeline() : venue(ExchangeType::BINANCE), type(OrderType::MARKET)
+    {
+        for (auto &stamp : stamps) stamp = 0;
+    }
+    void mark(OrderStage stage, int64_t ns) { stamps[static_cast<int>(stage)] = ns; }
+    void mark(OrderStage stage) { mark(stage, LatencyClock::nowNs()); }
+    int64_t at(OrderStage stage) const { return stamps[static_cast<int>(stage)]; }
+};
+
+class ExecutionTelemetry : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int VENUE_COUNT = 6;
+    static const int ORDER_TYPE_COUNT = 6;
+    static const int SEGMENT_COUNT = 5;
+
+    explicit ExecutionTelemetry(QObject *parent = nullptr);
+    ~ExecutionTelemetry();
+
+    // Lock-free; safe to call from any thread
+    void record(const OrderTimeline &timeline);
+    void recordSegment(ExchangeType venue, OrderType type, LatencySegment segment, int64_t latencyNs);
+
+    const LatencyHistogram &histogram(ExchangeType venue, OrderType type, LatencySegment segment) const;
+    LatencyHistogram::Summary summary(ExchangeType venue, OrderType type, LatencySegment segment) const;
+    void reset();
+
+    QJsonObject toJson() const;
+    QString report() const;
+
+    void startPeriodicDump(int intervalMs);
+    void stopPeriodicDump();
+
+    static QString venueName(ExchangeType venue);
+    static QString orderTypeName(OrderType type);
+    static QString segmentName(LatencySegment segment);
+
+signals:
+    void telemetryReport(const QString &report);
+
+private slots:
+    void onDumpTimer();
+
+private:
+    LatencyHistogram &slot(ExchangeType venue, OrderType type, LatencySegment segment) const;
+
+    // Fixed venue x order type x segment grid, allocated once so recording never allocates
+    std::unique_ptr<LatencyHistogram[]> m_histograms;
+    QTimer *m_dumpTimer;
+};
+
+#endif // EXECUTIONTELEMETRY_H
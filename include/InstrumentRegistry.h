@@ -0,0 +1,122 @@
+#ifndef INSTRUMENTREGISTRY_H
+#define INSTRUMENTREGISTRY_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+class ExchangeConnector;
+
+enum class InstrumentClass {
+    FOREX,
+    CFD,          // metals, indices: forex-style lots on a non-currency base
+    CRYPTO_SPOT,
+    CRYPTO_PERP,
+    OPTION
+};
+
+// Leverage applies to positions whose notional is up to maxNotional (0 = no cap)
+struct LeverageTier {
+    double maxNotional;
+    double leverage;
+};
+
+struct InstrumentSpec {
+    QString symbol;
+    InstrumentClass instrumentClass;
+    QString baseCurrency;
+    QString quoteCurrency;
+    double contractSize;   // units of base per lot
+    double tickSize;
+    double tickValue;      // quote currency per tick per lot; pip value is derived from it
+    double pipSize;        // price distance the strategy calls a "pip"
+    double minQuantity;
+    double maxQuantity;
+    double quantityStep;
+    std::vector<LeverageTier> leverageTiers; // ascending maxNotional
+    QString underlying;    // options: underlying symbol
+    double shortOptionMarginRate; // options: fraction of underlying notional added for short legs
+};
+
+// Contract specs loaded once (config, then venues) and read without locks afterwards.
+// Each instrument keeps its last mark in an atomic so pricing and currency conversion
+// need no lookups beyond the initial hash; the instrument that converts a quote
+// currency into the account currency is resolved at load time.
+//
+// addInstrument/loadConfig/loadFromConnector are not safe against concurrent readers:
+// change a copy and publish that instead (RiskManager swaps it into its snapshot).
+// setMark and every query are safe.
+class InstrumentRegistry
+{
+public:
+    InstrumentRegistry();
+    // Copies carry the marks as they stand
+    InstrumentRegistry(const InstrumentRegistry &other);
+    InstrumentRegistry &operator=(const InstrumentRegistry &other);
+    ~InstrumentRegistry();
+
+    void setAccountCurrency(const QString &currency);
+    QString accountCurrency() const { return m_accountCurrency; }
+
+    void loadConfig(const QJsonObject &config);
+    // Fills in symbols the config did not describe, using what the venue reports
+    void loadFromConnector(ExchangeConnector *connector, const QStringList &symbols);
+    void addInstrument(const InstrumentSpec &spec);
+
+    bool contains(const QString &symbol) const;
+    InstrumentSpec spec(const QString &symbol) const; // inferred from the symbol if unknown
+    QStringList symbols() const;
+
+    void setMark(const QString &symbol, double price);
+    double mark(const QString &symbol) const;
+
+    // Account currency per unit of the symbol's quote currency
+    double quoteConversion(const QString &symbol) const;
+
+    double contractSize(const QString &symbol) const;
+
+    // All results are in the account currency; price 0 means "use the last mark"
+    double pipValue(const QString &symbol, double lots = 1.0) const;
+    double notional(const QString &symbol, double lots, double price = 0.0) const;
+    double marginRequirement(const QString &symbol, double lots, double price = 0.0, bool shortPosition = false) const;
+    double maxLots(const QString &symbol, double availableMargin, double price = 0.0) const;
+    double roundLots(const QString &symbol, double lots) const;
+
+    static InstrumentSpec inferSpec(const QString &symbol);
+    static InstrumentClass classFromString(const QString &name);
+
+private:
+    struct Instrument {
+        InstrumentSpec spec;
+        std::atomic<double> mark;
+        int conversionIndex;    // instrument whose mark converts quote -> account, -1 if none needed
+        bool invertConversion;  // account currency is that instrument's base
+        int underlyingIndex;
+    };
+
+    const Instrument *find(const QString &symbol) const;
+    void resolveLinks();
+    double markOf(const Instrument &instrument, double price) const;
+    double conversionOf(const Instrument &instrument) const;
+    double marginFor(const Instrument &instrument, double lots, double price, bool shortPosition) const;
+    double pipValueFor(const Instrument &instrument, double lots) const;
+    static double pipValuePerLot(const InstrumentSpec &spec);
+    const InstrumentSpec &inferred(const QString &symbol) const;
+    static double leverageFor(const InstrumentSpec &spec, double notional);
+    static InstrumentSpec specFromJson(const QString &symbol, const QJsonObject &json);
+
+    QString m_accountCurrency;
+    std::vector<std::unique_ptr<Instrument>> m_instruments;
+    QHash<QString, int> m_index;
+    // Specs inferred for symbols never loaded, kept so a miss parses the symbol only once
+    mutable QMutex m_inferredMutex;
+    mutable std::map<QString, InstrumentSpec> m_inferred;
+};
+
+#endif // INSTRUMENTREGISTRY_H
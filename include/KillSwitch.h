@@ -0,0 +1,124 @@
+#ifndef KILLSWITCH_H
+#define KILLSWITCH_H
+
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+#include <QTimer>
+#include <QMutex>
+#include <QJsonObject>
+#include <atomic>
+#include <set>
+#include <vector>
+
+#include "ExchangeConnector.h"
+#include "OrderIdGenerator.h"
+
+class OrderManager;
+class RiskManager;
+
+// Times are from the trigger, on LatencyClock; -1 means not reached
+struct VenueKillReport {
+    QString venue;
+    bool cancelSent;
+    bool cancelAcknowledged;
+    int cancelledOrders;      // as reported by the venue
+    double cancelAckMs;
+    int flattenOrders;
+    int flattenFills;
+    double flattenAckMs;      // last flatten fill
+    QString error;
+};
+
+struct KillSwitchReport {
+    QString reason;
+    QDateTime triggeredAt;
+    double gateClosedUs;      // trigger -> OrderManager refusing new orders
+    double dispatchUs;        // trigger -> last cancel-all handed to a venue
+    std::vector<VenueKillReport> venues;
+    bool complete;
+    bool timedOut;
+};
+
+// Emergency stop. trigger() closes the OrderManager gate first, then hands a venue-native
+// cancel-all to every venue before waiting on any of them, and flattens each venue as soon
+// as its cancel is acknowledged, through OrderManager past its closed gate. Connectors that
+// live on their own threads run their cancel-all concurrently; acks are timed in the thread
+// they arrive on.
+//
+// Test-mode connectors are the mock venues: setSimulatedCancelLatency() sets their ack
+// delay and a disconnected one behaves like a venue that cannot be reached.
+class KillSwitch : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KillSwitch(QObject *parent = nullptr);
+    ~KillSwitch() = default;
+
+    // risk.emergencyStop arms automatic triggering; risk.killSwitch holds the options
+    void loadConfig(const QJsonObject &config);
+    void setArmed(bool armed);
+    bool isArmed() const { return m_armed.load(std::memory_order_acquire); }
+    void setFlattenOnTrigger(bool flatten);
+    void setAckTimeout(int ms);
+
+    void setOrderManager(OrderManager *orderManager);
+    // The daily loss and drawdown limits trip the switch while it is armed
+    void setRiskManager(RiskManager *riskManager);
+    // The primary venue is the one the strategy trades on: if it reports no positions
+    // (test mode), the RiskManager book is flattened there instead
+    int addVenue(ExchangeConnector *connector, bool primary = false);
+
+    bool isEngaged() const { return m_engaged.load(std::memory_order_acquire); }
+    KillSwitchReport lastReport() const;
+
+public slots:
+    // Idempotent while engaged
+    void trigger(const QString &reason);
+    // Re-opens the order gate; the switch can trip again afterwards
+    void reset();
+
+signals:
+    void engaged(const QString &reason);
+    void venueAcknowledged(const QString &venue, double ackMs);
+    void venueFlattened(const QString &venue, double ackMs);
+    void venueFailed(const QString &venue, const QString &error);
+    void completed(const KillSwitchReport &report);
+
+private slots:
+    void onAckTimeout();
+
+private:
+    struct Venue {
+        ExchangeConnector *connector;
+        bool primary;
+        std::set<QString> pendingFlatten; // client order ids
+    };
+
+    void dispatchCancel(int index);
+    void onCancelAcknowledged(int index, int count);
+    void onVenueFill(int index, const OrderResponse &response);
+    void flattenVenue(int index);
+    void failVenue(int index, const QString &error);
+    void finishIfDone();
+    double elapsedMs() const;
+
+    std::vector<Venue> m_venues;
+    OrderManager *m_orderManager;
+    RiskManager *m_riskManager;
+
+    std::atomic<bool> m_armed;
+    std::atomic<bool> m_engaged;
+    bool m_flatten;
+    int m_ackTimeoutMs;
+    qint64 m_triggerNs;
+    KillSwitchReport m_report;
+    QTimer *m_timeoutTimer;
+    OrderIdGenerator m_idGenerator;
+    mutable QMutex m_mutex;
+
+    static const int DEFAULT_ACK_TIMEOUT_MS = 5000;
+};
+
+#endif // KILLSWITCH_H
@@ -0,0 +1,173 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <array>
+
+class LatencyClock
+{
+public:
+    // Monotonic nanoseconds; only differences are meaningful
+    static int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+// HDR-style log-linear histogram: 32 linear sub-buckets per power of two (~3% precision)
+// covering 0 ns .. ~68 s. Recording is wait-free; readers scan the buckets.
+class LatencyHistogram
+{
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int MAX_VALUE_BITS = 36;
+    static const int BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    struct Summary {
+        uint64_t count;
+        int64_t min;
+        int64_t max;
+        double mean;
+        int64_t p50;
+        int64_t p90;
+        int64_t p99;
+        int64_t p999;
+    };
+
+    LatencyHistogram() { reset(); }
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void record(int64_t valueNs)
+    {
+        if (valueNs < 0) valueNs = 0;
+        m_buckets[bucketIndex(static_cast<uint64_t>(valueNs))].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(static_cast<uint64_t>(valueNs), std::memory_order_relaxed);
+        int64_t current = m_min.load(std::memory_order_relaxed);
+        while (valueNs < current && !m_min.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {}
+        current = m_max.load(std::memory_order_relaxed);
+        while (valueNs > current && !m_max.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {}
+    }
+
+    void reset()
+    {
+        for (auto &bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_min.store(INT64_MAX, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    // Adds another histogram's counts into this one
+    void merge(const LatencyHistogram &other)
+    {
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            uint64_t n = other.m_buckets[i].load(std::memory_order_relaxed);
+            if (n) m_buckets[i].fetch_add(n, std::memory_order_relaxed);
+        }
+        m_count.fetch_add(other.m_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_sum.fetch_add(other.m_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        int64_t otherMin = other.m_min.load(std::memory_order_relaxed);
+        int64_t current = m_min.load(std::memory_order_relaxed);
+        while (otherMin < current && !m_min.compare_exchange_weak(current, otherMin, std::memory_order_relaxed)) {}
+        int64_t otherMax = other.m_max.load(std::memory_order_relaxed);
+        current = m_max.load(std::memory_order_relaxed);
+        while (otherMax > current && !m_max.compare_exchange_weak(current, otherMax, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    int64_t min() const { return count() ? m_min.load(std::memory_order_relaxed) : 0; }
+    int64_t max() const { return m_max.load(std::memory_order_relaxed); }
+
+    double mean() const
+    {
+        uint64_t n = count();
+        return n ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    // Upper bound of the bucket holding the given quantile (0.0 - 1.0)
+    int64_t percentile(double quantile) const
+    {
+        uint64_t total = count();
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(quantile * total + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > total) rank = total;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                int64_t upper = bucketUpperBound(i);
+                int64_t maxSeen = max();
+                return upper < maxSeen ? upper : maxSeen;
+            }
+        }
+        return max();
+    }
+
+    Summary summary() const
+    {
+        Summary s;
+        s.count = count();
+        s.min = min();
+        s.max = max();
+        s.mean = mean();
+        s.p50 = percentile(0.50);
+        s.p90 = percentile(0.90);
+        s.p99 = percentile(0.99);
+        s.p999 = percentile(0.999);
+        return s;
+    }
+
+    uint64_t bucketCount(int index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+
+    static int bucketIndex(uint64_t value)
+    {
+        if (value < static_cast<uint64_t>(SUB_BUCKET_COUNT)) return static_cast<int>(value);
+        int msb = 63 - countLeadingZeros(value);
+        if (msb >= MAX_VALUE_BITS) return BUCKET_COUNT - 1;
+        int shift = msb - SUB_BUCKET_BITS;
+        int mantissa = static_cast<int>(value >> shift); // in [32, 64)
+        return (shift + 1) * SUB_BUCKET_COUNT + (mantissa - SUB_BUCKET_COUNT);
+    }
+
+    static int64_t bucketLowerBound(int index)
+    {
+        if (index < SUB_BUCKET_COUNT) return index;
+        int group = index / SUB_BUCKET_COUNT;
+        int64_t mantissa = index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+        return mantissa << (group - 1);
+    }
+
+    static int64_t bucketUpperBound(int index)
+    {
+        if (index < SUB_BUCKET_COUNT) return index;
+        int group = index / SUB_BUCKET_COUNT;
+        return bucketLowerBound(index) + (int64_t(1) << (group - 1)) - 1;
+    }
+
+private:
+    static int countLeadingZeros(uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#else
+        int n = 0;
+        for (uint64_t bit = uint64_t(1) << 63; bit && !(value & bit); bit >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<int64_t> m_min;
+    std::atomic<int64_t> m_max;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,84 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <QString>
+#include <QJsonObject>
+
+#include "LatencyHistogram.h"
+
+// Hot-path stages timed by LATENCY_PROBE
+enum class ProbeStage {
+    FEED_DECODE,
+    BRICK_FORMATION,
+    PATTERN_MATCH,
+    RISK_CHECK,
+    ORDER_SEND
+};
+
+// Registry of per-thread probe histograms. Each thread records into its own set, so a probe
+// never shares a cache line with another thread; readers merge every set on demand.
+// Sets outlive their threads (and are reused by later ones), so nothing recorded is lost.
+class LatencyProbes
+{
+public:
+    static const int STAGE_COUNT = 5;
+    static const int MAX_THREADS = 64;
+
+    // Runtime switch; a disabled probe costs one relaxed load
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Calling thread's histogram for the stage; wait-free after the thread's first call
+    static LatencyHistogram &threadHistogram(ProbeStage stage);
+    static void record(ProbeStage stage, int64_t latencyNs) { threadHistogram(stage).record(latencyNs); }
+
+    // Sum over all threads
+    static void merged(ProbeStage stage, LatencyHistogram &out);
+    static LatencyHistogram::Summary summary(ProbeStage stage);
+    static int threadCount();
+    static void reset();
+
+    static QJsonObject toJson();
+    static QString report();
+    static QString stageName(ProbeStage stage);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Times its own scope into the calling thread's histogram for the stage
+class ScopedLatencyProbe
+{
+public:
+    explicit ScopedLatencyProbe(ProbeStage stage)
+        : m_stage(stage)
+        , m_startNs(LatencyProbes::isEnabled() ? LatencyClock::nowNs() : 0)
+    {
+    }
+    ~ScopedLatencyProbe()
+    {
+        if (m_startNs) LatencyProbes::record(m_stage, LatencyClock::nowNs() - m_startNs);
+    }
+    ScopedLatencyProbe(const ScopedLatencyProbe &) = delete;
+    ScopedLatencyProbe &operator=(const ScopedLatencyProbe &) = delete;
+
+private:
+    ProbeStage m_stage;
+    int64_t m_startNs;
+};
+
+// Building with LATENCY_PROBES=0 compiles every probe out
+#ifndef LATENCY_PROBES
+#define LATENCY_PROBES 1
+#endif
+
+#define LATENCY_PROBE_CONCAT_(a, b) a##b
+#define LATENCY_PROBE_NAME_(line) LATENCY_PROBE_CONCAT_(latencyProbe_, line)
+
+#if LATENCY_PROBES
+#define LATENCY_PROBE(stage) ScopedLatencyProbe LATENCY_PROBE_NAME_(__LINE__)(stage)
+#else
+#define LATENCY_PROBE(stage) ((void)0)
+#endif
+
+#endif // LATENCYPROBE_H
@@ -4,38 +4,224 @@
 #include <QObject>
 #include <QString>
 #include <QFile>
-#include <QTextStream>
+#include <QByteArray>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QDateTime>
 #include <QThread>
-#include <QQueue>
+#include <QThreadPool>
+#include <QStringList>
+#include <QJsonObject>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "BinaryLog.h"
+
+// Lowest level compiled in (0 debug, 1 info, 2 warning, 3 error). LOG_* calls below it are
+// removed by the compiler, message expression included
+#ifndef LOG_COMPILED_LEVEL
+#define LOG_COMPILED_LEVEL 0
+#endif
+
+// The message is only built when the level is compiled in and enabled at runtime, so a
+// disabled call costs one relaxed load (or nothing below LOG_COMPILED_LEVEL)
+#define LOG_AT(logger, level, message) \
+    do { \
+        if constexpr ((level) >= LOG_COMPILED_LEVEL) { \
+            Logger *logTarget_ = (logger); \
+            if (logTarget_ && logTarget_->isEnabled(level)) logTarget_->write(level, message); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(logger, message) LOG_AT(logger, Logger::LEVEL_DEBUG, message)
+#define LOG_INFO(logger, message) LOG_AT(logger, Logger::LEVEL_INFO, message)
+#define LOG_WARNING(logger, message) LOG_AT(logger, Logger::LEVEL_WARNING, message)
+#define LOG_ERROR(logger, message) LOG_AT(logger, Logger::LEVEL_ERROR, message)
+
+// QString arguments for the binary log are narrowed to Latin-1 in place, without allocating
+inline void blogPut(BinaryLogRecord &record, int &pos, const QString &text)
+{
+    char buffer[BinaryLogRecord::ARG_BYTES];
+    const int length = std::min<int>(text.size(), BinaryLogRecord::ARG_BYTES);
+    const QChar *data = text.constData();
+    for (int i = 0; i < length; ++i) buffer[i] = data[i].toLatin1();
+    blogPutString(record, pos, buffer, length);
+}
+
+// Asynchronous file logger. Callers copy the message into a preallocated slot of a bounded
+// lock-free multi-producer ring and return; timestamp formatting, UTF-8 conversion and the
+// file write all happen on the writer thread, which drains the ring in batches and issues
+// one write per batch. The writer sleeps on a condition variable and is only woken when it
+// is actually waiting. When the ring is full the entry is dropped and counted rather than
+// blocking the caller; the writer reports the count in the log.
+//
+// log() is the deferred-format variant for the hot path: the caller writes a format id
+// registered with BinaryLogFormats plus raw arguments into its own thread's buffer. The
+// writer either appends the records to the binary log (decoded offline by
+// BinaryLogDecoder) or, when none is open, renders them into the text log.
+//
+// Rotation also runs on the writer thread: once a file would grow past maxFileSize it is
+// renamed to a timestamped segment and reopened empty. Segments are gzip-compressed and
+// pruned to maxFiles on a background archive thread, so neither producers nor the writer
+// wait for them.
 class Logger : public QObject
 {
     Q_OBJECT
 
 public:
+    enum LogLevel {
+        LEVEL_DEBUG,
+        LEVEL_INFO,
+        LEVEL_WARNING,
+        LEVEL_ERROR
+    };
+
     explicit Logger(QObject *parent = nullptr);
     ~Logger();
-    
+
+    // logging.level, logging.file, logging.binaryFile, logging.maxFileSize, logging.maxFiles,
+    // logging.compress
+    void loadConfig(const QJsonObject &config);
     void initialize(const QString &logFilePath);
+    bool openBinaryLog(const QString &filePath);
+    // maxFileSize <= 0 disables rotation; maxFiles is the number of closed segments kept per log
+    void setRotation(qint64 maxFileSize, int maxFiles, bool compress);
+    // Entries below the level are dropped before anything is copied or queued
+    void setLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(m_level.load(std::memory_order_relaxed)); }
+    bool isEnabled(int level) const { return level >= m_level.load(std::memory_order_relaxed); }
+    static LogLevel levelFromString(const QString &name, LogLevel fallback = LEVEL_INFO);
+
+    void write(LogLevel level, const QString &message)
+    {
+        if (isEnabled(level)) enqueueLog(level, message);
+    }
     void info(const QString &message);
     void warning(const QString &message);
     void error(const QString &message);
     void debug(const QString &message);
-    void exportLogs(const QString &filePath);
-    
+    // Closes the current segments and copies every closed segment into directory on the
+    // archive thread; returns immediately and reports through logsExported
+    void exportLogs(const QString &directory);
+
+    template<typename... Args>
+    void log(int formatId, const Args &...args)
+    {
+        // The level lives with the format, so the gate costs one table read
+        const int level = BinaryLogFormats::level(formatId);
+        if (!isEnabled(level)) return;
+        BinaryLogBuffer *buffer = threadBuffer();
+        BinaryLogRecord *record = buffer ? buffer->claim() : nullptr;
+        if (!record) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        record->timestampNs = BinaryLog::wallClockNs();
+        record->formatId = static_cast<quint16>(formatId);
+        record->level = static_cast<quint8>(level);
+        int pos = 0;
+        (blogPut(*record, pos, args), ...);
+        record->size = static_cast<quint8>(pos);
+        buffer->publish();
+        if (m_writerWaiting.load(std::memory_order_seq_cst)) wakeWriter();
+    }
+
+    quint64 droppedEntries() const { return m_dropped.load(std::memory_order_relaxed); }
+
+signals:
+    void logsExported(const QString &directory, int segments);
+
 private:
-    void enqueueLog(const QString &level, const QString &message);
+    static const int RING_CAPACITY = 4096;     // power of two
+    static const int RECORD_SIZE = 512;
+    static const int TEXT_CAPACITY = (RECORD_SIZE - 20) / 2;
+    static const int MAX_BATCH = 256;
+    static const int IDLE_WAIT_MS = 250;
+    static const int MAX_THREAD_BUFFERS = 64;
+    static const qint64 DEFAULT_MAX_FILE_SIZE = 10 * 1024 * 1024;
+    static const int DEFAULT_MAX_FILES = 5;
+
+    struct alignas(64) LogRecord {
+        std::atomic<quint64> sequence;
+        qint64 timestampMs;
+        quint16 length;
+        quint8 level;
+        quint8 truncated;
+        char16_t text[TEXT_CAPACITY];
+    };
+
+    void enqueueLog(LogLevel level, const QString &message);
     void processQueue();
-    
+    int drainBatch();
+    int drainThreadBuffers();
+    bool hasPendingRecords() const;
+    void appendEntry(const LogRecord &record);
+    void appendLine(qint64 timestampMs, int level, const char *text, int length);
+    void wakeWriter();
+    bool openBinaryLocked();
+    void rotateText();
+    void rotateBinary();
+    void handleRotationRequest();
+    QString closeSegment(QFile &file);
+    void archiveSegment(const QString &segment, const QString &livePath);
+
+    BinaryLogBuffer *threadBuffer()
+    {
+        struct Cache { quint64 loggerId; BinaryLogBuffer *buffer; };
+        thread_local Cache cache = { 0, nullptr };
+        if (cache.loggerId != m_instanceId) {
+            cache.buffer = registerThreadBuffer();
+            cache.loggerId = m_instanceId;
+        }
+        return cache.buffer;
+    }
+    BinaryLogBuffer *registerThreadBuffer();
+
     QFile m_logFile;
-    QTextStream m_stream;
-    QMutex m_mutex;
+    std::atomic<int> m_level;
+    QMutex m_mutex;            // guards the files
     bool m_initialized;
+    qint64 m_logSize;
     QThread *m_workerThread;
-    QQueue<QString> m_logQueue;
-    QMutex m_queueMutex;
+
+    std::unique_ptr<LogRecord[]> m_ring;
+    alignas(64) std::atomic<quint64> m_tail;   // next slot to claim (producers)
+    alignas(64) quint64 m_head;                // next slot to read (writer only)
+    std::atomic<bool> m_writerWaiting;
+    std::atomic<bool> m_stopping;
+    std::atomic<quint64> m_dropped;
+    quint64 m_reportedDropped;
+    QMutex m_wakeMutex;
+    QWaitCondition m_wakeCondition;
+
+    // Deferred-format records, one buffer per producing thread
+    const quint64 m_instanceId;
+    std::unique_ptr<BinaryLogBuffer> m_threadBuffers[MAX_THREAD_BUFFERS];
+    std::thread::id m_bufferOwners[MAX_THREAD_BUFFERS];
+    std::atomic<int> m_threadBufferCount;
+    QMutex m_bufferMutex;
+    QFile m_binaryFile;                // guarded by m_mutex
+    std::vector<bool> m_formatsWritten; // formats defined in the current binary file
+    qint64 m_binarySize;
+
+    // Rotation and archiving
+    qint64 m_maxFileSize;
+    int m_maxFiles;
+    bool m_compress;
+    std::atomic<bool> m_rotateRequested;
+    QStringList m_pendingExports;      // guarded by m_exportMutex
+    QMutex m_exportMutex;
+    QThreadPool m_archivePool;
+
+    // Writer-thread scratch
+    QByteArray m_batch;
+    std::string m_binaryBatch;
+    qint64 m_cachedSecond;
+    QByteArray m_cachedStamp;  // "yyyy-MM-dd hh:mm:ss" for m_cachedSecond
 };
 
-#endif // LOGGER_H 
\ No newline at end of file
+#endif // LOGGER_H
@@ -28,24 +28,20 @@
 #include <QMenu>
 #include <QSettings>
 #include <QCloseEvent>
-// #include <QChart>
-// #include <QChartView>
-// #include <QLineSeries>
-// #include <QValueAxis>
-// #include <QDateTimeAxis>
 #include <QTableWidgetItem>
+#include <QJsonObject>
 #include <memory>
 
-// Forward declare Qt Charts classes - temporarily disabled
-/*
-QT_BEGIN_NAMESPACE
-class QChart;
-class QChartView;
-class QLineSeries;
-class QValueAxis;
-class QDateTimeAxis;
-QT_END_NAMESPACE
-*/
+// Qt Charts is optional; CMake defines MMT_HAVE_CHARTS when it is found
+#ifdef MMT_HAVE_CHARTS
+#include <QChart>
+#include <QChartView>
+#include <QLineSeries>
+#include <QValueAxis>
+#include <QDateTimeAxis>
+#endif
+
+class DaemonClient;
 
 class MainWindow : public QMainWindow
 {
@@ -55,6 +51,9 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Mirrors and controls a running MasterMindTraderd instead of the local simulation
+    void attachToDaemon(const QString &socketName);
+
 protected:
     void closeEvent(QCloseEvent *event) override;
 
@@ -68,6 +67,9 @@ private slots:
     void updateStatusLabels();
     void simulateTrading();
     void simulateTradeSignal();
+    void onDaemonStatus(const QJsonObject &status);
+    void onDaemonReply(const QString &cmd, const QJsonObject &reply);
+    void onDaemonConnectionChanged();
 
 private:
     void setupUI();
@@ -79,6 +81,9 @@ private:
     void loadConfiguration();
     void saveConfiguration();
     void addTradeToTable(const QString &side, double size, double entryPrice, double pnl, const QString &status);
+    void appendPricePoint(double price);
+    void setTradingState(bool active);
+    bool isAttached() const;
     
     // UI Components
     QWidget *m_centralWidget;
@@ -125,16 +130,21 @@ private:
     
     // Chart components
     QWidget *m_chartWidget;
-    // QChart *m_priceChart;
-    // QChartView *m_chartView;
-    // QLineSeries *m_priceSeries;
-    // QValueAxis *m_priceAxis;
-    // QDateTimeAxis *m_timeAxis;
+#ifdef MMT_HAVE_CHARTS
+    QChart *m_priceChart;
+    QChartView *m_chartView;
+    QLineSeries *m_priceSeries;
+    QValueAxis *m_priceAxis;
+    QDateTimeAxis *m_timeAxis;
+#endif
     
     // Timers
     QTimer *m_updateTimer;
     QTimer *m_simulationTimer;
     
+    // Daemon connection, null when running standalone
+    DaemonClient *m_daemon;
+    
     // Application state
     bool m_tradingActive;
     bool m_paperTradingMode;
@@ -0,0 +1,56 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <atomic>
+#include <cstdint>
+
+#include "LatencyHistogram.h"
+
+// Monotonic count; one relaxed fetch_add per update
+class MetricCounter
+{
+public:
+    MetricCounter() : m_value(0) {}
+    void increment(uint64_t n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> m_value;
+};
+
+// Last written value; one relaxed store per update
+class MetricGauge
+{
+public:
+    MetricGauge() : m_value(0.0) {}
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    void add(double delta)
+    {
+        double current = m_value.load(std::memory_order_relaxed);
+        while (!m_value.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {}
+    }
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value;
+};
+
+// Process-wide metric registry rendered in the Prometheus text format. Metrics are registered
+// once, typically as file-scope statics next to the code that updates them, and live for the
+// whole process; updates never lock. Latency histograms record nanoseconds and are exported
+// as summaries in seconds, together with the LatencyProbes stages.
+class Metrics
+{
+public:
+    static const int MAX_METRICS = 128;
+
+    static MetricCounter &counter(const char *name, const char *help);
+    static MetricGauge &gauge(const char *name, const char *help);
+    static LatencyHistogram &histogram(const char *name, const char *help);
+
+    // Text exposition format 0.0.4
+    static QByteArray exposition();
+};
+
+#endif // METRICS_H
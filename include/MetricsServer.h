@@ -0,0 +1,53 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QHostAddress>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Minimal HTTP/1.0 endpoint for Prometheus scrapes: GET /metrics returns
+// Metrics::exposition(), anything else 404. One response per connection. Rendering
+// only reads the metric atomics, so a scrape never blocks the trading threads.
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+    ~MetricsServer();
+
+    // metrics.enabled, metrics.port, metrics.bindAddress
+    void loadConfig(const QJsonObject &config);
+    bool isEnabled() const { return m_enabled; }
+
+    bool start();
+    bool start(const QHostAddress &address, quint16 port);
+    void stop();
+    bool isListening() const;
+    quint16 port() const;
+
+signals:
+    void serverError(const QString &error);
+
+private slots:
+    void onNewConnection();
+
+private:
+    void onReadyRead(QTcpSocket *socket);
+    static QByteArray response(const QByteArray &status, const QByteArray &contentType, const QByteArray &body);
+
+    QTcpServer *m_server;
+    bool m_enabled;
+    QHostAddress m_address;
+    quint16 m_port;
+
+    static const int MAX_REQUEST_BYTES = 8192;
+    static const quint16 DEFAULT_PORT = 9464;
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,61 @@
+#ifndef ORDERIDGENERATOR_H
+#define ORDERIDGENERATOR_H
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Collision-free order ids: <tag><session><'-'><counter>, base36.
+// The session part is fixed at construction (start time + entropy), the counter is a
+// single atomic increment, so ids are unique across threads, within a millisecond and
+// across restarts. Generators in one process must use distinct tags: their sessions can
+// come from the same millisecond. Ids are at most MAX_ID_LENGTH (28) chars, leaving room
+// for a short suffix under the 36-char client id limit of the supported venues.
+class OrderIdGenerator
+{
+public:
+    static const int MAX_TAG_LENGTH = 4;
+    static const int SESSION_LENGTH = 10;
+    static const int MAX_ID_LENGTH = MAX_TAG_LENGTH + SESSION_LENGTH + 1 + 13;
+
+    explicit OrderIdGenerator(const char *tag = "MM");
+    OrderIdGenerator(const OrderIdGenerator &) = delete;
+    OrderIdGenerator &operator=(const OrderIdGenerator &) = delete;
+
+    // Writes the next id into buffer (at least MAX_ID_LENGTH bytes, not NUL-terminated)
+    // and returns its length. Wait-free.
+    int nextInto(char *buffer)
+    {
+        uint64_t sequence = m_counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        for (int i = 0; i < m_prefixLength; ++i) buffer[i] = m_prefix[i];
+        int length = m_prefixLength;
+        char digits[13];
+        int count = 0;
+        do {
+            digits[count++] = BASE36[sequence % 36];
+            sequence /= 36;
+        } while (sequence);
+        while (count) buffer[length++] = digits[--count];
+        return length;
+    }
+
+    QString next()
+    {
+        char buffer[MAX_ID_LENGTH];
+        int length = nextInto(buffer);
+        return QString::fromLatin1(buffer, length);
+    }
+
+    QString sessionPrefix() const { return QString::fromLatin1(m_prefix, m_prefixLength - 1); }
+    uint64_t issuedCount() const { return m_counter.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr const char *BASE36 = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+    char m_prefix[MAX_TAG_LENGTH + SESSION_LENGTH + 1];
+    int m_prefixLength;
+    std::atomic<uint64_t> m_counter;
+};
+
+#endif // ORDERIDGENERATOR_H
@@ -9,6 +9,55 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <atomic>
+
+#include "ExchangeConnector.h"
+#include "ExecutionTelemetry.h"
+#include "OrderIdGenerator.h"
+#include "StrategyEngine.h"
+
+class Logger;
+class TradeJournal;
+struct JournalState;
+
+enum class BracketState {
+    PENDING_ENTRY,
+    ACTIVE,
+    CLOSED,
+    CANCELLED
+};
+
+// What submitOrder did with a request. A HELD order went unsent because the venue was
+// disconnected; it is resent on reconnect under the same client id
+enum class SubmitStatus {
+    SENT,
+    HELD,
+    REJECTED,
+    BLOCKED
+};
+
+// Entry order with stop-loss and take-profit exits linked as one OCO group. The exits always
+// cover what is open, entryFilledQuantity - exitFilledQuantity; when that changes while the
+// group is live they are replaced under new ids (-SL1/-TP1, -SL2/-TP2, ...)
+struct BracketOrder {
+    QString groupId;
+    QString symbol;
+    OrderSide entrySide;
+    double quantity;
+    double entryPrice;
+    double stopLossPrice;
+    double takeProfitPrice;
+    QString entryOrderId;
+    QString stopLossOrderId;   // current exit legs; empty while nothing is open
+    QString takeProfitOrderId;
+    bool nativeOco;
+    BracketState state;
+    double entryFilledQuantity; // cumulative, as the entry's reports give it
+    double entryAveragePrice;
+    double exitFilledQuantity;  // over every exit leg the group has had
+    bool entryDone;             // the entry reached a final status; flat then means closed
+    int exitRevision;
+};
 
 class OrderManager : public QObject
 {
@@ -17,18 +66,120 @@ class OrderManager : public QObject
 public:
     explicit OrderManager(QObject *parent = nullptr);
     ~OrderManager() = default;
-    
+
+    void setExchangeConnector(ExchangeConnector *connector);
+    // Per-order audit trail (send, ack, fill, cancel, block) through the binary log
+    void setLogger(Logger *logger) { m_logger = logger; }
+    // Crash-safe record of requests, acks, fills and bracket state; set before trading
+    void setJournal(TradeJournal *journal) { m_journal = journal; }
+    // Re-links the live bracket groups recorded before a restart to their venue order ids
+    void restoreFromJournal(const JournalState &state);
+    void setTickBuffer(int buffer);
+    void onTick();
+
     void placeOrder(const QString &symbol, const QString &side, double quantity, double price);
-    void cancelOrder(const QString &orderId);
+    void placeOrder(const QString &symbol, const QString &side, double quantity, double price,
+                    qint64 signalTimeNs, qint64 riskPassTimeNs);
+    // Sends a fully built request (any type or time in force) through the gate, audit trail,
+    // journal and telemetry, to venue or, when null, the primary connector. Fills on another
+    // venue are reported through this manager from then on. Returns the venue order id, or
+    // empty if the order was blocked, rejected or held; status, when given, tells which
+    QString submitOrder(const OrderRequest &request, ExchangeConnector *venue = nullptr,
+                        SubmitStatus *status = nullptr);
+    // Kill switch only: closes a position while the gate is shut; otherwise as submitOrder
+    QString submitFlattenOrder(const OrderRequest &request, ExchangeConnector *venue = nullptr);
+    void cancelOrder(const QString &orderId, ExchangeConnector *venue = nullptr);
     void modifyOrder(const QString &orderId, double newPrice);
-    
+
+    // Bracket orders: stopLoss/takeProfit are absolute prices
+    QString placeBracketOrder(const QString &symbol, const QString &side, double quantity, double price,
+                              double stopLoss, double takeProfit);
+    // TradingSignal carries stopLoss/takeProfit as distances from the signal price
+    QString placeBracketOrder(const TradingSignal &signal);
+    void cancelBracketOrder(const QString &groupId);
+    BracketOrder getBracketOrder(const QString &groupId) const;
+
+    // Re-sends orders that could not reach the venue, reusing their client order ids
+    void resendUnsentOrders();
+    int getUnsentOrderCount() const;
+
+    // Kill-switch gate. Closing it drops buffered and unsent orders; while it is closed new
+    // orders, brackets and resends are refused with orderBlocked. One atomic load per order
+    void setOrderGateOpen(bool open);
+    bool isOrderGateOpen() const { return m_gateOpen.load(std::memory_order_acquire); }
+
+    // Signal -> risk -> wire -> ack -> fill latency per venue and order type
+    ExecutionTelemetry *getExecutionTelemetry() const { return m_telemetry; }
+
 signals:
     void orderPlaced(const QString &orderId);
     void orderFilled(const QString &orderId);
     void orderCancelled(const QString &orderId);
-    
+    void bracketActivated(const QString &groupId);
+    void bracketClosed(const QString &groupId, const QString &exitOrderId);
+    void bracketError(const QString &groupId, const QString &error);
+    // One report per entry or exit-leg fill, partial ones included, with the group as of the
+    // fill; quantity and price are what this report added, the response itself is cumulative
+    void bracketEntryFilled(const BracketOrder &bracket, const OrderResponse &fill, double quantity, double price);
+    void bracketExitFilled(const BracketOrder &bracket, const OrderResponse &fill, double quantity, double price);
+    void orderBlocked(const QString &symbol, const QString &reason);
+
+private slots:
+    void onConnectorOrderAcknowledged(const QString &orderId, const QString &venueOrderId);
+    void onConnectorOrderFilled(const OrderResponse &response);
+    void onConnectorOrderCancelled(const QString &orderId);
+    void onConnectorOrderRejected(const QString &orderId, const QString &reason);
+    void onConnectorConnected();
+
 private:
-    QMutex m_mutex;
+    OrderRequest makeRequest(const QString &symbol, OrderSide side, OrderType type, double quantity, double price);
+    QString submitToVenue(const OrderRequest &request, ExchangeConnector *venue, SubmitStatus *status = nullptr);
+    QString sendToVenue(const OrderRequest &request, ExchangeConnector *venue = nullptr,
+                        SubmitStatus *status = nullptr);
+    void trackVenue(ExchangeConnector *venue);
+    void linkBufferedEntry(const QString &clientOrderId, const QString &orderId);
+    QString submitBracket(const QString &symbol, const QString &side, double quantity, double price,
+                          double stopLoss, double takeProfit, qint64 feedTimeNs, qint64 signalTimeNs, qint64 riskPassTimeNs);
+    bool attachExitLegs(BracketOrder &bracket, double quantity);
+    OrderRequest exitLeg(const BracketOrder &bracket, bool stopLoss, double quantity);
+    bool replaceExitLegs(BracketOrder &bracket, const QString &keepLeg, std::vector<QString> &cancelled,
+                         std::vector<QString> &placed);
+    void journalBracket(const BracketOrder &bracket);
+    void acknowledgeLocked(const QString &orderId, const QString &venueOrderId);
+    void evictStaleTimelines(int64_t nowNs);
+
+    ExchangeConnector *m_exchangeConnector;
+    std::vector<ExchangeConnector *> m_extraVenues; // routed-to venues besides the primary one
+    int m_tickBuffer;
+    int m_pendingTicks;
+    std::vector<OrderRequest> m_orderBuffer;
+
+    // Bracket groups and the legs that belong to them
+    std::map<QString, BracketOrder> m_brackets;
+    std::map<QString, QString> m_legToGroup;
+    std::map<QString, QString> m_bufferedEntries; // clientOrderId -> groupId
+    // What each open exit leg has filled so far (quantity, notional); reports are cumulative
+    std::map<QString, std::pair<double, double>> m_exitLegFills;
+    static constexpr double QUANTITY_EPSILON = 1e-9;
+
+    // Client order ids, and requests held back while the venue is unreachable
+    OrderIdGenerator m_idGenerator;
+    std::vector<OrderRequest> m_unsentOrders;
+
+    // Execution telemetry: open timelines keyed by venue order id, dropped on fill, cancel,
+    // reject or after TIMELINE_TIMEOUT_NS. ACK is stamped when the venue reports the order
+    // accepted, not when placeOrder returns
+    ExecutionTelemetry *m_telemetry;
+    std::map<QString, OrderTimeline> m_timelines;
+    std::map<QString, QString> m_unackedOrders; // order id -> client order id, until acknowledged
+    int64_t m_nextTimelineSweepNs;
+    static const int64_t TIMELINE_TIMEOUT_NS = 3600LL * 1000000000LL;
+    static const int64_t TIMELINE_SWEEP_INTERVAL_NS = 60LL * 1000000000LL;
+
+    std::atomic<bool> m_gateOpen;
+    Logger *m_logger;
+    TradeJournal *m_journal;
+    mutable QMutex m_mutex;
 };
 
-#endif // ORDERMANAGER_H 
\ No newline at end of file
+#endif // ORDERMANAGER_H
@@ -0,0 +1,113 @@
+#ifndef PERFORMANCESTATS_H
+#define PERFORMANCESTATS_H
+
+#include <QtGlobal>
+#include <vector>
+
+// Mean/variance over the last N samples (N = 0: all samples) using Welford's update,
+// with the matching downdate when a sample leaves the window. Also tracks the
+// downside second moment for Sortino. O(1) per sample.
+class RollingStats
+{
+public:
+    explicit RollingStats(int window = 0);
+
+    void add(double value);
+    void reset();
+
+    int window() const { return m_window; }
+    int count() const { return m_count; }
+    double mean() const { return m_mean; }
+    double variance() const;          // sample variance
+    double stddev() const;
+    double downsideDeviation() const; // sqrt(mean of min(x, 0)^2)
+
+private:
+    std::vector<double> m_ring;
+    int m_window;
+    int m_head;
+    int m_count;
+    double m_mean;
+    double m_m2;
+    double m_downsideSq;
+};
+
+struct PnLBuckets {
+    double daily;
+    double weekly;
+    double monthly;
+};
+
+// Streaming performance statistics over the marked equity curve.
+//
+// Each update() is O(1): the running peak gives peak-to-trough drawdown, calendar
+// buckets (local day, ISO week, month) roll when a boundary is crossed, and a
+// period return is pushed into every rolling window whenever the sampling period
+// elapses. Sharpe and Sortino are annualized from the sampling period and assume a
+// zero risk-free rate.
+class PerformanceStats
+{
+public:
+    enum BucketRoll {
+        NO_ROLL = 0,
+        DAY_ROLLED = 1,
+        WEEK_ROLLED = 2,
+        MONTH_ROLLED = 4
+    };
+
+    PerformanceStats();
+
+    void reset(qint64 timeMs, double equity);
+    // After reset(): carries the running peak and the worst drawdown over a restart
+    void restoreDrawdown(double peakEquity, double maxDrawdown, double maxDrawdownPercent);
+    // Moves the day's opening equity so the daily bucket reads dailyPnL at the last equity
+    void setDailyPnL(double dailyPnL);
+    void setSamplePeriod(qint64 periodMs);
+    // Window lengths in sample periods; the first one is what RiskMetrics reports
+    void setReturnWindows(const std::vector<int> &windows);
+
+    // Returns a BucketRoll mask of the calendar buckets this update closed
+    int update(qint64 timeMs, double equity);
+
+    double peakEquity() const { return m_peakEquity; }
+    double currentDrawdown() const { return m_peakEquity - m_lastEquity; }
+    double maxDrawdown() const { return m_maxDrawdown; }
+    double maxDrawdownPercent() const { return m_maxDrawdownPercent; }
+
+    PnLBuckets pnlBuckets() const;
+
+    int windowCount() const { return static_cast<int>(m_windows.size()); }
+    const RollingStats &returns(int window = 0) const { return m_windows[window]; }
+    double sharpe(int window = 0) const;
+    double sortino(int window = 0) const;
+
+private:
+    void rollBuckets(qint64 timeMs, int &rolled);
+    void computeBoundaries(qint64 timeMs);
+
+    bool m_initialized;
+    double m_lastEquity;
+    double m_peakEquity;
+    double m_maxDrawdown;
+    double m_maxDrawdownPercent;
+
+    // Calendar buckets: equity at the start of each, and when the current ones end
+    double m_dayStartEquity;
+    double m_weekStartEquity;
+    double m_monthStartEquity;
+    qint64 m_nextDayMs;
+    qint64 m_nextWeekMs;
+    qint64 m_nextMonthMs;
+
+    // Return sampling
+    qint64 m_samplePeriodMs;
+    qint64 m_nextSampleMs;
+    double m_sampleEquity;
+    std::vector<RollingStats> m_windows;
+
+    static const qint64 DEFAULT_SAMPLE_PERIOD_MS = 60 * 1000;
+    static const int DEFAULT_SHORT_WINDOW = 60;   // one hour of minute returns
+    static const int DEFAULT_LONG_WINDOW = 1440;  // one day
+};
+
+#endif // PERFORMANCESTATS_H
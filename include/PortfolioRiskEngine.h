@@ -0,0 +1,84 @@
+#ifndef PORTFOLIORISKENGINE_H
+#define PORTFOLIORISKENGINE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QHash>
+#include <memory>
+#include <vector>
+
+// What the pre-trade check needs from the portfolio, frozen at one point in time.
+// With Sigma*e cached per symbol, the VaR after adding delta notional in symbol k is
+//   sqrt(e'Sigma e + 2 delta (Sigma e)_k + delta^2 Sigma_kk) * scale
+// which is O(1) per candidate order.
+struct PortfolioRiskView {
+    double valueAtRisk;            // account currency, over the configured horizon
+    double variance;               // e' Sigma e per sample period
+    double scale;                  // z * sqrt(horizon / sample period)
+    double fallbackVariance;       // used for symbols with no return history yet
+    std::vector<double> covTimesExposure;
+    std::vector<double> symbolVariance;
+    QHash<QString, int> symbolIds;
+
+    double valueAtRiskAfter(const QString &symbol, double deltaNotional) const;
+    double marginalVaR(const QString &symbol, double deltaNotional) const;
+};
+
+// EWMA covariance of symbol log returns (RiskMetrics-style, Sigma = lambda Sigma + (1 - lambda) r r')
+// sampled on a fixed clock so asynchronous ticks line up, and parametric VaR of the
+// current exposure vector. Symbols are PositionStore ids; the matrix grows as they appear.
+class PortfolioRiskEngine
+{
+public:
+    PortfolioRiskEngine();
+
+    void setDecay(double lambda);
+    void setConfidence(double confidence);
+    void setSamplePeriod(qint64 periodMs);
+    void setHorizon(qint64 horizonMs);
+
+    // O(1); returns true when this tick closed a sample period and the covariance moved (O(N^2))
+    bool onPrice(int symbolId, double price, qint64 timeMs);
+
+    // Exposure per symbol id in account-currency notional (signed); recomputes Sigma*e, O(N^2)
+    void setExposures(const std::vector<double> &exposure);
+
+    int symbolCount() const { return m_count; }
+    quint64 sampleCount() const { return m_samples; }
+    double covariance(int i, int j) const;
+    double correlation(int i, int j) const;
+    double valueAtRisk() const;
+    double scale() const;
+
+    std::shared_ptr<const PortfolioRiskView> view(const QHash<QString, int> &symbolIds) const;
+
+    // Inverse standard normal CDF (Acklam's rational approximation)
+    static double normalQuantile(double p);
+
+private:
+    void ensureSymbol(int symbolId);
+    void sample();
+
+    double m_lambda;
+    double m_z;
+    qint64 m_samplePeriodMs;
+    qint64 m_horizonMs;
+    qint64 m_nextSampleMs;
+    quint64 m_samples;
+
+    int m_count;
+    std::vector<double> m_lastPrice;
+    std::vector<double> m_samplePrice;
+    std::vector<double> m_returns;
+    std::vector<double> m_covariance; // m_count x m_count, row-major
+    std::vector<double> m_exposure;
+    std::vector<double> m_covTimesExposure;
+    double m_variance;
+
+    static constexpr double DEFAULT_DECAY = 0.94;
+    static constexpr double DEFAULT_CONFIDENCE = 0.99;
+    static const qint64 DEFAULT_SAMPLE_PERIOD_MS = 60 * 1000;
+    static const qint64 DEFAULT_HORIZON_MS = 24LL * 60 * 60 * 1000;
+};
+
+#endif // PORTFOLIORISKENGINE_H
@@ -0,0 +1,65 @@
+#ifndef POSITIONBOOK_H
+#define POSITIONBOOK_H
+
+#include <cstdint>
+#include <vector>
+
+struct BookTotals {
+    double unrealizedPnL;
+    double exposure; // sum of size * mark
+};
+
+// Structure-of-arrays view of the open book used for mark-to-market. Rows are
+// addressed by PositionStore slot, so a freed slot is simply a zero-size row.
+//
+// setPrice() keeps the totals current in O(1) through per-symbol net and gross
+// size, which is what a quote burst needs. revalue() recomputes everything from
+// the arrays with a SIMD kernel and replaces the running totals, removing any
+// floating-point drift; it is meant for the periodic sweep and for callers that
+// need per-row P&L.
+class PositionBook
+{
+public:
+    PositionBook();
+
+    // Sets (or replaces) a row; sideSign is +1 for long, -1 for short
+    void setRow(int row, int symbolId, double size, double entryPrice, int sideSign);
+    void clearRow(int row);
+    void clearRows();
+
+    void setPrice(int symbolId, double price);
+    double price(int symbolId) const;
+    // Net units across open rows in the symbol (long positive)
+    double netSize(int symbolId) const;
+    int symbolCount() const { return static_cast<int>(m_prices.size()); }
+
+    double rowUnrealizedPnL(int row) const;
+    int rowCount() const { return static_cast<int>(m_size.size()); }
+
+    BookTotals totals() const { return m_totals; }
+    BookTotals revalue();
+
+    // Kernel over raw arrays, exposed for benchmarking: marks are gathered from prices by symbol id
+    static BookTotals revalueArrays(const double *size, const double *entry, const double *sign,
+                                    const int32_t *symbol, const double *prices, int count);
+
+private:
+    void ensureSymbol(int symbolId);
+    void ensureRow(int row);
+    void applyRow(int row, double direction);
+
+    // Per row
+    std::vector<double> m_size;
+    std::vector<double> m_entry;
+    std::vector<double> m_sign;
+    std::vector<int32_t> m_symbol;
+
+    // Per symbol
+    std::vector<double> m_prices;
+    std::vector<double> m_netSize;    // sum of sign * size
+    std::vector<double> m_grossSize;  // sum of size
+
+    BookTotals m_totals;
+};
+
+#endif // POSITIONBOOK_H
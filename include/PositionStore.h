@@ -0,0 +1,94 @@
+#ifndef POSITIONSTORE_H
+#define POSITIONSTORE_H
+
+#include <QString>
+#include <QDateTime>
+#include <QHash>
+#include <vector>
+
+struct Position {
+    QString symbol;
+    QString side; // "BUY" or "SELL"
+    double size;
+    double entryPrice;
+    double currentPrice;
+    double stopLoss;
+    double takeProfit;
+    double unrealizedPnL;
+    double realizedPnL;
+    QDateTime openTime;
+    QDateTime closeTime;
+    bool isOpen;
+    QString orderId;
+    int symbolId;  // dense id assigned by PositionStore
+    double margin; // reserved when the position was opened
+};
+
+// What is kept of a position once it is closed
+struct ClosedTrade {
+    QString orderId;
+    int symbolId;
+    int sideSign; // +1 long, -1 short
+    double size;
+    double entryPrice;
+    double exitPrice;
+    double realizedPnL;
+    qint64 openTimeMs;
+    qint64 closeTimeMs;
+};
+
+// Single home for positions. Open positions live in stable slots (a slot index never
+// moves while the position is open) and are tracked in a dense open list, so open,
+// lookup, update and close are all O(1) and iterating open positions never touches
+// closed ones. Closed positions are appended to a compact trade history.
+class PositionStore
+{
+public:
+    PositionStore();
+
+    // Opens (or replaces an open position with the same orderId) and returns its slot.
+    // Pointers returned by find() are invalidated by the next open().
+    int open(const Position &position);
+    Position *find(const QString &positionId);
+    const Position *find(const QString &positionId) const;
+    int findSlot(const QString &positionId) const; // -1 when not open
+    Position *at(int slot);
+    const Position *at(int slot) const;
+
+    // Moves the position to the history; returns false if it is not open.
+    // contractSize converts lots into units of the base for the realized P&L
+    bool close(const QString &positionId, double closePrice, const QDateTime &closeTime, Position &closed,
+               double contractSize = 1.0);
+    void clear();
+
+    int symbolId(const QString &symbol);
+    QString symbolName(int symbolId) const;
+    int symbolCount() const { return static_cast<int>(m_symbols.size()); }
+    const QHash<QString, int> &symbolIds() const { return m_symbolIds; }
+
+    int openCount() const { return static_cast<int>(m_openSlots.size()); }
+    const std::vector<int> &openSlots() const { return m_openSlots; }
+    std::vector<Position> openPositions() const;
+
+    const std::vector<ClosedTrade> &history() const { return m_history; }
+    const ClosedTrade *findClosed(const QString &positionId) const;
+    Position toPosition(const ClosedTrade &trade) const;
+    std::vector<Position> closedPositions() const;
+
+    static int sideSign(const QString &side) { return side == "SELL" ? -1 : 1; }
+
+private:
+    std::vector<Position> m_slots;
+    std::vector<int> m_openIndex;   // per slot: position in m_openSlots, -1 when free
+    std::vector<int> m_openSlots;   // dense list of occupied slots
+    std::vector<int> m_freeSlots;
+    QHash<QString, int> m_slotById;
+
+    std::vector<QString> m_symbols;
+    QHash<QString, int> m_symbolIds;
+
+    std::vector<ClosedTrade> m_history;
+    QHash<QString, int> m_historyById;
+};
+
+#endif // POSITIONSTORE_H
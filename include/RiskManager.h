@@ -4,43 +4,82 @@
 #include <QObject>
 #include <QDateTime>
 #include <QString>
-#include <QTimer>
 #include <QMutex>
+#include <QJsonObject>
 #include <vector>
 #include <map>
+#include <memory>
+#include <atomic>
 
-struct Position {
-    QString symbol;
-    QString side; // "BUY" or "SELL"
-    double size;
-    double entryPrice;
-    double currentPrice;
-    double stopLoss;
-    double takeProfit;
-    double unrealizedPnL;
-    double realizedPnL;
-    QDateTime openTime;
-    QDateTime closeTime;
-    bool isOpen;
-    QString orderId;
-};
+#include "PositionStore.h"
+#include "PositionBook.h"
+#include "PerformanceStats.h"
+#include "InstrumentRegistry.h"
+#include "PortfolioRiskEngine.h"
+#include "CounterEngine.h"
+
+class TradeJournal;
+struct JournalState;
 
 struct RiskMetrics {
     double totalEquity;
     double availableMargin;
     double usedMargin;
-    double dailyPnL;
+    double dailyPnL;       // marked equity change since the start of the day/week/month
     double weeklyPnL;
     double monthlyPnL;
-    double maxDrawdown;
+    double maxDrawdown;    // peak-to-trough on marked equity
+    double currentDrawdown;
+    double exposure;       // sum of |size * currentPrice| over open positions
+    double unrealizedPnL;  // sum over open positions
     double riskUsed;
     double riskRemaining;
     int openPositions;
     int dailyTrades;
     double winRate;
     double profitFactor;
-    double sharpeRatio;
-    QDateTime lastUpdate;
+    double sharpeRatio;    // annualized, first configured return window
+    double sortinoRatio;
+    double portfolioVaR;   // parametric, EWMA covariance, configured confidence and horizon
+    QDateTime lastUpdate;  // last fill or periodic recompute, not every price tick
+};
+
+// Limits that halt trading, as bits of RiskSnapshot::breaches
+enum RiskBreach {
+    BREACH_NONE = 0,
+    BREACH_DAILY_RISK = 1,
+    BREACH_DRAWDOWN = 2,
+    BREACH_MAX_TRADES = 4
+};
+
+// Immutable copy of everything the risk checks read. The writer publishes a new one
+// after each change; readers take it with std::atomic_load and never touch m_mutex.
+struct RiskSnapshot {
+    double equity;
+    double initialEquity;
+    double maxRiskPerTrade;
+    double maxDailyRisk;
+    int maxOpenPositions;
+    double maxDrawdownPercent;
+    int maxTradesPerDay;
+    bool counterTradingEnabled;
+    int tradesPerCounter;
+    int currentCounterTrades;
+    double counterStartEquity;
+    int completedCounters;
+    double lastCounterPnL;
+    double dailyPnL;
+    double maxDrawdown;
+    double riskUsed;
+    double usedMargin;
+    double maxPortfolioVaR;
+    std::shared_ptr<const PortfolioRiskView> portfolio;
+    std::shared_ptr<const InstrumentRegistry> instruments;
+    int openPositions;
+    int dailyTradeCount;
+    int breaches;          // RiskBreach mask as of this snapshot
+    RiskMetrics metrics;
+    quint64 version;
 };
 
 class RiskManager : public QObject
@@ -51,7 +90,11 @@ public:
     explicit RiskManager(QObject *parent = nullptr);
     ~RiskManager();
     
+    void loadConfig(const QJsonObject &config);
+    
     // Risk parameters
+    void setStatsSamplePeriod(qint64 periodMs);
+    void setReturnWindows(const std::vector<int> &windows);
     void setMaxRiskPerTrade(double percent);
     void setMaxDailyRisk(double percent);
     void setMaxOpenPositions(int count);
@@ -60,9 +103,13 @@ public:
     void setMaxTradesPerDay(int count);
     void setCounterTradingEnabled(bool enabled);
     void setTradesPerCounter(int count);
+    void setMaxPortfolioVaR(double percent); // 0 disables the check
     
     // Position management
-    bool canOpenPosition(const QString &symbol, double lotSize);
+    bool canOpenPosition(const QString &symbol, double lotSize); // worse of buying and selling
+    bool canOpenPosition(const QString &symbol, const QString &side, double lotSize);
+    // Change in portfolio VaR if the order filled at the current mark
+    double calculateMarginalVaR(const QString &symbol, const QString &side, double lotSize) const;
     double calculateLotSize(const QString &symbol, double stopLossPips, double riskPercent);
     double calculateMaxLotSize(const QString &symbol);
     bool shouldClosePosition(const QString &positionId);
@@ -77,53 +124,85 @@ public:
     void addPosition(const Position &position);
     void updatePosition(const QString &positionId, double currentPrice);
     void closePosition(const QString &positionId, double closePrice);
+    // Partial close: the quantity is split off and closed as a trade of its own (it counts
+    // toward the daily trade count), the rest stays open at its entry price. Closes in full
+    // when quantity covers the position
+    void reducePosition(const QString &positionId, double quantity, double closePrice);
     void clearAllPositions();
     
-    // Counter trading
+    // Marks every open position in the symbol at once; O(1) per call
+    void updateMarketPrice(const QString &symbol, double price);
+    // Full SIMD revaluation of the book; also clears accumulated rounding in the running totals
+    void markToMarket();
+    
+    // Contract specs used for margin, pip value and lot sizing. The registry is never changed
+    // once published: loadConfig and addInstrument build a new one and swap it in
+    std::shared_ptr<const InstrumentRegistry> instruments() const { return getSnapshot()->instruments; }
+    void addInstrument(const InstrumentSpec &spec);
+    
+    // Covariance model behind portfolio VaR; configure before trading
+    PortfolioRiskEngine &portfolioRisk() { return m_portfolioRisk; }
+    
+    // Counter trading: closed trades are counted into the current counter; at
+    // tradesPerCounter it is closed, persisted and capital is reassessed
+    void setCapitalAllocator(CapitalAllocator *allocator);
+    bool openCounterHistory(const QString &path);
     void startNewCounter();
     void endCurrentCounter();
     bool isCounterComplete();
+    CounterStats getCurrentCounter() const;
+    std::vector<CounterStats> getCounterHistory() const;
+    CounterSummary getCounterSummary() const;
     bool shouldContinueTrading();
     
+    // Audit journal of position changes and risk decisions; set before trading
+    void setJournal(TradeJournal *journal);
+    // Rebuilds equity, the open book and today's statistics after a restart
+    void restoreFromJournal(const JournalState &state);
+    
     // Getters
+    // Never takes m_mutex. Not lock-free: shared_ptr atomics use the library's address-hashed
+    // lock pool, so this is a short spinlock plus a reference count increment
+    std::shared_ptr<const RiskSnapshot> getSnapshot() const { return std::atomic_load(&m_snapshot); }
     RiskMetrics getRiskMetrics() const;
     std::vector<Position> getOpenPositions() const;
     std::vector<Position> getClosedPositions() const;
     Position getPosition(const QString &positionId) const;
     
-    double getEquity() const { return m_equity; }
-    double getDailyPnL() const { return m_dailyPnL; }
-    double getMaxDrawdown() const { return m_maxDrawdown; }
-    double getRiskUsed() const { return m_riskUsed; }
-    int getOpenPositionCount() const { return m_openPositions.size(); }
-    int getDailyTradeCount() const { return m_dailyTradeCount; }
+    double getEquity() const { return getSnapshot()->equity; }
+    double getDailyPnL() const { return getSnapshot()->dailyPnL; }
+    double getMaxDrawdown() const { return getSnapshot()->maxDrawdown; }
+    double getRiskUsed() const { return getSnapshot()->riskUsed; }
+    int getOpenPositionCount() const { return getSnapshot()->openPositions; }
+    int getDailyTradeCount() const { return getSnapshot()->dailyTradeCount; }
     
     // Risk limits
-    double getMaxRiskPerTrade() const { return m_maxRiskPerTrade; }
-    double getMaxDailyRisk() const { return m_maxDailyRisk; }
-    int getMaxOpenPositions() const { return m_maxOpenPositions; }
-    int getMaxTradesPerDay() const { return m_maxTradesPerDay; }
+    double getMaxRiskPerTrade() const { return getSnapshot()->maxRiskPerTrade; }
+    double getMaxDailyRisk() const { return getSnapshot()->maxDailyRisk; }
+    int getMaxOpenPositions() const { return getSnapshot()->maxOpenPositions; }
+    int getMaxTradesPerDay() const { return getSnapshot()->maxTradesPerDay; }
+    // The text riskLimitReached and riskLimitCleared carry for a RiskBreach bit
+    static QString breachReason(int breach);
 
 signals:
+    // Edge-triggered: once when a limit is crossed, once when it clears (e.g. a day roll)
     void riskLimitReached(const QString &type);
+    void riskLimitCleared(const QString &type);
     void positionOpened(const Position &position);
     void positionClosed(const Position &position);
     void positionUpdated(const Position &position);
+    // After each change a writer publishes: fills, marks, equity and limit updates
     void riskMetricsUpdated(const RiskMetrics &metrics);
+    // Each time the maximum drawdown deepens
     void drawdownWarning(double currentDrawdown);
     void counterCompleted(int counterNumber, double pnl);
-    void tradingHalted(const QString &reason);
-
-private slots:
-    void onUpdateRiskMetrics();
-    void onCheckRiskLimits();
-    void onUpdatePositions();
+    void counterStatsCompleted(const CounterStats &stats);
+    void capitalReassessed(double scale);
+    void tradingHalted(const QString &reason); // on the transition into any breach
 
 private:
-    void calculateRiskMetrics();
     void updateDailyStatistics();
-    void updateDrawdown();
-    void checkRiskLimits();
+    bool updateDrawdown();
     void resetDailyCounters();
     bool isNewTradingDay();
     
@@ -133,6 +212,38 @@ private:
     double getPipValue(const QString &symbol) const;
     double getMarginRequirement(const QString &symbol, double lotSize) const;
     
+    // Incremental risk: add (sign = +1) or remove (sign = -1) one open position's stop distance
+    void applyPositionContribution(const Position &position, double sign);
+    int openPositionLocked(const Position &position);
+    Position markedPosition(int slot) const;
+    void refreshMetrics(bool stampTime);
+    void onSymbolPrice(int symbolId, double price);
+    
+    // Limit evaluation runs inside every write (fills, marks, limit changes). Thresholds are
+    // kept in account currency so the per-tick check is a few compares; transitions are
+    // queued under the lock and emitted by the writer once it has released it
+    struct BreachEvents {
+        int raised;
+        int cleared;
+        bool halted;
+        double drawdownWarning; // new maximum drawdown, 0 if it did not deepen
+    };
+    void updateLimitThresholds();
+    void evaluateLimits();
+    BreachEvents takeBreachEvents();
+    void emitBreachEvents(const BreachEvents &events);
+    void rebuildPortfolioRisk();
+    
+    // Pure checks over a snapshot, shared by the public readers
+    static bool dailyRiskExceeded(const RiskSnapshot &snapshot);
+    static bool drawdownExceeded(const RiskSnapshot &snapshot);
+    static bool counterComplete(const RiskSnapshot &snapshot);
+    static bool portfolioRiskAcceptable(const RiskSnapshot &snapshot, const QString &symbol, double deltaNotional);
+    // nullptr when the order passes, otherwise the first limit it fails
+    const char *openRejection(const RiskSnapshot &snapshot, const QString &symbol, const QString &side,
+                              double lotSize) const;
+    void recordDecision(const QString &symbol, const QString &side, double lotSize, const char *rejection);
+    
     // Member variables
     double m_equity;
     double m_initialEquity;
@@ -143,7 +254,8 @@ private:
     int m_maxTradesPerDay;
     
     // Current state
-    double m_dailyPnL;
+    double m_dailyPnL;        // realized today, as journaled
+    double m_markedDailyPnL;  // marked equity change today: what the daily loss limit checks
     double m_weeklyPnL;
     double m_monthlyPnL;
     double m_maxDrawdown;
@@ -151,17 +263,13 @@ private:
     int m_dailyTradeCount;
     
     // Positions
-    std::vector<Position> m_openPositions;
-    std::vector<Position> m_closedPositions;
-    std::map<QString, Position> m_positionMap;
+    PositionStore m_positions;
+    PositionBook m_book; // rows indexed by PositionStore slot
     
     // Counter trading
     bool m_counterTradingEnabled;
     int m_tradesPerCounter;
-    int m_currentCounterTrades;
-    int m_counterNumber;
-    double m_counterStartEquity;
-    std::vector<double> m_counterResults;
+    CounterEngine m_counters;
     
     // Statistics
     int m_totalTrades;
@@ -171,28 +279,45 @@ private:
     double m_largestWin;
     double m_largestLoss;
     
+    // Running stop-distance risk over open positions; exposure and unrealized P&L live in m_book
+    double m_totalRisk;
+    double m_usedMargin;
+    std::shared_ptr<InstrumentRegistry> m_instruments; // replaced, never edited, once published
+    PerformanceStats m_stats;
+    double m_warnedDrawdown;
+    double m_journaledDrawdown; // max drawdown as of the last DRAWDOWN journal record
+    PortfolioRiskEngine m_portfolioRisk;
+    std::shared_ptr<const PortfolioRiskView> m_portfolioView;
+    double m_maxPortfolioVaR;
+    RiskMetrics m_metrics;
+    
+    // Limit state: thresholds in account currency, current breaches and unsent transitions
+    double m_dailyLossLimit;
+    double m_drawdownLimit;
+    int m_breaches;
+    BreachEvents m_pendingBreaches;
+    
     // Date tracking
     QDateTime m_lastTradingDay;
     QDateTime m_lastUpdate;
     
-    // Timers
-    QTimer *m_updateTimer;
-    QTimer *m_riskCheckTimer;
-    
-    // Thread safety
+    // Thread safety: m_mutex serializes writers (and position queries); risk checks read m_snapshot
     mutable QMutex m_mutex;
+    std::shared_ptr<const RiskSnapshot> m_snapshot;
+    std::shared_ptr<RiskSnapshot> m_liveSnapshot;  // m_snapshot, writable
+    std::shared_ptr<RiskSnapshot> m_spareSnapshot; // the one before, reused once readers let go
+    quint64 m_snapshotVersion;
+    std::atomic<TradeJournal *> m_journal;
     
     // Constants
     static constexpr double DEFAULT_MAX_RISK_PER_TRADE = 2.0; // 2%
     static constexpr double DEFAULT_MAX_DAILY_RISK = 10.0; // 10%
     static const int DEFAULT_MAX_OPEN_POSITIONS = 5;
     static constexpr double DEFAULT_MAX_DRAWDOWN = 20.0; // 20%
+    static constexpr double DRAWDOWN_JOURNAL_STEP = 0.01; // of the drawdown limit
     static const int DEFAULT_MAX_TRADES_PER_DAY = 20;
     static const int DEFAULT_TRADES_PER_COUNTER = 10;
-    
-    // Update intervals
-    static const int RISK_UPDATE_INTERVAL = 1000; // 1 second
-    static const int POSITION_UPDATE_INTERVAL = 500; // 0.5 seconds
+    static constexpr double DEFAULT_MAX_PORTFOLIO_VAR = 0.0; // disabled unless configured
 };
 
 #endif // RISKMANAGER_H 
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef SMARTORDERROUTER_H
+#define SMARTORDERROUTER_H
+
+#include <QObject>
+#include <QString>
+#include <QMutex>
+#include <QJsonObject>
+#include <vector>
+#include <map>
+
+#include "ExchangeConnector.h"
+#include "ExecutionTelemetry.h"
+#include "OrderIdGenerator.h"
+
+class OrderManager;
+
+// What the router knows about one venue when it splits an order
+struct VenueQuote {
+    int venueIndex;
+    OrderBook book;
+    double feeRate;    // from ExchangeConnector::getCommissionRate
+    double latencyMs;  // measured wire->ack, or the configured estimate
+};
+
+struct ChildAllocation {
+    int venueIndex;
+    double quantity;
+    double limitPrice;   // worst level taken on that venue
+    double expectedCost; // notional incl. fees and latency penalty
+};
+
+struct ParentOrder {
+    QString parentId;
+    QString symbol;
+    OrderSide side;
+    double quantity;
+    double limitPrice; // 0 = no limit
+    double filledQuantity;
+    double averagePrice;
+    double commission;
+    int openChildren;
+    bool complete;
+};
+
+class SmartOrderRouter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SmartOrderRouter(QObject *parent = nullptr);
+    ~SmartOrderRouter() = default;
+
+    // Children are sent through the order manager, so the kill-switch gate, audit trail,
+    // journal and telemetry apply to them; routing is refused until one is set
+    void setOrderManager(OrderManager *orderManager);
+    // Venues are routed to in registration order; latencyEstimateMs is used until telemetry has samples
+    int addVenue(ExchangeConnector *connector, double latencyEstimateMs);
+    void removeVenue(ExchangeConnector *connector);
+    void setExecutionTelemetry(const ExecutionTelemetry *telemetry);
+    void setLatencyPenaltyBps(double bpsPerMs);
+    void setBookDepth(int depth);
+    // A child with no final report after this long is cancelled, and given up on after twice that
+    void setChildTimeout(int ms);
+    // routing.latencyPenaltyBps, routing.bookDepth, routing.childTimeoutMs
+    void loadConfig(const QJsonObject &config);
+
+    // Splits into IOC limit children and sends them; returns the parent id, or empty if nothing
+    // could be routed. The caller runs the pre-trade risk check, as for any other order
+    QString routeOrder(const QString &symbol, OrderSide side, double quantity, double limitPrice = 0.0,
+                       qint64 signalTimeNs = 0, qint64 riskPassTimeNs = 0);
+    ParentOrder getParentOrder(const QString &parentId) const;
+
+    // Pure split over venue snapshots: no I/O, deterministic for identical inputs
+    static std::vector<ChildAllocation> allocate(OrderSide side, double quantity, double limitPrice,
+                                                 const std::vector<VenueQuote> &venues, double latencyPenaltyBps);
+
+signals:
+    void childOrderPlaced(const QString &parentId, const QString &childOrderId, int venueIndex, double quantity);
+    void parentOrderUpdated(const ParentOrder &order);
+    void parentOrderCompleted(const ParentOrder &order);
+    void routingError(const QString &parentId, const QString &error);
+
+private slots:
+    void onChildFilled(const OrderResponse &response);
+    void onChildCancelled(const QString &orderId);
+    void onChildRejected(const QString &orderId, const QString &reason);
+
+private:
+    struct Venue {
+        ExchangeConnector *connector;
+        double latencyEstimateMs;
+    };
+
+    // Fill reports carry cumulative quantity, notional and commission; only the increase
+    // since the last report is added to the parent
+    struct ChildOrder {
+        QString parentId;
+        int venueIndex;
+        double quantity;
+        double filledQuantity;
+        double notional;
+        double commission;
+        bool cancelRequested;
+    };
+
+    VenueQuote snapshotVenue(int index, const QString &symbol);
+    void applyReport(const QString &childId, const OrderResponse *fill, bool final);
+    void onChildTimeout(const QString &childId);
+
+    OrderManager *m_orderManager;
+    std::vector<Venue> m_venues;
+    const ExecutionTelemetry *m_telemetry;
+    double m_latencyPenaltyBps;
+    int m_bookDepth;
+    int m_childTimeoutMs;
+
+    std::map<QString, ParentOrder> m_parents;
+    std::map<QString, ChildOrder> m_children; // keyed by venue order id
+    OrderIdGenerator m_idGenerator;
+    mutable QMutex m_mutex;
+
+    static constexpr double DEFAULT_LATENCY_PENALTY_BPS = 0.1; // per ms of expected latency
+    static const int DEFAULT_BOOK_DEPTH = 20;
+    static const int DEFAULT_CHILD_TIMEOUT_MS = 5000;
+};
+
+#endif // SMARTORDERROUTER_H
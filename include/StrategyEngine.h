@@ -5,6 +5,7 @@
 #include <QTimer>
 #include <QDateTime>
 #include <QMutex>
+#include <QJsonObject>
 #include <vector>
 #include <memory>
 
@@ -33,8 +34,14 @@ struct TradingSignal {
     QDateTime timestamp;
     bool isValid;
     QString description;
+    qint64 feedTimeNs;     // receive stamp of the tick that completed the pattern, 0 if not from a feed
+    qint64 signalTimeNs;   // LatencyClock stamp at detection
+    qint64 riskPassTimeNs; // set by whoever clears the pre-trade risk check
 };
 
+class Logger;
+struct MarketData;
+
 class StrategyEngine : public QObject
 {
     Q_OBJECT
@@ -57,6 +64,9 @@ public:
     void setSetup2Enabled(bool enabled);
     void setTickBuffer(int buffer);
     void setRiskPercent(double percent);
+    void setLogger(Logger *logger) { m_logger = logger; }
+    // strategy, trading.defaultSymbol, risk.maxRiskPerTrade
+    void loadConfig(const QJsonObject &config);
     
     QString getSymbol() const { return m_symbol; }
     double getBrickSize() const { return m_brickSize; }
@@ -71,6 +81,10 @@ public:
     int getSuccessfulSignals() const { return m_successfulSignals; }
     double getWinRate() const;
 
+public slots:
+    // Feed entry point: quotes for the configured symbol are processed while running
+    void onMarketData(const MarketData &data);
+
 signals:
     void newSignal(const TradingSignal &signal);
     void brickFormed(const RenkoBrick &brick);
@@ -84,7 +98,7 @@ private slots:
 
 private:
     void initializeEngine();
-    void processPriceData(double price, const QDateTime &timestamp);
+    void processPriceData(double price, const QDateTime &timestamp, qint64 feedTimeNs = 0);
     void formRenkoBrick(double price, const QDateTime &timestamp);
     void analyzeRenkoPattern();
     
@@ -126,6 +140,7 @@ private:
     TradingSignal m_lastSignal;
     
     double m_currentPrice;
+    qint64 m_feedTimeNs; // receive stamp of the tick being processed
     QDateTime m_lastTickTime;
     
     // Pattern detection state
@@ -143,6 +158,8 @@ private:
     QTimer *m_analysisTimer;
     QTimer *m_validationTimer;
     
+    Logger *m_logger;
+
     // Thread safety
     mutable QMutex m_mutex;
     
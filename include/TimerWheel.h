@@ -0,0 +1,83 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Hashed timer wheel: O(1) schedule, one slot scan per tick. Entries whose due tick is
+// more than one revolution away stay in their slot until the wheel comes round again.
+// Cancellation is left to the owner (ignore stale ids when they fire).
+class TimerWheel
+{
+public:
+    TimerWheel(int slotCount, int64_t tickMs)
+        : m_slots(slotCount > 0 ? slotCount : 1)
+        , m_tickMs(tickMs > 0 ? tickMs : 1)
+        , m_currentTick(0)
+        , m_originMs(0)
+        , m_count(0)
+    {
+    }
+
+    void reset(int64_t originMs)
+    {
+        for (auto &slot : m_slots) slot.clear();
+        m_originMs = originMs;
+        m_currentTick = 0;
+        m_count = 0;
+    }
+
+    void schedule(uint64_t id, int64_t delayMs)
+    {
+        uint64_t ticks = delayMs <= 0 ? 1 : static_cast<uint64_t>((delayMs + m_tickMs - 1) / m_tickMs);
+        uint64_t due = m_currentTick + ticks;
+        m_slots[due % m_slots.size()].push_back({id, due});
+        ++m_count;
+    }
+
+    // Runs every tick up to nowMs, calling onExpired(id) for each due entry.
+    // Callbacks may schedule() again; those entries land in later ticks.
+    template <class Callback>
+    void advance(int64_t nowMs, Callback &&onExpired)
+    {
+        if (nowMs < m_originMs) return;
+        uint64_t targetTick = static_cast<uint64_t>((nowMs - m_originMs) / m_tickMs);
+        while (m_currentTick < targetTick) {
+            ++m_currentTick;
+            std::vector<Entry> &slot = m_slots[m_currentTick % m_slots.size()];
+            if (slot.empty()) continue;
+            m_expired.clear();
+            size_t kept = 0;
+            for (size_t i = 0; i < slot.size(); ++i) {
+                if (slot[i].dueTick <= m_currentTick) {
+                    m_expired.push_back(slot[i].id);
+                } else {
+                    slot[kept++] = slot[i];
+                }
+            }
+            slot.resize(kept);
+            m_count -= m_expired.size();
+            for (uint64_t id : m_expired) onExpired(id);
+        }
+    }
+
+    int64_t tickMs() const { return m_tickMs; }
+    uint64_t currentTick() const { return m_currentTick; }
+    size_t size() const { return m_count; }
+
+private:
+    struct Entry {
+        uint64_t id;
+        uint64_t dueTick;
+    };
+
+    std::vector<std::vector<Entry>> m_slots;
+    std::vector<uint64_t> m_expired;
+    int64_t m_tickMs;
+    uint64_t m_currentTick;
+    int64_t m_originMs;
+    size_t m_count;
+};
+
+#endif // TIMERWHEEL_H
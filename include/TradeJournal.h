@@ -0,0 +1,154 @@
+#ifndef TRADEJOURNAL_H
+#define TRADEJOURNAL_H
+
+#include <QObject>
+#include <QString>
+#include <QDate>
+#include <QFile>
+#include <QByteArray>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QJsonObject>
+#include <atomic>
+#include <map>
+#include <vector>
+
+#include "PositionStore.h"
+#include "OrderManager.h"
+
+enum class JournalRecordType : quint8 {
+    CHECKPOINT = 1,       // start of a day file; the state records that follow restate it
+    CHECKPOINT_END = 2,
+    EQUITY = 3,
+    POSITION_OPEN = 4,
+    POSITION_CLOSE = 5,
+    ORDER_REQUEST = 6,
+    ORDER_ACK = 7,
+    ORDER_REJECT = 8,
+    ORDER_FILL = 9,
+    ORDER_CANCEL = 10,
+    BRACKET = 11,
+    RISK_DECISION = 12,
+    DRAWDOWN = 13         // running peak equity and worst drawdown, as they grow
+};
+
+// What a journal replays to: the book, the live bracket groups and the day's statistics.
+// The journal keeps one of these current as it appends, so a new day file can start with a
+// checkpoint of it and recovery never reads more than one day.
+struct JournalState {
+    QDate day;
+    double equity;
+    double initialEquity;
+    double peakEquity;           // not per day: carried across day files
+    double maxDrawdown;
+    double maxDrawdownPercent;
+    std::map<QString, Position> openPositions;   // by position id
+    std::map<QString, BracketOrder> brackets;    // PENDING_ENTRY and ACTIVE groups only
+    int dailyTrades;
+    int winningTrades;
+    double dailyPnL;
+    double grossProfit;
+    double grossLoss;
+    double largestWin;
+    double largestLoss;
+    quint64 lastSequence;
+
+    JournalState();
+    void resetDay(const QDate &date);
+};
+
+struct JournalRecovery {
+    JournalState state;
+    QString file;          // empty when there was nothing to recover
+    qint64 records;
+    qint64 truncatedBytes; // torn tail dropped from the file
+    double elapsedMs;
+};
+
+// Append-only, checksummed journal of orders, fills, positions and risk decisions, one file
+// per trading day (journal-yyyyMMdd.jnl). Each record is framed as
+//   [uint32 length][uint32 CRC-32 of payload][payload: type, sequence, time, fields]
+// Appends only serialize into a pending buffer; a commit thread writes and fsyncs whatever
+// has accumulated every groupCommitMs (group commit), so callers never wait on the disk.
+// waitForDurable() is there for the few places that must.
+class TradeJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TradeJournal(QObject *parent = nullptr);
+    ~TradeJournal();
+
+    // journal.directory, journal.groupCommitMs
+    void loadConfig(const QJsonObject &config);
+    void setGroupCommitInterval(int ms);
+    QString directory() const { return m_directory; }
+
+    // Rebuilds the state from the newest complete day file in the directory
+    static JournalRecovery recover(const QString &directory);
+    // Continues today's file, or starts one with a checkpoint of the recovered state
+    bool open(const QString &directory, const JournalState &recovered);
+    void close();
+    bool isOpen() const { return m_open.load(std::memory_order_acquire); }
+
+    // Producers (any thread)
+    void recordEquity(double equity, double initialEquity);
+    void recordDrawdown(double peakEquity, double maxDrawdown, double maxDrawdownPercent);
+    void recordPositionOpen(const Position &position);
+    void recordPositionClose(const Position &closed, double equityAfter);
+    void recordOrderRequest(const OrderRequest &request);
+    void recordOrderAck(const QString &clientOrderId, const QString &orderId);
+    void recordOrderReject(const QString &clientOrderId, bool held);
+    void recordOrderFill(const OrderResponse &response);
+    void recordOrderCancel(const QString &orderId);
+    void recordBracket(const BracketOrder &bracket);
+    void recordRiskDecision(const QString &symbol, const QString &side, double lotSize, bool accepted,
+                            const QString &reason);
+
+    quint64 lastSequence() const;
+    quint64 durableSequence() const { return m_durableSequence.load(std::memory_order_acquire); }
+    // Blocks until every record up to sequence is on disk; false on timeout or when closed
+    bool waitForDurable(quint64 sequence, int timeoutMs = 1000);
+    bool flush(int timeoutMs = 1000) { return waitForDurable(lastSequence(), timeoutMs); }
+
+signals:
+    void journalError(const QString &error);
+
+private:
+    struct Chunk {
+        QString path;
+        QByteArray data;
+        quint64 lastSequence;
+    };
+
+    void append(JournalRecordType type, const QByteArray &fields);
+    void writeRecordLocked(JournalRecordType type, const QByteArray &fields, qint64 timeMs);
+    void startDayLocked(const QDate &date);
+    void commitLoop();
+    QString pathFor(const QDate &date) const;
+
+    QString m_directory;
+    int m_groupCommitMs;
+
+    // Producer side, guarded by m_mutex
+    mutable QMutex m_mutex;
+    QWaitCondition m_commitWake;
+    QWaitCondition m_durableWake;
+    JournalState m_state;
+    QString m_currentPath;
+    qint64 m_nextDayMs;         // local midnight ending the current file's day
+    std::vector<Chunk> m_pending;
+    bool m_flushRequested;
+
+    // Commit thread
+    QThread *m_commitThread;
+    QFile m_file;
+    std::atomic<bool> m_open;
+    std::atomic<bool> m_stopping;
+    std::atomic<quint64> m_durableSequence;
+
+    static const int DEFAULT_GROUP_COMMIT_MS = 5;
+};
+
+#endif // TRADEJOURNAL_H
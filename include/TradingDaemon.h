@@ -0,0 +1,111 @@
+#ifndef TRADINGDAEMON_H
+#define TRADINGDAEMON_H
+
+#include <QObject>
+#include <QString>
+#include <QJsonObject>
+#include <QList>
+
+class QLocalServer;
+class QLocalSocket;
+class QTimer;
+class Logger;
+class TradeJournal;
+class RiskManager;
+class CapitalAllocator;
+class ExchangeConnector;
+class OrderManager;
+class StrategyEngine;
+class KillSwitch;
+class SmartOrderRouter;
+class ExecutionAlgoScheduler;
+class MetricsServer;
+struct TradingSignal;
+struct BracketOrder;
+struct OrderResponse;
+struct ParentOrder;
+
+// Headless trading process: owns the core components, wires feed -> strategy -> risk ->
+// orders, and serves a local control channel the GUI attaches to. Nothing here touches
+// QtWidgets, so it runs under a plain QCoreApplication.
+//
+// Control protocol, one JSON object per line in both directions:
+//   {"cmd": "status" | "start" | "stop" | "kill" | "subscribe" | "unsubscribe", ...}
+//   {"cmd": "route", "symbol": s, "side": "BUY" | "SELL", "quantity": q, "limitPrice": p}
+//     risk-checks and sends one order through the smart order router; replies with parentId.
+//     Its fills open a position under the parentId in the risk book
+// Replies are {"reply": cmd, "ok": bool, ...}; subscribers also get {"status": {...}}
+// every daemon.statusIntervalMs.
+class TradingDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TradingDaemon(QObject *parent = nullptr);
+    ~TradingDaemon();
+
+    // Builds and wires the components from config; returns false if the control
+    // channel cannot listen. Trading only begins on start() or the "start" command.
+    bool initialize(const QJsonObject &config);
+    qint64 startupMs() const { return m_startupMs; }
+    QString socketName() const { return m_socketName; }
+
+    bool isTrading() const;
+    QJsonObject status() const;
+
+    StrategyEngine *strategyEngine() const { return m_strategy; }
+    OrderManager *orderManager() const { return m_orders; }
+    RiskManager *riskManager() const { return m_risk; }
+    ExchangeConnector *exchangeConnector() const { return m_connector; }
+    ExecutionAlgoScheduler *executionAlgoScheduler() const { return m_algos; }
+
+public slots:
+    void start();
+    void stop();
+    void shutdown();
+
+signals:
+    void tradingStateChanged(bool trading);
+
+private slots:
+    void onNewClient();
+    void onSignal(const TradingSignal &signal);
+    void onEntryFilled(const BracketOrder &bracket, const OrderResponse &fill, double quantity, double price);
+    void onExitFilled(const BracketOrder &bracket, const OrderResponse &fill, double quantity, double price);
+    void onRoutedFill(const ParentOrder &order);
+    void pushStatus();
+
+private:
+    void onClientReadyRead(QLocalSocket *client);
+    QJsonObject handleCommand(QLocalSocket *client, const QJsonObject &command);
+    QString routeOrder(const QJsonObject &command);
+    static void sendLine(QLocalSocket *client, const QJsonObject &object);
+
+    Logger *m_logger;
+    TradeJournal *m_journal;
+    RiskManager *m_risk;
+    CapitalAllocator *m_allocator;
+    ExchangeConnector *m_connector;
+    OrderManager *m_orders;
+    StrategyEngine *m_strategy;
+    KillSwitch *m_killSwitch;
+    SmartOrderRouter *m_router;
+    ExecutionAlgoScheduler *m_algos;
+    MetricsServer *m_metrics;
+
+    QLocalServer *m_server;
+    QList<QLocalSocket *> m_subscribers;
+    QTimer *m_statusTimer;
+    QString m_socketName;
+    QString m_exchangeName;
+    QString m_volumeProfileFile; // VWAP profiles, loaded at startup and saved on shutdown
+    bool m_journalEnabled;
+    qint64 m_startupMs;
+
+    static const int DEFAULT_STATUS_INTERVAL_MS = 1000;
+    static constexpr double DEFAULT_ROUTING_LATENCY_MS = 5.0;
+    static const int DEFAULT_TELEMETRY_DUMP_INTERVAL_MS = 60000;
+    static const int MAX_COMMAND_BYTES = 64 * 1024;
+};
+
+#endif // TRADINGDAEMON_H
@@ -0,0 +1,161 @@
+#include "BinaryLog.h"
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+
+static_assert(sizeof(BinaryLogRecord) == 128, "binary log record must stay 128 bytes");
+static_assert(sizeof(BinaryLog::FileHeader) == 16, "binary log header must stay 16 bytes");
+
+static const char *const LEVEL_NAMES[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+struct FormatEntry {
+    int level;
+    const char *format;
+};
+
+static FormatEntry s_formats[BinaryLogFormats::MAX_FORMATS];
+static std::atomic<int> s_formatCount(0);
+
+static std::mutex &formatMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+int BinaryLogFormats::add(int level, const char *format)
+{
+    std::lock_guard<std::mutex> lock(formatMutex());
+    int id = s_formatCount.load(std::memory_order_relaxed);
+    if (id >= MAX_FORMATS) return MAX_FORMATS - 1;
+    s_formats[id].level = level;
+    s_formats[id].format = format;
+    s_formatCount.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+int BinaryLogFormats::count()
+{
+    return s_formatCount.load(std::memory_order_acquire);
+}
+
+const char *BinaryLogFormats::format(int id)
+{
+    return id >= 0 && id < count() ? s_formats[id].format : "";
+}
+
+int BinaryLogFormats::level(int id)
+{
+    return id >= 0 && id < count() ? s_formats[id].level : 0;
+}
+
+BinaryLogBuffer::BinaryLogBuffer(uint32_t threadId)
+    : m_records(new BinaryLogRecord[CAPACITY])
+    , m_threadId(threadId)
+    , m_tail(0)
+    , m_cachedHead(0)
+    , m_head(0)
+{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "buffer capacity must be a power of two");
+}
+
+BinaryLog::FileHeader BinaryLog::fileHeader()
+{
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = FORMAT_VERSION;
+    header.recordSize = sizeof(BinaryLogRecord);
+    header.reserved = 0;
+    return header;
+}
+
+bool BinaryLog::isValidHeader(const FileHeader &header)
+{
+    return std::memcmp(header.magic, MAGIC, 4) == 0
+        && header.version == FORMAT_VERSION
+        && header.recordSize == sizeof(BinaryLogRecord);
+}
+
+void BinaryLog::appendFormatFrame(std::string &out, int id, int level, const char *format)
+{
+    const uint16_t formatId = static_cast<uint16_t>(id);
+    const uint8_t formatLevel = static_cast<uint8_t>(level);
+    const uint16_t length = static_cast<uint16_t>(std::strlen(format));
+    out.push_back(static_cast<char>(FRAME_FORMAT));
+    out.append(reinterpret_cast<const char *>(&formatId), sizeof(formatId));
+    out.append(reinterpret_cast<const char *>(&formatLevel), sizeof(formatLevel));
+    out.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    out.append(format, length);
+}
+
+const char *BinaryLog::levelName(int level)
+{
+    return level >= 0 && level < 4 ? LEVEL_NAMES[level] : "LOG";
+}
+
+std::string BinaryLog::render(const char *format, const BinaryLogRecord &record)
+{
+    // Offsets of the arguments, in order
+    int offsets[9];
+    int argCount = 0;
+    for (int pos = 0; pos < record.size && argCount < 9;) {
+        offsets[argCount++] = pos;
+        pos += record.args[pos] == BLOG_STRING ? 2 + record.args[pos + 1] : 9;
+    }
+
+    std::string out;
+    out.reserve(128);
+    for (const char *p = format; *p; ++p) {
+        if (p[0] != '%' || p[1] < '1' || p[1] > '9') {
+            out.push_back(*p);
+            continue;
+        }
+        int index = *++p - '1';
+        if (index >= argCount) continue;
+        const uint8_t *arg = record.args + offsets[index];
+        char text[64];
+        switch (arg[0]) {
+        case BLOG_INT: {
+            int64_t value;
+            std::memcpy(&value, arg + 1, 8);
+            std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+            out.append(text);
+            break;
+        }
+        case BLOG_DOUBLE: {
+            double value;
+            std::memcpy(&value, arg + 1, 8);
+            // Enough digits for prices and quantities without binary noise
+            std::snprintf(text, sizeof(text), "%.12g", value);
+            out.append(text);
+            break;
+        }
+        case BLOG_STRING:
+            out.append(reinterpret_cast<const char *>(arg + 2), arg[1]);
+            break;
+        case BLOG_TIME: {
+            int64_t value;
+            std::memcpy(&value, arg + 1, 8);
+            out.append(formatTimestamp(value));
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return out;
+}
+
+std::string BinaryLog::formatTimestamp(int64_t ms)
+{
+    std::time_t seconds = static_cast<std::time_t>(ms / 1000);
+    std::tm local;
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char text[32];
+    size_t length = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+    std::snprintf(text + length, sizeof(text) - length, ".%03d", static_cast<int>(ms % 1000));
+    return text;
+}
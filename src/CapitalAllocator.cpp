@@ -2,9 +2,18 @@
 
 CapitalAllocator::CapitalAllocator(QObject *parent)
     : QObject(parent)
+    , m_scale(1.0)
 {
 }
 
+void CapitalAllocator::loadConfig(const QJsonObject &config)
+{
+    QJsonObject allocation = config["capital"].toObject()["allocation"].toObject();
+    for (const QString &symbol : allocation.keys()) {
+        setCapitalForSymbol(symbol, allocation[symbol].toDouble());
+    }
+}
+
 void CapitalAllocator::setCapitalForSymbol(const QString &symbol, double capital)
 {
     QMutexLocker locker(&m_mutex);
@@ -15,7 +24,7 @@ double CapitalAllocator::getCapitalForSymbol(const QString &symbol) const
 {
     QMutexLocker locker(&m_mutex);
     auto it = m_capitalAllocation.find(symbol);
-    return it != m_capitalAllocation.end() ? it->second : 0.0;
+    return it != m_capitalAllocation.end() ? it->second * m_scale : 0.0;
 }
 
 double CapitalAllocator::getTotalCapital() const
@@ -25,5 +34,18 @@ double CapitalAllocator::getTotalCapital() const
     for (const auto &pair : m_capitalAllocation) {
         total += pair.second;
     }
-    return total;
-} 
\ No newline at end of file
+    return total * m_scale;
+}
+
+void CapitalAllocator::setScale(double scale)
+{
+    if (scale <= 0.0) return;
+    QMutexLocker locker(&m_mutex);
+    m_scale = scale;
+}
+
+double CapitalAllocator::getScale() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_scale;
+}
@@ -1,4 +1,5 @@
 #include "ChartWidget.h"
+#include <QLabel>
 
 ChartWidget::ChartWidget(QWidget *parent)
     : QWidget(parent)
@@ -31,13 +32,20 @@ void ChartWidget::setupUI()
     groupLayout->addLayout(controlLayout);
     
     // Chart view
+#ifdef MMT_HAVE_CHARTS
     m_chartView = new QChartView;
     m_chartView->setRenderHint(QPainter::Antialiasing);
     groupLayout->addWidget(m_chartView);
+#else
+    QLabel *placeholder = new QLabel("Charts unavailable: built without Qt Charts");
+    placeholder->setAlignment(Qt::AlignCenter);
+    groupLayout->addWidget(placeholder);
+#endif
 }
 
 void ChartWidget::setupChart()
 {
+#ifdef MMT_HAVE_CHARTS
     m_chart = new QChart;
     m_chart->setTitle("Price Chart");
     m_chart->setAnimationOptions(QChart::NoAnimation);
@@ -61,6 +69,7 @@ void ChartWidget::setupChart()
     
     // Set chart to chart view
     m_chartView->setChart(m_chart);
+#endif
 }
 
 void ChartWidget::updateChart(const QString &symbol)
@@ -71,6 +80,7 @@ void ChartWidget::updateChart(const QString &symbol)
 
 void ChartWidget::addDataPoint(double price, const QDateTime &time)
 {
+#ifdef MMT_HAVE_CHARTS
     m_priceSeries->append(time.toMSecsSinceEpoch(), price);
     
     // Keep only last 100 points
@@ -95,9 +105,15 @@ void ChartWidget::addDataPoint(double price, const QDateTime &time)
         double range = maxPrice - minPrice;
         m_priceAxis->setRange(minPrice - range * 0.1, maxPrice + range * 0.1);
     }
+#else
+    Q_UNUSED(price)
+    Q_UNUSED(time)
+#endif
 }
 
 void ChartWidget::clearChart()
 {
+#ifdef MMT_HAVE_CHARTS
     m_priceSeries->clear();
+#endif
 } 
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "CounterEngine.h"
+#include "CapitalAllocator.h"
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// On-disk layout, host byte order (every supported target is little-endian)
+static const char COUNTER_MAGIC[4] = { 'M', 'M', 'C', 'T' };
+static const quint32 COUNTER_FORMAT_VERSION = 1;
+
+struct CounterFileHeader {
+    char magic[4];
+    quint32 version;
+    quint32 recordSize;
+    quint32 reserved;
+    qint32 counters;
+    qint32 profitableCounters;
+    qint32 consecutiveLosing;
+    qint32 lastCounterNumber;
+    double baseEquity;
+    double totalPnL;
+    double bestCounter;
+    double worstCounter;
+};
+
+struct CounterRecord {
+    qint32 counterNumber;
+    qint32 trades;
+    qint32 wins;
+    qint32 losses;
+    double startEquity;
+    double endEquity;
+    double netPnL;
+    double grossProfit;
+    double grossLoss;
+    double largestWin;
+    double largestLoss;
+    double peakPnL;
+    double maxDrawdown;
+    qint64 startTimeMs;
+    qint64 endTimeMs;
+};
+
+static_assert(sizeof(CounterFileHeader) == 64, "counter file header must stay 64 bytes");
+static_assert(sizeof(CounterRecord) == 104, "counter record must stay 104 bytes");
+
+static CounterRecord toRecord(const CounterStats &stats)
+{
+    CounterRecord record;
+    record.counterNumber = stats.counterNumber;
+    record.trades = stats.trades;
+    record.wins = stats.wins;
+    record.losses = stats.losses;
+    record.startEquity = stats.startEquity;
+    record.endEquity = stats.endEquity;
+    record.netPnL = stats.netPnL;
+    record.grossProfit = stats.grossProfit;
+    record.grossLoss = stats.grossLoss;
+    record.largestWin = stats.largestWin;
+    record.largestLoss = stats.largestLoss;
+    record.peakPnL = stats.peakPnL;
+    record.maxDrawdown = stats.maxDrawdown;
+    record.startTimeMs = stats.startTimeMs;
+    record.endTimeMs = stats.endTimeMs;
+    return record;
+}
+
+static CounterStats fromRecord(const CounterRecord &record)
+{
+    CounterStats stats;
+    stats.counterNumber = record.counterNumber;
+    stats.trades = record.trades;
+    stats.wins = record.wins;
+    stats.losses = record.losses;
+    stats.startEquity = record.startEquity;
+    stats.endEquity = record.endEquity;
+    stats.netPnL = record.netPnL;
+    stats.grossProfit = record.grossProfit;
+    stats.grossLoss = record.grossLoss;
+    stats.largestWin = record.largestWin;
+    stats.largestLoss = record.largestLoss;
+    stats.peakPnL = record.peakPnL;
+    stats.maxDrawdown = record.maxDrawdown;
+    stats.startTimeMs = record.startTimeMs;
+    stats.endTimeMs = record.endTimeMs;
+    return stats;
+}
+
+CounterEngine::CounterEngine()
+    : m_tradesPerCounter(DEFAULT_TRADES_PER_COUNTER)
+    , m_lookback(DEFAULT_LOOKBACK)
+    , m_lossReduction(DEFAULT_LOSS_REDUCTION)
+    , m_minScale(DEFAULT_MIN_SCALE)
+    , m_maxScale(DEFAULT_MAX_SCALE)
+    , m_capitalScale(1.0)
+    , m_allocator(nullptr)
+{
+    std::memset(&m_summary, 0, sizeof(m_summary));
+    resetCurrent(1, 0.0, 0);
+}
+
+CounterEngine::~CounterEngine()
+{
+    closeHistory();
+}
+
+void CounterEngine::setTradesPerCounter(int trades)
+{
+    if (trades > 0) m_tradesPerCounter = trades;
+}
+
+void CounterEngine::setLookback(int counters)
+{
+    if (counters <= 0) return;
+    m_lookback = counters;
+    while (static_cast<int>(m_history.size()) > m_lookback) m_history.pop_front();
+}
+
+void CounterEngine::setReassessment(double lossReduction, double minScale, double maxScale)
+{
+    if (lossReduction > 0.0 && lossReduction <= 1.0) m_lossReduction = lossReduction;
+    if (minScale > 0.0) m_minScale = minScale;
+    if (maxScale >= m_minScale) m_maxScale = maxScale;
+}
+
+void CounterEngine::setCapitalAllocator(CapitalAllocator *allocator)
+{
+    m_allocator = allocator;
+    if (m_allocator) m_allocator->setScale(m_capitalScale);
+}
+
+bool CounterEngine::openHistory(const QString &path)
+{
+    closeHistory();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) return false;
+
+    const qint64 headerSize = sizeof(CounterFileHeader);
+    const qint64 recordSize = sizeof(CounterRecord);
+    CounterFileHeader header;
+    if (m_file.size() < headerSize) {
+        // New file
+        std::memset(&m_summary, 0, sizeof(m_summary));
+        m_history.clear();
+        m_file.resize(0);
+        return writeHeader();
+    }
+
+    m_file.seek(0);
+    if (m_file.read(reinterpret_cast<char *>(&header), headerSize) != headerSize
+        || std::memcmp(header.magic, COUNTER_MAGIC, 4) != 0
+        || header.version != COUNTER_FORMAT_VERSION
+        || header.recordSize != static_cast<quint32>(recordSize)) {
+        m_file.close();
+        return false;
+    }
+
+    // A record torn by a crash is dropped
+    qint64 recordCount = (m_file.size() - headerSize) / recordSize;
+    m_file.resize(headerSize + recordCount * recordSize);
+
+    m_summary.counters = header.counters;
+    m_summary.profitableCounters = header.profitableCounters;
+    m_summary.consecutiveLosing = header.consecutiveLosing;
+    m_summary.lastCounterNumber = header.lastCounterNumber;
+    m_summary.baseEquity = header.baseEquity;
+    m_summary.totalPnL = header.totalPnL;
+    m_summary.bestCounter = header.bestCounter;
+    m_summary.worstCounter = header.worstCounter;
+
+    // Only the tail is read: the lookback window, plus any records appended after the
+    // header was last rewritten (crash between the two writes)
+    qint64 missing = std::max<qint64>(0, recordCount - m_summary.counters);
+    qint64 tail = std::min<qint64>(recordCount, std::max<qint64>(m_lookback, missing));
+    m_history.clear();
+    m_file.seek(headerSize + (recordCount - tail) * recordSize);
+    for (qint64 i = 0; i < tail; ++i) {
+        CounterRecord record;
+        if (m_file.read(reinterpret_cast<char *>(&record), recordSize) != recordSize) break;
+        CounterStats stats = fromRecord(record);
+        if (i >= tail - missing) fold(stats);
+        remember(stats);
+    }
+    if (missing > 0) writeHeader();
+
+    m_capitalScale = reassess();
+    if (m_allocator) m_allocator->setScale(m_capitalScale);
+    resetCurrent(m_summary.lastCounterNumber + 1, m_current.startEquity, m_current.startTimeMs);
+    return true;
+}
+
+void CounterEngine::closeHistory()
+{
+    if (m_file.isOpen()) {
+        m_file.flush();
+        m_file.close();
+    }
+}
+
+void CounterEngine::start(double equity, qint64 timeMs)
+{
+    resetCurrent(m_current.counterNumber, equity, timeMs);
+}
+
+bool CounterEngine::recordTrade(double pnl, double equity, qint64 timeMs)
+{
+    CounterStats &c = m_current;
+    if (c.trades == 0 && c.startTimeMs == 0) {
+        c.startTimeMs = timeMs;
+        c.startEquity = equity - pnl;
+    }
+    c.trades++;
+    if (pnl > 0.0) {
+        c.wins++;
+        c.grossProfit += pnl;
+        c.largestWin = std::max(c.largestWin, pnl);
+    } else {
+        c.losses++;
+        c.grossLoss += -pnl;
+        c.largestLoss = std::max(c.largestLoss, -pnl);
+    }
+    c.netPnL += pnl;
+    c.peakPnL = std::max(c.peakPnL, c.netPnL);
+    c.maxDrawdown = std::max(c.maxDrawdown, c.peakPnL - c.netPnL);
+    c.endEquity = equity;
+    c.endTimeMs = timeMs;
+    return c.trades >= m_tradesPerCounter;
+}
+
+CounterStats CounterEngine::finish(double equity, qint64 timeMs)
+{
+    CounterStats completed = m_current;
+    completed.endEquity = equity;
+    completed.endTimeMs = timeMs;
+
+    fold(completed);
+    remember(completed);
+    if (m_file.isOpen()) {
+        appendRecord(completed);
+        writeHeader();
+        m_file.flush();
+    }
+
+    m_capitalScale = reassess();
+    if (m_allocator) m_allocator->setScale(m_capitalScale);
+    resetCurrent(completed.counterNumber + 1, equity, timeMs);
+    return completed;
+}
+
+void CounterEngine::resetCurrent(int counterNumber, double equity, qint64 timeMs)
+{
+    std::memset(&m_current, 0, sizeof(m_current));
+    m_current.counterNumber = counterNumber;
+    m_current.startEquity = equity;
+    m_current.endEquity = equity;
+    m_current.startTimeMs = timeMs;
+    m_current.endTimeMs = timeMs;
+}
+
+void CounterEngine::fold(const CounterStats &stats)
+{
+    if (m_summary.counters == 0) {
+        m_summary.bestCounter = stats.netPnL;
+        m_summary.worstCounter = stats.netPnL;
+        if (m_summary.baseEquity <= 0.0) m_summary.baseEquity = stats.startEquity;
+    }
+    m_summary.counters++;
+    m_summary.totalPnL += stats.netPnL;
+    m_summary.bestCounter = std::max(m_summary.bestCounter, stats.netPnL);
+    m_summary.worstCounter = std::min(m_summary.worstCounter, stats.netPnL);
+    m_summary.lastCounterNumber = std::max(m_summary.lastCounterNumber, stats.counterNumber);
+    if (stats.netPnL > 0.0) {
+        m_summary.profitableCounters++;
+        m_summary.consecutiveLosing = 0;
+    } else {
+        m_summary.consecutiveLosing++;
+    }
+}
+
+void CounterEngine::remember(const CounterStats &stats)
+{
+    m_history.push_back(stats);
+    while (static_cast<int>(m_history.size()) > m_lookback) m_history.pop_front();
+}
+
+double CounterEngine::reassess() const
+{
+    if (m_summary.counters == 0 || m_summary.baseEquity <= 0.0 || m_history.empty()) return 1.0;
+    double scale = m_history.back().endEquity / m_summary.baseEquity;
+    scale *= std::pow(m_lossReduction, m_summary.consecutiveLosing);
+    return std::min(m_maxScale, std::max(m_minScale, scale));
+}
+
+bool CounterEngine::appendRecord(const CounterStats &stats)
+{
+    CounterRecord record = toRecord(stats);
+    m_file.seek(m_file.size());
+    return m_file.write(reinterpret_cast<const char *>(&record), sizeof(record)) == sizeof(record);
+}
+
+bool CounterEngine::writeHeader()
+{
+    CounterFileHeader header;
+    std::memcpy(header.magic, COUNTER_MAGIC, 4);
+    header.version = COUNTER_FORMAT_VERSION;
+    header.recordSize = sizeof(CounterRecord);
+    header.reserved = 0;
+    header.counters = m_summary.counters;
+    header.profitableCounters = m_summary.profitableCounters;
+    header.consecutiveLosing = m_summary.consecutiveLosing;
+    header.lastCounterNumber = m_summary.lastCounterNumber;
+    header.baseEquity = m_summary.baseEquity;
+    header.totalPnL = m_summary.totalPnL;
+    header.bestCounter = m_summary.bestCounter;
+    header.worstCounter = m_summary.worstCounter;
+    m_file.seek(0);
+    return m_file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == sizeof(header);
+}
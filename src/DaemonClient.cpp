@@ -0,0 +1,64 @@
+#include "DaemonClient.h"
+#include <QLocalSocket>
+#include <QJsonDocument>
+
+DaemonClient::DaemonClient(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QLocalSocket(this))
+{
+    connect(m_socket, &QLocalSocket::connected, this, [this]() {
+        sendCommand("subscribe");
+        emit connected();
+    });
+    connect(m_socket, &QLocalSocket::disconnected, this, &DaemonClient::disconnected);
+    connect(m_socket, &QLocalSocket::readyRead, this, &DaemonClient::onReadyRead);
+    connect(m_socket, &QLocalSocket::errorOccurred, this, [this](QLocalSocket::LocalSocketError) {
+        emit errorOccurred(QString("Daemon %1: %2").arg(m_socketName, m_socket->errorString()));
+    });
+}
+
+DaemonClient::~DaemonClient()
+{
+    disconnectFromDaemon();
+}
+
+void DaemonClient::connectToDaemon(const QString &socketName)
+{
+    disconnectFromDaemon();
+    m_socketName = socketName;
+    m_socket->connectToServer(socketName);
+}
+
+void DaemonClient::disconnectFromDaemon()
+{
+    if (m_socket->state() != QLocalSocket::UnconnectedState) m_socket->disconnectFromServer();
+}
+
+bool DaemonClient::isConnected() const
+{
+    return m_socket->state() == QLocalSocket::ConnectedState;
+}
+
+void DaemonClient::sendCommand(const QString &cmd, const QJsonObject &args)
+{
+    if (!isConnected()) return;
+    QJsonObject command = args;
+    command["cmd"] = cmd;
+    m_socket->write(QJsonDocument(command).toJson(QJsonDocument::Compact));
+    m_socket->write("\n");
+}
+
+void DaemonClient::onReadyRead()
+{
+    while (m_socket->canReadLine()) {
+        QJsonObject message = QJsonDocument::fromJson(m_socket->readLine()).object();
+        if (message.isEmpty()) continue;
+        // Pushed updates carry only "status"; replies name the command they answer
+        if (message.contains("reply")) {
+            emit replyReceived(message["reply"].toString(), message);
+        }
+        if (message.contains("status")) {
+            emit statusReceived(message["status"].toObject());
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QTextStream>
+#include "ConfigManager.h"
+#include "TradingDaemon.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("MasterMind Trader Daemon");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("MasterMind Trading Systems");
+    app.setOrganizationDomain("mastermindtrader.com");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless MasterMind Trader; the GUI attaches with --attach");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption configOption(QStringList() << "c" << "config", "Configuration file.", "file", "config.json");
+    QCommandLineOption startOption(QStringList() << "s" << "start", "Start trading immediately.");
+    QCommandLineOption socketOption("socket", "Control socket name (overrides daemon.socketName).", "name");
+    parser.addOption(configOption);
+    parser.addOption(startOption);
+    parser.addOption(socketOption);
+    parser.process(app);
+
+    ConfigManager configManager;
+    configManager.loadConfig(parser.value(configOption));
+    QJsonObject config = configManager.getConfig();
+    if (parser.isSet(socketOption)) {
+        QJsonObject daemon = config["daemon"].toObject();
+        daemon["socketName"] = parser.value(socketOption);
+        config["daemon"] = daemon;
+    }
+
+    TradingDaemon daemon;
+    if (!daemon.initialize(config)) {
+        QTextStream(stderr) << "Cannot start: control socket " << daemon.socketName() << " unavailable\n";
+        return 1;
+    }
+    QTextStream(stdout) << "Ready in " << daemon.startupMs() << " ms, control socket " << daemon.socketName() << "\n";
+
+    if (parser.isSet(startOption) || config["trading"].toObject()["autoStart"].toBool(false)) {
+        daemon.start();
+    }
+
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, &daemon, &TradingDaemon::shutdown);
+    return app.exec();
+}
@@ -1,4 +1,11 @@
 #include "ExchangeConnector.h"
+#include "LatencyProbe.h"
+#include <QJsonDocument>
+#include <QMessageAuthenticationCode>
+#include <QUrl>
+#include <QUrlQuery>
+#include <algorithm>
+#include <set>
 
 ExchangeConnector::ExchangeConnector(QObject *parent)
     : QObject(parent)
@@ -8,7 +15,16 @@ ExchangeConnector::ExchangeConnector(QObject *parent)
     , m_networkManager(nullptr)
     , m_webSocket(nullptr)
     , m_reconnectAttempts(0)
+    , m_frameTimeNs(0)
     , m_requestCount(0)
+    , m_clientOrderIds("EC")
+    , m_simulatedOrderIds("SIM")
+    , m_simulatedCancelLatencyMs(0)
+    , m_pendingMassCancels(0)
+    , m_massCancelCount(0)
+    , m_userStream(nullptr)
+    , m_listenKeyTimer(nullptr)
+    , m_userStreamReady(false)
 {
 }
 
@@ -34,16 +50,36 @@ void ExchangeConnector::setTestMode(bool enabled)
     m_testMode = enabled;
 }
 
+void ExchangeConnector::setEndpoints(const QString &restUrl, const QString &webSocketUrl)
+{
+    m_restUrl = restUrl;
+    m_webSocketUrl = webSocketUrl;
+    while (m_restUrl.endsWith('/')) m_restUrl.chop(1);
+}
+
 bool ExchangeConnector::connect()
 {
-    m_connected = true;
-    emit connected();
+    if (m_testMode || m_webSocketUrl.isEmpty()) {
+        m_connected = true;
+        emit connected();
+        return true;
+    }
+    // Live: connected() follows the stream handshake in onWebSocketConnected
+    setupWebSocket();
+    if (m_webSocket->state() == QAbstractSocket::UnconnectedState) m_webSocket->open(QUrl(m_webSocketUrl));
+    if (m_currentExchange == ExchangeType::BINANCE) binanceStartUserStream();
     return true;
 }
 
 void ExchangeConnector::disconnect()
 {
     m_connected = false;
+    if (m_webSocket && m_webSocket->state() != QAbstractSocket::UnconnectedState) m_webSocket->abort();
+    {
+        QMutexLocker locker(&m_mutex);
+        m_depthBooks.clear();
+    }
+    binanceStopUserStream();
     emit disconnected();
 }
 
@@ -52,10 +88,17 @@ bool ExchangeConnector::isConnected() const
     return m_connected;
 }
 
+bool ExchangeConnector::hasOrderUpdates() const
+{
+    return m_testMode || m_userStreamReady;
+}
+
 void ExchangeConnector::subscribeToMarketData(const QString &symbol)
 {
-    Q_UNUSED(symbol)
-    // Stub implementation
+    if (std::find(m_subscriptions.begin(), m_subscriptions.end(), symbol) != m_subscriptions.end()) return;
+    m_subscriptions.push_back(symbol);
+    // Before the handshake the subscription is sent from onWebSocketConnected
+    if (m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState) subscribeOnVenue(symbol);
 }
 
 void ExchangeConnector::unsubscribeFromMarketData(const QString &symbol)
@@ -66,28 +109,156 @@ void ExchangeConnector::unsubscribeFromMarketData(const QString &symbol)
 
 MarketData ExchangeConnector::getMarketData(const QString &symbol) const
 {
-    Q_UNUSED(symbol)
-    MarketData data;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_marketData.find(symbol);
+        if (it != m_marketData.end()) return it->second;
+    }
+    // Nothing from a feed yet: no quote rather than a made-up one
+    MarketData data = MarketData();
     data.symbol = symbol;
-    data.bid = 50000.0;
-    data.ask = 50001.0;
-    data.last = 50000.5;
-    data.volume = 1000.0;
-    data.timestamp = QDateTime::currentDateTime();
     return data;
 }
 
-QString ExchangeConnector::placeOrder(const OrderRequest &request)
+OrderBook ExchangeConnector::getOrderBook(const QString &symbol, int depth)
 {
+    OrderBook book;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto simulated = m_simulatedBooks.find(symbol);
+        auto streamed = m_depthBooks.find(formatSymbol(symbol));
+        if (simulated != m_simulatedBooks.end()) {
+            book = simulated->second;
+        } else if (streamed != m_depthBooks.end() && streamed->second.synced) {
+            const DepthBook &levels = streamed->second;
+            for (const auto &level : levels.bids) {
+                if (depth > 0 && book.bids.size() >= static_cast<size_t>(depth)) break;
+                book.bids.push_back({ level.first, level.second });
+            }
+            for (const auto &level : levels.asks) {
+                if (depth > 0 && book.asks.size() >= static_cast<size_t>(depth)) break;
+                book.asks.push_back({ level.first, level.second });
+            }
+            book.timestamp = levels.timestamp;
+        }
+    }
+    // No book yet: no levels, so nobody sizes an order against liquidity the venue never showed
+    book.symbol = symbol;
+    if (depth > 0) {
+        if (book.bids.size() > static_cast<size_t>(depth)) book.bids.resize(depth);
+        if (book.asks.size() > static_cast<size_t>(depth)) book.asks.resize(depth);
+    }
+    return book;
+}
+
+void ExchangeConnector::setSimulatedOrderBook(const OrderBook &book)
+{
+    QMutexLocker locker(&m_mutex);
+    m_simulatedBooks[book.symbol] = book;
+}
+
+bool ExchangeConnector::simulateExecution(const OrderRequest &request, double &filledQuantity, double &averagePrice)
+{
+    // Walks the simulated book up to the limit price; the book itself is not consumed,
+    // so repeated runs against the same book are deterministic
+    filledQuantity = 0.0;
+    averagePrice = 0.0;
+    OrderBook book = getOrderBook(request.symbol, 0);
+    const auto &levels = (request.side == OrderSide::BUY) ? book.asks : book.bids;
+    const bool limited = request.type == OrderType::LIMIT && request.price > 0.0;
+    double notional = 0.0;
+    for (const auto &level : levels) {
+        if (filledQuantity >= request.quantity) break;
+        if (limited) {
+            if (request.side == OrderSide::BUY && level.price > request.price) break;
+            if (request.side == OrderSide::SELL && level.price < request.price) break;
+        }
+        double take = std::min(level.quantity, request.quantity - filledQuantity);
+        filledQuantity += take;
+        notional += take * level.price;
+    }
+    if (filledQuantity <= 0.0) return false;
+    averagePrice = notional / filledQuantity;
+    return true;
+}
+
+QString ExchangeConnector::placeOrder(const OrderRequest &orderRequest)
+{
+    OrderRequest request = orderRequest;
+    if (request.clientOrderId.isEmpty()) {
+        request.clientOrderId = generateClientOrderId();
+    }
+    emit orderSubmitted(request);
     if (m_testMode) {
+        // Venue-side dedup: a retried client id returns the original order instead of a duplicate
+        {
+            QMutexLocker locker(&m_mutex);
+            auto existing = m_clientOrderIndex.find(request.clientOrderId);
+            if (existing != m_clientOrderIndex.end()) return existing->second;
+        }
         // Simulate order placement
-        QString orderId = QString("ORDER_%1").arg(QDateTime::currentMSecsSinceEpoch());
-        QTimer::singleShot(1000, [this, orderId]() {
+        QString orderId = m_simulatedOrderIds.next();
+        {
+            QMutexLocker locker(&m_mutex);
+            m_clientOrderIndex[request.clientOrderId] = orderId;
+        }
+        // The simulated venue accepts on the next event-loop turn, never inside placeOrder
+        QTimer::singleShot(0, this, [this, orderId]() { emit orderAcknowledged(orderId, orderId); });
+        double filledQuantity = 0.0;
+        double averagePrice = 0.0;
+        bool marketable = request.type == OrderType::MARKET || request.type == OrderType::LIMIT;
+        if (marketable && !simulateExecution(request, filledQuantity, averagePrice)) {
+            marketable = false;
+        }
+        const bool immediate = request.type == OrderType::LIMIT && request.timeInForce != TimeInForce::GTC;
+        if (request.timeInForce == TimeInForce::FOK && filledQuantity < request.quantity) marketable = false;
+        if (!marketable && immediate) {
+            // IOC/FOK with nothing to take expires instead of resting
+            QString clientOrderId = request.clientOrderId;
+            QTimer::singleShot(1000, this, [this, orderId, clientOrderId]() {
+                {
+                    QMutexLocker locker(&m_mutex);
+                    m_clientOrderIndex.erase(clientOrderId);
+                }
+                emit orderCancelled(orderId);
+            });
+            return orderId;
+        }
+        if (!marketable) {
+            // Resting orders (stop legs, non-crossing limits) stay open until cancelled
+            OrderResponse response;
+            response.orderId = orderId;
+            response.clientOrderId = request.clientOrderId;
+            response.status = OrderStatus::PENDING;
+            response.filledQuantity = 0.0;
+            response.averagePrice = 0.0;
+            response.commission = 0.0;
+            response.timestamp = QDateTime::currentDateTime();
+            QMutexLocker locker(&m_mutex);
+            m_orders[orderId] = response;
+            return orderId;
+        }
+        QString clientOrderId = request.clientOrderId;
+        // Marketable orders execute immediately-or-cancel against the simulated book; a market or
+        // IOC remainder is reported EXPIRED with the partial fill, as Binance does
+        OrderStatus status = OrderStatus::FILLED;
+        if (filledQuantity < request.quantity) {
+            status = (immediate || request.type == OrderType::MARKET) ? OrderStatus::EXPIRED
+                                                                       : OrderStatus::PARTIALLY_FILLED;
+        }
+        double commission = filledQuantity * averagePrice * getCommissionRate(request.symbol);
+        QTimer::singleShot(1000, [this, orderId, clientOrderId, status, filledQuantity, averagePrice, commission]() {
+            {
+                QMutexLocker locker(&m_mutex);
+                m_clientOrderIndex.erase(clientOrderId);
+            }
             OrderResponse response;
             response.orderId = orderId;
-            response.status = OrderStatus::FILLED;
-            response.filledQuantity = 1.0;
-            response.averagePrice = 50000.0;
+            response.clientOrderId = clientOrderId;
+            response.status = status;
+            response.filledQuantity = filledQuantity;
+            response.averagePrice = averagePrice;
+            response.commission = commission;
             response.timestamp = QDateTime::currentDateTime();
             emit orderFilled(response);
         });
@@ -116,14 +287,83 @@ QString ExchangeConnector::placeOrder(const OrderRequest &request)
 bool ExchangeConnector::cancelOrder(const QString &orderId)
 {
     if (m_testMode) {
+        {
+            QMutexLocker locker(&m_mutex);
+            auto it = m_orders.find(orderId);
+            if (it != m_orders.end()) {
+                m_clientOrderIndex.erase(it->second.clientOrderId);
+                m_orders.erase(it);
+            }
+        }
         emit orderCancelled(orderId);
         return true;
     }
-    // TODO: Route to exchange-specific cancel logic
-    emit errorOccurred("Cancel order not implemented for this exchange");
+    if (m_currentExchange == ExchangeType::BINANCE) return binanceCancelOrder(orderId);
+    m_lastError = "Cancel order not supported on " + getExchangeName();
+    emit errorOccurred(m_lastError);
     return false;
 }
 
+bool ExchangeConnector::cancelAllOrders()
+{
+    if (!m_connected) {
+        emit errorOccurred("Cancel all orders: not connected");
+        return false;
+    }
+    if (m_testMode) {
+        std::vector<QString> cancelled;
+        {
+            QMutexLocker locker(&m_mutex);
+            for (const auto &order : m_orders) {
+                cancelled.push_back(order.first);
+                m_clientOrderIndex.erase(order.second.clientOrderId);
+            }
+            m_orders.clear();
+        }
+        for (const QString &orderId : cancelled) {
+            emit orderCancelled(orderId);
+        }
+        int count = static_cast<int>(cancelled.size());
+        if (m_simulatedCancelLatencyMs > 0) {
+            QTimer::singleShot(m_simulatedCancelLatencyMs, this, [this, count]() {
+                emit allOrdersCancelled(count);
+            });
+        } else {
+            emit allOrdersCancelled(count);
+        }
+        return true;
+    }
+    bool sent = false;
+    switch (m_currentExchange) {
+        case ExchangeType::BINANCE:
+            sent = binanceCancelAllOrders();
+            break;
+        case ExchangeType::COINBASE:
+            sent = coinbaseCancelAllOrders();
+            break;
+        case ExchangeType::DERIBIT:
+            sent = deribitCancelAllOrders();
+            break;
+        case ExchangeType::DELTA_EXCHANGE:
+            sent = deltaCancelAllOrders();
+            break;
+        default:
+            // MetaTrader bridges have no mass cancel
+            break;
+    }
+    if (!sent) {
+        emit errorOccurred("Cancel all orders failed on " + getExchangeName());
+        return false;
+    }
+    // The venue's answer arrives as allOrdersCancelled or cancelAllFailed
+    return true;
+}
+
+void ExchangeConnector::setSimulatedCancelLatency(int ms)
+{
+    m_simulatedCancelLatencyMs = std::max(0, ms);
+}
+
 bool ExchangeConnector::modifyOrder(const QString &orderId, double newPrice, double newQuantity)
 {
     Q_UNUSED(orderId)
@@ -132,6 +372,28 @@ bool ExchangeConnector::modifyOrder(const QString &orderId, double newPrice, dou
     return true;
 }
 
+bool ExchangeConnector::supportsNativeOco() const
+{
+    // Test mode always emulates OCO locally through OrderManager
+    if (m_testMode) return false;
+    return m_currentExchange == ExchangeType::BINANCE;
+}
+
+bool ExchangeConnector::placeOcoOrder(const OrderRequest &stopLeg, const OrderRequest &takeProfitLeg,
+                                      QString &stopOrderId, QString &takeProfitOrderId)
+{
+    if (m_testMode || !supportsNativeOco()) {
+        emit errorOccurred("Native OCO not supported for this exchange");
+        return false;
+    }
+    switch (m_currentExchange) {
+        case ExchangeType::BINANCE:
+            return binancePlaceOcoOrder(stopLeg, takeProfitLeg, stopOrderId, takeProfitOrderId);
+        default:
+            return false;
+    }
+}
+
 OrderResponse ExchangeConnector::getOrderStatus(const QString &orderId)
 {
     if (m_testMode) {
@@ -175,23 +437,44 @@ AccountInfo ExchangeConnector::getAccountInfo()
         info.lastUpdate = QDateTime::currentDateTime();
         return info;
     }
+    QJsonObject account;
     switch (m_currentExchange) {
         case ExchangeType::BINANCE:
-            return binanceGetAccountInfo();
+            account = binanceGetAccountInfo();
+            break;
         case ExchangeType::COINBASE:
-            return coinbaseGetAccountInfo();
+            account = coinbaseGetAccountInfo();
+            break;
         case ExchangeType::DERIBIT:
-            return deribitGetAccountInfo();
+            account = deribitGetAccountInfo();
+            break;
         case ExchangeType::DELTA_EXCHANGE:
-            return deltaGetAccountInfo();
+            account = deltaGetAccountInfo();
+            break;
         case ExchangeType::METATRADER4:
-            return metatraderGetAccountInfo();
         case ExchangeType::METATRADER5:
-            return metatraderGetAccountInfo();
+            account = metatraderGetAccountInfo();
+            break;
         default:
             emit errorOccurred("Unsupported exchange");
             return AccountInfo();
     }
+    return parseAccountInfo(account);
+}
+
+AccountInfo ExchangeConnector::parseAccountInfo(const QJsonObject &account) const
+{
+    // The per-venue readers normalize their payloads to these keys
+    AccountInfo info;
+    info.totalBalance = account["totalBalance"].toDouble();
+    info.availableBalance = account["availableBalance"].toDouble();
+    info.usedMargin = account["usedMargin"].toDouble();
+    info.freeMargin = account["freeMargin"].toDouble();
+    info.marginLevel = account["marginLevel"].toDouble();
+    info.equity = account["equity"].toDouble(info.totalBalance);
+    info.currency = account["currency"].toString("USD");
+    info.lastUpdate = QDateTime::currentDateTime();
+    return info;
 }
 
 std::vector<Position> ExchangeConnector::getPositions(const QString &symbol)
@@ -271,15 +554,308 @@ QString ExchangeConnector::getConnectionStatus() const
     return m_connected ? "Connected" : "Disconnected";
 }
 
-// Stub implementations for private methods
-void ExchangeConnector::onNetworkReplyFinished() {}
-void ExchangeConnector::onWebSocketConnected() {}
-void ExchangeConnector::onWebSocketDisconnected() {}
-void ExchangeConnector::onWebSocketTextMessageReceived(const QString &message) { Q_UNUSED(message) }
-void ExchangeConnector::onWebSocketError(QAbstractSocket::SocketError error) { Q_UNUSED(error) }
+void ExchangeConnector::onNetworkReplyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+    const QString clientOrderId = reply->property("clientOrderId").toString();
+    const QByteArray verb = reply->property("verb").toByteArray();
+    const int attempt = reply->property("attempt").toInt();
+    const QUrlQuery params(reply->property("params").toString());
+    // No answer or a 5xx: the venue may or may not have the order. Resending under the same
+    // newClientOrderId is safe, the venue refuses a second order with that id
+    const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const bool transient = httpStatus >= 500 || (httpStatus == 0 && reply->error() != QNetworkReply::NoError);
+    if (transient && attempt < MAX_ORDER_RETRIES) {
+        QTimer::singleShot(ORDER_RETRY_BACKOFF << attempt, this, [this, verb, params, clientOrderId, attempt]() {
+            binanceOrderRequest(verb, params, clientOrderId, attempt + 1);
+        });
+        return;
+    }
+    QJsonObject response = QJsonDocument::fromJson(reply->readAll()).object();
+    if (verb == "POST" && attempt > 0 && response["code"].toInt() == -2010
+        && response["msg"].toString().contains("Duplicate order")) {
+        // An earlier attempt got through. The stream reports it; otherwise ask for its state
+        if (reply->property("streamed").toBool()) return;
+        QUrlQuery query;
+        query.addQueryItem("symbol", params.queryItemValue("symbol"));
+        query.addQueryItem("origClientOrderId", clientOrderId);
+        binanceOrderRequest("GET", query, clientOrderId, 0);
+        return;
+    }
+    if (response.isEmpty()) {
+        m_lastError = reply->errorString();
+        {
+            QMutexLocker locker(&m_mutex);
+            m_orderSymbols.erase(clientOrderId);
+        }
+        emit orderRejected(clientOrderId, m_lastError);
+        return;
+    }
+    // Any body without an error code means the venue took the order, streamed or not
+    if (!response.contains("code")) emit orderAcknowledged(clientOrderId, response["orderId"].toVariant().toString());
+    // The user-data stream reports the order itself
+    if (reply->property("streamed").toBool() && !response.contains("code")) return;
+    // Venue error bodies ({code, msg}) do not echo the client id
+    if (!response.contains("clientOrderId")) response["clientOrderId"] = clientOrderId;
+    processOrderResponse(response);
+}
+
+void ExchangeConnector::onOcoReplyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+    const QString legs[2] = { reply->property("stopClientOrderId").toString(),
+                              reply->property("limitClientOrderId").toString() };
+    QJsonObject response = QJsonDocument::fromJson(reply->readAll()).object();
+    if (response.isEmpty() || response.contains("code")) {
+        // The list is accepted or refused as a whole
+        m_lastError = response.isEmpty() ? reply->errorString() : response["msg"].toString();
+        {
+            QMutexLocker locker(&m_mutex);
+            for (const QString &leg : legs) m_orderSymbols.erase(leg);
+        }
+        for (const QString &leg : legs) emit orderRejected(leg, m_lastError);
+        return;
+    }
+    const QJsonArray reports = response["orderReports"].toArray();
+    for (const QJsonValue &report : reports) {
+        const QJsonObject leg = report.toObject();
+        emit orderAcknowledged(leg["clientOrderId"].toString(), leg["orderId"].toVariant().toString());
+    }
+    if (reply->property("streamed").toBool()) return;
+    // One execution report per leg, in the same shape as a single order result
+    for (const QJsonValue &report : reports) processOrderResponse(report.toObject());
+}
+
+void ExchangeConnector::onCancelReplyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+    const QString clientOrderId = reply->property("clientOrderId").toString();
+    QJsonObject response = QJsonDocument::fromJson(reply->readAll()).object();
+    if (response.isEmpty() || response.contains("code")) {
+        // The order stays as it was (often it has just filled); its own report settles it
+        m_lastError = response.isEmpty() ? reply->errorString() : response["msg"].toString();
+        emit errorOccurred("Cancel " + clientOrderId + " failed: " + m_lastError);
+        return;
+    }
+    if (reply->property("streamed").toBool()) return;
+    // clientOrderId names the cancel request itself; the order is origClientOrderId
+    response["clientOrderId"] = clientOrderId;
+    processOrderResponse(response);
+}
+
+void ExchangeConnector::onCancelAllReplyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+    const QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
+    int cancelled = 0;
+    QString error;
+    if (document.isArray()) {
+        // Plain orders, and OCO lists that carry one report per leg
+        for (const QJsonValue &value : document.array()) {
+            const QJsonObject entry = value.toObject();
+            const QJsonArray legs = entry.contains("orderReports") ? entry["orderReports"].toArray() : QJsonArray{ entry };
+            for (const QJsonValue &leg : legs) {
+                QJsonObject report = leg.toObject();
+                report["clientOrderId"] = report["origClientOrderId"];
+                if (!reply->property("streamed").toBool()) processOrderResponse(report);
+                ++cancelled;
+            }
+        }
+    } else if (document.object()["code"].toInt() != BINANCE_UNKNOWN_ORDER) {
+        // Unknown order means nothing was open for the symbol
+        error = document.isObject() ? document.object()["msg"].toString() : reply->errorString();
+    }
+
+    int total = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_massCancelCount += cancelled;
+        if (m_massCancelError.isEmpty()) m_massCancelError = error;
+        if (--m_pendingMassCancels > 0) return;
+        total = m_massCancelCount;
+        error = m_massCancelError;
+    }
+    if (!error.isEmpty()) {
+        m_lastError = error;
+        emit errorOccurred("Cancel all orders failed on " + getExchangeName() + ": " + error);
+        emit cancelAllFailed(error);
+        return;
+    }
+    emit allOrdersCancelled(total);
+}
+
+void ExchangeConnector::onWebSocketConnected()
+{
+    m_connected = true;
+    m_reconnectAttempts = 0;
+    m_lastHeartbeat = QDateTime::currentDateTime();
+    for (const QString &symbol : m_subscriptions) subscribeOnVenue(symbol);
+    emit connected();
+}
+
+void ExchangeConnector::onWebSocketDisconnected()
+{
+    {
+        // The diffs stop with the stream, so the books would go stale; rebuilt on resubscribe
+        QMutexLocker locker(&m_mutex);
+        m_depthBooks.clear();
+    }
+    // disconnect() has already reported a local close
+    if (!m_connected) return;
+    m_connected = false;
+    emit disconnected();
+}
+
+void ExchangeConnector::onWebSocketError(QAbstractSocket::SocketError error)
+{
+    Q_UNUSED(error)
+    m_lastError = m_webSocket ? m_webSocket->errorString() : QString("WebSocket error");
+    emit connectionError(m_lastError);
+}
+
+void ExchangeConnector::onDepthSnapshotFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+    const QString symbol = reply->property("symbol").toString();
+    const QJsonObject snapshot = QJsonDocument::fromJson(reply->readAll()).object();
+    if (!snapshot.contains("lastUpdateId")) {
+        m_lastError = snapshot.isEmpty() ? reply->errorString() : snapshot["msg"].toString();
+        emit errorOccurred("Depth snapshot for " + symbol + " failed: " + m_lastError);
+        // Tried again while the stream is up; the book stays empty meanwhile
+        QTimer::singleShot(RECONNECT_INTERVAL, this, [this, symbol]() {
+            if (m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState) {
+                binanceRequestDepthSnapshot(symbol);
+            }
+        });
+        return;
+    }
+    bool resync = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_depthBooks.find(symbol);
+        // Dropped by a disconnect, or superseded by a newer snapshot request
+        if (it == m_depthBooks.end() || it->second.synced) return;
+        DepthBook &book = it->second;
+        for (const QJsonValue &level : snapshot["bids"].toArray()) {
+            const QJsonArray pair = level.toArray();
+            book.bids[pair.at(0).toString().toDouble()] = pair.at(1).toString().toDouble();
+        }
+        for (const QJsonValue &level : snapshot["asks"].toArray()) {
+            const QJsonArray pair = level.toArray();
+            book.asks[pair.at(0).toString().toDouble()] = pair.at(1).toString().toDouble();
+        }
+        book.lastUpdateId = snapshot["lastUpdateId"].toVariant().toLongLong();
+        book.synced = true;
+        book.timestamp = QDateTime::currentDateTimeUtc();
+        std::vector<QJsonObject> pending;
+        pending.swap(book.pending);
+        for (const QJsonObject &update : pending) {
+            if (!applyDepthUpdate(book, update)) {
+                resync = true;
+                break;
+            }
+        }
+    }
+    if (resync) binanceRequestDepthSnapshot(symbol);
+}
+
 void ExchangeConnector::onHeartbeatTimer() {}
 void ExchangeConnector::onReconnectTimer() {}
 
+void ExchangeConnector::onListenKeyReplyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+    const QJsonObject response = QJsonDocument::fromJson(reply->readAll()).object();
+    const QString listenKey = response["listenKey"].toString();
+    if (listenKey.isEmpty()) {
+        m_lastError = response.isEmpty() ? reply->errorString() : response["msg"].toString();
+        emit errorOccurred("User data stream unavailable: " + m_lastError);
+        return;
+    }
+    // Disconnected while the key was on its way
+    if (!m_webSocket || m_webSocket->state() == QAbstractSocket::UnconnectedState) return;
+    m_listenKey = listenKey;
+    if (!m_userStream) {
+        m_userStream = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+        QObject::connect(m_userStream, &QWebSocket::connected, this, &ExchangeConnector::onUserStreamConnected);
+        QObject::connect(m_userStream, &QWebSocket::disconnected, this, &ExchangeConnector::onUserStreamDisconnected);
+        QObject::connect(m_userStream, &QWebSocket::textMessageReceived,
+                         this, &ExchangeConnector::onUserStreamTextMessageReceived);
+    }
+    QString base = m_webSocketUrl;
+    while (base.endsWith('/')) base.chop(1);
+    if (m_userStream->state() == QAbstractSocket::UnconnectedState) m_userStream->open(QUrl(base + "/" + m_listenKey));
+}
+
+void ExchangeConnector::onUserStreamConnected()
+{
+    m_userStreamReady = true;
+    if (!m_listenKeyTimer) {
+        m_listenKeyTimer = new QTimer(this);
+        m_listenKeyTimer->setInterval(LISTEN_KEY_KEEPALIVE_INTERVAL);
+        QObject::connect(m_listenKeyTimer, &QTimer::timeout, this, &ExchangeConnector::onListenKeyTimer);
+    }
+    m_listenKeyTimer->start();
+}
+
+void ExchangeConnector::onUserStreamDisconnected()
+{
+    if (!m_userStreamReady) return;
+    m_userStreamReady = false;
+    if (m_listenKeyTimer) m_listenKeyTimer->stop();
+    emit errorOccurred("User data stream closed");
+    // Still trading: ask for a key again, which reopens the stream
+    if (m_connected) {
+        QTimer::singleShot(RECONNECT_INTERVAL, this, [this]() {
+            if (m_connected && !m_userStreamReady) binanceStartUserStream();
+        });
+    }
+}
+
+void ExchangeConnector::onUserStreamTextMessageReceived(const QString &message)
+{
+    const QJsonObject event = QJsonDocument::fromJson(message.toUtf8()).object();
+    const QString type = event["e"].toString();
+    if (type == "executionReport") {
+        processExecutionReport(event);
+    } else if (type == "listenKeyExpired") {
+        // The stream closes after this; onUserStreamDisconnected gets a new key
+        m_listenKey.clear();
+    }
+    // Balance and account position events are not used
+}
+
+void ExchangeConnector::onListenKeyTimer()
+{
+    // Keepalive: an unanswered key lapses and the venue closes the stream
+    if (m_listenKey.isEmpty()) return;
+    QNetworkReply *reply = binanceUserStreamRequest("PUT");
+    QObject::connect(reply, &QNetworkReply::finished, reply, &QObject::deleteLater);
+}
+
+void ExchangeConnector::onWebSocketTextMessageReceived(const QString &message)
+{
+    m_frameTimeNs = LatencyClock::nowNs();
+    QJsonObject object;
+    {
+        LATENCY_PROBE(ProbeStage::FEED_DECODE);
+        object = QJsonDocument::fromJson(message.toUtf8()).object();
+    }
+    if (!object.isEmpty()) handleWebSocketMessage(object);
+}
+
 // More stub implementations for exchange-specific methods
 void ExchangeConnector::connectBinance() {}
 void ExchangeConnector::connectCoinbase() {}
@@ -288,41 +864,223 @@ void ExchangeConnector::connectDeltaExchange() {}
 void ExchangeConnector::connectMetaTrader4() {}
 void ExchangeConnector::connectMetaTrader5() {}
 
-QNetworkRequest ExchangeConnector::createRequest(const QString &endpoint, const QJsonObject &params)
+QString ExchangeConnector::signRequest(const QString &queryString, const QString &secret)
 {
-    Q_UNUSED(endpoint)
-    Q_UNUSED(params)
-    return QNetworkRequest();
+    return QString::fromLatin1(QMessageAuthenticationCode::hash(queryString.toUtf8(), secret.toUtf8(),
+                                                                QCryptographicHash::Sha256).toHex());
 }
 
-QJsonObject ExchangeConnector::sendRequest(const QString &method, const QString &endpoint, const QJsonObject &params)
+void ExchangeConnector::setupWebSocket()
 {
-    Q_UNUSED(method)
-    Q_UNUSED(endpoint)
-    Q_UNUSED(params)
-    return QJsonObject();
+    if (m_webSocket) return;
+    m_webSocket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+    QObject::connect(m_webSocket, &QWebSocket::connected, this, &ExchangeConnector::onWebSocketConnected);
+    QObject::connect(m_webSocket, &QWebSocket::disconnected, this, &ExchangeConnector::onWebSocketDisconnected);
+    QObject::connect(m_webSocket, &QWebSocket::textMessageReceived, this, &ExchangeConnector::onWebSocketTextMessageReceived);
+    QObject::connect(m_webSocket, &QWebSocket::errorOccurred, this, &ExchangeConnector::onWebSocketError);
 }
 
-QString ExchangeConnector::signRequest(const QString &queryString, const QString &secret)
+void ExchangeConnector::sendWebSocketMessage(const QJsonObject &message)
 {
-    Q_UNUSED(queryString)
-    Q_UNUSED(secret)
-    return QString();
+    if (!m_webSocket || m_webSocket->state() != QAbstractSocket::ConnectedState) return;
+    m_webSocket->sendTextMessage(QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact)));
 }
 
-void ExchangeConnector::setupWebSocket() {}
-void ExchangeConnector::sendWebSocketMessage(const QJsonObject &message) { Q_UNUSED(message) }
-void ExchangeConnector::handleWebSocketMessage(const QJsonObject &message) { Q_UNUSED(message) }
+void ExchangeConnector::subscribeOnVenue(const QString &symbol)
+{
+    switch (m_currentExchange) {
+        case ExchangeType::BINANCE:
+            binanceSubscribeMarketData(symbol);
+            break;
+        case ExchangeType::COINBASE:
+            coinbaseSubscribeMarketData(symbol);
+            break;
+        case ExchangeType::DERIBIT:
+            deribitSubscribeMarketData(symbol);
+            break;
+        case ExchangeType::DELTA_EXCHANGE:
+            deltaSubscribeMarketData(symbol);
+            break;
+        case ExchangeType::METATRADER4:
+        case ExchangeType::METATRADER5:
+            metatraderSubscribeMarketData(symbol);
+            break;
+    }
+}
+
+void ExchangeConnector::handleWebSocketMessage(const QJsonObject &message)
+{
+    // Subscription acks ({"result": null, "id": n}) and errors carry no market data
+    if (message.contains("error")) {
+        m_lastError = message["error"].toObject()["msg"].toString();
+        emit errorOccurred("Stream error: " + m_lastError);
+        return;
+    }
+    if (message.contains("result")) return;
+    processMarketData(message);
+}
 
 QString ExchangeConnector::generateClientOrderId()
 {
-    return QString("CLIENT_%1").arg(QDateTime::currentMSecsSinceEpoch());
+    return m_clientOrderIds.next();
+}
+
+void ExchangeConnector::processOrderResponse(const QJsonObject &response)
+{
+    // Binance order result; placeOrder handed the client id back as the order id
+    const QString clientOrderId = response["clientOrderId"].toString();
+    if (response.contains("code")) {
+        m_lastError = response["msg"].toString();
+        {
+            QMutexLocker locker(&m_mutex);
+            m_orderSymbols.erase(clientOrderId);
+        }
+        emit orderRejected(clientOrderId, m_lastError);
+        return;
+    }
+    OrderResponse order;
+    order.orderId = clientOrderId;
+    order.clientOrderId = clientOrderId;
+    order.status = parseOrderStatus(response["status"].toString());
+    order.filledQuantity = response["executedQty"].toString().toDouble();
+    const double notional = response["cummulativeQuoteQty"].toString().toDouble();
+    order.averagePrice = order.filledQuantity > 0.0 ? notional / order.filledQuantity : 0.0;
+    order.commission = notional * getCommissionRate(response["symbol"].toString());
+    order.timestamp = QDateTime::currentDateTime();
+    {
+        QMutexLocker locker(&m_mutex);
+        if (order.status == OrderStatus::PENDING) m_orders[order.orderId] = order;
+        else m_orders.erase(order.orderId);
+        // A partly filled order is still open and can still be cancelled
+        if (order.status != OrderStatus::PENDING && order.status != OrderStatus::PARTIALLY_FILLED) {
+            m_orderSymbols.erase(order.orderId);
+        }
+    }
+    switch (order.status) {
+        case OrderStatus::FILLED:
+        case OrderStatus::PARTIALLY_FILLED:
+            emit orderFilled(order);
+            break;
+        case OrderStatus::CANCELLED:
+        case OrderStatus::EXPIRED:
+            // An IOC remainder expires with the part that did fill; that part is still a fill
+            if (order.filledQuantity > 0.0) emit orderFilled(order);
+            else emit orderCancelled(order.orderId);
+            break;
+        case OrderStatus::REJECTED:
+            emit orderRejected(order.orderId, response["status"].toString());
+            break;
+        case OrderStatus::PENDING:
+            break;
+    }
+}
+
+void ExchangeConnector::processExecutionReport(const QJsonObject &report)
+{
+    // User-data stream executionReport, mapped onto the REST result fields. c is the client id
+    // of the request behind the event, so a cancel names the order in C; z and Z are cumulative
+    const QString status = report["X"].toString();
+    const QString originalClientId = report["C"].toString();
+    if (status == "NEW") emit orderAcknowledged(report["c"].toString(), report["i"].toVariant().toString());
+    QJsonObject response;
+    response["clientOrderId"] = status == "CANCELED" && !originalClientId.isEmpty() ? originalClientId
+                                                                                   : report["c"].toString();
+    response["symbol"] = report["s"];
+    response["status"] = status;
+    response["executedQty"] = report["z"];
+    response["cummulativeQuoteQty"] = report["Z"];
+    processOrderResponse(response);
 }
 
-void ExchangeConnector::processOrderResponse(const QJsonObject &response) { Q_UNUSED(response) }
 void ExchangeConnector::updateOrderStatus(const QString &orderId, OrderStatus status) { Q_UNUSED(orderId) Q_UNUSED(status) }
-void ExchangeConnector::processMarketData(const QJsonObject &data) { Q_UNUSED(data) }
-void ExchangeConnector::updateMarketData(const QString &symbol, const MarketData &data) { Q_UNUSED(symbol) Q_UNUSED(data) }
+
+void ExchangeConnector::processMarketData(const QJsonObject &data)
+{
+    // Binance streams: bookTicker {s, b, B, a, A}, trade {e: "trade", s, p, q} and the
+    // depth diffs {e: "depthUpdate", s, U, u, b, a}
+    const QString symbol = data["s"].toString();
+    if (symbol.isEmpty()) return;
+    if (data["e"].toString() == "depthUpdate") {
+        processDepthUpdate(data);
+        return;
+    }
+    MarketData tick = MarketData();
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_marketData.find(symbol);
+        if (it != m_marketData.end()) tick = it->second;
+    }
+    tick.symbol = symbol;
+    if (data["e"].toString() == "trade") {
+        tick.last = data["p"].toString().toDouble();
+        tick.volume = data["q"].toString().toDouble();
+    } else {
+        tick.bid = data["b"].toString().toDouble();
+        tick.ask = data["a"].toString().toDouble();
+        // The last trade price carries over; resting size at the touch is not traded volume
+        tick.volume = 0.0;
+    }
+    tick.timestamp = QDateTime::currentDateTimeUtc();
+    tick.receiveTimeNs = m_frameTimeNs;
+    updateMarketData(symbol, tick);
+}
+
+void ExchangeConnector::processDepthUpdate(const QJsonObject &update)
+{
+    const QString symbol = update["s"].toString();
+    bool resync = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_depthBooks.find(symbol);
+        if (it == m_depthBooks.end()) return;
+        DepthBook &book = it->second;
+        if (!book.synced) {
+            // Held until the snapshot lands; past the cap the snapshot is too far behind to use
+            if (book.pending.size() < static_cast<size_t>(MAX_PENDING_DEPTH_UPDATES)) book.pending.push_back(update);
+            else resync = true;
+        } else if (applyDepthUpdate(book, update)) {
+            book.timestamp = QDateTime::currentDateTimeUtc();
+        } else {
+            resync = true;
+        }
+    }
+    if (resync) binanceRequestDepthSnapshot(symbol);
+}
+
+bool ExchangeConnector::applyDepthUpdate(DepthBook &book, const QJsonObject &update)
+{
+    // Returns false on a gap in update ids; the book must then be rebuilt from a snapshot.
+    // Diffs already covered by the snapshot are skipped; a zero quantity removes the level
+    const qint64 first = update["U"].toVariant().toLongLong();
+    const qint64 last = update["u"].toVariant().toLongLong();
+    if (last <= book.lastUpdateId) return true;
+    if (first > book.lastUpdateId + 1) return false;
+    for (const QJsonValue &level : update["b"].toArray()) {
+        const QJsonArray pair = level.toArray();
+        const double price = pair.at(0).toString().toDouble();
+        const double quantity = pair.at(1).toString().toDouble();
+        if (quantity > 0.0) book.bids[price] = quantity;
+        else book.bids.erase(price);
+    }
+    for (const QJsonValue &level : update["a"].toArray()) {
+        const QJsonArray pair = level.toArray();
+        const double price = pair.at(0).toString().toDouble();
+        const double quantity = pair.at(1).toString().toDouble();
+        if (quantity > 0.0) book.asks[price] = quantity;
+        else book.asks.erase(price);
+    }
+    book.lastUpdateId = last;
+    return true;
+}
+
+void ExchangeConnector::updateMarketData(const QString &symbol, const MarketData &data)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_marketData[symbol] = data;
+    }
+    emit marketDataReceived(data);
+}
 
 QString ExchangeConnector::formatSymbol(const QString &symbol) const { return symbol; }
 double ExchangeConnector::formatPrice(double price, const QString &symbol) const { Q_UNUSED(symbol) return price; }
@@ -330,24 +1088,285 @@ double ExchangeConnector::formatQuantity(double quantity, const QString &symbol)
 
 OrderStatus ExchangeConnector::parseOrderStatus(const QString &status) const
 {
-    Q_UNUSED(status)
-    return OrderStatus::FILLED;
+    if (status == "FILLED") return OrderStatus::FILLED;
+    if (status == "PARTIALLY_FILLED") return OrderStatus::PARTIALLY_FILLED;
+    if (status == "CANCELED" || status == "CANCELLED") return OrderStatus::CANCELLED;
+    if (status == "REJECTED") return OrderStatus::REJECTED;
+    if (status.startsWith("EXPIRED")) return OrderStatus::EXPIRED;
+    return OrderStatus::PENDING; // NEW, PENDING_NEW
 }
 
 // Exchange-specific stub implementations
-QString ExchangeConnector::binancePlaceOrder(const OrderRequest &request) { Q_UNUSED(request) return QString(); }
+QString ExchangeConnector::binancePlaceOrder(const OrderRequest &request)
+{
+    if (m_restUrl.isEmpty()) {
+        m_lastError = "No REST endpoint configured for " + getExchangeName();
+        return QString();
+    }
+    QUrlQuery query;
+    query.addQueryItem("symbol", formatSymbol(request.symbol));
+    query.addQueryItem("side", request.side == OrderSide::BUY ? "BUY" : "SELL");
+    const QString price = QString::number(formatPrice(request.price, request.symbol), 'f', 8);
+    switch (request.type) {
+        case OrderType::MARKET:
+            query.addQueryItem("type", "MARKET");
+            break;
+        case OrderType::STOP:
+            query.addQueryItem("type", "STOP_LOSS");
+            query.addQueryItem("stopPrice", request.stopPrice > 0.0
+                                                ? QString::number(formatPrice(request.stopPrice, request.symbol), 'f', 8)
+                                                : price);
+            break;
+        default:
+            query.addQueryItem("type", "LIMIT");
+            query.addQueryItem("timeInForce", request.timeInForce == TimeInForce::IOC ? "IOC"
+                                              : request.timeInForce == TimeInForce::FOK ? "FOK" : "GTC");
+            query.addQueryItem("price", price);
+            break;
+    }
+    query.addQueryItem("quantity", QString::number(formatQuantity(request.quantity, request.symbol), 'f', 8));
+    query.addQueryItem("newClientOrderId", request.clientOrderId);
+    query.addQueryItem("newOrderRespType", "RESULT");
+
+    {
+        // Cancels need the symbol; kept until the order reaches a final state
+        QMutexLocker locker(&m_mutex);
+        m_orderSymbols[request.clientOrderId] = formatSymbol(request.symbol);
+    }
+    binanceOrderRequest("POST", query, request.clientOrderId, 0);
+    // The result arrives asynchronously as orderFilled / orderRejected under this id
+    return request.clientOrderId;
+}
+
+void ExchangeConnector::binanceOrderRequest(const QByteArray &verb, const QUrlQuery &params,
+                                            const QString &clientOrderId, int attempt)
+{
+    QNetworkReply *reply = binanceSignedRequest(verb, "/api/v3/order", params);
+    reply->setProperty("clientOrderId", clientOrderId);
+    reply->setProperty("verb", verb);
+    reply->setProperty("params", params.toString(QUrl::FullyEncoded));
+    reply->setProperty("attempt", attempt);
+    QObject::connect(reply, &QNetworkReply::finished, this, &ExchangeConnector::onNetworkReplyFinished);
+}
+
+QNetworkReply *ExchangeConnector::binanceSignedRequest(const QByteArray &verb, const QString &path,
+                                                       const QUrlQuery &params)
+{
+    QUrlQuery query = params;
+    query.addQueryItem("timestamp", QString::number(QDateTime::currentMSecsSinceEpoch()));
+    if (!m_apiSecret.isEmpty()) {
+        query.addQueryItem("signature", signRequest(query.toString(QUrl::FullyEncoded), m_apiSecret));
+    }
+    if (!m_networkManager) m_networkManager = new QNetworkAccessManager(this);
+    // POST parameters go in the form body; DELETE has no body, so they go in the URL
+    const bool hasBody = verb == "POST";
+    QUrl url(m_restUrl + path);
+    if (!hasBody) url.setQuery(query);
+    QNetworkRequest request(url);
+    if (hasBody) request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+    request.setTransferTimeout(REQUEST_TIMEOUT);
+    if (!m_apiKey.isEmpty()) request.setRawHeader("X-MBX-APIKEY", m_apiKey.toUtf8());
+    QNetworkReply *reply = m_networkManager->sendCustomRequest(request, verb,
+                                                               hasBody ? query.toString(QUrl::FullyEncoded).toUtf8()
+                                                                       : QByteArray());
+    // Sent while the user-data stream was open: the stream reports what it does to orders
+    reply->setProperty("streamed", m_userStreamReady);
+    return reply;
+}
+
+QNetworkReply *ExchangeConnector::binanceUserStreamRequest(const QByteArray &verb)
+{
+    // USER_STREAM endpoints take the API key but no timestamp or signature
+    if (!m_networkManager) m_networkManager = new QNetworkAccessManager(this);
+    QUrl url(m_restUrl + "/api/v3/userDataStream");
+    if (verb != "POST") {
+        QUrlQuery query;
+        query.addQueryItem("listenKey", m_listenKey);
+        url.setQuery(query);
+    }
+    QNetworkRequest request(url);
+    request.setTransferTimeout(REQUEST_TIMEOUT);
+    if (!m_apiKey.isEmpty()) request.setRawHeader("X-MBX-APIKEY", m_apiKey.toUtf8());
+    return m_networkManager->sendCustomRequest(request, verb, QByteArray());
+}
+
+void ExchangeConnector::binanceStartUserStream()
+{
+    if (m_restUrl.isEmpty() || m_webSocketUrl.isEmpty()) return;
+    QNetworkReply *reply = binanceUserStreamRequest("POST");
+    QObject::connect(reply, &QNetworkReply::finished, this, &ExchangeConnector::onListenKeyReplyFinished);
+}
+
+void ExchangeConnector::binanceStopUserStream()
+{
+    m_userStreamReady = false;
+    if (m_listenKeyTimer) m_listenKeyTimer->stop();
+    if (m_userStream && m_userStream->state() != QAbstractSocket::UnconnectedState) m_userStream->abort();
+    m_listenKey.clear();
+}
+
+bool ExchangeConnector::binancePlaceOcoOrder(const OrderRequest &stopLeg, const OrderRequest &takeProfitLeg,
+                                             QString &stopOrderId, QString &takeProfitOrderId)
+{
+    // POST /api/v3/order/oco: a LIMIT_MAKER take-profit and a STOP_LOSS stop in one order list,
+    // so the venue cancels the survivor the moment either leg fills
+    if (m_restUrl.isEmpty()) {
+        m_lastError = "No REST endpoint configured for " + getExchangeName();
+        return false;
+    }
+    const QString stopClientId = stopLeg.clientOrderId.isEmpty() ? generateClientOrderId() : stopLeg.clientOrderId;
+    const QString limitClientId = takeProfitLeg.clientOrderId.isEmpty() ? generateClientOrderId()
+                                                                        : takeProfitLeg.clientOrderId;
+    const double stopPrice = stopLeg.stopPrice > 0.0 ? stopLeg.stopPrice : stopLeg.price;
+    QUrlQuery query;
+    query.addQueryItem("symbol", formatSymbol(takeProfitLeg.symbol));
+    query.addQueryItem("side", takeProfitLeg.side == OrderSide::BUY ? "BUY" : "SELL");
+    query.addQueryItem("quantity", QString::number(formatQuantity(takeProfitLeg.quantity, takeProfitLeg.symbol), 'f', 8));
+    query.addQueryItem("price", QString::number(formatPrice(takeProfitLeg.price, takeProfitLeg.symbol), 'f', 8));
+    query.addQueryItem("stopPrice", QString::number(formatPrice(stopPrice, stopLeg.symbol), 'f', 8));
+    query.addQueryItem("limitClientOrderId", limitClientId);
+    query.addQueryItem("stopClientOrderId", stopClientId);
+    query.addQueryItem("newOrderRespType", "RESULT");
+
+    OrderRequest submitted = stopLeg;
+    submitted.clientOrderId = stopClientId;
+    emit orderSubmitted(submitted);
+    submitted = takeProfitLeg;
+    submitted.clientOrderId = limitClientId;
+    emit orderSubmitted(submitted);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_orderSymbols[stopClientId] = formatSymbol(takeProfitLeg.symbol);
+        m_orderSymbols[limitClientId] = formatSymbol(takeProfitLeg.symbol);
+    }
+    QNetworkReply *reply = binanceSignedRequest("POST", "/api/v3/order/oco", query);
+    reply->setProperty("stopClientOrderId", stopClientId);
+    reply->setProperty("limitClientOrderId", limitClientId);
+    QObject::connect(reply, &QNetworkReply::finished, this, &ExchangeConnector::onOcoReplyFinished);
+    stopOrderId = stopClientId;
+    takeProfitOrderId = limitClientId;
+    return true;
+}
+
+bool ExchangeConnector::binanceCancelOrder(const QString &orderId)
+{
+    // DELETE /api/v3/order by client id; the venue's report arrives as orderCancelled
+    QString symbol;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_orderSymbols.find(orderId);
+        if (it != m_orderSymbols.end()) symbol = it->second;
+    }
+    if (symbol.isEmpty() || m_restUrl.isEmpty()) {
+        m_lastError = symbol.isEmpty() ? "No open order " + orderId
+                                       : "No REST endpoint configured for " + getExchangeName();
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    QUrlQuery query;
+    query.addQueryItem("symbol", symbol);
+    query.addQueryItem("origClientOrderId", orderId);
+    QNetworkReply *reply = binanceSignedRequest("DELETE", "/api/v3/order", query);
+    reply->setProperty("clientOrderId", orderId);
+    QObject::connect(reply, &QNetworkReply::finished, this, &ExchangeConnector::onCancelReplyFinished);
+    return true;
+}
+
+bool ExchangeConnector::binanceCancelAllOrders()
+{
+    // DELETE /api/v3/openOrders is per symbol: sweep every symbol with an order of ours or a
+    // feed; the replies are counted up into one allOrdersCancelled
+    if (m_restUrl.isEmpty()) {
+        m_lastError = "No REST endpoint configured for " + getExchangeName();
+        return false;
+    }
+    std::set<QString> symbols;
+    {
+        QMutexLocker locker(&m_mutex);
+        // One sweep at a time; a second request is answered by the one in flight
+        if (m_pendingMassCancels > 0) return true;
+        for (const auto &order : m_orderSymbols) symbols.insert(order.second);
+        for (const auto &data : m_marketData) symbols.insert(formatSymbol(data.first));
+        m_pendingMassCancels = static_cast<int>(symbols.size());
+        m_massCancelCount = 0;
+        m_massCancelError.clear();
+    }
+    if (symbols.empty()) {
+        // Nothing placed or quoted here, so nothing of ours can be open
+        emit allOrdersCancelled(0);
+        return true;
+    }
+    for (const QString &symbol : symbols) {
+        QUrlQuery query;
+        query.addQueryItem("symbol", symbol);
+        QNetworkReply *reply = binanceSignedRequest("DELETE", "/api/v3/openOrders", query);
+        QObject::connect(reply, &QNetworkReply::finished, this, &ExchangeConnector::onCancelAllReplyFinished);
+    }
+    return true;
+}
+
 QJsonObject ExchangeConnector::binanceGetAccountInfo() { return QJsonObject(); }
-void ExchangeConnector::binanceSubscribeMarketData(const QString &symbol) { Q_UNUSED(symbol) }
+void ExchangeConnector::binanceSubscribeMarketData(const QString &symbol)
+{
+    QJsonObject message;
+    message["method"] = "SUBSCRIBE";
+    const QString stream = formatSymbol(symbol).toLower();
+    message["params"] = QJsonArray{ stream + "@bookTicker", stream + "@trade", stream + "@depth@100ms" };
+    message["id"] = static_cast<int>(m_subscriptions.size());
+    sendWebSocketMessage(message);
+    // Diffs buffer from here until the snapshot they apply on top of arrives
+    binanceRequestDepthSnapshot(formatSymbol(symbol));
+}
+
+void ExchangeConnector::binanceRequestDepthSnapshot(const QString &symbol)
+{
+    // GET /api/v3/depth is public: no key or signature. Any older book for the symbol is dropped
+    {
+        QMutexLocker locker(&m_mutex);
+        m_depthBooks[symbol] = DepthBook();
+    }
+    if (m_restUrl.isEmpty()) return;
+    if (!m_networkManager) m_networkManager = new QNetworkAccessManager(this);
+    QUrl url(m_restUrl + "/api/v3/depth");
+    QUrlQuery query;
+    query.addQueryItem("symbol", symbol);
+    query.addQueryItem("limit", QString::number(DEPTH_SNAPSHOT_LIMIT));
+    url.setQuery(query);
+    QNetworkRequest request(url);
+    request.setTransferTimeout(REQUEST_TIMEOUT);
+    QNetworkReply *reply = m_networkManager->get(request);
+    reply->setProperty("symbol", symbol);
+    QObject::connect(reply, &QNetworkReply::finished, this, &ExchangeConnector::onDepthSnapshotFinished);
+}
 
 QString ExchangeConnector::coinbasePlaceOrder(const OrderRequest &request) { Q_UNUSED(request) return QString(); }
+bool ExchangeConnector::coinbaseCancelAllOrders()
+{
+    m_lastError = "Cancel all orders not implemented for Coinbase";
+    return false;
+}
+
 QJsonObject ExchangeConnector::coinbaseGetAccountInfo() { return QJsonObject(); }
 void ExchangeConnector::coinbaseSubscribeMarketData(const QString &symbol) { Q_UNUSED(symbol) }
 
 QString ExchangeConnector::deribitPlaceOrder(const OrderRequest &request) { Q_UNUSED(request) return QString(); }
+bool ExchangeConnector::deribitCancelAllOrders()
+{
+    m_lastError = "Cancel all orders not implemented for Deribit";
+    return false;
+}
+
 QJsonObject ExchangeConnector::deribitGetAccountInfo() { return QJsonObject(); }
 void ExchangeConnector::deribitSubscribeMarketData(const QString &symbol) { Q_UNUSED(symbol) }
 
 QString ExchangeConnector::deltaPlaceOrder(const OrderRequest &request) { Q_UNUSED(request) return QString(); }
+bool ExchangeConnector::deltaCancelAllOrders()
+{
+    m_lastError = "Cancel all orders not implemented for Delta Exchange";
+    return false;
+}
+
 QJsonObject ExchangeConnector::deltaGetAccountInfo() { return QJsonObject(); }
 void ExchangeConnector::deltaSubscribeMarketData(const QString &symbol) { Q_UNUSED(symbol) }
 
@@ -0,0 +1,382 @@
+#include "ExecutionAlgoScheduler.h"
+#include "OrderManager.h"
+#include "LatencyHistogram.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+static const qint64 DAY_MS = 24LL * 60 * 60 * 1000;
+static const double QUANTITY_EPSILON = 1e-9;
+
+ExecutionAlgoScheduler::ExecutionAlgoScheduler(QObject *parent)
+    : QObject(parent)
+    , m_orderManager(nullptr)
+    , m_wheelTimer(new QTimer(this))
+    , m_wheel(WHEEL_SLOTS, DEFAULT_TICK_MS)
+    , m_nextAlgoId(0)
+    , m_wallOffsetMs(QDateTime::currentMSecsSinceEpoch() - nowMs())
+{
+    m_wheel.reset(nowMs());
+    // One timer drives every algo; individual algos only occupy wheel slots
+    m_wheelTimer->setTimerType(Qt::PreciseTimer);
+    m_wheelTimer->setInterval(DEFAULT_TICK_MS);
+    connect(m_wheelTimer, &QTimer::timeout, this, &ExecutionAlgoScheduler::onWheelTick);
+}
+
+ExecutionAlgoScheduler::~ExecutionAlgoScheduler()
+{
+    m_wheelTimer->stop();
+}
+
+void ExecutionAlgoScheduler::setOrderManager(OrderManager *orderManager)
+{
+    QMutexLocker locker(&m_mutex);
+    m_orderManager = orderManager;
+}
+
+void ExecutionAlgoScheduler::setTickInterval(int ms)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_algos.empty()) return; // the wheel can only be re-gridded while idle
+    m_wheel = TimerWheel(WHEEL_SLOTS, ms);
+    m_wheel.reset(nowMs());
+    m_wheelTimer->setInterval(ms);
+}
+
+quint64 ExecutionAlgoScheduler::startAlgo(const ExecutionAlgoParams &params)
+{
+    QMutexLocker locker(&m_mutex);
+    if (params.totalQuantity <= 0.0) return 0;
+
+    ExecutionAlgoStatus algo;
+    algo.algoId = ++m_nextAlgoId;
+    algo.params = params;
+    if (algo.params.sliceIntervalMs <= 0) algo.params.sliceIntervalMs = m_wheel.tickMs();
+    algo.state = ExecutionAlgoState::RUNNING;
+    algo.sentQuantity = 0.0;
+    algo.observedVolume = 0.0;
+    algo.slicesSent = 0;
+    algo.startMs = nowMs();
+
+    m_algos[algo.algoId] = algo;
+    if (params.type == ExecutionAlgoType::POV) {
+        m_povBySymbol[params.symbol].push_back(algo.algoId);
+    }
+    m_wheel.schedule(algo.algoId, algo.params.sliceIntervalMs);
+    if (!m_wheelTimer->isActive()) {
+        m_wheelTimer->start();
+    }
+    return algo.algoId;
+}
+
+void ExecutionAlgoScheduler::cancelAlgo(quint64 algoId)
+{
+    double sent = 0.0;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_algos.find(algoId);
+        if (it == m_algos.end()) return;
+        sent = it->second.sentQuantity;
+        auto &pov = m_povBySymbol[it->second.params.symbol];
+        pov.erase(std::remove(pov.begin(), pov.end(), algoId), pov.end());
+        // Its wheel entry is skipped when it fires
+        m_algos.erase(it);
+    }
+    emit algoCancelled(algoId, sent);
+}
+
+ExecutionAlgoStatus ExecutionAlgoScheduler::getAlgoStatus(quint64 algoId) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_algos.find(algoId);
+    if (it != m_algos.end()) {
+        return it->second;
+    }
+    ExecutionAlgoStatus status;
+    status.algoId = 0;
+    status.state = ExecutionAlgoState::COMPLETED;
+    status.sentQuantity = 0.0;
+    status.observedVolume = 0.0;
+    status.slicesSent = 0;
+    status.startMs = 0;
+    return status;
+}
+
+int ExecutionAlgoScheduler::getActiveAlgoCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_algos.size());
+}
+
+void ExecutionAlgoScheduler::setVolumeProfile(const QString &symbol, const std::vector<double> &bucketWeights)
+{
+    QMutexLocker locker(&m_mutex);
+    m_profiles[symbol].weights = bucketWeights;
+}
+
+std::vector<double> ExecutionAlgoScheduler::getVolumeProfile(const QString &symbol) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_profiles.find(symbol);
+    if (it == m_profiles.end()) return std::vector<double>();
+    return it->second.weights;
+}
+
+std::vector<double> ExecutionAlgoScheduler::getRecordedVolume(const QString &symbol) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_profiles.find(symbol);
+    if (it == m_profiles.end()) return std::vector<double>();
+    return it->second.recorded;
+}
+
+bool ExecutionAlgoScheduler::loadVolumeProfiles(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) return false;
+    const QJsonObject profiles = document.object();
+    QMutexLocker locker(&m_mutex);
+    for (auto it = profiles.begin(); it != profiles.end(); ++it) {
+        std::vector<double> weights;
+        for (const QJsonValue &volume : it.value().toArray()) weights.push_back(std::max(0.0, volume.toDouble()));
+        m_profiles[it.key()].weights = weights;
+    }
+    return true;
+}
+
+bool ExecutionAlgoScheduler::saveVolumeProfiles(const QString &path) const
+{
+    QJsonObject profiles;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const auto &entry : m_profiles) {
+            const VolumeProfile &profile = entry.second;
+            // A loaded profile on another bucket grid is replaced, not merged
+            const bool keepLoaded = profile.weights.size() == static_cast<size_t>(PROFILE_BUCKETS);
+            QJsonArray buckets;
+            for (int i = 0; i < PROFILE_BUCKETS; ++i) {
+                const double recorded = i < static_cast<int>(profile.recorded.size()) ? profile.recorded[i] : 0.0;
+                buckets.append(recorded > 0.0 || !keepLoaded ? recorded : profile.weights[i]);
+            }
+            profiles[entry.first] = buckets;
+        }
+    }
+    // Written to a temporary file and renamed, so a crash mid-write keeps the previous profile
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(profiles).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+void ExecutionAlgoScheduler::onWheelTick()
+{
+    advanceTo(nowMs());
+}
+
+void ExecutionAlgoScheduler::advanceTo(qint64 now)
+{
+    struct Slice {
+        quint64 algoId;
+        OrderRequest request;
+    };
+    std::vector<Slice> slices;
+    std::vector<std::pair<quint64, double>> completed;
+    OrderManager *orderManager = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        orderManager = m_orderManager;
+        m_wheel.advance(now, [&](uint64_t id) {
+            auto it = m_algos.find(id);
+            if (it == m_algos.end()) return; // cancelled
+            ExecutionAlgoStatus &algo = it->second;
+            const double slice = runSlice(algo, now);
+            if (slice > 0.0) slices.push_back({id, sliceRequest(algo.params, slice)});
+            if (algo.state == ExecutionAlgoState::RUNNING) {
+                m_wheel.schedule(id, algo.params.sliceIntervalMs);
+                return;
+            }
+            completed.push_back({id, algo.sentQuantity});
+            auto &pov = m_povBySymbol[algo.params.symbol];
+            pov.erase(std::remove(pov.begin(), pov.end(), id), pov.end());
+            m_algos.erase(it);
+        });
+        if (m_algos.empty()) {
+            m_wheelTimer->stop();
+        }
+    }
+    // Orders leave outside the lock: the order manager reports back through signals
+    for (const Slice &slice : slices) {
+        if (orderManager) {
+            // A held slice goes out on reconnect and stays counted; refunding it as well would
+            // send the same quantity twice
+            SubmitStatus status = SubmitStatus::REJECTED;
+            orderManager->submitOrder(slice.request, nullptr, &status);
+            if (status == SubmitStatus::REJECTED || status == SubmitStatus::BLOCKED) {
+                // Not sent: the quantity goes back to the schedule and a later slice catches up
+                QMutexLocker locker(&m_mutex);
+                auto it = m_algos.find(slice.algoId);
+                if (it != m_algos.end()) {
+                    it->second.sentQuantity -= slice.request.quantity;
+                    it->second.slicesSent--;
+                }
+                locker.unlock();
+                // Kill switch: the rest of the schedule is not worked
+                if (status == SubmitStatus::BLOCKED) cancelAlgo(slice.algoId);
+                continue;
+            }
+        }
+        emit childOrderRequested(slice.algoId, slice.request.symbol, slice.request.side, slice.request.quantity);
+    }
+    for (const auto &done : completed) {
+        emit algoCompleted(done.first, done.second);
+    }
+}
+
+double ExecutionAlgoScheduler::runSlice(ExecutionAlgoStatus &algo, qint64 now)
+{
+    // Called with m_mutex held; returns the quantity to send now, 0 if none
+    const ExecutionAlgoParams &params = algo.params;
+    const double remaining = params.totalQuantity - algo.sentQuantity;
+    const bool horizonReached = now - algo.startMs >= params.durationMs;
+
+    double slice = std::min(targetQuantity(algo, now) - algo.sentQuantity, remaining);
+    if (horizonReached && params.type != ExecutionAlgoType::POV) {
+        slice = remaining; // schedule-driven algos finish on time
+    }
+    if (slice < params.minSliceQuantity && !horizonReached && slice < remaining) {
+        slice = 0.0;
+    }
+    if (slice <= QUANTITY_EPSILON) slice = 0.0;
+
+    if (slice > 0.0) {
+        algo.sentQuantity += slice;
+        algo.slicesSent++;
+    }
+    if (algo.sentQuantity >= params.totalQuantity - QUANTITY_EPSILON || horizonReached) {
+        algo.state = ExecutionAlgoState::COMPLETED;
+    }
+    return slice;
+}
+
+OrderRequest ExecutionAlgoScheduler::sliceRequest(const ExecutionAlgoParams &params, double quantity)
+{
+    // Resting limit at the algo's limit price, or a market order when it has none
+    OrderRequest request;
+    request.symbol = params.symbol;
+    request.type = params.limitPrice > 0.0 ? OrderType::LIMIT : OrderType::MARKET;
+    request.side = params.side;
+    request.quantity = quantity;
+    request.price = params.limitPrice;
+    request.stopPrice = 0.0;
+    request.timeInForce = TimeInForce::GTC;
+    request.feedTimeNs = 0;
+    request.signalTimeNs = 0;
+    request.riskPassTimeNs = 0;
+    return request;
+}
+
+double ExecutionAlgoScheduler::targetQuantity(const ExecutionAlgoStatus &algo, qint64 now) const
+{
+    const ExecutionAlgoParams &params = algo.params;
+    const qint64 elapsed = now - algo.startMs;
+    double timeFraction = params.durationMs > 0 ? std::min(1.0, static_cast<double>(elapsed) / params.durationMs) : 1.0;
+
+    switch (params.type) {
+        case ExecutionAlgoType::TWAP:
+            return params.totalQuantity * timeFraction;
+        case ExecutionAlgoType::VWAP: {
+            double horizon = profileFraction(params.symbol, algo.startMs, algo.startMs + params.durationMs);
+            if (horizon <= 0.0) {
+                return params.totalQuantity * timeFraction; // no historical profile: behave as TWAP
+            }
+            double done = profileFraction(params.symbol, algo.startMs, std::min(now, algo.startMs + params.durationMs));
+            return params.totalQuantity * std::min(1.0, done / horizon);
+        }
+        case ExecutionAlgoType::POV:
+            return std::min(params.totalQuantity, params.participationRate * algo.observedVolume);
+    }
+    return 0.0;
+}
+
+double ExecutionAlgoScheduler::profileFraction(const QString &symbol, qint64 fromMs, qint64 toMs) const
+{
+    // Only a loaded profile: today's recording covers the hours already gone, so scheduling on
+    // it would push the whole parent into the current bucket
+    auto it = m_profiles.find(symbol);
+    if (it == m_profiles.end() || toMs <= fromMs) return 0.0;
+    const std::vector<double> &weights = it->second.weights;
+    if (weights.empty()) return 0.0;
+
+    const qint64 bucketMs = DAY_MS / static_cast<qint64>(weights.size());
+    double total = 0.0;
+    for (double w : weights) total += w;
+    if (total <= 0.0) return 0.0;
+
+    // Cumulative profile weight from midnight to a time of day
+    auto cumulative = [&](qint64 tod) {
+        size_t index = static_cast<size_t>(tod / bucketMs);
+        double sum = 0.0;
+        for (size_t i = 0; i < index && i < weights.size(); ++i) sum += weights[i];
+        if (index < weights.size()) sum += weights[index] * static_cast<double>(tod % bucketMs) / bucketMs;
+        return sum;
+    };
+
+    const qint64 span = toMs - fromMs;
+    const qint64 fromTod = msOfDay(fromMs, m_wallOffsetMs);
+    const qint64 toTod = fromTod + span % DAY_MS;
+    double result = static_cast<double>(span / DAY_MS) * total;
+    if (toTod <= DAY_MS) {
+        result += cumulative(toTod) - cumulative(fromTod);
+    } else {
+        result += (total - cumulative(fromTod)) + cumulative(toTod - DAY_MS);
+    }
+    return result;
+}
+
+void ExecutionAlgoScheduler::onTradePrint(const QString &symbol, double price, double quantity)
+{
+    Q_UNUSED(price)
+    if (quantity <= 0.0) return;
+    QMutexLocker locker(&m_mutex);
+
+    VolumeProfile &profile = m_profiles[symbol];
+    if (profile.recorded.empty()) profile.recorded.assign(PROFILE_BUCKETS, 0.0);
+    qint64 bucketMs = DAY_MS / PROFILE_BUCKETS;
+    profile.recorded[static_cast<size_t>(msOfDay(nowMs(), m_wallOffsetMs) / bucketMs)] += quantity;
+
+    auto pov = m_povBySymbol.find(symbol);
+    if (pov == m_povBySymbol.end()) return;
+    for (quint64 id : pov->second) {
+        auto it = m_algos.find(id);
+        if (it != m_algos.end()) it->second.observedVolume += quantity;
+    }
+}
+
+void ExecutionAlgoScheduler::onMarketData(const MarketData &data)
+{
+    // MarketData::volume is the quantity printed by this update; quote updates carry none
+    if (data.volume > 0.0) {
+        onTradePrint(data.symbol, data.last, data.volume);
+    }
+}
+
+qint64 ExecutionAlgoScheduler::nowMs()
+{
+    return LatencyClock::nowNs() / 1000000;
+}
+
+qint64 ExecutionAlgoScheduler::msOfDay(qint64 monotonicMs, qint64 wallOffsetMs)
+{
+    qint64 tod = (monotonicMs + wallOffsetMs) % DAY_MS;
+    return tod < 0 ? tod + DAY_MS : tod;
+}
@@ -0,0 +1,176 @@
+#include "ExecutionTelemetry.h"
+#include <QJsonArray>
+
+ExecutionTelemetry::ExecutionTelemetry(QObject *parent)
+    : QObject(parent)
+    , m_histograms(new LatencyHistogram[VENUE_COUNT * ORDER_TYPE_COUNT * SEGMENT_COUNT])
+    , m_dumpTimer(nullptr)
+{
+}
+
+ExecutionTelemetry::~ExecutionTelemetry()
+{
+    stopPeriodicDump();
+}
+
+LatencyHistogram &ExecutionTelemetry::slot(ExchangeType venue, OrderType type, LatencySegment segment) const
+{
+    int index = (static_cast<int>(venue) * ORDER_TYPE_COUNT + static_cast<int>(type)) * SEGMENT_COUNT
+                + static_cast<int>(segment);
+    return m_histograms[index];
+}
+
+void ExecutionTelemetry::record(const OrderTimeline &timeline)
+{
+    auto segment = [&](OrderStage from, OrderStage to, LatencySegment which) {
+        int64_t start = timeline.at(from);
+        int64_t end = timeline.at(to);
+        if (start > 0 && end >= start) {
+            slot(timeline.venue, timeline.type, which).record(end - start);
+        }
+    };
+    segment(OrderStage::SIGNAL, OrderStage::RISK_PASS, LatencySegment::SIGNAL_TO_RISK);
+    segment(OrderStage::RISK_PASS, OrderStage::WIRE_SEND, LatencySegment::RISK_TO_WIRE);
+    segment(OrderStage::WIRE_SEND, OrderStage::ACK, LatencySegment::WIRE_TO_ACK);
+    segment(OrderStage::ACK, OrderStage::FILL, LatencySegment::ACK_TO_FILL);
+    segment(OrderStage::SIGNAL, OrderStage::FILL, LatencySegment::SIGNAL_TO_FILL);
+}
+
+void ExecutionTelemetry::recordSegment(ExchangeType venue, OrderType type, LatencySegment segment, int64_t latencyNs)
+{
+    slot(venue, type, segment).record(latencyNs);
+}
+
+const LatencyHistogram &ExecutionTelemetry::histogram(ExchangeType venue, OrderType type, LatencySegment segment) const
+{
+    return slot(venue, type, segment);
+}
+
+LatencyHistogram::Summary ExecutionTelemetry::summary(ExchangeType venue, OrderType type, LatencySegment segment) const
+{
+    return slot(venue, type, segment).summary();
+}
+
+void ExecutionTelemetry::reset()
+{
+    for (int i = 0; i < VENUE_COUNT * ORDER_TYPE_COUNT * SEGMENT_COUNT; ++i) {
+        m_histograms[i].reset();
+    }
+}
+
+QJsonObject ExecutionTelemetry::toJson() const
+{
+    QJsonObject root;
+    for (int v = 0; v < VENUE_COUNT; ++v) {
+        QJsonObject venueObject;
+        for (int t = 0; t < ORDER_TYPE_COUNT; ++t) {
+            QJsonObject typeObject;
+            for (int s = 0; s < SEGMENT_COUNT; ++s) {
+                const LatencyHistogram &h = slot(static_cast<ExchangeType>(v), static_cast<OrderType>(t),
+                                                 static_cast<LatencySegment>(s));
+                if (h.count() == 0) continue;
+                LatencyHistogram::Summary sum = h.summary();
+                QJsonObject segmentObject;
+                segmentObject["count"] = static_cast<qint64>(sum.count);
+                segmentObject["minNs"] = static_cast<qint64>(sum.min);
+                segmentObject["meanNs"] = sum.mean;
+                segmentObject["p50Ns"] = static_cast<qint64>(sum.p50);
+                segmentObject["p90Ns"] = static_cast<qint64>(sum.p90);
+                segmentObject["p99Ns"] = static_cast<qint64>(sum.p99);
+                segmentObject["p999Ns"] = static_cast<qint64>(sum.p999);
+                segmentObject["maxNs"] = static_cast<qint64>(sum.max);
+                typeObject[segmentName(static_cast<LatencySegment>(s))] = segmentObject;
+            }
+            if (!typeObject.isEmpty()) venueObject[orderTypeName(static_cast<OrderType>(t))] = typeObject;
+        }
+        if (!venueObject.isEmpty()) root[venueName(static_cast<ExchangeType>(v))] = venueObject;
+    }
+    return root;
+}
+
+QString ExecutionTelemetry::report() const
+{
+    QString text;
+    for (int v = 0; v < VENUE_COUNT; ++v) {
+        for (int t = 0; t < ORDER_TYPE_COUNT; ++t) {
+            for (int s = 0; s < SEGMENT_COUNT; ++s) {
+                const LatencyHistogram &h = slot(static_cast<ExchangeType>(v), static_cast<OrderType>(t),
+                                                 static_cast<LatencySegment>(s));
+                if (h.count() == 0) continue;
+                LatencyHistogram::Summary sum = h.summary();
+                text += QString("%1 %2 %3: n=%4 p50=%5us p99=%6us p99.9=%7us max=%8us\n")
+                    .arg(venueName(static_cast<ExchangeType>(v)))
+                    .arg(orderTypeName(static_cast<OrderType>(t)))
+                    .arg(segmentName(static_cast<LatencySegment>(s)))
+                    .arg(static_cast<qint64>(sum.count))
+                    .arg(sum.p50 / 1000.0, 0, 'f', 1)
+                    .arg(sum.p99 / 1000.0, 0, 'f', 1)
+                    .arg(sum.p999 / 1000.0, 0, 'f', 1)
+                    .arg(sum.max / 1000.0, 0, 'f', 1);
+            }
+        }
+    }
+    return text;
+}
+
+void ExecutionTelemetry::startPeriodicDump(int intervalMs)
+{
+    if (!m_dumpTimer) {
+        m_dumpTimer = new QTimer(this);
+        connect(m_dumpTimer, &QTimer::timeout, this, &ExecutionTelemetry::onDumpTimer);
+    }
+    m_dumpTimer->start(intervalMs);
+}
+
+void ExecutionTelemetry::stopPeriodicDump()
+{
+    if (m_dumpTimer) {
+        m_dumpTimer->stop();
+    }
+}
+
+void ExecutionTelemetry::onDumpTimer()
+{
+    QString text = report();
+    if (!text.isEmpty()) {
+        emit telemetryReport(text);
+    }
+}
+
+QString ExecutionTelemetry::venueName(ExchangeType venue)
+{
+    switch (venue) {
+        case ExchangeType::BINANCE: return "Binance";
+        case ExchangeType::COINBASE: return "Coinbase";
+        case ExchangeType::DERIBIT: return "Deribit";
+        case ExchangeType::DELTA_EXCHANGE: return "Delta Exchange";
+        case ExchangeType::METATRADER4: return "MetaTrader 4";
+        case ExchangeType::METATRADER5: return "MetaTrader 5";
+        default: return "Unknown";
+    }
+}
+
+QString ExecutionTelemetry::orderTypeName(OrderType type)
+{
+    switch (type) {
+        case OrderType::MARKET: return "MARKET";
+        case OrderType::LIMIT: return "LIMIT";
+        case OrderType::STOP: return "STOP";
+        case OrderType::STOP_LIMIT: return "STOP_LIMIT";
+        case OrderType::TRAILING_STOP: return "TRAILING_STOP";
+        case OrderType::ICEBERG: return "ICEBERG";
+        default: return "UNKNOWN";
+    }
+}
+
+QString ExecutionTelemetry::segmentName(LatencySegment segment)
+{
+    switch (segment) {
+        case LatencySegment::SIGNAL_TO_RISK: return "signalToRisk";
+        case LatencySegment::RISK_TO_WIRE: return "riskToWire";
+        case LatencySegment::WIRE_TO_ACK: return "wireToAck";
+        case LatencySegment::ACK_TO_FILL: return "ackToFill";
+        case LatencySegment::SIGNAL_TO_FILL: return "signalToFill";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,436 @@
+#include "InstrumentRegistry.h"
+#include "ExchangeConnector.h"
+#include <QJsonArray>
+#include <algorithm>
+#include <cmath>
+
+static const QStringList FIAT_CURRENCIES = {"USD", "EUR", "GBP", "JPY", "CHF", "AUD", "CAD", "NZD"};
+static const QStringList STABLECOINS = {"USDT", "USDC", "BUSD"};
+
+InstrumentRegistry::InstrumentRegistry()
+    : m_accountCurrency("USD")
+{
+}
+
+InstrumentRegistry::InstrumentRegistry(const InstrumentRegistry &other)
+{
+    *this = other;
+}
+
+InstrumentRegistry &InstrumentRegistry::operator=(const InstrumentRegistry &other)
+{
+    if (this == &other) return *this;
+    m_accountCurrency = other.m_accountCurrency;
+    m_index = other.m_index;
+    {
+        QMutexLocker locker(&other.m_inferredMutex);
+        m_inferred = other.m_inferred;
+    }
+    m_instruments.clear();
+    m_instruments.reserve(other.m_instruments.size());
+    for (const auto &source : other.m_instruments) {
+        std::unique_ptr<Instrument> instrument(new Instrument);
+        instrument->spec = source->spec;
+        instrument->mark.store(source->mark.load(std::memory_order_relaxed));
+        instrument->conversionIndex = source->conversionIndex;
+        instrument->invertConversion = source->invertConversion;
+        instrument->underlyingIndex = source->underlyingIndex;
+        m_instruments.push_back(std::move(instrument));
+    }
+    return *this;
+}
+
+InstrumentRegistry::~InstrumentRegistry()
+{
+}
+
+void InstrumentRegistry::setAccountCurrency(const QString &currency)
+{
+    m_accountCurrency = currency;
+    resolveLinks();
+}
+
+void InstrumentRegistry::loadConfig(const QJsonObject &config)
+{
+    if (config.contains("capital")) {
+        QJsonObject capital = config["capital"].toObject();
+        if (capital.contains("currency")) m_accountCurrency = capital["currency"].toString();
+    }
+    if (config.contains("instruments")) {
+        QJsonObject instruments = config["instruments"].toObject();
+        for (const QString &symbol : instruments.keys()) {
+            addInstrument(specFromJson(symbol, instruments[symbol].toObject()));
+        }
+    }
+    resolveLinks();
+}
+
+void InstrumentRegistry::loadFromConnector(ExchangeConnector *connector, const QStringList &symbols)
+{
+    if (!connector) return;
+    for (const QString &symbol : symbols) {
+        if (contains(symbol)) continue; // config wins over venue defaults
+        InstrumentSpec spec = inferSpec(symbol);
+        spec.tickSize = connector->getTickSize(symbol);
+        spec.tickValue = spec.tickSize * spec.contractSize;
+        spec.minQuantity = connector->getMinOrderSize(symbol);
+        spec.maxQuantity = connector->getMaxOrderSize(symbol);
+        addInstrument(spec);
+    }
+}
+
+void InstrumentRegistry::addInstrument(const InstrumentSpec &spec)
+{
+    auto it = m_index.constFind(spec.symbol);
+    Instrument *instrument;
+    if (it != m_index.constEnd()) {
+        instrument = m_instruments[it.value()].get();
+    } else {
+        m_index.insert(spec.symbol, static_cast<int>(m_instruments.size()));
+        m_instruments.push_back(std::unique_ptr<Instrument>(new Instrument));
+        instrument = m_instruments.back().get();
+        instrument->mark.store(0.0);
+        instrument->conversionIndex = -1;
+        instrument->invertConversion = false;
+        instrument->underlyingIndex = -1;
+    }
+    instrument->spec = spec;
+    std::sort(instrument->spec.leverageTiers.begin(), instrument->spec.leverageTiers.end(),
+              [](const LeverageTier &a, const LeverageTier &b) {
+                  // Uncapped tier (0) goes last
+                  if (a.maxNotional <= 0.0) return false;
+                  if (b.maxNotional <= 0.0) return true;
+                  return a.maxNotional < b.maxNotional;
+              });
+    resolveLinks();
+}
+
+bool InstrumentRegistry::contains(const QString &symbol) const
+{
+    return m_index.contains(symbol);
+}
+
+InstrumentSpec InstrumentRegistry::spec(const QString &symbol) const
+{
+    const Instrument *instrument = find(symbol);
+    return instrument ? instrument->spec : inferred(symbol);
+}
+
+QStringList InstrumentRegistry::symbols() const
+{
+    QStringList list;
+    for (const auto &instrument : m_instruments) {
+        list.append(instrument->spec.symbol);
+    }
+    return list;
+}
+
+void InstrumentRegistry::setMark(const QString &symbol, double price)
+{
+    auto it = m_index.constFind(symbol);
+    if (it != m_index.constEnd() && price > 0.0) {
+        m_instruments[it.value()]->mark.store(price, std::memory_order_relaxed);
+    }
+}
+
+double InstrumentRegistry::mark(const QString &symbol) const
+{
+    const Instrument *instrument = find(symbol);
+    return instrument ? instrument->mark.load(std::memory_order_relaxed) : 0.0;
+}
+
+double InstrumentRegistry::quoteConversion(const QString &symbol) const
+{
+    const Instrument *instrument = find(symbol);
+    return instrument ? conversionOf(*instrument) : 1.0;
+}
+
+double InstrumentRegistry::contractSize(const QString &symbol) const
+{
+    const Instrument *instrument = find(symbol);
+    return instrument ? instrument->spec.contractSize : inferred(symbol).contractSize;
+}
+
+double InstrumentRegistry::pipValue(const QString &symbol, double lots) const
+{
+    const Instrument *instrument = find(symbol);
+    if (!instrument) return lots * pipValuePerLot(inferred(symbol));
+    return pipValueFor(*instrument, lots);
+}
+
+double InstrumentRegistry::notional(const QString &symbol, double lots, double price) const
+{
+    const Instrument *instrument = find(symbol);
+    if (!instrument) return lots * inferred(symbol).contractSize * price;
+    return lots * instrument->spec.contractSize * markOf(*instrument, price) * conversionOf(*instrument);
+}
+
+double InstrumentRegistry::marginRequirement(const QString &symbol, double lots, double price, bool shortPosition) const
+{
+    const Instrument *instrument = find(symbol);
+    if (!instrument) {
+        // Unknown symbol: no leverage assumed
+        return lots * inferred(symbol).contractSize * price;
+    }
+    return marginFor(*instrument, lots, markOf(*instrument, price), shortPosition);
+}
+
+double InstrumentRegistry::maxLots(const QString &symbol, double availableMargin, double price) const
+{
+    const Instrument *instrument = find(symbol);
+    if (!instrument || availableMargin <= 0.0) return 0.0;
+    const InstrumentSpec &spec = instrument->spec;
+    double px = markOf(*instrument, price);
+    double unitNotional = spec.contractSize * px * conversionOf(*instrument);
+    if (unitNotional <= 0.0) return 0.0;
+
+    double lots;
+    if (spec.instrumentClass == InstrumentClass::OPTION) {
+        lots = availableMargin / unitNotional;
+    } else {
+        // Higher tiers only lower leverage, so walking down the tiers converges in at most tiers+1 steps
+        double leverage = leverageFor(spec, 0.0);
+        lots = availableMargin * leverage / unitNotional;
+        for (size_t i = 0; i < spec.leverageTiers.size(); ++i) {
+            double tierLeverage = leverageFor(spec, lots * unitNotional);
+            if (tierLeverage >= leverage) break;
+            leverage = tierLeverage;
+            lots = availableMargin * leverage / unitNotional;
+        }
+    }
+    if (spec.quantityStep > 0.0) {
+        lots = std::floor(lots / spec.quantityStep + 1e-9) * spec.quantityStep;
+    }
+    if (spec.maxQuantity > 0.0) lots = std::min(lots, spec.maxQuantity);
+    return lots;
+}
+
+double InstrumentRegistry::roundLots(const QString &symbol, double lots) const
+{
+    const Instrument *instrument = find(symbol);
+    if (!instrument) {
+        const InstrumentSpec &spec = inferred(symbol);
+        lots = std::max(lots, spec.minQuantity);
+        return spec.maxQuantity > 0.0 ? std::min(lots, spec.maxQuantity) : lots;
+    }
+    const InstrumentSpec &spec = instrument->spec;
+    if (spec.quantityStep > 0.0) {
+        lots = std::floor(lots / spec.quantityStep + 1e-9) * spec.quantityStep;
+    }
+    if (lots < spec.minQuantity) lots = spec.minQuantity;
+    if (spec.maxQuantity > 0.0 && lots > spec.maxQuantity) lots = spec.maxQuantity;
+    return lots;
+}
+
+InstrumentSpec InstrumentRegistry::inferSpec(const QString &symbol)
+{
+    InstrumentSpec spec;
+    spec.symbol = symbol;
+    spec.instrumentClass = InstrumentClass::CRYPTO_PERP;
+    spec.contractSize = 1.0;
+    spec.tickSize = 0.01;
+    spec.pipSize = 1.0; // crypto: the strategy's "pips" are whole price units
+    spec.minQuantity = 0.001;
+    spec.maxQuantity = 1000.0;
+    spec.quantityStep = 0.001;
+    spec.shortOptionMarginRate = 0.0;
+
+    QString upper = symbol.toUpper();
+    QString base = upper.left(3);
+    QString quote = upper.mid(3);
+
+    if (upper.endsWith("-C") || upper.endsWith("-P")) {
+        // Deribit style: BTC-27DEC24-50000-C
+        spec.instrumentClass = InstrumentClass::OPTION;
+        base = upper.section('-', 0, 0);
+        quote = "USD";
+        spec.underlying = base + "USD";
+        spec.contractSize = 1.0;
+        spec.quantityStep = 0.1;
+        spec.minQuantity = 0.1;
+        spec.shortOptionMarginRate = 0.15;
+    } else if (upper.length() == 6 && FIAT_CURRENCIES.contains(base) && FIAT_CURRENCIES.contains(quote)) {
+        spec.instrumentClass = InstrumentClass::FOREX;
+        spec.contractSize = 100000.0;
+        spec.pipSize = quote == "JPY" ? 0.01 : 0.0001;
+        spec.tickSize = spec.pipSize / 10.0;
+        spec.minQuantity = 0.01;
+        spec.maxQuantity = 100.0;
+        spec.quantityStep = 0.01;
+        spec.leverageTiers.push_back({0.0, 30.0});
+    } else if (base == "XAU" || base == "XAG") {
+        spec.instrumentClass = InstrumentClass::CFD;
+        spec.contractSize = base == "XAU" ? 100.0 : 5000.0;
+        spec.pipSize = base == "XAU" ? 0.1 : 0.01;
+        spec.tickSize = spec.pipSize / 10.0;
+        spec.minQuantity = 0.01;
+        spec.maxQuantity = 100.0;
+        spec.quantityStep = 0.01;
+        spec.leverageTiers.push_back({0.0, 20.0});
+    } else {
+        for (const QString &stable : STABLECOINS) {
+            if (upper.endsWith(stable) && upper.length() > stable.length()) {
+                spec.instrumentClass = InstrumentClass::CRYPTO_SPOT;
+                base = upper.left(upper.length() - stable.length());
+                quote = stable;
+            }
+        }
+        if (upper.endsWith("-PERPETUAL")) {
+            base = upper.section('-', 0, 0);
+            quote = "USD";
+        } else if (spec.instrumentClass == InstrumentClass::CRYPTO_PERP && upper.endsWith("USD")) {
+            base = upper.left(upper.length() - 3);
+            quote = "USD";
+        }
+        if (spec.instrumentClass == InstrumentClass::CRYPTO_PERP) {
+            spec.leverageTiers.push_back({0.0, 20.0});
+        }
+    }
+
+    spec.baseCurrency = base;
+    spec.quoteCurrency = quote;
+    spec.tickValue = spec.tickSize * spec.contractSize;
+    return spec;
+}
+
+InstrumentClass InstrumentRegistry::classFromString(const QString &name)
+{
+    QString lower = name.toLower();
+    if (lower == "forex" || lower == "fx") return InstrumentClass::FOREX;
+    if (lower == "cfd" || lower == "metal") return InstrumentClass::CFD;
+    if (lower == "crypto_spot" || lower == "spot") return InstrumentClass::CRYPTO_SPOT;
+    if (lower == "option") return InstrumentClass::OPTION;
+    return InstrumentClass::CRYPTO_PERP;
+}
+
+const InstrumentRegistry::Instrument *InstrumentRegistry::find(const QString &symbol) const
+{
+    auto it = m_index.constFind(symbol);
+    return it != m_index.constEnd() ? m_instruments[it.value()].get() : nullptr;
+}
+
+void InstrumentRegistry::resolveLinks()
+{
+    // Load time only: link each instrument to the pair that converts its quote currency
+    for (auto &instrument : m_instruments) {
+        const QString &quote = instrument->spec.quoteCurrency;
+        instrument->conversionIndex = -1;
+        instrument->invertConversion = false;
+        instrument->underlyingIndex = m_index.value(instrument->spec.underlying, -1);
+
+        bool stable = STABLECOINS.contains(quote) && m_accountCurrency == "USD";
+        if (quote.isEmpty() || quote == m_accountCurrency || stable) continue;
+
+        int direct = m_index.value(quote + m_accountCurrency, -1);
+        if (direct >= 0) {
+            instrument->conversionIndex = direct;
+            continue;
+        }
+        int inverse = m_index.value(m_accountCurrency + quote, -1);
+        if (inverse >= 0) {
+            instrument->conversionIndex = inverse;
+            instrument->invertConversion = true;
+        }
+    }
+}
+
+double InstrumentRegistry::markOf(const Instrument &instrument, double price) const
+{
+    return price > 0.0 ? price : instrument.mark.load(std::memory_order_relaxed);
+}
+
+double InstrumentRegistry::conversionOf(const Instrument &instrument) const
+{
+    if (instrument.conversionIndex < 0) return 1.0;
+    double rate = m_instruments[instrument.conversionIndex]->mark.load(std::memory_order_relaxed);
+    if (rate <= 0.0) return 1.0; // no quote yet
+    return instrument.invertConversion ? 1.0 / rate : rate;
+}
+
+double InstrumentRegistry::marginFor(const Instrument &instrument, double lots, double price, bool shortPosition) const
+{
+    const InstrumentSpec &spec = instrument.spec;
+    const double conversion = conversionOf(instrument);
+    const double notionalValue = lots * spec.contractSize * price * conversion;
+
+    switch (spec.instrumentClass) {
+        case InstrumentClass::OPTION: {
+            // Long: the premium. Short: premium plus a share of the underlying notional
+            if (!shortPosition) return notionalValue;
+            double underlying = instrument.underlyingIndex >= 0
+                ? m_instruments[instrument.underlyingIndex]->mark.load(std::memory_order_relaxed) : 0.0;
+            return notionalValue + spec.shortOptionMarginRate * lots * spec.contractSize * underlying * conversion;
+        }
+        case InstrumentClass::CRYPTO_SPOT:
+            if (spec.leverageTiers.empty()) return notionalValue;
+            break;
+        default:
+            break;
+    }
+    return notionalValue / leverageFor(spec, notionalValue);
+}
+
+double InstrumentRegistry::pipValueFor(const Instrument &instrument, double lots) const
+{
+    return lots * pipValuePerLot(instrument.spec) * conversionOf(instrument);
+}
+
+double InstrumentRegistry::pipValuePerLot(const InstrumentSpec &spec)
+{
+    // Quote currency per pip per lot, from the venue's tick value where there is one
+    if (spec.tickSize > 0.0 && spec.tickValue > 0.0) {
+        return spec.tickValue * (spec.pipSize / spec.tickSize);
+    }
+    return spec.pipSize * spec.contractSize;
+}
+
+const InstrumentSpec &InstrumentRegistry::inferred(const QString &symbol) const
+{
+    // Unknown symbols are inferred once; std::map keeps the returned reference valid
+    QMutexLocker locker(&m_inferredMutex);
+    auto it = m_inferred.find(symbol);
+    if (it == m_inferred.end()) {
+        it = m_inferred.emplace(symbol, inferSpec(symbol)).first;
+    }
+    return it->second;
+}
+
+double InstrumentRegistry::leverageFor(const InstrumentSpec &spec, double notional)
+{
+    if (spec.leverageTiers.empty()) return 1.0;
+    for (const auto &tier : spec.leverageTiers) {
+        if (tier.maxNotional <= 0.0 || notional <= tier.maxNotional) {
+            return std::max(1.0, tier.leverage);
+        }
+    }
+    return std::max(1.0, spec.leverageTiers.back().leverage);
+}
+
+InstrumentSpec InstrumentRegistry::specFromJson(const QString &symbol, const QJsonObject &json)
+{
+    InstrumentSpec spec = inferSpec(symbol);
+    if (json.contains("class")) spec.instrumentClass = classFromString(json["class"].toString());
+    if (json.contains("baseCurrency")) spec.baseCurrency = json["baseCurrency"].toString();
+    if (json.contains("quoteCurrency")) spec.quoteCurrency = json["quoteCurrency"].toString();
+    if (json.contains("contractSize")) spec.contractSize = json["contractSize"].toDouble();
+    if (json.contains("tickSize")) spec.tickSize = json["tickSize"].toDouble();
+    if (json.contains("pipSize")) spec.pipSize = json["pipSize"].toDouble();
+    if (json.contains("minQuantity")) spec.minQuantity = json["minQuantity"].toDouble();
+    if (json.contains("maxQuantity")) spec.maxQuantity = json["maxQuantity"].toDouble();
+    if (json.contains("quantityStep")) spec.quantityStep = json["quantityStep"].toDouble();
+    if (json.contains("underlying")) spec.underlying = json["underlying"].toString();
+    if (json.contains("shortOptionMarginRate")) spec.shortOptionMarginRate = json["shortOptionMarginRate"].toDouble();
+    spec.tickValue = json.contains("tickValue") ? json["tickValue"].toDouble() : spec.tickSize * spec.contractSize;
+
+    if (json.contains("leverageTiers")) {
+        spec.leverageTiers.clear();
+        for (const QJsonValue &value : json["leverageTiers"].toArray()) {
+            QJsonObject tier = value.toObject();
+            spec.leverageTiers.push_back({tier["maxNotional"].toDouble(), tier["leverage"].toDouble()});
+        }
+    } else if (json.contains("leverage")) {
+        spec.leverageTiers.clear();
+        spec.leverageTiers.push_back({0.0, json["leverage"].toDouble()});
+    }
+    return spec;
+}
@@ -0,0 +1,340 @@
+#include "KillSwitch.h"
+#include "OrderManager.h"
+#include "RiskManager.h"
+#include "LatencyHistogram.h"
+
+KillSwitch::KillSwitch(QObject *parent)
+    : QObject(parent)
+    , m_orderManager(nullptr)
+    , m_riskManager(nullptr)
+    , m_armed(false)
+    , m_engaged(false)
+    , m_flatten(true)
+    , m_ackTimeoutMs(DEFAULT_ACK_TIMEOUT_MS)
+    , m_triggerNs(0)
+    , m_timeoutTimer(new QTimer(this))
+    , m_idGenerator("KS")
+{
+    m_report.complete = false;
+    m_report.timedOut = false;
+    m_report.gateClosedUs = -1.0;
+    m_report.dispatchUs = -1.0;
+    m_timeoutTimer->setSingleShot(true);
+    m_timeoutTimer->setInterval(m_ackTimeoutMs);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &KillSwitch::onAckTimeout);
+}
+
+void KillSwitch::loadConfig(const QJsonObject &config)
+{
+    QJsonObject risk = config["risk"].toObject();
+    if (risk.contains("emergencyStop")) setArmed(risk["emergencyStop"].toBool());
+    QJsonObject options = risk["killSwitch"].toObject();
+    if (options.contains("flattenPositions")) setFlattenOnTrigger(options["flattenPositions"].toBool());
+    if (options.contains("ackTimeoutMs")) setAckTimeout(options["ackTimeoutMs"].toInt());
+}
+
+void KillSwitch::setArmed(bool armed)
+{
+    m_armed.store(armed, std::memory_order_release);
+}
+
+void KillSwitch::setFlattenOnTrigger(bool flatten)
+{
+    QMutexLocker locker(&m_mutex);
+    m_flatten = flatten;
+}
+
+void KillSwitch::setAckTimeout(int ms)
+{
+    if (ms <= 0) return;
+    QMutexLocker locker(&m_mutex);
+    m_ackTimeoutMs = ms;
+    m_timeoutTimer->setInterval(ms);
+}
+
+void KillSwitch::setOrderManager(OrderManager *orderManager)
+{
+    m_orderManager = orderManager;
+}
+
+void KillSwitch::setRiskManager(RiskManager *riskManager)
+{
+    if (m_riskManager) {
+        QObject::disconnect(m_riskManager, nullptr, this, nullptr);
+    }
+    m_riskManager = riskManager;
+    if (m_riskManager) {
+        // Direct: the gate closes in the same call stack as the breach, not a later event-loop turn.
+        // Only the loss limits trip it; the trade count limit just stops new entries in RiskManager
+        connect(m_riskManager, &RiskManager::riskLimitReached, this, [this](const QString &type) {
+            const bool lossLimit = type == RiskManager::breachReason(BREACH_DAILY_RISK)
+                                   || type == RiskManager::breachReason(BREACH_DRAWDOWN);
+            if (lossLimit && isArmed()) trigger(type);
+        }, Qt::DirectConnection);
+    }
+}
+
+int KillSwitch::addVenue(ExchangeConnector *connector, bool primary)
+{
+    QMutexLocker locker(&m_mutex);
+    int index = static_cast<int>(m_venues.size());
+    Venue venue;
+    venue.connector = connector;
+    venue.primary = primary;
+    m_venues.push_back(venue);
+    connect(connector, &ExchangeConnector::allOrdersCancelled, this, [this, index](int count) {
+        onCancelAcknowledged(index, count);
+    }, Qt::DirectConnection);
+    connect(connector, &ExchangeConnector::cancelAllFailed, this, [this, index](const QString &error) {
+        if (isEngaged()) failVenue(index, "Cancel-all failed: " + error);
+    }, Qt::DirectConnection);
+    connect(connector, &ExchangeConnector::orderFilled, this, [this, index](const OrderResponse &response) {
+        onVenueFill(index, response);
+    }, Qt::DirectConnection);
+    return index;
+}
+
+KillSwitchReport KillSwitch::lastReport() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_report;
+}
+
+void KillSwitch::trigger(const QString &reason)
+{
+    bool expected = false;
+    if (!m_engaged.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+    const qint64 triggerNs = LatencyClock::nowNs();
+
+    // Nothing new reaches a venue from here on
+    if (m_orderManager) m_orderManager->setOrderGateOpen(false);
+    const qint64 gateNs = LatencyClock::nowNs();
+
+    int venueCount = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_triggerNs = triggerNs;
+        m_report = KillSwitchReport();
+        m_report.reason = reason;
+        m_report.triggeredAt = QDateTime::currentDateTime();
+        m_report.gateClosedUs = (gateNs - triggerNs) / 1000.0;
+        m_report.dispatchUs = -1.0;
+        m_report.complete = false;
+        m_report.timedOut = false;
+        for (auto &venue : m_venues) {
+            VenueKillReport entry;
+            entry.venue = venue.connector->getExchangeName();
+            entry.cancelSent = false;
+            entry.cancelAcknowledged = false;
+            entry.cancelledOrders = 0;
+            entry.cancelAckMs = -1.0;
+            entry.flattenOrders = 0;
+            entry.flattenFills = 0;
+            entry.flattenAckMs = -1.0;
+            m_report.venues.push_back(entry);
+            venue.pendingFlatten.clear();
+        }
+        venueCount = static_cast<int>(m_venues.size());
+    }
+    emit engaged(reason);
+
+    // Every cancel-all goes out before any ack is awaited; a connector on another
+    // thread runs its own in parallel
+    for (int i = 0; i < venueCount; ++i) {
+        QMetaObject::invokeMethod(m_venues[i].connector, [this, i]() { dispatchCancel(i); }, Qt::AutoConnection);
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_report.dispatchUs = (LatencyClock::nowNs() - triggerNs) / 1000.0;
+    }
+    QMetaObject::invokeMethod(this, [this]() { m_timeoutTimer->start(); }, Qt::AutoConnection);
+    finishIfDone();
+}
+
+void KillSwitch::reset()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto &venue : m_venues) {
+            venue.pendingFlatten.clear();
+        }
+    }
+    QMetaObject::invokeMethod(this, [this]() { m_timeoutTimer->stop(); }, Qt::AutoConnection);
+    m_engaged.store(false, std::memory_order_release);
+    if (m_orderManager) m_orderManager->setOrderGateOpen(true);
+}
+
+void KillSwitch::dispatchCancel(int index)
+{
+    // Runs in the connector's thread
+    if (!isEngaged()) return;
+    ExchangeConnector *connector = m_venues[index].connector;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_report.venues[index].cancelSent = true;
+    }
+    if (!connector->cancelAllOrders()) {
+        failVenue(index, connector->isConnected() ? "Cancel-all not supported or rejected" : "Venue not connected");
+    }
+}
+
+void KillSwitch::onCancelAcknowledged(int index, int count)
+{
+    if (!isEngaged()) return;
+    QString venueName;
+    double ackMs = elapsedMs();
+    bool flatten = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        VenueKillReport &entry = m_report.venues[index];
+        if (entry.cancelAcknowledged) return;
+        entry.cancelAcknowledged = true;
+        entry.cancelledOrders = count;
+        entry.cancelAckMs = ackMs;
+        venueName = entry.venue;
+        flatten = m_flatten;
+    }
+    emit venueAcknowledged(venueName, ackMs);
+    if (flatten) flattenVenue(index);
+    finishIfDone();
+}
+
+void KillSwitch::flattenVenue(int index)
+{
+    // Runs where the ack arrived, i.e. the connector's thread
+    ExchangeConnector *connector = m_venues[index].connector;
+    std::vector<Position> positions = connector->getPositions();
+    if (positions.empty() && m_venues[index].primary && m_riskManager) {
+        positions = m_riskManager->getOpenPositions();
+    }
+
+    std::vector<OrderRequest> orders;
+    for (const Position &position : positions) {
+        if (!position.isOpen || position.size <= 0.0) continue;
+        OrderRequest request;
+        request.symbol = position.symbol;
+        request.type = OrderType::MARKET;
+        request.side = position.side == "SELL" ? OrderSide::BUY : OrderSide::SELL;
+        request.quantity = position.size;
+        request.price = position.currentPrice;
+        request.stopPrice = 0.0;
+        request.timeInForce = TimeInForce::GTC;
+        request.clientOrderId = m_idGenerator.next();
+        request.metadata["reduceOnly"] = true;
+        request.feedTimeNs = 0;
+        request.signalTimeNs = 0;
+        request.riskPassTimeNs = 0;
+        orders.push_back(request);
+    }
+
+    QString venueName;
+    double ackMs = -1.0;
+    {
+        // Registered before sending so a fill reported synchronously is still matched
+        QMutexLocker locker(&m_mutex);
+        VenueKillReport &entry = m_report.venues[index];
+        for (const auto &request : orders) {
+            m_venues[index].pendingFlatten.insert(request.clientOrderId);
+        }
+        entry.flattenOrders = static_cast<int>(orders.size());
+        if (orders.empty()) entry.flattenAckMs = entry.cancelAckMs;
+        venueName = entry.venue;
+        ackMs = entry.flattenAckMs;
+    }
+    if (orders.empty()) {
+        // Nothing open on this venue: flat as of the cancel ack
+        emit venueFlattened(venueName, ackMs);
+        return;
+    }
+
+    for (const auto &request : orders) {
+        // Through OrderManager, past its closed gate, so the flatten is audited and journaled
+        // and its fills reach the risk book like any other
+        const QString orderId = m_orderManager ? m_orderManager->submitFlattenOrder(request, connector)
+                                               : connector->placeOrder(request);
+        if (orderId.isEmpty()) {
+            failVenue(index, "Flatten order rejected for " + request.symbol);
+        }
+    }
+}
+
+void KillSwitch::onVenueFill(int index, const OrderResponse &response)
+{
+    if (!isEngaged()) return;
+    QString venueName;
+    double ackMs = -1.0;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto &pending = m_venues[index].pendingFlatten;
+        if (pending.erase(response.clientOrderId) == 0) return;
+        VenueKillReport &entry = m_report.venues[index];
+        entry.flattenFills++;
+        if (!pending.empty()) return;
+        entry.flattenAckMs = elapsedMs();
+        venueName = entry.venue;
+        ackMs = entry.flattenAckMs;
+    }
+    emit venueFlattened(venueName, ackMs);
+    finishIfDone();
+}
+
+void KillSwitch::failVenue(int index, const QString &error)
+{
+    QString venueName;
+    {
+        QMutexLocker locker(&m_mutex);
+        VenueKillReport &entry = m_report.venues[index];
+        if (!entry.error.isEmpty()) return;
+        entry.error = error;
+        venueName = entry.venue;
+    }
+    emit venueFailed(venueName, error);
+    finishIfDone();
+}
+
+void KillSwitch::onAckTimeout()
+{
+    std::vector<std::pair<QString, QString>> failures;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_report.complete || !isEngaged()) return;
+        const QString timeout = QString("No acknowledgement within %1 ms").arg(m_ackTimeoutMs);
+        for (size_t i = 0; i < m_report.venues.size(); ++i) {
+            VenueKillReport &entry = m_report.venues[i];
+            bool flattened = !m_flatten || entry.flattenAckMs >= 0.0;
+            if (entry.error.isEmpty() && (!entry.cancelAcknowledged || !flattened)) {
+                entry.error = timeout;
+                failures.push_back(std::make_pair(entry.venue, timeout));
+            }
+        }
+        m_report.timedOut = true;
+    }
+    for (const auto &failure : failures) {
+        emit venueFailed(failure.first, failure.second);
+    }
+    finishIfDone();
+}
+
+void KillSwitch::finishIfDone()
+{
+    KillSwitchReport report;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_report.complete || m_report.dispatchUs < 0.0) return;
+        for (const auto &entry : m_report.venues) {
+            if (!entry.error.isEmpty()) continue;
+            if (!entry.cancelAcknowledged) return;
+            if (m_flatten && entry.flattenAckMs < 0.0) return;
+        }
+        m_report.complete = true;
+        report = m_report;
+    }
+    // The switch stays engaged (gate closed) until reset()
+    QMetaObject::invokeMethod(this, [this]() { m_timeoutTimer->stop(); }, Qt::AutoConnection);
+    emit completed(report);
+}
+
+double KillSwitch::elapsedMs() const
+{
+    return (LatencyClock::nowNs() - m_triggerNs) / 1e6;
+}
@@ -0,0 +1,138 @@
+#include "LatencyProbe.h"
+#include <memory>
+#include <mutex>
+
+std::atomic<bool> LatencyProbes::s_enabled(true);
+
+struct ProbeSet {
+    LatencyHistogram stages[LatencyProbes::STAGE_COUNT];
+    std::atomic<bool> claimed;
+};
+
+static std::unique_ptr<ProbeSet> s_sets[LatencyProbes::MAX_THREADS];
+static std::atomic<int> s_setCount(0);
+// Shared by threads beyond MAX_THREADS: still lock-free, only contended
+static ProbeSet s_overflow;
+
+static std::mutex &registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+static ProbeSet *claimSet()
+{
+    // Slow path, once per thread: reuse a set released by an exited thread, else add one
+    std::lock_guard<std::mutex> lock(registryMutex());
+    int count = s_setCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        bool expected = false;
+        if (s_sets[i]->claimed.compare_exchange_strong(expected, true)) return s_sets[i].get();
+    }
+    if (count >= LatencyProbes::MAX_THREADS) return &s_overflow;
+    s_sets[count].reset(new ProbeSet);
+    s_sets[count]->claimed.store(true, std::memory_order_relaxed);
+    s_setCount.store(count + 1, std::memory_order_release);
+    return s_sets[count].get();
+}
+
+// Hands the set back when its thread exits; the counts stay in it
+struct ProbeThreadSet {
+    ProbeSet *set = nullptr;
+    ~ProbeThreadSet()
+    {
+        if (set && set != &s_overflow) set->claimed.store(false, std::memory_order_release);
+    }
+};
+
+static thread_local ProbeThreadSet t_set;
+
+LatencyHistogram &LatencyProbes::threadHistogram(ProbeStage stage)
+{
+    if (!t_set.set) t_set.set = claimSet();
+    return t_set.set->stages[static_cast<int>(stage)];
+}
+
+void LatencyProbes::merged(ProbeStage stage, LatencyHistogram &out)
+{
+    const int index = static_cast<int>(stage);
+    const int count = s_setCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        out.merge(s_sets[i]->stages[index]);
+    }
+    out.merge(s_overflow.stages[index]);
+}
+
+LatencyHistogram::Summary LatencyProbes::summary(ProbeStage stage)
+{
+    LatencyHistogram total;
+    merged(stage, total);
+    return total.summary();
+}
+
+int LatencyProbes::threadCount()
+{
+    return s_setCount.load(std::memory_order_acquire);
+}
+
+void LatencyProbes::reset()
+{
+    // Concurrent probes may land either side of the reset; counts stay non-negative
+    const int count = s_setCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        for (auto &histogram : s_sets[i]->stages) histogram.reset();
+    }
+    for (auto &histogram : s_overflow.stages) histogram.reset();
+}
+
+QString LatencyProbes::stageName(ProbeStage stage)
+{
+    switch (stage) {
+    case ProbeStage::FEED_DECODE: return "feed_decode";
+    case ProbeStage::BRICK_FORMATION: return "brick_formation";
+    case ProbeStage::PATTERN_MATCH: return "pattern_match";
+    case ProbeStage::RISK_CHECK: return "risk_check";
+    case ProbeStage::ORDER_SEND: return "order_send";
+    }
+    return "unknown";
+}
+
+QJsonObject LatencyProbes::toJson()
+{
+    QJsonObject root;
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        const ProbeStage stage = static_cast<ProbeStage>(s);
+        LatencyHistogram::Summary sum = summary(stage);
+        if (sum.count == 0) continue;
+        QJsonObject stageObject;
+        stageObject["count"] = static_cast<qint64>(sum.count);
+        stageObject["minNs"] = static_cast<qint64>(sum.min);
+        stageObject["meanNs"] = sum.mean;
+        stageObject["p50Ns"] = static_cast<qint64>(sum.p50);
+        stageObject["p90Ns"] = static_cast<qint64>(sum.p90);
+        stageObject["p99Ns"] = static_cast<qint64>(sum.p99);
+        stageObject["p999Ns"] = static_cast<qint64>(sum.p999);
+        stageObject["maxNs"] = static_cast<qint64>(sum.max);
+        root[stageName(stage)] = stageObject;
+    }
+    root["threads"] = threadCount();
+    return root;
+}
+
+QString LatencyProbes::report()
+{
+    QString text;
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        const ProbeStage stage = static_cast<ProbeStage>(s);
+        LatencyHistogram::Summary sum = summary(stage);
+        if (sum.count == 0) continue;
+        text += QString("%1: n=%2 p50=%3us p99=%4us p99.9=%5us max=%6us\n")
+            .arg(stageName(stage))
+            .arg(static_cast<qint64>(sum.count))
+            .arg(sum.p50 / 1000.0, 0, 'f', 2)
+            .arg(sum.p99 / 1000.0, 0, 'f', 2)
+            .arg(sum.p999 / 1000.0, 0, 'f', 2)
+            .arg(sum.max / 1000.0, 0, 'f', 2);
+    }
+    return text;
+}
@@ -1,15 +1,88 @@
 #include "Logger.h"
-#include <QThread>
-#include <QQueue>
-#include <QTimer>
 #include <QFileInfo>
 #include <QFile>
+#include <QDir>
+#include "Crc32.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+static std::atomic<quint64> s_nextInstanceId(1);
+
+static_assert(sizeof(char16_t) == sizeof(QChar), "log records copy QChar data verbatim");
+
+// gzip member around the raw deflate stream inside qCompress's output
+// (4-byte length prefix, 2-byte zlib header, deflate data, 4-byte Adler-32)
+static bool gzipFile(const QString &sourcePath, const QString &targetPath)
+{
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly)) return false;
+    const QByteArray data = source.readAll();
+    source.close();
+    const QByteArray zlib = qCompress(data, 6);
+    if (zlib.size() < 10) return false;
+
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    static const char header[10] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff' };
+    const quint32 crc = Crc32::compute(data.constData(), static_cast<size_t>(data.size()));
+    const quint32 size = static_cast<quint32>(data.size());
+    const char trailer[8] = { static_cast<char>(crc), static_cast<char>(crc >> 8), static_cast<char>(crc >> 16),
+                              static_cast<char>(crc >> 24), static_cast<char>(size), static_cast<char>(size >> 8),
+                              static_cast<char>(size >> 16), static_cast<char>(size >> 24) };
+    bool ok = target.write(header, sizeof(header)) == sizeof(header);
+    ok = ok && target.write(zlib.constData() + 6, zlib.size() - 10) == zlib.size() - 10;
+    ok = ok && target.write(trailer, sizeof(trailer)) == sizeof(trailer);
+    target.close();
+    if (!ok) QFile::remove(targetPath);
+    return ok;
+}
+
+// Closed segments of a log, oldest first (the timestamp in the name sorts chronologically)
+static QStringList closedSegments(const QString &livePath)
+{
+    QFileInfo info(livePath);
+    QDir dir(info.absolutePath());
+    const QString pattern = info.completeBaseName() + "-*." + info.suffix();
+    QStringList names = dir.entryList(QStringList{pattern, pattern + ".gz"}, QDir::Files, QDir::Name);
+    QStringList paths;
+    for (const QString &name : names) {
+        paths << dir.filePath(name);
+    }
+    return paths;
+}
 
 Logger::Logger(QObject *parent)
     : QObject(parent)
+    , m_level(LEVEL_INFO)
     , m_initialized(false)
+    , m_logSize(0)
     , m_workerThread(nullptr)
+    , m_ring(new LogRecord[RING_CAPACITY])
+    , m_tail(0)
+    , m_head(0)
+    , m_writerWaiting(false)
+    , m_stopping(false)
+    , m_dropped(0)
+    , m_reportedDropped(0)
+    , m_instanceId(s_nextInstanceId.fetch_add(1, std::memory_order_relaxed))
+    , m_threadBufferCount(0)
+    , m_binarySize(0)
+    , m_maxFileSize(DEFAULT_MAX_FILE_SIZE)
+    , m_maxFiles(DEFAULT_MAX_FILES)
+    , m_compress(true)
+    , m_rotateRequested(false)
+    , m_cachedSecond(-1)
 {
+    static_assert((RING_CAPACITY & (RING_CAPACITY - 1)) == 0, "ring capacity must be a power of two");
+    static_assert(sizeof(LogRecord) == RECORD_SIZE, "log record must fill its slot exactly");
+    for (int i = 0; i < RING_CAPACITY; ++i) {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_batch.reserve(MAX_BATCH * 128);
+    // One archive thread keeps compression, pruning and exports in submission order
+    m_archivePool.setMaxThreadCount(1);
+
     m_workerThread = QThread::create([this]() { this->processQueue(); });
     m_workerThread->start();
 }
@@ -17,14 +90,40 @@ Logger::Logger(QObject *parent)
 Logger::~Logger()
 {
     if (m_workerThread) {
-        m_workerThread->requestInterruption();
-        m_workerThread->quit();
+        m_stopping.store(true, std::memory_order_seq_cst);
+        {
+            QMutexLocker locker(&m_wakeMutex);
+            m_wakeCondition.wakeOne();
+        }
         m_workerThread->wait();
         delete m_workerThread;
     }
+    m_archivePool.waitForDone();
     if (m_logFile.isOpen()) {
         m_logFile.close();
     }
+    if (m_binaryFile.isOpen()) {
+        m_binaryFile.close();
+    }
+}
+
+void Logger::loadConfig(const QJsonObject &config)
+{
+    QJsonObject logging = config["logging"].toObject();
+    if (!logging["enabled"].toBool(true)) return;
+    setLevel(levelFromString(logging["level"].toString(), level()));
+    setRotation(static_cast<qint64>(logging["maxFileSize"].toDouble(DEFAULT_MAX_FILE_SIZE)),
+                logging["maxFiles"].toInt(DEFAULT_MAX_FILES), logging["compress"].toBool(true));
+    QString file = logging["file"].toString();
+    if (!file.isEmpty()) {
+        QDir().mkpath(QFileInfo(file).absolutePath());
+        initialize(file);
+    }
+    QString binaryFile = logging["binaryFile"].toString();
+    if (!binaryFile.isEmpty()) {
+        QDir().mkpath(QFileInfo(binaryFile).absolutePath());
+        openBinaryLog(binaryFile);
+    }
 }
 
 void Logger::initialize(const QString &logFilePath)
@@ -32,51 +131,344 @@ void Logger::initialize(const QString &logFilePath)
     QMutexLocker locker(&m_mutex);
     m_logFile.setFileName(logFilePath);
     if (m_logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
-        m_stream.setDevice(&m_logFile);
         m_initialized = true;
+        m_logSize = m_logFile.size();
     }
 }
 
-void Logger::info(const QString &message)    { enqueueLog("INFO", message); }
-void Logger::warning(const QString &message) { enqueueLog("WARNING", message); }
-void Logger::error(const QString &message)   { enqueueLog("ERROR", message); }
-void Logger::debug(const QString &message)   { enqueueLog("DEBUG", message); }
+void Logger::setRotation(qint64 maxFileSize, int maxFiles, bool compress)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxFileSize = maxFileSize;
+    m_maxFiles = std::max(1, maxFiles);
+    m_compress = compress;
+}
 
-void Logger::exportLogs(const QString &filePath)
+bool Logger::openBinaryLog(const QString &filePath)
 {
     QMutexLocker locker(&m_mutex);
-    if (m_logFile.isOpen()) m_stream.flush();
-    QFile::copy(m_logFile.fileName(), filePath);
+    if (m_binaryFile.isOpen()) m_binaryFile.close();
+    m_binaryFile.setFileName(filePath);
+    return openBinaryLocked();
+}
+
+bool Logger::openBinaryLocked()
+{
+    if (!m_binaryFile.open(QIODevice::ReadWrite)) return false;
+
+    BinaryLog::FileHeader header;
+    if (m_binaryFile.size() == 0) {
+        header = BinaryLog::fileHeader();
+        m_binaryFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    } else if (m_binaryFile.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header)
+               || !BinaryLog::isValidHeader(header)) {
+        m_binaryFile.close();
+        return false;
+    }
+    // Format ids are only stable within one process, so every run (and every segment)
+    // re-defines what it uses
+    m_binaryFile.seek(m_binaryFile.size());
+    m_binarySize = m_binaryFile.size();
+    m_formatsWritten.assign(BinaryLogFormats::MAX_FORMATS, false);
+    return true;
+}
+
+void Logger::info(const QString &message)    { write(LEVEL_INFO, message); }
+void Logger::warning(const QString &message) { write(LEVEL_WARNING, message); }
+void Logger::error(const QString &message)   { write(LEVEL_ERROR, message); }
+void Logger::debug(const QString &message)   { write(LEVEL_DEBUG, message); }
+
+Logger::LogLevel Logger::levelFromString(const QString &name, LogLevel fallback)
+{
+    const QString upper = name.trimmed().toUpper();
+    if (upper == "DEBUG") return LEVEL_DEBUG;
+    if (upper == "INFO") return LEVEL_INFO;
+    if (upper == "WARNING" || upper == "WARN") return LEVEL_WARNING;
+    if (upper == "ERROR") return LEVEL_ERROR;
+    return fallback;
+}
+
+void Logger::exportLogs(const QString &directory)
+{
+    {
+        QMutexLocker locker(&m_exportMutex);
+        m_pendingExports << directory;
+    }
+    m_rotateRequested.store(true, std::memory_order_seq_cst);
+    wakeWriter();
+}
+
+void Logger::enqueueLog(LogLevel level, const QString &message)
+{
+    // Claim a slot (bounded MPMC ring, used here with a single consumer)
+    quint64 pos = m_tail.load(std::memory_order_relaxed);
+    LogRecord *record;
+    for (;;) {
+        record = &m_ring[pos & (RING_CAPACITY - 1)];
+        quint64 sequence = record->sequence.load(std::memory_order_acquire);
+        qint64 diff = static_cast<qint64>(sequence - pos);
+        if (diff == 0) {
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // Full: the writer is behind, never block the caller
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    int length = std::min<int>(message.size(), TEXT_CAPACITY);
+    if (length < message.size() && message.at(length - 1).isHighSurrogate()) --length;
+    record->timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record->level = static_cast<quint8>(level);
+    record->length = static_cast<quint16>(length);
+    record->truncated = message.size() > TEXT_CAPACITY ? 1 : 0;
+    std::memcpy(record->text, message.constData(), length * sizeof(char16_t));
+    record->sequence.store(pos + 1, std::memory_order_seq_cst);
+
+    if (m_writerWaiting.load(std::memory_order_seq_cst)) {
+        wakeWriter();
+    }
 }
 
-void Logger::enqueueLog(const QString &level, const QString &message)
+void Logger::wakeWriter()
 {
-    QMutexLocker locker(&m_queueMutex);
-    QString logEntry = QString("[%1] %2: %3\n")
-        .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
-        .arg(level)
-        .arg(message);
-    m_logQueue.enqueue(logEntry);
+    QMutexLocker locker(&m_wakeMutex);
+    m_wakeCondition.wakeOne();
+}
+
+BinaryLogBuffer *Logger::registerThreadBuffer()
+{
+    // Slow path, once per thread
+    QMutexLocker locker(&m_bufferMutex);
+    const std::thread::id self = std::this_thread::get_id();
+    int count = m_threadBufferCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        if (m_bufferOwners[i] == self) return m_threadBuffers[i].get();
+    }
+    if (count >= MAX_THREAD_BUFFERS) return nullptr;
+    m_threadBuffers[count].reset(new BinaryLogBuffer(static_cast<quint32>(count)));
+    m_bufferOwners[count] = self;
+    m_threadBufferCount.store(count + 1, std::memory_order_release);
+    return m_threadBuffers[count].get();
 }
 
 void Logger::processQueue()
 {
-    while (!QThread::currentThread()->isInterruptionRequested()) {
-        QString entry;
-        {
-            QMutexLocker locker(&m_queueMutex);
-            if (!m_logQueue.isEmpty()) {
-                entry = m_logQueue.dequeue();
+    for (;;) {
+        if (drainBatch() > 0) continue;
+        if (m_stopping.load(std::memory_order_seq_cst)) {
+            // Producers are gone by now; flush whatever they left behind
+            while (drainBatch() > 0) {}
+            break;
+        }
+
+        // Announce the wait before re-checking the ring, so a producer that publishes
+        // in between either sees the flag or is seen by the re-check
+        QMutexLocker locker(&m_wakeMutex);
+        m_writerWaiting.store(true, std::memory_order_seq_cst);
+        const LogRecord &next = m_ring[m_head & (RING_CAPACITY - 1)];
+        if (next.sequence.load(std::memory_order_seq_cst) != m_head + 1
+            && !hasPendingRecords() && !m_rotateRequested.load(std::memory_order_seq_cst)
+            && !m_stopping.load(std::memory_order_seq_cst)) {
+            m_wakeCondition.wait(&m_wakeMutex, IDLE_WAIT_MS);
+        }
+        m_writerWaiting.store(false, std::memory_order_relaxed);
+    }
+}
+
+int Logger::drainBatch()
+{
+    QMutexLocker locker(&m_mutex);
+    m_batch.clear();
+    int count = 0;
+    while (count < MAX_BATCH) {
+        LogRecord &record = m_ring[m_head & (RING_CAPACITY - 1)];
+        if (record.sequence.load(std::memory_order_acquire) != m_head + 1) break;
+        appendEntry(record);
+        record.sequence.store(m_head + RING_CAPACITY, std::memory_order_release);
+        ++m_head;
+        ++count;
+    }
+    count += drainThreadBuffers();
+
+    const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped) {
+        m_batch.append(QString("[%1] WARNING: Logger buffers full, %2 entries dropped\n")
+                           .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
+                           .arg(dropped - m_reportedDropped)
+                           .toUtf8());
+        m_reportedDropped = dropped;
+    }
+
+    // One write per batch instead of a flush per entry
+    if (!m_batch.isEmpty() && m_initialized) {
+        if (m_maxFileSize > 0 && m_logSize > 0 && m_logSize + m_batch.size() > m_maxFileSize) rotateText();
+        m_logFile.write(m_batch);
+        m_logFile.flush();
+        m_logSize += m_batch.size();
+    }
+    if (!m_binaryBatch.empty()) {
+        const qint64 size = static_cast<qint64>(m_binaryBatch.size());
+        if (m_maxFileSize > 0 && m_binarySize > static_cast<qint64>(sizeof(BinaryLog::FileHeader))
+            && m_binarySize + size > m_maxFileSize) {
+            // The batch was framed against the old file's format table; keep it whole there
+            m_binaryFile.write(m_binaryBatch.data(), size);
+            m_binaryBatch.clear();
+            rotateBinary();
+        } else {
+            m_binaryFile.write(m_binaryBatch.data(), size);
+            m_binaryFile.flush();
+            m_binarySize += size;
+            m_binaryBatch.clear();
+        }
+    }
+    if (m_rotateRequested.exchange(false, std::memory_order_seq_cst)) handleRotationRequest();
+    return count;
+}
+
+void Logger::rotateText()
+{
+    // Writer thread, m_mutex held. A rename is all the writer pays; producers never wait
+    const QString segment = closeSegment(m_logFile);
+    m_initialized = m_logFile.open(QIODevice::WriteOnly | QIODevice::Append);
+    m_logSize = 0;
+    if (!segment.isEmpty()) archiveSegment(segment, m_logFile.fileName());
+}
+
+void Logger::rotateBinary()
+{
+    m_binaryFile.flush();
+    const QString segment = closeSegment(m_binaryFile);
+    openBinaryLocked();
+    if (!segment.isEmpty()) archiveSegment(segment, m_binaryFile.fileName());
+}
+
+void Logger::handleRotationRequest()
+{
+    // Close whatever has been written so exports see it as a closed segment
+    if (m_initialized && m_logSize > 0) rotateText();
+    if (m_binaryFile.isOpen() && m_binarySize > static_cast<qint64>(sizeof(BinaryLog::FileHeader))) rotateBinary();
+
+    QStringList directories;
+    {
+        QMutexLocker locker(&m_exportMutex);
+        directories.swap(m_pendingExports);
+    }
+    QStringList livePaths;
+    if (!m_logFile.fileName().isEmpty()) livePaths << m_logFile.fileName();
+    if (!m_binaryFile.fileName().isEmpty()) livePaths << m_binaryFile.fileName();
+
+    for (const QString &directory : directories) {
+        // Queued behind the compression of the segments closed above
+        m_archivePool.start([this, directory, livePaths]() {
+            QDir().mkpath(directory);
+            int copied = 0;
+            for (const QString &livePath : livePaths) {
+                for (const QString &segment : closedSegments(livePath)) {
+                    const QString target = QDir(directory).filePath(QFileInfo(segment).fileName());
+                    QFile::remove(target);
+                    if (QFile::copy(segment, target)) copied++;
+                }
             }
+            emit logsExported(directory, copied);
+        });
+    }
+}
+
+QString Logger::closeSegment(QFile &file)
+{
+    const QString livePath = file.fileName();
+    file.close();
+    QFileInfo info(livePath);
+    QString segment = QDir(info.absolutePath()).filePath(info.completeBaseName() + "-"
+        + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz") + "." + info.suffix());
+    if (!QFile::rename(livePath, segment)) segment.clear();
+    file.setFileName(livePath);
+    return segment;
+}
+
+void Logger::archiveSegment(const QString &segment, const QString &livePath)
+{
+    const bool compress = m_compress;
+    const int maxFiles = m_maxFiles;
+    m_archivePool.start([segment, livePath, compress, maxFiles]() {
+        if (compress && gzipFile(segment, segment + ".gz")) {
+            QFile::remove(segment);
         }
-        if (!entry.isEmpty()) {
-            QMutexLocker locker(&m_mutex);
-            if (m_initialized) {
-                m_stream << entry;
-                m_stream.flush();
+        QStringList segments = closedSegments(livePath);
+        for (int i = 0; i + maxFiles < segments.size(); ++i) {
+            QFile::remove(segments[i]);
+        }
+    });
+}
+
+int Logger::drainThreadBuffers()
+{
+    // Called with m_mutex held
+    const bool binary = m_binaryFile.isOpen();
+    const int buffers = m_threadBufferCount.load(std::memory_order_acquire);
+    int count = 0;
+    for (int i = 0; i < buffers; ++i) {
+        BinaryLogBuffer *buffer = m_threadBuffers[i].get();
+        for (int n = 0; n < MAX_BATCH; ++n) {
+            const BinaryLogRecord *record = buffer->peek();
+            if (!record) break;
+            const int formatId = record->formatId;
+            if (binary) {
+                if (formatId < BinaryLogFormats::MAX_FORMATS && !m_formatsWritten[formatId]) {
+                    BinaryLog::appendFormatFrame(m_binaryBatch, formatId, BinaryLogFormats::level(formatId),
+                                                 BinaryLogFormats::format(formatId));
+                    m_formatsWritten[formatId] = true;
+                }
+                m_binaryBatch.push_back(static_cast<char>(BinaryLog::FRAME_RECORD));
+                m_binaryBatch.append(reinterpret_cast<const char *>(record), sizeof(BinaryLogRecord));
+            } else {
+                std::string text = BinaryLog::render(BinaryLogFormats::format(formatId), *record);
+                appendLine(record->timestampNs / 1000000, record->level, text.data(), static_cast<int>(text.size()));
             }
-        } else {
-            QThread::msleep(20); // Sleep briefly if no log
+            buffer->release();
+            ++count;
         }
     }
-} 
\ No newline at end of file
+    return count;
+}
+
+bool Logger::hasPendingRecords() const
+{
+    const int buffers = m_threadBufferCount.load(std::memory_order_acquire);
+    for (int i = 0; i < buffers; ++i) {
+        if (!m_threadBuffers[i]->isEmpty()) return true;
+    }
+    return false;
+}
+
+void Logger::appendEntry(const LogRecord &record)
+{
+    QByteArray text = QString::fromUtf16(record.text, record.length).toUtf8();
+    if (record.truncated) text.append("...");
+    appendLine(record.timestampMs, record.level, text.constData(), text.size());
+}
+
+void Logger::appendLine(qint64 timestampMs, int level, const char *text, int length)
+{
+    const qint64 second = timestampMs / 1000;
+    if (second != m_cachedSecond) {
+        m_cachedStamp = QDateTime::fromSecsSinceEpoch(second).toString("yyyy-MM-dd hh:mm:ss").toUtf8();
+        m_cachedSecond = second;
+    }
+    const int millis = static_cast<int>(timestampMs % 1000);
+    const char fraction[5] = { '.', static_cast<char>('0' + millis / 100), static_cast<char>('0' + millis / 10 % 10),
+                               static_cast<char>('0' + millis % 10), '\0' };
+
+    m_batch.append('[');
+    m_batch.append(m_cachedStamp);
+    m_batch.append(fraction, 4);
+    m_batch.append("] ");
+    m_batch.append(BinaryLog::levelName(level));
+    m_batch.append(": ");
+    m_batch.append(text, length);
+    m_batch.append('\n');
+}
@@ -1,4 +1,5 @@
 #include "MainWindow.h"
+#include "DaemonClient.h"
 #include <QApplication>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
@@ -31,6 +32,7 @@
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_centralWidget(nullptr)
+    , m_daemon(nullptr)
     , m_tradingActive(false)
     , m_paperTradingMode(true)
     , m_paused(false)
@@ -87,7 +89,8 @@ MainWindow::~MainWindow()
 {
     saveConfiguration();
     
-    if (m_tradingActive) {
+    // An attached daemon keeps trading after the GUI goes away
+    if (m_tradingActive && !isAttached()) {
         onStopTrading();
     }
 }
@@ -128,22 +131,28 @@ void MainWindow::loadConfiguration()
 
 void MainWindow::saveConfiguration()
 {
+    // The daemon reads the same file, so only the settings edited here are replaced
     QJsonObject config;
+    QFile existing("config.json");
+    if (existing.open(QIODevice::ReadOnly)) {
+        config = QJsonDocument::fromJson(existing.readAll()).object();
+        existing.close();
+    }
     
     // Save current settings
-    QJsonObject trading;
+    QJsonObject trading = config["trading"].toObject();
     trading["defaultExchange"] = m_currentExchange;
     trading["defaultSymbol"] = m_currentSymbol;
     trading["paperTradingMode"] = m_paperTradingMode;
     config["trading"] = trading;
     
-    QJsonObject risk;
+    QJsonObject risk = config["risk"].toObject();
     risk["maxRiskPerTrade"] = m_maxRiskPerTrade;
     risk["maxDailyRisk"] = m_maxDailyRisk;
     risk["maxOpenPositions"] = m_maxOpenPositions;
     config["risk"] = risk;
     
-    QJsonObject capital;
+    QJsonObject capital = config["capital"].toObject();
     capital["totalCapital"] = m_currentEquity;
     config["capital"] = capital;
     
@@ -431,6 +440,7 @@ void MainWindow::setupPriceChart()
     m_chartWidget = new QWidget;
     QVBoxLayout *chartLayout = new QVBoxLayout(m_chartWidget);
     
+#ifdef MMT_HAVE_CHARTS
     // Create chart
     m_priceChart = new QChart;
     m_priceChart->setTitle("Live Price Chart");
@@ -465,6 +475,31 @@ void MainWindow::setupPriceChart()
     m_priceSeries->append(now.toMSecsSinceEpoch(), m_currentPrice);
     m_timeAxis->setRange(now.addSecs(-300), now.addSecs(60)); // Show last 5 minutes
     m_priceAxis->setRange(m_currentPrice - 500, m_currentPrice + 500);
+#else
+    QLabel *placeholder = new QLabel("Live chart unavailable: built without Qt Charts");
+    placeholder->setAlignment(Qt::AlignCenter);
+    placeholder->setMinimumHeight(300);
+    chartLayout->addWidget(placeholder);
+#endif
+}
+
+void MainWindow::appendPricePoint(double price)
+{
+#ifdef MMT_HAVE_CHARTS
+    QDateTime now = QDateTime::currentDateTime();
+    m_priceSeries->append(now.toMSecsSinceEpoch(), price);
+    
+    // Keep only last 100 points
+    if (m_priceSeries->count() > 100) {
+        m_priceSeries->removePoints(0, m_priceSeries->count() - 100);
+    }
+    
+    // Update chart axes
+    m_timeAxis->setRange(now.addSecs(-300), now.addSecs(60));
+    m_priceAxis->setRange(price - 500, price + 500);
+#else
+    Q_UNUSED(price)
+#endif
 }
 
 void MainWindow::simulateTrading()
@@ -492,19 +527,7 @@ void MainWindow::simulateTrading()
     }
     
     // Update chart
-    QDateTime now = QDateTime::currentDateTime();
-    m_priceSeries->append(now.toMSecsSinceEpoch(), m_currentPrice);
-    
-    // Keep only last 100 points
-    if (m_priceSeries->count() > 100) {
-        m_priceSeries->removePoints(0, m_priceSeries->count() - 100);
-    }
-    
-    // Update chart axes
-    m_timeAxis->setRange(now.addSecs(-300), now.addSecs(60));
-    double minPrice = m_currentPrice - 500;
-    double maxPrice = m_currentPrice + 500;
-    m_priceAxis->setRange(minPrice, maxPrice);
+    appendPricePoint(m_currentPrice);
     
     // Update price label
     m_priceLabel->setText(QString("$%1").arg(m_currentPrice, 0, 'f', 2));
@@ -514,12 +537,14 @@ void MainWindow::simulateTrading()
         simulateTradeSignal();
     }
     
+#ifdef MMT_HAVE_CHARTS
     // Update chart colors based on price movement
     if (priceChange > 0) {
         m_priceSeries->setColor(QColor(76, 175, 80)); // Green
     } else {
         m_priceSeries->setColor(QColor(244, 67, 54)); // Red
     }
+#endif
 }
 
 void MainWindow::simulateTradeSignal()
@@ -859,18 +884,15 @@ void MainWindow::onStartTrading()
 {
     if (m_tradingActive) return;
     
+    // The daemon's next status update flips the UI
+    if (isAttached()) {
+        m_daemon->sendCommand("start");
+        return;
+    }
+    
     m_tradingActive = true;
     m_paused = false;
-    
-    m_startButton->setEnabled(false);
-    m_stopButton->setEnabled(true);
-    m_tradingStatusLabel->setText("Running");
-    m_tradingStatusLabel->setStyleSheet("color: #4CAF50;");
-    
-    // Update connection status
-    m_connectionStatusLabel->setText("Connected");
-    m_connectionStatusLabel->setStyleSheet("color: #4CAF50;");
-    m_connectionIndicator->setStyleSheet("color: #4CAF50; font-size: 16px;");
+    setTradingState(true);
     
     // Start simulation
     m_simulationTimer->start();
@@ -892,18 +914,14 @@ void MainWindow::onStopTrading()
 {
     if (!m_tradingActive) return;
     
+    if (isAttached()) {
+        m_daemon->sendCommand("stop");
+        return;
+    }
+    
     m_tradingActive = false;
     m_paused = false;
-    
-    m_startButton->setEnabled(true);
-    m_stopButton->setEnabled(false);
-    m_tradingStatusLabel->setText("Stopped");
-    m_tradingStatusLabel->setStyleSheet("color: #f44336;");
-    
-    // Update connection status
-    m_connectionStatusLabel->setText("Disconnected");
-    m_connectionStatusLabel->setStyleSheet("color: #f44336;");
-    m_connectionIndicator->setStyleSheet("color: #f44336; font-size: 16px;");
+    setTradingState(false);
     
     // Stop simulation
     m_simulationTimer->stop();
@@ -918,6 +936,103 @@ void MainWindow::onStopTrading()
     statusBar()->showMessage("Trading stopped", 3000);
 }
 
+void MainWindow::setTradingState(bool active)
+{
+    const QString color = active ? "#4CAF50" : "#f44336";
+    m_startButton->setEnabled(!active);
+    m_stopButton->setEnabled(active);
+    m_tradingStatusLabel->setText(active ? "Running" : "Stopped");
+    m_tradingStatusLabel->setStyleSheet("color: " + color + ";");
+    
+    // Update connection status
+    m_connectionStatusLabel->setText(active ? "Connected" : "Disconnected");
+    m_connectionStatusLabel->setStyleSheet("color: " + color + ";");
+    m_connectionIndicator->setStyleSheet("color: " + color + "; font-size: 16px;");
+}
+
+bool MainWindow::isAttached() const
+{
+    return m_daemon && m_daemon->isConnected();
+}
+
+void MainWindow::attachToDaemon(const QString &socketName)
+{
+    if (!m_daemon) {
+        m_daemon = new DaemonClient(this);
+        connect(m_daemon, &DaemonClient::statusReceived, this, &MainWindow::onDaemonStatus);
+        connect(m_daemon, &DaemonClient::replyReceived, this, &MainWindow::onDaemonReply);
+        connect(m_daemon, &DaemonClient::connected, this, &MainWindow::onDaemonConnectionChanged);
+        connect(m_daemon, &DaemonClient::disconnected, this, &MainWindow::onDaemonConnectionChanged);
+        connect(m_daemon, &DaemonClient::errorOccurred, this, [this](const QString &error) {
+            m_logTextEdit->append(QString("[%1] %2").arg(QDateTime::currentDateTime().toString(), error));
+        });
+    }
+    
+    // Local simulation and daemon control are exclusive
+    m_simulationTimer->stop();
+    m_tradingActive = false;
+    setTradingState(false);
+    m_daemon->connectToDaemon(socketName);
+}
+
+void MainWindow::onDaemonConnectionChanged()
+{
+    const bool attached = isAttached();
+    m_logTextEdit->append(QString("[%1] %2 daemon %3")
+                         .arg(QDateTime::currentDateTime().toString(),
+                              attached ? "Attached to" : "Detached from", m_daemon->socketName()));
+    statusBar()->showMessage(attached ? "Attached to trading daemon" : "Trading daemon disconnected", 3000);
+    if (!attached) {
+        m_tradingActive = false;
+        setTradingState(false);
+        m_connectionStatusLabel->setText("Daemon offline");
+    }
+}
+
+void MainWindow::onDaemonStatus(const QJsonObject &status)
+{
+    const bool trading = status["trading"].toBool();
+    if (trading != m_tradingActive) {
+        m_tradingActive = trading;
+        setTradingState(trading);
+        m_logTextEdit->append(QString("[%1] Daemon trading %2")
+                             .arg(QDateTime::currentDateTime().toString(), trading ? "started" : "stopped"));
+    }
+    if (!status["connected"].toBool()) {
+        m_connectionStatusLabel->setText(status["connectionStatus"].toString("Disconnected"));
+        m_connectionStatusLabel->setStyleSheet("color: #f44336;");
+    }
+    
+    m_currentExchange = status["exchange"].toString(m_currentExchange);
+    m_currentSymbol = status["symbol"].toString(m_currentSymbol);
+    m_currentEquity = status["equity"].toDouble(m_currentEquity);
+    m_dailyPnL = status["dailyPnL"].toDouble();
+    m_openPositions = status["openPositions"].toInt();
+    m_totalTrades = status["dailyTrades"].toInt();
+    m_winRate = status["winRate"].toDouble();
+    m_riskUsed = status["riskUsed"].toDouble();
+    m_riskProgressBar->setValue(static_cast<int>(m_riskUsed));
+    
+    double price = status["price"].toDouble();
+    if (price > 0.0) {
+        m_currentPrice = price;
+        m_priceLabel->setText(QString("$%1").arg(m_currentPrice, 0, 'f', 2));
+        appendPricePoint(m_currentPrice);
+    }
+    if (status["killSwitch"].toBool()) {
+        m_tradingStatusLabel->setText("Kill switch");
+        m_tradingStatusLabel->setStyleSheet("color: #f44336; font-weight: bold;");
+    }
+    updateStatusLabels();
+}
+
+void MainWindow::onDaemonReply(const QString &cmd, const QJsonObject &reply)
+{
+    if (reply["ok"].toBool(true)) return;
+    m_logTextEdit->append(QString("[%1] Daemon refused %2: %3")
+                         .arg(QDateTime::currentDateTime().toString(), cmd, reply["error"].toString()));
+}
+
 void MainWindow::onSwitchToPaperTrading()
 {
     m_paperTradingMode = true;
@@ -962,8 +1077,10 @@ void MainWindow::onTradingModeChanged()
     m_logTextEdit->append(QString("[%1] Selected %2 on %3").arg(QDateTime::currentDateTime().toString(), m_currentSymbol, m_currentExchange));
     statusBar()->showMessage(QString("Selected %1 on %2").arg(m_currentSymbol, m_currentExchange), 3000);
     
+#ifdef MMT_HAVE_CHARTS
     // Update price chart title
     m_priceChart->setTitle(QString("%1 - %2").arg(m_currentSymbol, m_currentExchange));
+#endif
 }
 
 void MainWindow::onShowAbout()
@@ -1023,7 +1140,7 @@ void MainWindow::updateStatusLabels()
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
-    if (m_tradingActive) {
+    if (m_tradingActive && !isAttached()) {
         int ret = QMessageBox::question(this, "Exit Application",
             "Trading is currently active. Are you sure you want to exit?",
             QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
@@ -0,0 +1,145 @@
+#include "Metrics.h"
+#include "LatencyProbe.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+enum MetricKind {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_SUMMARY
+};
+
+struct MetricEntry {
+    MetricKind kind;
+    const char *name;
+    const char *help;
+    void *metric;
+};
+
+static MetricEntry s_entries[Metrics::MAX_METRICS];
+static std::atomic<int> s_entryCount(0);
+
+static const double QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+
+static std::mutex &registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+static void *registerMetric(MetricKind kind, const char *name, const char *help)
+{
+    // Startup path; the same name always maps to the same metric
+    std::lock_guard<std::mutex> lock(registryMutex());
+    int count = s_entryCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        if (std::strcmp(s_entries[i].name, name) == 0 && s_entries[i].kind == kind) return s_entries[i].metric;
+    }
+    void *metric = nullptr;
+    switch (kind) {
+    case METRIC_COUNTER: metric = new MetricCounter; break;
+    case METRIC_GAUGE: metric = new MetricGauge; break;
+    case METRIC_SUMMARY: metric = new LatencyHistogram; break;
+    }
+    // Past the limit the metric still works, it is just not exported
+    if (count >= Metrics::MAX_METRICS) return metric;
+    s_entries[count] = MetricEntry{kind, name, help, metric};
+    s_entryCount.store(count + 1, std::memory_order_release);
+    return metric;
+}
+
+MetricCounter &Metrics::counter(const char *name, const char *help)
+{
+    return *static_cast<MetricCounter *>(registerMetric(METRIC_COUNTER, name, help));
+}
+
+MetricGauge &Metrics::gauge(const char *name, const char *help)
+{
+    return *static_cast<MetricGauge *>(registerMetric(METRIC_GAUGE, name, help));
+}
+
+LatencyHistogram &Metrics::histogram(const char *name, const char *help)
+{
+    return *static_cast<LatencyHistogram *>(registerMetric(METRIC_SUMMARY, name, help));
+}
+
+static void appendValue(QByteArray &out, double value)
+{
+    char text[32];
+    if (std::isnan(value)) {
+        out.append("NaN");
+    } else if (std::isinf(value)) {
+        out.append(value > 0 ? "+Inf" : "-Inf");
+    } else {
+        std::snprintf(text, sizeof(text), "%.17g", value);
+        out.append(text);
+    }
+}
+
+static void appendHeader(QByteArray &out, const char *name, const char *help, const char *type)
+{
+    out.append("# HELP ").append(name).append(' ').append(help).append('\n');
+    out.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+}
+
+// Quantiles, sum and count of a nanosecond histogram, in seconds
+static void appendSummary(QByteArray &out, const char *name, const QByteArray &labels, const LatencyHistogram &h)
+{
+    const uint64_t count = h.count();
+    for (double quantile : QUANTILES) {
+        char label[24];
+        std::snprintf(label, sizeof(label), "quantile=\"%g\"", quantile);
+        out.append(name).append('{');
+        if (!labels.isEmpty()) out.append(labels).append(',');
+        out.append(label).append("} ");
+        appendValue(out, count ? h.percentile(quantile) / 1e9 : std::nan(""));
+        out.append('\n');
+    }
+    const QByteArray suffix = labels.isEmpty() ? QByteArray(" ") : "{" + labels + "} ";
+    out.append(name).append("_sum").append(suffix);
+    appendValue(out, h.mean() * count / 1e9);
+    out.append('\n');
+    out.append(name).append("_count").append(suffix);
+    out.append(QByteArray::number(static_cast<qulonglong>(count))).append('\n');
+}
+
+QByteArray Metrics::exposition()
+{
+    QByteArray out;
+    out.reserve(8192);
+    const int count = s_entryCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        const MetricEntry &entry = s_entries[i];
+        switch (entry.kind) {
+        case METRIC_COUNTER:
+            appendHeader(out, entry.name, entry.help, "counter");
+            out.append(entry.name).append(' ');
+            out.append(QByteArray::number(static_cast<qulonglong>(static_cast<MetricCounter *>(entry.metric)->value())));
+            out.append('\n');
+            break;
+        case METRIC_GAUGE:
+            appendHeader(out, entry.name, entry.help, "gauge");
+            out.append(entry.name).append(' ');
+            appendValue(out, static_cast<MetricGauge *>(entry.metric)->value());
+            out.append('\n');
+            break;
+        case METRIC_SUMMARY:
+            appendHeader(out, entry.name, entry.help, "summary");
+            appendSummary(out, entry.name, QByteArray(), *static_cast<LatencyHistogram *>(entry.metric));
+            break;
+        }
+    }
+
+    // Hot-path probe stages, merged across threads
+    const char *stageMetric = "mmt_stage_latency_seconds";
+    appendHeader(out, stageMetric, "Hot-path stage latency from the scoped probes", "summary");
+    for (int s = 0; s < LatencyProbes::STAGE_COUNT; ++s) {
+        const ProbeStage stage = static_cast<ProbeStage>(s);
+        LatencyHistogram merged;
+        LatencyProbes::merged(stage, merged);
+        appendSummary(out, stageMetric, "stage=\"" + LatencyProbes::stageName(stage).toLatin1() + "\"", merged);
+    }
+    return out;
+}
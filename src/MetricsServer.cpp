@@ -0,0 +1,111 @@
+#include "MetricsServer.h"
+#include "Metrics.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_enabled(false)
+    , m_address(QHostAddress::LocalHost)
+    , m_port(DEFAULT_PORT)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+void MetricsServer::loadConfig(const QJsonObject &config)
+{
+    QJsonObject metrics = config["metrics"].toObject();
+    m_enabled = metrics["enabled"].toBool(false);
+    m_port = static_cast<quint16>(metrics["port"].toInt(DEFAULT_PORT));
+    // Loopback unless configured otherwise; the endpoint has no authentication
+    m_address = QHostAddress(metrics["bindAddress"].toString("127.0.0.1"));
+}
+
+bool MetricsServer::start()
+{
+    return start(m_address, m_port);
+}
+
+bool MetricsServer::start(const QHostAddress &address, quint16 port)
+{
+    stop();
+    m_address = address;
+    m_port = port;
+    if (!m_server->listen(address, port)) {
+        emit serverError(QString("Metrics server cannot listen on %1:%2: %3")
+                             .arg(address.toString()).arg(port).arg(m_server->errorString()));
+        return false;
+    }
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    if (m_server->isListening()) m_server->close();
+}
+
+bool MetricsServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+quint16 MetricsServer::port() const
+{
+    return m_server->isListening() ? m_server->serverPort() : m_port;
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket *socket = m_server->nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void MetricsServer::onReadyRead(QTcpSocket *socket)
+{
+    // Headers are buffered in the socket until the blank line arrives
+    const QByteArray pending = socket->peek(MAX_REQUEST_BYTES);
+    if (!pending.contains("\r\n\r\n") && !pending.contains("\n\n")) {
+        if (pending.size() >= MAX_REQUEST_BYTES) {
+            socket->write(response("431 Request Header Fields Too Large", "text/plain", QByteArray()));
+            socket->disconnectFromHost();
+        }
+        return;
+    }
+    const QByteArray requestLine = socket->readLine().trimmed();
+    socket->readAll();
+
+    const QList<QByteArray> parts = requestLine.split(' ');
+    const QByteArray method = parts.value(0);
+    const QByteArray path = parts.value(1).split('?').value(0);
+    if (method != "GET" && method != "HEAD") {
+        socket->write(response("405 Method Not Allowed", "text/plain", "GET only\n"));
+    } else if (path == "/metrics") {
+        QByteArray reply = response("200 OK", "text/plain; version=0.0.4; charset=utf-8", Metrics::exposition());
+        if (method == "HEAD") reply.truncate(reply.indexOf("\r\n\r\n") + 4);
+        socket->write(reply);
+    } else {
+        socket->write(response("404 Not Found", "text/plain", "Try /metrics\n"));
+    }
+    socket->disconnectFromHost();
+}
+
+QByteArray MetricsServer::response(const QByteArray &status, const QByteArray &contentType, const QByteArray &body)
+{
+    QByteArray out;
+    out.reserve(body.size() + 128);
+    out.append("HTTP/1.0 ").append(status).append("\r\n");
+    out.append("Content-Type: ").append(contentType).append("\r\n");
+    out.append("Content-Length: ").append(QByteArray::number(body.size())).append("\r\n");
+    out.append("Connection: close\r\n\r\n");
+    out.append(body);
+    return out;
+}
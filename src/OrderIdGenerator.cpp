@@ -0,0 +1,27 @@
+#include "OrderIdGenerator.h"
+#include <chrono>
+#include <random>
+
+OrderIdGenerator::OrderIdGenerator(const char *tag)
+    : m_prefixLength(0)
+    , m_counter(0)
+{
+    for (int i = 0; tag && tag[i] && i < MAX_TAG_LENGTH; ++i) {
+        m_prefix[m_prefixLength++] = tag[i];
+    }
+
+    // 8 base36 digits of start time in ms (good until year 2059) + 2 digits of entropy,
+    // so two processes started in the same millisecond still get different sessions
+    uint64_t startMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    std::random_device entropy;
+    uint64_t session = (startMs % 2821109907456ULL) * 1296 + entropy() % 1296; // 36^8, 36^2
+
+    char digits[SESSION_LENGTH];
+    for (int i = SESSION_LENGTH - 1; i >= 0; --i) {
+        digits[i] = BASE36[session % 36];
+        session /= 36;
+    }
+    for (char digit : digits) m_prefix[m_prefixLength++] = digit;
+    m_prefix[m_prefixLength++] = '-';
+}
@@ -1,18 +1,87 @@
 #include "OrderManager.h"
 #include "ExchangeConnector.h"
+#include "Logger.h"
+#include "TradeJournal.h"
+#include "LatencyProbe.h"
+#include "Metrics.h"
+#include <algorithm>
+
+// Audit trail formats; arguments are stored raw and rendered by the log writer or decoder
+static const int AUDIT_ORDER_SENT = BinaryLogFormats::add(Logger::LEVEL_INFO, "Order %1 sent: %2 %3 %4 qty %5 @ %6");
+static const int AUDIT_ORDER_ACKED = BinaryLogFormats::add(Logger::LEVEL_INFO, "Order %1 acknowledged as %2 in %3 ns");
+static const int AUDIT_ORDER_HELD = BinaryLogFormats::add(Logger::LEVEL_WARNING, "Order %1 held: venue not connected");
+static const int AUDIT_ORDER_REJECTED = BinaryLogFormats::add(Logger::LEVEL_WARNING, "Order %1 rejected by venue");
+static const int AUDIT_ORDER_FILL = BinaryLogFormats::add(Logger::LEVEL_INFO, "Order %1 %2: filled %3 @ %4, commission %5");
+static const int AUDIT_ORDER_CANCEL = BinaryLogFormats::add(Logger::LEVEL_INFO, "Order %1 cancel requested");
+static const int AUDIT_ORDER_CANCELLED = BinaryLogFormats::add(Logger::LEVEL_INFO, "Order %1 cancelled by venue");
+static const int AUDIT_ORDER_MODIFY = BinaryLogFormats::add(Logger::LEVEL_INFO, "Order %1 modify to %2");
+static const int AUDIT_ORDER_BLOCKED = BinaryLogFormats::add(Logger::LEVEL_WARNING, "Order for %1 blocked: gate closed");
+
+static MetricCounter &METRIC_ORDERS_SENT = Metrics::counter("mmt_orders_sent_total", "Orders handed to the venue");
+static MetricCounter &METRIC_ORDERS_ACKED = Metrics::counter("mmt_orders_acked_total", "Orders acknowledged by the venue");
+static MetricCounter &METRIC_ORDERS_REJECTED = Metrics::counter("mmt_orders_rejected_total", "Orders rejected by a connected venue");
+static MetricCounter &METRIC_ORDERS_HELD = Metrics::counter("mmt_orders_held_total", "Orders held while the venue was unreachable");
+static MetricCounter &METRIC_ORDERS_BLOCKED = Metrics::counter("mmt_orders_blocked_total", "Orders refused by the closed order gate");
+static MetricCounter &METRIC_FILLS = Metrics::counter("mmt_fills_total", "Fill reports received");
+static LatencyHistogram &METRIC_ACK_LATENCY = Metrics::histogram("mmt_order_ack_latency_seconds", "Wire send to venue acknowledgement");
+
+static const char *const SIDE_NAMES[] = { "BUY", "SELL" };
+static const char *const TYPE_NAMES[] = { "MARKET", "LIMIT", "STOP", "STOP_LIMIT", "TRAILING_STOP", "ICEBERG" };
+static const char *const STATUS_NAMES[] = { "PENDING", "FILLED", "PARTIALLY_FILLED", "CANCELLED", "REJECTED", "EXPIRED" };
 
 OrderManager::OrderManager(QObject *parent)
     : QObject(parent)
     , m_exchangeConnector(nullptr)
     , m_tickBuffer(0)
     , m_pendingTicks(0)
+    , m_idGenerator("MM")
+    , m_telemetry(new ExecutionTelemetry(this))
+    , m_nextTimelineSweepNs(0)
+    , m_gateOpen(true)
+    , m_logger(nullptr)
+    , m_journal(nullptr)
 {
 }
 
 void OrderManager::setExchangeConnector(ExchangeConnector *connector)
 {
     QMutexLocker locker(&m_mutex);
+    if (m_exchangeConnector) {
+        QObject::disconnect(m_exchangeConnector, nullptr, this, nullptr);
+    }
     m_exchangeConnector = connector;
+    if (m_exchangeConnector) {
+        // Direct connections: sibling legs are cancelled in the same call stack as the fill,
+        // never deferred to a later event-loop turn or a UI timer
+        connect(m_exchangeConnector, &ExchangeConnector::orderAcknowledged,
+                this, &OrderManager::onConnectorOrderAcknowledged, Qt::DirectConnection);
+        connect(m_exchangeConnector, &ExchangeConnector::orderFilled,
+                this, &OrderManager::onConnectorOrderFilled, Qt::DirectConnection);
+        connect(m_exchangeConnector, &ExchangeConnector::orderCancelled,
+                this, &OrderManager::onConnectorOrderCancelled, Qt::DirectConnection);
+        connect(m_exchangeConnector, &ExchangeConnector::orderRejected,
+                this, &OrderManager::onConnectorOrderRejected, Qt::DirectConnection);
+        connect(m_exchangeConnector, &ExchangeConnector::connected,
+                this, &OrderManager::onConnectorConnected);
+    }
+}
+
+void OrderManager::setOrderGateOpen(bool open)
+{
+    // The flag goes first so concurrent placeOrder calls are refused before the lock is taken
+    m_gateOpen.store(open, std::memory_order_release);
+    if (open) return;
+    QMutexLocker locker(&m_mutex);
+    m_orderBuffer.clear();
+    m_unsentOrders.clear();
+    for (const auto &entry : m_bufferedEntries) {
+        auto bracket = m_brackets.find(entry.second);
+        if (bracket != m_brackets.end()) {
+            bracket->second.state = BracketState::CANCELLED;
+            journalBracket(bracket->second);
+        }
+    }
+    m_bufferedEntries.clear();
 }
 
 void OrderManager::setTickBuffer(int buffer)
@@ -24,6 +93,7 @@ void OrderManager::setTickBuffer(int buffer)
 void OrderManager::onTick()
 {
     QMutexLocker locker(&m_mutex);
+    if (!isOrderGateOpen()) return;
     if (m_tickBuffer > 0) {
         m_pendingTicks++;
         if (m_pendingTicks < m_tickBuffer) return;
@@ -32,7 +102,9 @@ void OrderManager::onTick()
     // Place all buffered orders
     for (const auto &order : m_orderBuffer) {
         if (m_exchangeConnector) {
-            QString orderId = m_exchangeConnector->placeOrder(order);
+            QString orderId = sendToVenue(order);
+            if (orderId.isEmpty()) continue;
+            linkBufferedEntry(order.clientOrderId, orderId);
             emit orderPlaced(orderId);
         }
     }
@@ -41,27 +113,96 @@ void OrderManager::onTick()
 
 void OrderManager::placeOrder(const QString &symbol, const QString &side, double quantity, double price)
 {
+    placeOrder(symbol, side, quantity, price, 0, 0);
+}
+
+void OrderManager::placeOrder(const QString &symbol, const QString &side, double quantity, double price,
+                              qint64 signalTimeNs, qint64 riskPassTimeNs)
+{
+    if (!isOrderGateOpen()) {
+        if (m_logger) m_logger->log(AUDIT_ORDER_BLOCKED, symbol);
+        METRIC_ORDERS_BLOCKED.increment();
+        emit orderBlocked(symbol, "Order gate closed");
+        return;
+    }
     QMutexLocker locker(&m_mutex);
     if (!m_exchangeConnector) return;
-    OrderRequest req;
-    req.symbol = symbol;
-    req.side = (side == "BUY") ? OrderSide::BUY : OrderSide::SELL;
-    req.type = OrderType::MARKET;
-    req.quantity = quantity;
-    req.price = price;
+    OrderRequest req = makeRequest(symbol, (side == "BUY") ? OrderSide::BUY : OrderSide::SELL,
+                                   OrderType::MARKET, quantity, price);
+    req.signalTimeNs = signalTimeNs;
+    req.riskPassTimeNs = riskPassTimeNs;
     if (m_tickBuffer > 0) {
         m_orderBuffer.push_back(req);
         return;
     }
-    QString orderId = m_exchangeConnector->placeOrder(req);
-    emit orderPlaced(orderId);
+    QString orderId = sendToVenue(req);
+    if (!orderId.isEmpty()) emit orderPlaced(orderId);
 }
 
-void OrderManager::cancelOrder(const QString &orderId)
+QString OrderManager::submitOrder(const OrderRequest &request, ExchangeConnector *venue, SubmitStatus *status)
+{
+    if (!isOrderGateOpen()) {
+        if (m_logger) m_logger->log(AUDIT_ORDER_BLOCKED, request.symbol);
+        METRIC_ORDERS_BLOCKED.increment();
+        if (status) *status = SubmitStatus::BLOCKED;
+        emit orderBlocked(request.symbol, "Order gate closed");
+        return QString();
+    }
+    return submitToVenue(request, venue, status);
+}
+
+QString OrderManager::submitFlattenOrder(const OrderRequest &request, ExchangeConnector *venue)
+{
+    // The one order allowed past a closed gate; it is audited and journaled like any other
+    return submitToVenue(request, venue);
+}
+
+QString OrderManager::submitToVenue(const OrderRequest &request, ExchangeConnector *venue, SubmitStatus *status)
 {
     QMutexLocker locker(&m_mutex);
-    if (m_exchangeConnector) {
-        m_exchangeConnector->cancelOrder(orderId);
+    if (status) *status = SubmitStatus::REJECTED;
+    if (!venue) venue = m_exchangeConnector;
+    if (!venue) return QString();
+    trackVenue(venue);
+    OrderRequest sent = request;
+    if (sent.clientOrderId.isEmpty()) sent.clientOrderId = m_idGenerator.next();
+    QString orderId = sendToVenue(sent, venue, status);
+    locker.unlock();
+    if (!orderId.isEmpty()) emit orderPlaced(orderId);
+    return orderId;
+}
+
+void OrderManager::trackVenue(ExchangeConnector *venue)
+{
+    // Called with m_mutex held. Reports from venues other than the primary one feed the same
+    // audit trail, journal and telemetry; they carry no brackets and are never resent
+    if (venue == m_exchangeConnector
+        || std::find(m_extraVenues.begin(), m_extraVenues.end(), venue) != m_extraVenues.end()) {
+        return;
+    }
+    m_extraVenues.push_back(venue);
+    connect(venue, &ExchangeConnector::orderAcknowledged, this, &OrderManager::onConnectorOrderAcknowledged,
+            Qt::DirectConnection);
+    connect(venue, &ExchangeConnector::orderFilled, this, &OrderManager::onConnectorOrderFilled, Qt::DirectConnection);
+    connect(venue, &ExchangeConnector::orderCancelled, this, &OrderManager::onConnectorOrderCancelled, Qt::DirectConnection);
+    connect(venue, &ExchangeConnector::orderRejected, this, &OrderManager::onConnectorOrderRejected, Qt::DirectConnection);
+    connect(venue, &QObject::destroyed, this, [this, venue]() {
+        QMutexLocker locker(&m_mutex);
+        m_extraVenues.erase(std::remove(m_extraVenues.begin(), m_extraVenues.end(), venue), m_extraVenues.end());
+    });
+}
+
+void OrderManager::cancelOrder(const QString &orderId, ExchangeConnector *venue)
+{
+    ExchangeConnector *connector = venue;
+    if (!connector) {
+        QMutexLocker locker(&m_mutex);
+        connector = m_exchangeConnector;
+    }
+    // The connector may report the cancel synchronously, which re-enters onConnectorOrderCancelled
+    if (connector) {
+        if (m_logger) m_logger->log(AUDIT_ORDER_CANCEL, orderId);
+        connector->cancelOrder(orderId);
         emit orderCancelled(orderId);
     }
 }
@@ -70,6 +211,598 @@ void OrderManager::modifyOrder(const QString &orderId, double newPrice)
 {
     QMutexLocker locker(&m_mutex);
     if (m_exchangeConnector) {
+        if (m_logger) m_logger->log(AUDIT_ORDER_MODIFY, orderId, newPrice);
         m_exchangeConnector->modifyOrder(orderId, newPrice);
     }
-} 
\ No newline at end of file
+}
+
+QString OrderManager::placeBracketOrder(const QString &symbol, const QString &side, double quantity, double price,
+                                        double stopLoss, double takeProfit)
+{
+    return submitBracket(symbol, side, quantity, price, stopLoss, takeProfit, 0, 0, 0);
+}
+
+QString OrderManager::placeBracketOrder(const TradingSignal &signal)
+{
+    if (!signal.isValid || signal.type == TradingSignal::CLOSE) return QString();
+    const bool isBuy = signal.type == TradingSignal::BUY;
+    double stopLoss = isBuy ? signal.price - signal.stopLoss : signal.price + signal.stopLoss;
+    double takeProfit = isBuy ? signal.price + signal.takeProfit : signal.price - signal.takeProfit;
+    return submitBracket(signal.symbol, isBuy ? "BUY" : "SELL", signal.lotSize, signal.price,
+                         stopLoss, takeProfit, signal.feedTimeNs, signal.signalTimeNs, signal.riskPassTimeNs);
+}
+
+QString OrderManager::submitBracket(const QString &symbol, const QString &side, double quantity, double price,
+                                    double stopLoss, double takeProfit, qint64 feedTimeNs, qint64 signalTimeNs,
+                                    qint64 riskPassTimeNs)
+{
+    if (!isOrderGateOpen()) {
+        if (m_logger) m_logger->log(AUDIT_ORDER_BLOCKED, symbol);
+        METRIC_ORDERS_BLOCKED.increment();
+        emit orderBlocked(symbol, "Order gate closed");
+        return QString();
+    }
+    QMutexLocker locker(&m_mutex);
+    if (!m_exchangeConnector) return QString();
+    if (!m_exchangeConnector->hasOrderUpdates()) {
+        // Nothing would report the exit legs filling, so nothing could cancel the sibling
+        const QString venue = m_exchangeConnector->getExchangeName();
+        locker.unlock();
+        emit bracketError(QString(), "No order updates from " + venue + "; bracket refused");
+        return QString();
+    }
+
+    BracketOrder bracket;
+    bracket.groupId = m_idGenerator.next();
+    bracket.symbol = symbol;
+    bracket.entrySide = (side == "BUY") ? OrderSide::BUY : OrderSide::SELL;
+    bracket.quantity = quantity;
+    bracket.entryPrice = price;
+    bracket.stopLossPrice = stopLoss;
+    bracket.takeProfitPrice = takeProfit;
+    bracket.nativeOco = false;
+    bracket.state = BracketState::PENDING_ENTRY;
+    bracket.entryFilledQuantity = 0.0;
+    bracket.entryAveragePrice = 0.0;
+    bracket.exitFilledQuantity = 0.0;
+    bracket.entryDone = false;
+    bracket.exitRevision = 0;
+
+    OrderRequest entry = makeRequest(symbol, bracket.entrySide, OrderType::MARKET, quantity, price);
+    entry.clientOrderId = bracket.groupId + "-E";
+    entry.feedTimeNs = feedTimeNs;
+    entry.signalTimeNs = signalTimeNs;
+    entry.riskPassTimeNs = riskPassTimeNs;
+    m_brackets[bracket.groupId] = bracket;
+
+    if (m_tickBuffer > 0) {
+        m_bufferedEntries[entry.clientOrderId] = bracket.groupId;
+        m_orderBuffer.push_back(entry);
+        journalBracket(bracket);
+        return bracket.groupId;
+    }
+
+    QString orderId = sendToVenue(entry);
+    if (orderId.isEmpty() && !m_exchangeConnector->isConnected()) {
+        // Held in m_unsentOrders; linked to the group when it is re-sent
+        m_bufferedEntries[entry.clientOrderId] = bracket.groupId;
+        journalBracket(bracket);
+        return bracket.groupId;
+    }
+    if (orderId.isEmpty()) {
+        m_brackets.erase(bracket.groupId);
+        locker.unlock();
+        emit bracketError(bracket.groupId, "Entry order rejected");
+        return QString();
+    }
+    m_brackets[bracket.groupId].entryOrderId = orderId;
+    m_legToGroup[orderId] = bracket.groupId;
+    journalBracket(m_brackets[bracket.groupId]);
+    locker.unlock();
+    emit orderPlaced(orderId);
+    return bracket.groupId;
+}
+
+void OrderManager::cancelBracketOrder(const QString &groupId)
+{
+    ExchangeConnector *connector = nullptr;
+    std::vector<QString> legs;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_brackets.find(groupId);
+        if (it == m_brackets.end()) return;
+        BracketOrder &bracket = it->second;
+        const bool live = bracket.state == BracketState::PENDING_ENTRY || bracket.state == BracketState::ACTIVE;
+        if (live && !bracket.entryDone && !bracket.entryOrderId.isEmpty()) legs.push_back(bracket.entryOrderId);
+        if (bracket.state == BracketState::ACTIVE) {
+            if (!bracket.stopLossOrderId.isEmpty()) legs.push_back(bracket.stopLossOrderId);
+            if (!bracket.takeProfitOrderId.isEmpty()) legs.push_back(bracket.takeProfitOrderId);
+        }
+        bracket.state = BracketState::CANCELLED;
+        journalBracket(bracket);
+        connector = m_exchangeConnector;
+        // An entry that never reached the venue is simply dropped
+        const QString entryClientId = groupId + "-E";
+        auto sameEntry = [&entryClientId](const OrderRequest &r) { return r.clientOrderId == entryClientId; };
+        m_orderBuffer.erase(std::remove_if(m_orderBuffer.begin(), m_orderBuffer.end(), sameEntry), m_orderBuffer.end());
+        m_unsentOrders.erase(std::remove_if(m_unsentOrders.begin(), m_unsentOrders.end(), sameEntry), m_unsentOrders.end());
+        m_bufferedEntries.erase(entryClientId);
+    }
+    if (!connector) return;
+    for (const QString &leg : legs) {
+        connector->cancelOrder(leg);
+    }
+}
+
+void OrderManager::restoreFromJournal(const JournalState &state)
+{
+    QMutexLocker locker(&m_mutex);
+    for (const auto &entry : state.brackets) {
+        BracketOrder bracket = entry.second;
+        if (bracket.state == BracketState::PENDING_ENTRY && bracket.entryOrderId.isEmpty()) {
+            // The entry never reached the venue; it is not re-sent after a restart
+            bracket.state = BracketState::CANCELLED;
+            journalBracket(bracket);
+            continue;
+        }
+        m_brackets[bracket.groupId] = bracket;
+        // What the exit legs had filled before the restart is not known; their next report
+        // counts in full
+        if (!bracket.entryDone) m_legToGroup[bracket.entryOrderId] = bracket.groupId;
+        if (bracket.state == BracketState::ACTIVE) {
+            if (!bracket.stopLossOrderId.isEmpty()) m_legToGroup[bracket.stopLossOrderId] = bracket.groupId;
+            if (!bracket.takeProfitOrderId.isEmpty()) m_legToGroup[bracket.takeProfitOrderId] = bracket.groupId;
+        }
+    }
+}
+
+BracketOrder OrderManager::getBracketOrder(const QString &groupId) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_brackets.find(groupId);
+    if (it != m_brackets.end()) {
+        return it->second;
+    }
+    return BracketOrder();
+}
+
+void OrderManager::resendUnsentOrders()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!isOrderGateOpen() || !m_exchangeConnector || m_unsentOrders.empty()) return;
+    std::vector<OrderRequest> pending;
+    pending.swap(m_unsentOrders);
+    for (const auto &request : pending) {
+        // Same clientOrderId as the first attempt, so the venue drops it if that one got through
+        QString orderId = sendToVenue(request);
+        if (orderId.isEmpty()) continue;
+        linkBufferedEntry(request.clientOrderId, orderId);
+        emit orderPlaced(orderId);
+    }
+}
+
+int OrderManager::getUnsentOrderCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_unsentOrders.size());
+}
+
+void OrderManager::onConnectorConnected()
+{
+    resendUnsentOrders();
+}
+
+void OrderManager::onConnectorOrderFilled(const OrderResponse &response)
+{
+    std::vector<QString> legsToCancel;
+    std::vector<QString> placedLegs;
+    QString closedGroup;
+    QString activatedGroup;
+    QString errorGroup;
+    QString legError;
+    BracketOrder entryFilled = BracketOrder();
+    BracketOrder exitFilled = BracketOrder();
+    double fillQuantity = 0.0;
+    double fillPrice = 0.0;
+    ExchangeConnector *connector = nullptr;
+    if (m_logger) {
+        m_logger->log(AUDIT_ORDER_FILL, response.orderId, STATUS_NAMES[static_cast<int>(response.status)],
+                      response.filledQuantity, response.averagePrice, response.commission);
+    }
+    if (m_journal) m_journal->recordOrderFill(response);
+    METRIC_FILLS.increment();
+    {
+        QMutexLocker locker(&m_mutex);
+        connector = m_exchangeConnector;
+        // A fill implies the venue accepted the order, if its ack has not arrived yet
+        acknowledgeLocked(response.orderId, QString());
+        // Partial fills leave the timeline open for the final report
+        auto timeline = m_timelines.find(response.orderId);
+        if (timeline != m_timelines.end() && response.status != OrderStatus::PARTIALLY_FILLED) {
+            OrderTimeline &stamps = timeline->second;
+            stamps.mark(OrderStage::FILL);
+            const int64_t fillNs = stamps.at(OrderStage::FILL);
+            m_telemetry->recordSegment(stamps.venue, stamps.type, LatencySegment::ACK_TO_FILL,
+                                       fillNs - stamps.at(OrderStage::ACK));
+            if (stamps.at(OrderStage::SIGNAL) > 0) {
+                m_telemetry->recordSegment(stamps.venue, stamps.type, LatencySegment::SIGNAL_TO_FILL,
+                                           fillNs - stamps.at(OrderStage::SIGNAL));
+            }
+            m_timelines.erase(timeline);
+        }
+        auto legIt = m_legToGroup.find(response.orderId);
+        if (legIt == m_legToGroup.end()) {
+            locker.unlock();
+            emit orderFilled(response.orderId);
+            return;
+        }
+        auto it = m_brackets.find(legIt->second);
+        if (it == m_brackets.end()) {
+            m_legToGroup.erase(legIt);
+            locker.unlock();
+            emit orderFilled(response.orderId);
+            return;
+        }
+        BracketOrder &bracket = it->second;
+        // Reports carry the order's running totals; what this one added is the difference
+        const bool orderDone = response.status != OrderStatus::PARTIALLY_FILLED;
+
+        if (response.orderId == bracket.entryOrderId) {
+            const double added = response.filledQuantity - bracket.entryFilledQuantity;
+            if (added > QUANTITY_EPSILON) {
+                fillQuantity = added;
+                fillPrice = (response.filledQuantity * response.averagePrice
+                             - bracket.entryFilledQuantity * bracket.entryAveragePrice) / added;
+                bracket.entryFilledQuantity = response.filledQuantity;
+                bracket.entryAveragePrice = response.averagePrice;
+            }
+            // The entry stays linked until its final report
+            if (orderDone) {
+                bracket.entryDone = true;
+                m_legToGroup.erase(legIt);
+            }
+            const double open = bracket.entryFilledQuantity - bracket.exitFilledQuantity;
+            if (bracket.state == BracketState::PENDING_ENTRY && open > QUANTITY_EPSILON) {
+                // Exits cover what the entry actually filled, not what it asked for
+                if (!attachExitLegs(bracket, open)) legError = "Failed to attach exit legs";
+                if (bracket.state == BracketState::ACTIVE) {
+                    activatedGroup = bracket.groupId;
+                    if (!bracket.stopLossOrderId.isEmpty()) placedLegs.push_back(bracket.stopLossOrderId);
+                    if (!bracket.takeProfitOrderId.isEmpty()) placedLegs.push_back(bracket.takeProfitOrderId);
+                }
+            } else if (bracket.state == BracketState::PENDING_ENTRY && bracket.entryDone) {
+                bracket.state = BracketState::CANCELLED;
+            } else if (bracket.state == BracketState::ACTIVE && bracket.entryDone && open <= QUANTITY_EPSILON) {
+                // Everything the entry filled has already been exited
+                bracket.state = BracketState::CLOSED;
+                closedGroup = bracket.groupId;
+            } else if (bracket.state == BracketState::ACTIVE && fillQuantity > 0.0) {
+                // The entry grew: both exits are placed again for the larger size
+                if (!replaceExitLegs(bracket, QString(), legsToCancel, placedLegs)) {
+                    legError = "Failed to resize exit legs";
+                }
+            }
+            journalBracket(bracket);
+            // The position is open whether or not its exits could be attached
+            if (fillQuantity > 0.0) entryFilled = bracket;
+        } else if (bracket.state == BracketState::ACTIVE) {
+            std::pair<double, double> &legFill = m_exitLegFills[response.orderId];
+            const double added = response.filledQuantity - legFill.first;
+            if (added > QUANTITY_EPSILON) {
+                const double notional = response.filledQuantity * response.averagePrice;
+                fillQuantity = added;
+                fillPrice = (notional - legFill.second) / added;
+                legFill = std::make_pair(response.filledQuantity, notional);
+                bracket.exitFilledQuantity += added;
+            }
+            const bool current = response.orderId == bracket.stopLossOrderId
+                                 || response.orderId == bracket.takeProfitOrderId;
+            if (orderDone) {
+                m_exitLegFills.erase(response.orderId);
+                m_legToGroup.erase(legIt);
+                if (response.orderId == bracket.stopLossOrderId) bracket.stopLossOrderId.clear();
+                if (response.orderId == bracket.takeProfitOrderId) bracket.takeProfitOrderId.clear();
+            }
+            const double open = bracket.entryFilledQuantity - bracket.exitFilledQuantity;
+            if (open <= QUANTITY_EPSILON && bracket.entryDone) {
+                // Flat with nothing more to come: the other leg must go now. Native OCO lists
+                // cancel it venue-side, unless the fill came from a list already replaced
+                bracket.state = BracketState::CLOSED;
+                closedGroup = bracket.groupId;
+                for (const QString &leg : { bracket.stopLossOrderId, bracket.takeProfitOrderId }) {
+                    if (leg.isEmpty() || leg == response.orderId) continue;
+                    m_legToGroup.erase(leg);
+                    m_exitLegFills.erase(leg);
+                    if (!bracket.nativeOco || !current) legsToCancel.push_back(leg);
+                }
+                if (!orderDone) {
+                    m_legToGroup.erase(response.orderId);
+                    m_exitLegFills.erase(response.orderId);
+                }
+            } else if (fillQuantity > 0.0 || (current && orderDone)) {
+                // Partly out: a leg still resting keeps its own remainder and the sibling is
+                // shrunk to match; anything else is placed again for what is open
+                QString keep;
+                if (current && !bracket.nativeOco && open > QUANTITY_EPSILON) {
+                    if (!orderDone) keep = response.orderId;
+                    else if (fillQuantity <= 0.0) keep = bracket.stopLossOrderId.isEmpty() ? bracket.takeProfitOrderId
+                                                                                           : bracket.stopLossOrderId;
+                }
+                if (!replaceExitLegs(bracket, keep, legsToCancel, placedLegs)) legError = "Failed to resize exit legs";
+            }
+            journalBracket(bracket);
+            if (fillQuantity > 0.0) exitFilled = bracket;
+        } else {
+            m_legToGroup.erase(legIt);
+        }
+        if (!legError.isEmpty()) errorGroup = bracket.groupId;
+    }
+
+    if (connector) {
+        for (const QString &leg : legsToCancel) connector->cancelOrder(leg);
+    }
+    emit orderFilled(response.orderId);
+    if (!entryFilled.groupId.isEmpty()) emit bracketEntryFilled(entryFilled, response, fillQuantity, fillPrice);
+    if (!exitFilled.groupId.isEmpty()) emit bracketExitFilled(exitFilled, response, fillQuantity, fillPrice);
+    for (const QString &leg : placedLegs) emit orderPlaced(leg);
+    if (!legError.isEmpty()) emit bracketError(errorGroup, legError);
+    if (!activatedGroup.isEmpty()) emit bracketActivated(activatedGroup);
+    if (!closedGroup.isEmpty()) emit bracketClosed(closedGroup, response.orderId);
+}
+
+void OrderManager::onConnectorOrderRejected(const QString &orderId, const QString &reason)
+{
+    // Asynchronous reject or expiry of an order the connector had already accepted
+    if (m_logger) m_logger->log(AUDIT_ORDER_REJECTED, orderId);
+    if (m_journal) m_journal->recordOrderReject(orderId, false);
+    METRIC_ORDERS_REJECTED.increment();
+    QString failedGroup;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_timelines.erase(orderId);
+        m_unackedOrders.erase(orderId);
+        m_exitLegFills.erase(orderId);
+        auto legIt = m_legToGroup.find(orderId);
+        if (legIt == m_legToGroup.end()) return;
+        auto it = m_brackets.find(legIt->second);
+        m_legToGroup.erase(legIt);
+        if (it == m_brackets.end()) return;
+        failedGroup = it->first;
+        if (it->second.state == BracketState::PENDING_ENTRY && it->second.entryOrderId == orderId) {
+            it->second.state = BracketState::CANCELLED;
+            journalBracket(it->second);
+        }
+    }
+    emit bracketError(failedGroup, "Order " + orderId + " rejected: " + reason);
+}
+
+void OrderManager::onConnectorOrderCancelled(const QString &orderId)
+{
+    if (m_logger) m_logger->log(AUDIT_ORDER_CANCELLED, orderId);
+    if (m_journal) m_journal->recordOrderCancel(orderId);
+    QMutexLocker locker(&m_mutex);
+    m_timelines.erase(orderId);
+    m_unackedOrders.erase(orderId);
+    m_exitLegFills.erase(orderId);
+    auto legIt = m_legToGroup.find(orderId);
+    if (legIt == m_legToGroup.end()) return;
+    auto it = m_brackets.find(legIt->second);
+    m_legToGroup.erase(legIt);
+    if (it == m_brackets.end() || it->second.entryOrderId != orderId) return;
+    BracketOrder &bracket = it->second;
+    // The entry's remainder is gone; what did fill stays covered by the exits
+    bracket.entryDone = true;
+    QString closedGroup;
+    if (bracket.state == BracketState::PENDING_ENTRY) {
+        bracket.state = BracketState::CANCELLED;
+    } else if (bracket.state == BracketState::ACTIVE
+               && bracket.entryFilledQuantity - bracket.exitFilledQuantity <= QUANTITY_EPSILON) {
+        bracket.state = BracketState::CLOSED;
+        closedGroup = bracket.groupId;
+    }
+    journalBracket(bracket);
+    locker.unlock();
+    if (!closedGroup.isEmpty()) emit bracketClosed(closedGroup, orderId);
+}
+
+OrderRequest OrderManager::makeRequest(const QString &symbol, OrderSide side, OrderType type, double quantity, double price)
+{
+    OrderRequest req;
+    req.clientOrderId = m_idGenerator.next();
+    req.symbol = symbol;
+    req.side = side;
+    req.type = type;
+    req.quantity = quantity;
+    req.price = price;
+    req.stopPrice = 0.0;
+    req.timeInForce = TimeInForce::GTC;
+    req.feedTimeNs = 0;
+    req.signalTimeNs = 0;
+    req.riskPassTimeNs = 0;
+    return req;
+}
+
+QString OrderManager::sendToVenue(const OrderRequest &request, ExchangeConnector *venue, SubmitStatus *status)
+{
+    // Called with m_mutex held
+    LATENCY_PROBE(ProbeStage::ORDER_SEND);
+    if (!venue) venue = m_exchangeConnector;
+    OrderTimeline timeline;
+    timeline.venue = venue->getCurrentExchange();
+    timeline.type = request.type;
+    timeline.mark(OrderStage::SIGNAL, request.signalTimeNs);
+    timeline.mark(OrderStage::RISK_PASS, request.riskPassTimeNs);
+    if (m_logger) {
+        m_logger->log(AUDIT_ORDER_SENT, request.clientOrderId, request.symbol, SIDE_NAMES[static_cast<int>(request.side)],
+                      TYPE_NAMES[static_cast<int>(request.type)], request.quantity, request.price);
+    }
+    if (m_journal) m_journal->recordOrderRequest(request);
+    METRIC_ORDERS_SENT.increment();
+    // Audit and journal writes count as risk-to-wire, not as venue latency
+    timeline.mark(OrderStage::WIRE_SEND);
+    QString orderId = venue->placeOrder(request);
+    if (orderId.isEmpty()) {
+        // Only resting orders for the primary venue are held for resend; an IOC sent late
+        // would trade on a stale price
+        const bool held = !venue->isConnected() && venue == m_exchangeConnector
+                          && request.timeInForce == TimeInForce::GTC;
+        if (m_logger) m_logger->log(held ? AUDIT_ORDER_HELD : AUDIT_ORDER_REJECTED, request.clientOrderId);
+        if (m_journal) m_journal->recordOrderReject(request.clientOrderId, held);
+        (held ? METRIC_ORDERS_HELD : METRIC_ORDERS_REJECTED).increment();
+        if (status) *status = held ? SubmitStatus::HELD : SubmitStatus::REJECTED;
+        if (held) {
+            bool queued = false;
+            for (const auto &unsent : m_unsentOrders) {
+                if (unsent.clientOrderId == request.clientOrderId) queued = true;
+            }
+            if (!queued) m_unsentOrders.push_back(request);
+        }
+        return orderId;
+    }
+    if (status) *status = SubmitStatus::SENT;
+    // The ack comes later, from the venue's reply or report; until then the timeline is open
+    evictStaleTimelines(timeline.at(OrderStage::WIRE_SEND));
+    m_timelines[orderId] = timeline;
+    m_unackedOrders[orderId] = request.clientOrderId;
+    return orderId;
+}
+
+void OrderManager::onConnectorOrderAcknowledged(const QString &orderId, const QString &venueOrderId)
+{
+    QMutexLocker locker(&m_mutex);
+    acknowledgeLocked(orderId, venueOrderId);
+}
+
+void OrderManager::acknowledgeLocked(const QString &orderId, const QString &venueOrderId)
+{
+    // Called with m_mutex held. Only the first ack counts; the REST reply and the stream
+    // may both report the same acceptance
+    auto unacked = m_unackedOrders.find(orderId);
+    if (unacked == m_unackedOrders.end()) return;
+    const QString clientOrderId = unacked->second;
+    m_unackedOrders.erase(unacked);
+    auto timeline = m_timelines.find(orderId);
+    if (timeline == m_timelines.end()) return;
+    OrderTimeline &stamps = timeline->second;
+    stamps.mark(OrderStage::ACK);
+    const int64_t wireToAckNs = stamps.at(OrderStage::ACK) - stamps.at(OrderStage::WIRE_SEND);
+    // Segments up to the ack are recorded now, so orders that never fill still count;
+    // the fill adds only the segments that end at FILL
+    m_telemetry->record(stamps);
+    if (m_logger) {
+        m_logger->log(AUDIT_ORDER_ACKED, clientOrderId, venueOrderId.isEmpty() ? orderId : venueOrderId, wireToAckNs);
+    }
+    if (m_journal) m_journal->recordOrderAck(clientOrderId, orderId);
+    METRIC_ORDERS_ACKED.increment();
+    METRIC_ACK_LATENCY.record(wireToAckNs);
+}
+
+void OrderManager::evictStaleTimelines(int64_t nowNs)
+{
+    // Called with m_mutex held. Orders resting past the timeout no longer say anything about
+    // fill latency; without this a venue that never reports them would grow the map forever
+    if (nowNs < m_nextTimelineSweepNs) return;
+    m_nextTimelineSweepNs = nowNs + TIMELINE_SWEEP_INTERVAL_NS;
+    for (auto it = m_timelines.begin(); it != m_timelines.end();) {
+        if (nowNs - it->second.at(OrderStage::WIRE_SEND) > TIMELINE_TIMEOUT_NS) {
+            m_unackedOrders.erase(it->first);
+            it = m_timelines.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void OrderManager::linkBufferedEntry(const QString &clientOrderId, const QString &orderId)
+{
+    auto entry = m_bufferedEntries.find(clientOrderId);
+    if (entry == m_bufferedEntries.end()) return;
+    auto bracket = m_brackets.find(entry->second);
+    if (bracket != m_brackets.end()) {
+        bracket->second.entryOrderId = orderId;
+        m_legToGroup[orderId] = bracket->first;
+        journalBracket(bracket->second);
+    }
+    m_bufferedEntries.erase(entry);
+}
+
+void OrderManager::journalBracket(const BracketOrder &bracket)
+{
+    if (m_journal) m_journal->recordBracket(bracket);
+}
+
+bool OrderManager::attachExitLegs(BracketOrder &bracket, double quantity)
+{
+    // Called with m_mutex held; the connector never reports new orders synchronously.
+    // Returns false when a leg could not be placed; the caller reports it after unlocking
+    if (!isOrderGateOpen()) {
+        // An entry that fills after the kill switch is flattened, not protected
+        bracket.state = BracketState::CANCELLED;
+        return true;
+    }
+    OrderRequest stopLeg = exitLeg(bracket, true, quantity);
+    OrderRequest takeProfitLeg = exitLeg(bracket, false, quantity);
+
+    bracket.nativeOco = false;
+    if (m_exchangeConnector->supportsNativeOco()) {
+        QString stopId, takeProfitId;
+        if (m_exchangeConnector->placeOcoOrder(stopLeg, takeProfitLeg, stopId, takeProfitId)) {
+            bracket.nativeOco = true;
+            bracket.stopLossOrderId = stopId;
+            bracket.takeProfitOrderId = takeProfitId;
+        }
+    }
+
+    // Local emulation: two independent resting orders, linked here
+    if (!bracket.nativeOco) {
+        bracket.stopLossOrderId = sendToVenue(stopLeg);
+        bracket.takeProfitOrderId = sendToVenue(takeProfitLeg);
+    }
+
+    if (!bracket.stopLossOrderId.isEmpty()) m_legToGroup[bracket.stopLossOrderId] = bracket.groupId;
+    if (!bracket.takeProfitOrderId.isEmpty()) m_legToGroup[bracket.takeProfitOrderId] = bracket.groupId;
+    bracket.state = BracketState::ACTIVE;
+    return !bracket.stopLossOrderId.isEmpty() && !bracket.takeProfitOrderId.isEmpty();
+}
+
+OrderRequest OrderManager::exitLeg(const BracketOrder &bracket, bool stopLoss, double quantity)
+{
+    const OrderSide exitSide = (bracket.entrySide == OrderSide::BUY) ? OrderSide::SELL : OrderSide::BUY;
+    OrderRequest leg = makeRequest(bracket.symbol, exitSide, stopLoss ? OrderType::STOP : OrderType::LIMIT, quantity,
+                                   stopLoss ? bracket.stopLossPrice : bracket.takeProfitPrice);
+    if (stopLoss) leg.stopPrice = bracket.stopLossPrice;
+    // Replacements get fresh ids; the venue still knows the legs they replace
+    leg.clientOrderId = bracket.groupId + (stopLoss ? "-SL" : "-TP")
+                        + (bracket.exitRevision > 0 ? QString::number(bracket.exitRevision) : QString());
+    return leg;
+}
+
+bool OrderManager::replaceExitLegs(BracketOrder &bracket, const QString &keepLeg, std::vector<QString> &cancelled,
+                                   std::vector<QString> &placed)
+{
+    // Called with m_mutex held. Every current leg but keepLeg is cancelled, then the missing
+    // legs are placed for what is open now; keepLeg rests on with its own remainder. Cancelled
+    // legs stay linked until the venue confirms, so a fill that races the cancel still counts
+    for (QString *leg : { &bracket.stopLossOrderId, &bracket.takeProfitOrderId }) {
+        if (leg->isEmpty() || *leg == keepLeg) continue;
+        cancelled.push_back(*leg);
+        leg->clear();
+    }
+    const double open = bracket.entryFilledQuantity - bracket.exitFilledQuantity;
+    // Flat for now: a later entry fill places them again
+    if (open <= QUANTITY_EPSILON || !isOrderGateOpen()) return true;
+    bracket.exitRevision++;
+    if (keepLeg.isEmpty()) {
+        const bool attached = attachExitLegs(bracket, open);
+        if (!bracket.stopLossOrderId.isEmpty()) placed.push_back(bracket.stopLossOrderId);
+        if (!bracket.takeProfitOrderId.isEmpty()) placed.push_back(bracket.takeProfitOrderId);
+        return attached;
+    }
+    const bool stopLoss = bracket.stopLossOrderId.isEmpty();
+    const QString orderId = sendToVenue(exitLeg(bracket, stopLoss, open));
+    if (orderId.isEmpty()) return false;
+    (stopLoss ? bracket.stopLossOrderId : bracket.takeProfitOrderId) = orderId;
+    m_legToGroup[orderId] = bracket.groupId;
+    placed.push_back(orderId);
+    return true;
+}
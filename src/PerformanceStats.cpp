@@ -0,0 +1,225 @@
+#include "PerformanceStats.h"
+#include <QDateTime>
+#include <algorithm>
+#include <cmath>
+
+static const double MS_PER_YEAR = 365.25 * 24.0 * 60.0 * 60.0 * 1000.0;
+
+RollingStats::RollingStats(int window)
+    : m_window(window > 0 ? window : 0)
+    , m_head(0)
+    , m_count(0)
+    , m_mean(0.0)
+    , m_m2(0.0)
+    , m_downsideSq(0.0)
+{
+    m_ring.assign(static_cast<size_t>(m_window), 0.0);
+}
+
+void RollingStats::add(double value)
+{
+    const double downside = value < 0.0 ? value * value : 0.0;
+
+    if (m_window == 0 || m_count < m_window) {
+        // Welford update
+        m_count++;
+        double delta = value - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (value - m_mean);
+        m_downsideSq += downside;
+        if (m_window > 0) {
+            m_ring[m_head] = value;
+            m_head = (m_head + 1) % m_window;
+        }
+        return;
+    }
+
+    // Window full: replace the oldest sample (Welford downdate + update in one step)
+    double old = m_ring[m_head];
+    m_ring[m_head] = value;
+    m_head = (m_head + 1) % m_window;
+
+    double oldMean = m_mean;
+    m_mean += (value - old) / m_count;
+    m_m2 += (value - old) * (value - m_mean + old - oldMean);
+    m_m2 = std::max(0.0, m_m2);
+    m_downsideSq = std::max(0.0, m_downsideSq + downside - (old < 0.0 ? old * old : 0.0));
+}
+
+void RollingStats::reset()
+{
+    std::fill(m_ring.begin(), m_ring.end(), 0.0);
+    m_head = 0;
+    m_count = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_downsideSq = 0.0;
+}
+
+double RollingStats::variance() const
+{
+    return m_count > 1 ? m_m2 / (m_count - 1) : 0.0;
+}
+
+double RollingStats::stddev() const
+{
+    return std::sqrt(variance());
+}
+
+double RollingStats::downsideDeviation() const
+{
+    return m_count > 0 ? std::sqrt(m_downsideSq / m_count) : 0.0;
+}
+
+PerformanceStats::PerformanceStats()
+    : m_initialized(false)
+    , m_lastEquity(0.0)
+    , m_peakEquity(0.0)
+    , m_maxDrawdown(0.0)
+    , m_maxDrawdownPercent(0.0)
+    , m_dayStartEquity(0.0)
+    , m_weekStartEquity(0.0)
+    , m_monthStartEquity(0.0)
+    , m_nextDayMs(0)
+    , m_nextWeekMs(0)
+    , m_nextMonthMs(0)
+    , m_samplePeriodMs(DEFAULT_SAMPLE_PERIOD_MS)
+    , m_nextSampleMs(0)
+    , m_sampleEquity(0.0)
+{
+    m_windows.push_back(RollingStats(DEFAULT_SHORT_WINDOW));
+    m_windows.push_back(RollingStats(DEFAULT_LONG_WINDOW));
+}
+
+void PerformanceStats::reset(qint64 timeMs, double equity)
+{
+    m_initialized = true;
+    m_lastEquity = equity;
+    m_peakEquity = equity;
+    m_maxDrawdown = 0.0;
+    m_maxDrawdownPercent = 0.0;
+    m_dayStartEquity = equity;
+    m_weekStartEquity = equity;
+    m_monthStartEquity = equity;
+    m_sampleEquity = equity;
+    m_nextSampleMs = timeMs + m_samplePeriodMs;
+    for (auto &window : m_windows) {
+        window.reset();
+    }
+    computeBoundaries(timeMs);
+}
+
+void PerformanceStats::restoreDrawdown(double peakEquity, double maxDrawdown, double maxDrawdownPercent)
+{
+    m_peakEquity = std::max(m_peakEquity, peakEquity);
+    m_maxDrawdown = std::max(m_maxDrawdown, maxDrawdown);
+    m_maxDrawdownPercent = std::max(m_maxDrawdownPercent, maxDrawdownPercent);
+}
+
+void PerformanceStats::setDailyPnL(double dailyPnL)
+{
+    m_dayStartEquity = m_lastEquity - dailyPnL;
+}
+
+void PerformanceStats::setSamplePeriod(qint64 periodMs)
+{
+    if (periodMs <= 0) return;
+    m_nextSampleMs += periodMs - m_samplePeriodMs;
+    m_samplePeriodMs = periodMs;
+}
+
+void PerformanceStats::setReturnWindows(const std::vector<int> &windows)
+{
+    m_windows.clear();
+    for (int window : windows) {
+        m_windows.push_back(RollingStats(window));
+    }
+    if (m_windows.empty()) {
+        m_windows.push_back(RollingStats(DEFAULT_SHORT_WINDOW));
+    }
+}
+
+int PerformanceStats::update(qint64 timeMs, double equity)
+{
+    if (!m_initialized) {
+        reset(timeMs, equity);
+        return NO_ROLL;
+    }
+
+    // Buckets close at the last equity seen before the boundary
+    int rolled = NO_ROLL;
+    if (timeMs >= m_nextDayMs) {
+        rollBuckets(timeMs, rolled);
+    }
+
+    m_lastEquity = equity;
+    if (equity > m_peakEquity) {
+        m_peakEquity = equity;
+    }
+    double drawdown = m_peakEquity - equity;
+    if (drawdown > m_maxDrawdown) {
+        m_maxDrawdown = drawdown;
+    }
+    if (m_peakEquity > 0.0) {
+        m_maxDrawdownPercent = std::max(m_maxDrawdownPercent, drawdown / m_peakEquity * 100.0);
+    }
+
+    if (timeMs >= m_nextSampleMs) {
+        double periodReturn = m_sampleEquity > 0.0 ? equity / m_sampleEquity - 1.0 : 0.0;
+        for (auto &window : m_windows) {
+            window.add(periodReturn);
+        }
+        m_sampleEquity = equity;
+        m_nextSampleMs = timeMs + m_samplePeriodMs;
+    }
+    return rolled;
+}
+
+PnLBuckets PerformanceStats::pnlBuckets() const
+{
+    PnLBuckets buckets;
+    buckets.daily = m_lastEquity - m_dayStartEquity;
+    buckets.weekly = m_lastEquity - m_weekStartEquity;
+    buckets.monthly = m_lastEquity - m_monthStartEquity;
+    return buckets;
+}
+
+double PerformanceStats::sharpe(int window) const
+{
+    const RollingStats &stats = m_windows[window];
+    double sd = stats.stddev();
+    if (stats.count() < 2 || sd <= 0.0) return 0.0;
+    return stats.mean() / sd * std::sqrt(MS_PER_YEAR / m_samplePeriodMs);
+}
+
+double PerformanceStats::sortino(int window) const
+{
+    const RollingStats &stats = m_windows[window];
+    double dd = stats.downsideDeviation();
+    if (stats.count() < 2 || dd <= 0.0) return 0.0;
+    return stats.mean() / dd * std::sqrt(MS_PER_YEAR / m_samplePeriodMs);
+}
+
+void PerformanceStats::rollBuckets(qint64 timeMs, int &rolled)
+{
+    rolled |= DAY_ROLLED;
+    m_dayStartEquity = m_lastEquity;
+    if (timeMs >= m_nextWeekMs) {
+        rolled |= WEEK_ROLLED;
+        m_weekStartEquity = m_lastEquity;
+    }
+    if (timeMs >= m_nextMonthMs) {
+        rolled |= MONTH_ROLLED;
+        m_monthStartEquity = m_lastEquity;
+    }
+    computeBoundaries(timeMs);
+}
+
+void PerformanceStats::computeBoundaries(qint64 timeMs)
+{
+    // Only runs on a day change, so the calendar math stays off the per-update path
+    QDate today = QDateTime::fromMSecsSinceEpoch(timeMs).date();
+    m_nextDayMs = today.addDays(1).startOfDay().toMSecsSinceEpoch();
+    m_nextWeekMs = today.addDays(8 - today.dayOfWeek()).startOfDay().toMSecsSinceEpoch();
+    m_nextMonthMs = QDate(today.year(), today.month(), 1).addMonths(1).startOfDay().toMSecsSinceEpoch();
+}
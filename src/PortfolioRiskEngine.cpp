@@ -0,0 +1,234 @@
+#include "PortfolioRiskEngine.h"
+#include <algorithm>
+#include <cmath>
+
+double PortfolioRiskView::valueAtRiskAfter(const QString &symbol, double deltaNotional) const
+{
+    double crossTerm = 0.0;
+    double ownVariance = fallbackVariance;
+    auto it = symbolIds.constFind(symbol);
+    if (it != symbolIds.constEnd() && it.value() < static_cast<int>(symbolVariance.size())) {
+        int id = it.value();
+        crossTerm = covTimesExposure[id];
+        if (symbolVariance[id] > 0.0) {
+            ownVariance = symbolVariance[id];
+        }
+    }
+
+    double after = variance + 2.0 * deltaNotional * crossTerm + deltaNotional * deltaNotional * ownVariance;
+    return std::sqrt(std::max(0.0, after)) * scale;
+}
+
+double PortfolioRiskView::marginalVaR(const QString &symbol, double deltaNotional) const
+{
+    return valueAtRiskAfter(symbol, deltaNotional) - valueAtRisk;
+}
+
+PortfolioRiskEngine::PortfolioRiskEngine()
+    : m_lambda(DEFAULT_DECAY)
+    , m_z(normalQuantile(DEFAULT_CONFIDENCE))
+    , m_samplePeriodMs(DEFAULT_SAMPLE_PERIOD_MS)
+    , m_horizonMs(DEFAULT_HORIZON_MS)
+    , m_nextSampleMs(0)
+    , m_samples(0)
+    , m_count(0)
+    , m_variance(0.0)
+{
+}
+
+void PortfolioRiskEngine::setDecay(double lambda)
+{
+    if (lambda > 0.0 && lambda < 1.0) {
+        m_lambda = lambda;
+    }
+}
+
+void PortfolioRiskEngine::setConfidence(double confidence)
+{
+    if (confidence > 0.5 && confidence < 1.0) {
+        m_z = normalQuantile(confidence);
+    }
+}
+
+void PortfolioRiskEngine::setSamplePeriod(qint64 periodMs)
+{
+    if (periodMs <= 0) return;
+    if (m_nextSampleMs > 0) {
+        m_nextSampleMs += periodMs - m_samplePeriodMs;
+    }
+    m_samplePeriodMs = periodMs;
+}
+
+void PortfolioRiskEngine::setHorizon(qint64 horizonMs)
+{
+    if (horizonMs > 0) {
+        m_horizonMs = horizonMs;
+    }
+}
+
+bool PortfolioRiskEngine::onPrice(int symbolId, double price, qint64 timeMs)
+{
+    if (symbolId < 0 || price <= 0.0) return false;
+    ensureSymbol(symbolId);
+
+    // A period closes at the last prices seen before the boundary, so every symbol's
+    // return covers the same interval whichever symbol ticks first
+    bool sampled = false;
+    if (m_nextSampleMs == 0) {
+        m_nextSampleMs = timeMs + m_samplePeriodMs;
+    } else if (timeMs >= m_nextSampleMs) {
+        sample();
+        m_nextSampleMs = timeMs + m_samplePeriodMs;
+        sampled = true;
+    }
+    m_lastPrice[symbolId] = price;
+    return sampled;
+}
+
+void PortfolioRiskEngine::ensureSymbol(int symbolId)
+{
+    if (symbolId < m_count) return;
+
+    int count = symbolId + 1;
+    std::vector<double> covariance(static_cast<size_t>(count) * count, 0.0);
+    for (int i = 0; i < m_count; ++i) {
+        std::copy(m_covariance.begin() + static_cast<size_t>(i) * m_count,
+                  m_covariance.begin() + static_cast<size_t>(i + 1) * m_count,
+                  covariance.begin() + static_cast<size_t>(i) * count);
+    }
+    m_covariance.swap(covariance);
+    m_lastPrice.resize(count, 0.0);
+    m_samplePrice.resize(count, 0.0);
+    m_returns.resize(count, 0.0);
+    m_exposure.resize(count, 0.0);
+    m_covTimesExposure.resize(count, 0.0);
+    m_count = count;
+}
+
+void PortfolioRiskEngine::sample()
+{
+    // Symbols that did not trade during the period contribute a zero return; a symbol's
+    // first sample only seeds its reference price
+    for (int i = 0; i < m_count; ++i) {
+        double last = m_lastPrice[i];
+        double previous = m_samplePrice[i];
+        m_returns[i] = (last > 0.0 && previous > 0.0) ? std::log(last / previous) : 0.0;
+        if (last > 0.0) {
+            m_samplePrice[i] = last;
+        }
+    }
+
+    const double weight = 1.0 - m_lambda;
+    for (int i = 0; i < m_count; ++i) {
+        double ri = weight * m_returns[i];
+        double *row = &m_covariance[static_cast<size_t>(i) * m_count];
+        for (int j = 0; j <= i; ++j) {
+            row[j] = m_lambda * row[j] + ri * m_returns[j];
+        }
+    }
+    // Mirror the lower triangle
+    for (int i = 0; i < m_count; ++i) {
+        for (int j = i + 1; j < m_count; ++j) {
+            m_covariance[static_cast<size_t>(i) * m_count + j] = m_covariance[static_cast<size_t>(j) * m_count + i];
+        }
+    }
+    m_samples++;
+
+    setExposures(m_exposure);
+}
+
+void PortfolioRiskEngine::setExposures(const std::vector<double> &exposure)
+{
+    if (&exposure != &m_exposure) {
+        ensureSymbol(static_cast<int>(exposure.size()) - 1);
+        std::fill(m_exposure.begin(), m_exposure.end(), 0.0);
+        std::copy(exposure.begin(), exposure.end(), m_exposure.begin());
+    }
+
+    double variance = 0.0;
+    for (int i = 0; i < m_count; ++i) {
+        const double *row = &m_covariance[static_cast<size_t>(i) * m_count];
+        double sum = 0.0;
+        for (int j = 0; j < m_count; ++j) {
+            sum += row[j] * m_exposure[j];
+        }
+        m_covTimesExposure[i] = sum;
+        variance += m_exposure[i] * sum;
+    }
+    m_variance = std::max(0.0, variance);
+}
+
+double PortfolioRiskEngine::covariance(int i, int j) const
+{
+    if (i < 0 || j < 0 || i >= m_count || j >= m_count) return 0.0;
+    return m_covariance[static_cast<size_t>(i) * m_count + j];
+}
+
+double PortfolioRiskEngine::correlation(int i, int j) const
+{
+    double denominator = std::sqrt(covariance(i, i) * covariance(j, j));
+    return denominator > 0.0 ? covariance(i, j) / denominator : 0.0;
+}
+
+double PortfolioRiskEngine::scale() const
+{
+    return m_z * std::sqrt(static_cast<double>(m_horizonMs) / m_samplePeriodMs);
+}
+
+double PortfolioRiskEngine::valueAtRisk() const
+{
+    return std::sqrt(m_variance) * scale();
+}
+
+std::shared_ptr<const PortfolioRiskView> PortfolioRiskEngine::view(const QHash<QString, int> &symbolIds) const
+{
+    auto view = std::make_shared<PortfolioRiskView>();
+    view->valueAtRisk = valueAtRisk();
+    view->variance = m_variance;
+    view->scale = scale();
+    view->covTimesExposure = m_covTimesExposure;
+    view->symbolVariance.resize(m_count);
+
+    // Unknown or not yet sampled symbols are assumed as volatile as the most volatile one we know
+    double fallback = 0.0;
+    for (int i = 0; i < m_count; ++i) {
+        double v = m_covariance[static_cast<size_t>(i) * m_count + i];
+        view->symbolVariance[i] = v;
+        fallback = std::max(fallback, v);
+    }
+    view->fallbackVariance = fallback;
+    view->symbolIds = symbolIds;
+    return view;
+}
+
+double PortfolioRiskEngine::normalQuantile(double p)
+{
+    static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                6.680131188771972e+01, -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                3.754408661907416e+00 };
+    static const double LOW = 0.02425;
+
+    if (p <= 0.0) return -INFINITY;
+    if (p >= 1.0) return INFINITY;
+
+    if (p < LOW) {
+        double q = std::sqrt(-2.0 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    if (p > 1.0 - LOW) {
+        double q = std::sqrt(-2.0 * std::log(1.0 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
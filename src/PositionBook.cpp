@@ -0,0 +1,180 @@
+#include "PositionBook.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+PositionBook::PositionBook()
+{
+    m_totals.unrealizedPnL = 0.0;
+    m_totals.exposure = 0.0;
+}
+
+void PositionBook::setRow(int row, int symbolId, double size, double entryPrice, int sideSign)
+{
+    ensureRow(row);
+    ensureSymbol(symbolId);
+    applyRow(row, -1.0);
+    m_size[row] = size;
+    m_entry[row] = entryPrice;
+    m_sign[row] = sideSign < 0 ? -1.0 : 1.0;
+    m_symbol[row] = symbolId;
+    applyRow(row, 1.0);
+}
+
+void PositionBook::clearRow(int row)
+{
+    if (row < 0 || row >= rowCount()) return;
+    applyRow(row, -1.0);
+    // A zero row contributes nothing to the kernel
+    m_size[row] = 0.0;
+    m_entry[row] = 0.0;
+    m_sign[row] = 0.0;
+    m_symbol[row] = 0;
+}
+
+void PositionBook::clearRows()
+{
+    m_size.clear();
+    m_entry.clear();
+    m_sign.clear();
+    m_symbol.clear();
+    std::fill(m_netSize.begin(), m_netSize.end(), 0.0);
+    std::fill(m_grossSize.begin(), m_grossSize.end(), 0.0);
+    m_totals.unrealizedPnL = 0.0;
+    m_totals.exposure = 0.0;
+}
+
+void PositionBook::setPrice(int symbolId, double price)
+{
+    ensureSymbol(symbolId);
+    double delta = price - m_prices[symbolId];
+    m_totals.unrealizedPnL += delta * m_netSize[symbolId];
+    m_totals.exposure += delta * m_grossSize[symbolId];
+    m_prices[symbolId] = price;
+}
+
+double PositionBook::price(int symbolId) const
+{
+    return symbolId >= 0 && symbolId < static_cast<int>(m_prices.size()) ? m_prices[symbolId] : 0.0;
+}
+
+double PositionBook::netSize(int symbolId) const
+{
+    return symbolId >= 0 && symbolId < static_cast<int>(m_netSize.size()) ? m_netSize[symbolId] : 0.0;
+}
+
+double PositionBook::rowUnrealizedPnL(int row) const
+{
+    if (row < 0 || row >= rowCount()) return 0.0;
+    return m_sign[row] * m_size[row] * (m_prices[m_symbol[row]] - m_entry[row]);
+}
+
+BookTotals PositionBook::revalue()
+{
+    m_totals = revalueArrays(m_size.data(), m_entry.data(), m_sign.data(), m_symbol.data(),
+                             m_prices.data(), rowCount());
+    return m_totals;
+}
+
+BookTotals PositionBook::revalueArrays(const double *size, const double *entry, const double *sign,
+                                       const int32_t *symbol, const double *prices, int count)
+{
+    int i = 0;
+    double pnl = 0.0;
+    double exposure = 0.0;
+
+#if defined(__AVX2__)
+    // Four rows per step; marks are gathered straight from the per-symbol price table
+    __m256d pnlAcc = _mm256_setzero_pd();
+    __m256d exposureAcc = _mm256_setzero_pd();
+    const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (; i + 4 <= count; i += 4) {
+        __m128i ids = _mm_loadu_si128(reinterpret_cast<const __m128i *>(symbol + i));
+        __m256d mark = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), prices, ids, allLanes, 8);
+        __m256d qty = _mm256_loadu_pd(size + i);
+        __m256d signedQty = _mm256_mul_pd(qty, _mm256_loadu_pd(sign + i));
+        __m256d diff = _mm256_sub_pd(mark, _mm256_loadu_pd(entry + i));
+#if defined(__FMA__)
+        pnlAcc = _mm256_fmadd_pd(signedQty, diff, pnlAcc);
+        exposureAcc = _mm256_fmadd_pd(qty, mark, exposureAcc);
+#else
+        pnlAcc = _mm256_add_pd(pnlAcc, _mm256_mul_pd(signedQty, diff));
+        exposureAcc = _mm256_add_pd(exposureAcc, _mm256_mul_pd(qty, mark));
+#endif
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, pnlAcc);
+    pnl = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm256_store_pd(lanes, exposureAcc);
+    exposure = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(__SSE2__) || defined(_M_X64)
+    // Baseline x86-64: two rows per step, two independent accumulators each to hide add latency
+    __m128d pnlAcc0 = _mm_setzero_pd();
+    __m128d pnlAcc1 = _mm_setzero_pd();
+    __m128d exposureAcc0 = _mm_setzero_pd();
+    __m128d exposureAcc1 = _mm_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        __m128d mark0 = _mm_set_pd(prices[symbol[i + 1]], prices[symbol[i]]);
+        __m128d mark1 = _mm_set_pd(prices[symbol[i + 3]], prices[symbol[i + 2]]);
+        __m128d qty0 = _mm_loadu_pd(size + i);
+        __m128d qty1 = _mm_loadu_pd(size + i + 2);
+        __m128d diff0 = _mm_sub_pd(mark0, _mm_loadu_pd(entry + i));
+        __m128d diff1 = _mm_sub_pd(mark1, _mm_loadu_pd(entry + i + 2));
+        pnlAcc0 = _mm_add_pd(pnlAcc0, _mm_mul_pd(_mm_mul_pd(qty0, _mm_loadu_pd(sign + i)), diff0));
+        pnlAcc1 = _mm_add_pd(pnlAcc1, _mm_mul_pd(_mm_mul_pd(qty1, _mm_loadu_pd(sign + i + 2)), diff1));
+        exposureAcc0 = _mm_add_pd(exposureAcc0, _mm_mul_pd(qty0, mark0));
+        exposureAcc1 = _mm_add_pd(exposureAcc1, _mm_mul_pd(qty1, mark1));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(pnlAcc0, pnlAcc1));
+    pnl = lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, _mm_add_pd(exposureAcc0, exposureAcc1));
+    exposure = lanes[0] + lanes[1];
+#endif
+
+    for (; i < count; ++i) {
+        double mark = prices[symbol[i]];
+        pnl += sign[i] * size[i] * (mark - entry[i]);
+        exposure += size[i] * mark;
+    }
+
+    BookTotals totals;
+    totals.unrealizedPnL = pnl;
+    totals.exposure = exposure;
+    return totals;
+}
+
+void PositionBook::ensureSymbol(int symbolId)
+{
+    if (symbolId < static_cast<int>(m_prices.size())) return;
+    size_t count = static_cast<size_t>(symbolId) + 1;
+    m_prices.resize(count, 0.0);
+    m_netSize.resize(count, 0.0);
+    m_grossSize.resize(count, 0.0);
+}
+
+void PositionBook::ensureRow(int row)
+{
+    if (row < rowCount()) return;
+    size_t count = static_cast<size_t>(row) + 1;
+    m_size.resize(count, 0.0);
+    m_entry.resize(count, 0.0);
+    m_sign.resize(count, 0.0);
+    m_symbol.resize(count, 0);
+}
+
+void PositionBook::applyRow(int row, double direction)
+{
+    // Adds (direction = +1) or removes (-1) one row from the per-symbol aggregates and totals
+    if (m_size[row] == 0.0) return;
+    const int s = m_symbol[row];
+    const double signedQty = direction * m_sign[row] * m_size[row];
+    m_netSize[s] += signedQty;
+    m_grossSize[s] += direction * m_size[row];
+    m_totals.unrealizedPnL += signedQty * (m_prices[s] - m_entry[row]);
+    m_totals.exposure += direction * m_size[row] * m_prices[s];
+}
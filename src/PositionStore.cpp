@@ -0,0 +1,176 @@
+#include "PositionStore.h"
+
+PositionStore::PositionStore()
+{
+}
+
+int PositionStore::open(const Position &position)
+{
+    auto existing = m_slotById.constFind(position.orderId);
+    int slot;
+    if (existing != m_slotById.constEnd()) {
+        slot = existing.value();
+    } else if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<int>(m_slots.size());
+        m_slots.push_back(Position());
+        m_openIndex.push_back(-1);
+    }
+
+    Position &stored = m_slots[slot];
+    stored = position;
+    stored.isOpen = true;
+    stored.symbolId = symbolId(position.symbol);
+
+    if (m_openIndex[slot] < 0) {
+        m_openIndex[slot] = static_cast<int>(m_openSlots.size());
+        m_openSlots.push_back(slot);
+        m_slotById.insert(position.orderId, slot);
+    }
+    return slot;
+}
+
+Position *PositionStore::find(const QString &positionId)
+{
+    auto it = m_slotById.constFind(positionId);
+    return it != m_slotById.constEnd() ? &m_slots[it.value()] : nullptr;
+}
+
+const Position *PositionStore::find(const QString &positionId) const
+{
+    auto it = m_slotById.constFind(positionId);
+    return it != m_slotById.constEnd() ? &m_slots[it.value()] : nullptr;
+}
+
+int PositionStore::findSlot(const QString &positionId) const
+{
+    return m_slotById.value(positionId, -1);
+}
+
+Position *PositionStore::at(int slot)
+{
+    return slot >= 0 && slot < static_cast<int>(m_slots.size()) && m_openIndex[slot] >= 0 ? &m_slots[slot] : nullptr;
+}
+
+const Position *PositionStore::at(int slot) const
+{
+    return slot >= 0 && slot < static_cast<int>(m_slots.size()) && m_openIndex[slot] >= 0 ? &m_slots[slot] : nullptr;
+}
+
+bool PositionStore::close(const QString &positionId, double closePrice, const QDateTime &closeTime, Position &closed,
+                          double contractSize)
+{
+    auto it = m_slotById.find(positionId);
+    if (it == m_slotById.end()) return false;
+    const int slot = it.value();
+    m_slotById.erase(it);
+
+    Position &position = m_slots[slot];
+    const int sign = sideSign(position.side);
+    position.currentPrice = closePrice;
+    position.closeTime = closeTime;
+    position.isOpen = false;
+    position.realizedPnL = (closePrice - position.entryPrice) * sign * position.size * contractSize;
+    position.unrealizedPnL = 0.0;
+    closed = position;
+
+    ClosedTrade trade;
+    trade.orderId = position.orderId;
+    trade.symbolId = position.symbolId;
+    trade.sideSign = sign;
+    trade.size = position.size;
+    trade.entryPrice = position.entryPrice;
+    trade.exitPrice = closePrice;
+    trade.realizedPnL = position.realizedPnL;
+    trade.openTimeMs = position.openTime.isValid() ? position.openTime.toMSecsSinceEpoch() : 0;
+    trade.closeTimeMs = closeTime.toMSecsSinceEpoch();
+    m_historyById.insert(trade.orderId, static_cast<int>(m_history.size()));
+    m_history.push_back(trade);
+
+    // Swap-remove from the dense open list; other slots keep their index
+    const int index = m_openIndex[slot];
+    const int last = m_openSlots.back();
+    m_openSlots[index] = last;
+    m_openIndex[last] = index;
+    m_openSlots.pop_back();
+    m_openIndex[slot] = -1;
+
+    position = Position();
+    m_freeSlots.push_back(slot);
+    return true;
+}
+
+void PositionStore::clear()
+{
+    m_slots.clear();
+    m_openIndex.clear();
+    m_openSlots.clear();
+    m_freeSlots.clear();
+    m_slotById.clear();
+}
+
+int PositionStore::symbolId(const QString &symbol)
+{
+    auto it = m_symbolIds.constFind(symbol);
+    if (it != m_symbolIds.constEnd()) {
+        return it.value();
+    }
+    int id = static_cast<int>(m_symbols.size());
+    m_symbols.push_back(symbol);
+    m_symbolIds.insert(symbol, id);
+    return id;
+}
+
+QString PositionStore::symbolName(int symbolId) const
+{
+    return symbolId >= 0 && symbolId < static_cast<int>(m_symbols.size()) ? m_symbols[symbolId] : QString();
+}
+
+std::vector<Position> PositionStore::openPositions() const
+{
+    std::vector<Position> positions;
+    positions.reserve(m_openSlots.size());
+    for (int slot : m_openSlots) {
+        positions.push_back(m_slots[slot]);
+    }
+    return positions;
+}
+
+const ClosedTrade *PositionStore::findClosed(const QString &positionId) const
+{
+    auto it = m_historyById.constFind(positionId);
+    return it != m_historyById.constEnd() ? &m_history[it.value()] : nullptr;
+}
+
+Position PositionStore::toPosition(const ClosedTrade &trade) const
+{
+    Position position;
+    position.symbol = symbolName(trade.symbolId);
+    position.side = trade.sideSign < 0 ? "SELL" : "BUY";
+    position.size = trade.size;
+    position.entryPrice = trade.entryPrice;
+    position.currentPrice = trade.exitPrice;
+    position.stopLoss = 0.0;
+    position.takeProfit = 0.0;
+    position.unrealizedPnL = 0.0;
+    position.realizedPnL = trade.realizedPnL;
+    position.openTime = QDateTime::fromMSecsSinceEpoch(trade.openTimeMs);
+    position.closeTime = QDateTime::fromMSecsSinceEpoch(trade.closeTimeMs);
+    position.isOpen = false;
+    position.orderId = trade.orderId;
+    position.symbolId = trade.symbolId;
+    position.margin = 0.0;
+    return position;
+}
+
+std::vector<Position> PositionStore::closedPositions() const
+{
+    std::vector<Position> positions;
+    positions.reserve(m_history.size());
+    for (const auto &trade : m_history) {
+        positions.push_back(toPosition(trade));
+    }
+    return positions;
+}
@@ -1,5 +1,21 @@
 #include "RiskManager.h"
+#include "TradeJournal.h"
+#include "LatencyProbe.h"
+#include "Metrics.h"
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QMetaMethod>
+#include <algorithm>
+#include <cmath>
+
+static MetricCounter &METRIC_RISK_REJECTIONS = Metrics::counter("mmt_risk_rejections_total", "Orders refused by the pre-trade risk check");
+static MetricGauge &METRIC_EQUITY = Metrics::gauge("mmt_equity", "Account equity after realized P&L");
+static MetricGauge &METRIC_UNREALIZED = Metrics::gauge("mmt_unrealized_pnl", "Unrealized P&L of the open book");
+static MetricGauge &METRIC_DAILY_PNL = Metrics::gauge("mmt_daily_pnl", "Marked equity change since the start of the day");
+static MetricGauge &METRIC_DRAWDOWN = Metrics::gauge("mmt_drawdown", "Current peak-to-trough drawdown of marked equity");
+static MetricGauge &METRIC_MAX_DRAWDOWN = Metrics::gauge("mmt_max_drawdown", "Largest drawdown of marked equity");
+static MetricGauge &METRIC_OPEN_POSITIONS = Metrics::gauge("mmt_open_positions", "Open positions");
+static MetricGauge &METRIC_EXPOSURE = Metrics::gauge("mmt_exposure", "Gross notional of the open book");
 
 RiskManager::RiskManager(QObject *parent)
     : QObject(parent)
@@ -11,6 +27,7 @@ RiskManager::RiskManager(QObject *parent)
     , m_maxDrawdownPercent(DEFAULT_MAX_DRAWDOWN)
     , m_maxTradesPerDay(DEFAULT_MAX_TRADES_PER_DAY)
     , m_dailyPnL(0.0)
+    , m_markedDailyPnL(0.0)
     , m_weeklyPnL(0.0)
     , m_monthlyPnL(0.0)
     , m_maxDrawdown(0.0)
@@ -18,17 +35,32 @@ RiskManager::RiskManager(QObject *parent)
     , m_dailyTradeCount(0)
     , m_counterTradingEnabled(false)
     , m_tradesPerCounter(DEFAULT_TRADES_PER_COUNTER)
-    , m_currentCounterTrades(0)
-    , m_counterNumber(0)
-    , m_counterStartEquity(0.0)
     , m_totalTrades(0)
     , m_winningTrades(0)
     , m_totalProfit(0.0)
     , m_totalLoss(0.0)
     , m_largestWin(0.0)
     , m_largestLoss(0.0)
+    , m_totalRisk(0.0)
+    , m_usedMargin(0.0)
+    , m_instruments(std::make_shared<InstrumentRegistry>())
+    , m_warnedDrawdown(0.0)
+    , m_journaledDrawdown(0.0)
+    , m_maxPortfolioVaR(DEFAULT_MAX_PORTFOLIO_VAR)
+    , m_dailyLossLimit(0.0)
+    , m_drawdownLimit(0.0)
+    , m_breaches(BREACH_NONE)
+    , m_snapshotVersion(0)
+    , m_journal(nullptr)
 {
     // Initialize with default values
+    m_metrics.lastUpdate = QDateTime::currentDateTime();
+    m_stats.reset(m_metrics.lastUpdate.toMSecsSinceEpoch(), m_equity);
+    m_counters.start(m_equity, m_metrics.lastUpdate.toMSecsSinceEpoch());
+    m_portfolioView = m_portfolioRisk.view(m_positions.symbolIds());
+    m_pendingBreaches = BreachEvents{BREACH_NONE, BREACH_NONE, false, 0.0};
+    updateLimitThresholds();
+    refreshMetrics(false);
 }
 
 RiskManager::~RiskManager()
@@ -45,69 +77,183 @@ void RiskManager::loadConfig(const QJsonObject &config)
         if (risk.contains("maxOpenPositions")) setMaxOpenPositions(risk["maxOpenPositions"].toInt());
         if (risk.contains("maxTradesPerDay")) setMaxTradesPerDay(risk["maxTradesPerDay"].toInt());
         if (risk.contains("maxDrawdown")) setMaxDrawdown(risk["maxDrawdown"].toDouble());
+        if (risk.contains("statsSamplePeriodMs")) setStatsSamplePeriod(static_cast<qint64>(risk["statsSamplePeriodMs"].toDouble()));
+        if (risk.contains("returnWindows")) {
+            std::vector<int> windows;
+            for (const QJsonValue &value : risk["returnWindows"].toArray()) {
+                windows.push_back(value.toInt());
+            }
+            setReturnWindows(windows);
+        }
+        if (risk.contains("maxPortfolioVaR")) setMaxPortfolioVaR(risk["maxPortfolioVaR"].toDouble());
+        if (risk.contains("portfolioVaR")) {
+            QJsonObject var = risk["portfolioVaR"].toObject();
+            QMutexLocker locker(&m_mutex);
+            if (var.contains("decay")) m_portfolioRisk.setDecay(var["decay"].toDouble());
+            if (var.contains("confidence")) m_portfolioRisk.setConfidence(var["confidence"].toDouble());
+            if (var.contains("samplePeriodMs")) m_portfolioRisk.setSamplePeriod(static_cast<qint64>(var["samplePeriodMs"].toDouble()));
+            if (var.contains("horizonMs")) m_portfolioRisk.setHorizon(static_cast<qint64>(var["horizonMs"].toDouble()));
+            rebuildPortfolioRisk();
+            refreshMetrics(false);
+        }
+    }
+    if (config.contains("strategy")) {
+        QJsonObject strategy = config["strategy"].toObject();
+        if (strategy.contains("counterTradingEnabled")) setCounterTradingEnabled(strategy["counterTradingEnabled"].toBool());
+        if (strategy.contains("tradesPerCounter")) setTradesPerCounter(strategy["tradesPerCounter"].toInt());
+        QMutexLocker locker(&m_mutex);
+        m_counters.setLookback(strategy["counterLookback"].toInt());
+        m_counters.setReassessment(strategy["counterLossReduction"].toDouble(),
+                                   strategy["counterMinCapitalScale"].toDouble(),
+                                   strategy["counterMaxCapitalScale"].toDouble());
+        locker.unlock();
+        if (strategy.contains("counterHistoryFile")) openCounterHistory(strategy["counterHistoryFile"].toString());
     }
     if (config.contains("capital")) {
         QJsonObject capital = config["capital"].toObject();
         if (capital.contains("totalCapital")) setEquity(capital["totalCapital"].toDouble());
     }
+    
+    // Specs from the "instruments" section; allocated symbols without one are inferred.
+    // Built on a copy and swapped in, so checks in flight keep the registry they started with
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<InstrumentRegistry> instruments = std::make_shared<InstrumentRegistry>(*m_instruments);
+    instruments->loadConfig(config);
+    QJsonObject allocation = config["capital"].toObject()["allocation"].toObject();
+    for (const QString &symbol : allocation.keys()) {
+        if (!instruments->contains(symbol)) {
+            instruments->addInstrument(InstrumentRegistry::inferSpec(symbol));
+        }
+    }
+    m_instruments = std::move(instruments);
+    refreshMetrics(false);
+}
+
+void RiskManager::addInstrument(const InstrumentSpec &spec)
+{
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<InstrumentRegistry> instruments = std::make_shared<InstrumentRegistry>(*m_instruments);
+    instruments->addInstrument(spec);
+    m_instruments = std::move(instruments);
+    refreshMetrics(false);
+}
+
+void RiskManager::setStatsSamplePeriod(qint64 periodMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.setSamplePeriod(periodMs);
+}
+
+void RiskManager::setReturnWindows(const std::vector<int> &windows)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.setReturnWindows(windows);
+    refreshMetrics(false);
 }
 
 void RiskManager::setMaxRiskPerTrade(double percent)
 {
     QMutexLocker locker(&m_mutex);
     m_maxRiskPerTrade = percent;
+    refreshMetrics(false);
 }
 
 void RiskManager::setMaxDailyRisk(double percent)
 {
     QMutexLocker locker(&m_mutex);
     m_maxDailyRisk = percent;
+    updateLimitThresholds();
+    refreshMetrics(false);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
 }
 
 void RiskManager::setMaxOpenPositions(int count)
 {
     QMutexLocker locker(&m_mutex);
     m_maxOpenPositions = count;
+    refreshMetrics(false);
 }
 
 void RiskManager::setMaxDrawdown(double percent)
 {
     QMutexLocker locker(&m_mutex);
     m_maxDrawdownPercent = percent;
+    updateLimitThresholds();
+    refreshMetrics(false);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
 }
 
 void RiskManager::setEquity(double equity)
 {
     QMutexLocker locker(&m_mutex);
     m_equity = equity;
+    // Before the first trade this is the session's starting capital
+    const bool fresh = m_totalTrades == 0 && m_positions.openCount() == 0;
+    if (fresh) {
+        m_initialEquity = equity;
+        m_maxDrawdown = 0.0;
+        m_warnedDrawdown = 0.0;
+        m_journaledDrawdown = 0.0;
+        m_stats.reset(QDateTime::currentMSecsSinceEpoch(), equity);
+        m_counters.start(equity, QDateTime::currentMSecsSinceEpoch());
+    }
+    updateLimitThresholds();
+    refreshMetrics(false);
+    if (TradeJournal *journal = m_journal.load(std::memory_order_acquire)) {
+        journal->recordEquity(m_equity, m_initialEquity);
+        // The drawdown starts over on replay as well
+        if (fresh) journal->recordDrawdown(equity, 0.0, 0.0);
+    }
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
+}
+
+void RiskManager::setMaxPortfolioVaR(double percent)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxPortfolioVaR = percent;
+    refreshMetrics(false);
 }
 
 void RiskManager::setMaxTradesPerDay(int count)
 {
     QMutexLocker locker(&m_mutex);
     m_maxTradesPerDay = count;
+    refreshMetrics(false);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
 }
 
 void RiskManager::setCounterTradingEnabled(bool enabled)
 {
     QMutexLocker locker(&m_mutex);
     m_counterTradingEnabled = enabled;
+    refreshMetrics(false);
 }
 
 void RiskManager::setTradesPerCounter(int count)
 {
     QMutexLocker locker(&m_mutex);
     m_tradesPerCounter = count;
+    m_counters.setTradesPerCounter(count);
+    refreshMetrics(false);
 }
 
 double RiskManager::calculateLotSize(const QString &symbol, double stopLossPips, double riskPercent)
 {
-    QMutexLocker locker(&m_mutex);
-    // Standard risk: Lot size = (Equity * Risk%) / (StopLoss in price units)
-    double riskAmount = m_equity * (riskPercent / 100.0);
-    if (stopLossPips <= 0.0) return 0.01;
-    double lotSize = riskAmount / stopLossPips;
-    if (lotSize < 0.01) lotSize = 0.01;
+    // Standard risk: Lot size = (Equity * Risk%) / (StopLoss in pips * pip value per lot)
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
+    const InstrumentRegistry &instruments = *snapshot->instruments;
+    double riskAmount = snapshot->equity * (riskPercent / 100.0);
+    double pipValue = instruments.pipValue(symbol, 1.0);
+    if (stopLossPips <= 0.0 || pipValue <= 0.0) return instruments.roundLots(symbol, 0.0);
+    double lotSize = instruments.roundLots(symbol, riskAmount / (stopLossPips * pipValue));
     double maxLot = calculateMaxLotSize(symbol);
     if (lotSize > maxLot) lotSize = maxLot;
     return lotSize;
@@ -115,185 +261,393 @@ double RiskManager::calculateLotSize(const QString &symbol, double stopLossPips,
 
 double RiskManager::calculateMaxLotSize(const QString &symbol)
 {
-    Q_UNUSED(symbol)
-    
-    // Stub implementation
-    return 1.0;
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
+    const InstrumentRegistry &instruments = *snapshot->instruments;
+    if (instruments.mark(symbol) <= 0.0) {
+        // No price yet, so margin cannot bound the size; the venue limit still does
+        return instruments.spec(symbol).maxQuantity;
+    }
+    double availableMargin = snapshot->equity + snapshot->metrics.unrealizedPnL - snapshot->usedMargin;
+    return instruments.maxLots(symbol, availableMargin);
 }
 
 bool RiskManager::shouldClosePosition(const QString &positionId)
 {
-    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
     // Close if drawdown or daily risk exceeded
-    if (isDailyRiskExceeded() || isDrawdownExceeded()) return true;
-    // Optionally, close if unrealized loss exceeds risk per trade
-    auto it = m_positionMap.find(positionId);
-    if (it != m_positionMap.end()) {
-        const Position &pos = it->second;
-        double maxRisk = m_equity * (m_maxRiskPerTrade / 100.0);
-        if (std::abs(pos.unrealizedPnL) > maxRisk) return true;
-    }
-    return false;
+    if (dailyRiskExceeded(*snapshot) || drawdownExceeded(*snapshot)) return true;
+    // Optionally, close if unrealized loss exceeds risk per trade; per-position marks need the book
+    double maxRisk = snapshot->equity * (snapshot->maxRiskPerTrade / 100.0);
+    QMutexLocker locker(&m_mutex);
+    int slot = m_positions.findSlot(positionId);
+    return slot >= 0 && std::abs(m_book.rowUnrealizedPnL(slot)) > maxRisk;
 }
 
 bool RiskManager::isRiskAcceptable(double lotSize, double stopLossPips)
 {
-    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
     // Check if this trade would exceed max risk per trade or daily risk
     double riskAmount = lotSize * stopLossPips;
-    double maxRisk = m_equity * (m_maxRiskPerTrade / 100.0);
+    double maxRisk = snapshot->equity * (snapshot->maxRiskPerTrade / 100.0);
     if (riskAmount > maxRisk) return false;
-    double dailyRiskLimit = m_equity * (m_maxDailyRisk / 100.0);
-    if ((std::abs(m_dailyPnL) + riskAmount) > dailyRiskLimit) return false;
+    double dailyRiskLimit = snapshot->equity * (snapshot->maxDailyRisk / 100.0);
+    // Only today's losses use up the daily budget
+    if ((std::max(0.0, -snapshot->dailyPnL) + riskAmount) > dailyRiskLimit) return false;
     return true;
 }
 
 bool RiskManager::canOpenPosition(const QString &symbol, double lotSize)
 {
-    QMutexLocker locker(&m_mutex);
-    // Check open positions
-    if (m_openPositions.size() >= static_cast<size_t>(m_maxOpenPositions)) return false;
-    // Check daily trade count
-    if (m_dailyTradeCount >= m_maxTradesPerDay) return false;
-    // Check daily risk
-    double dailyRiskLimit = m_equity * (m_maxDailyRisk / 100.0);
-    if (std::abs(m_dailyPnL) >= dailyRiskLimit) return false;
-    // Check drawdown
-    double drawdownLimit = m_initialEquity * (m_maxDrawdownPercent / 100.0);
-    if (m_maxDrawdown >= drawdownLimit) return false;
+    LATENCY_PROBE(ProbeStage::RISK_CHECK);
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
+    const char *rejection = openRejection(*snapshot, symbol, "BUY", lotSize);
+    // Side unknown: the order must fit the VaR limit either way
+    if (!rejection && !portfolioRiskAcceptable(*snapshot, symbol, -snapshot->instruments->notional(symbol, lotSize))) {
+        rejection = "portfolio VaR";
+    }
+    recordDecision(symbol, "ANY", lotSize, rejection);
+    return !rejection;
+}
+
+bool RiskManager::canOpenPosition(const QString &symbol, const QString &side, double lotSize)
+{
+    LATENCY_PROBE(ProbeStage::RISK_CHECK);
+    // Every check reads the same snapshot, so the decision is consistent without a lock
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
+    const char *rejection = openRejection(*snapshot, symbol, side, lotSize);
+    recordDecision(symbol, side, lotSize, rejection);
+    return !rejection;
+}
+
+const char *RiskManager::openRejection(const RiskSnapshot &snapshot, const QString &symbol, const QString &side,
+                                       double lotSize) const
+{
+    if (snapshot.openPositions >= snapshot.maxOpenPositions) return "max open positions";
+    if (snapshot.dailyTradeCount >= snapshot.maxTradesPerDay) return "max trades per day";
+    if (dailyRiskExceeded(snapshot)) return "daily risk";
+    if (drawdownExceeded(snapshot)) return "drawdown";
     // Check risk per trade
-    double maxRisk = m_equity * (m_maxRiskPerTrade / 100.0);
-    if ((lotSize * 10.0) > maxRisk) return false; // Assume 10 price units as default stop loss if not provided
-    // Counter trading logic
-    if (m_counterTradingEnabled && m_currentCounterTrades >= m_tradesPerCounter) return false;
-    return true;
+    double maxRisk = snapshot.equity * (snapshot.maxRiskPerTrade / 100.0);
+    if ((lotSize * 10.0) > maxRisk) return "risk per trade"; // Assume 10 price units as default stop loss if not provided
+    if (snapshot.counterTradingEnabled && counterComplete(snapshot)) return "counter complete";
+    // Portfolio VaR with this order added, O(1) from the published view
+    double delta = PositionStore::sideSign(side) * snapshot.instruments->notional(symbol, lotSize);
+    if (!portfolioRiskAcceptable(snapshot, symbol, delta)) return "portfolio VaR";
+    return nullptr;
+}
+
+void RiskManager::recordDecision(const QString &symbol, const QString &side, double lotSize, const char *rejection)
+{
+    if (rejection) METRIC_RISK_REJECTIONS.increment();
+    if (TradeJournal *journal = m_journal.load(std::memory_order_acquire)) {
+        journal->recordRiskDecision(symbol, side, lotSize, !rejection, rejection ? rejection : "");
+    }
+}
+
+double RiskManager::calculateMarginalVaR(const QString &symbol, const QString &side, double lotSize) const
+{
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
+    double delta = PositionStore::sideSign(side) * snapshot->instruments->notional(symbol, lotSize);
+    return snapshot->portfolio->marginalVaR(symbol, delta);
 }
 
 bool RiskManager::isDailyRiskExceeded()
 {
-    QMutexLocker locker(&m_mutex);
-    double dailyRiskLimit = m_equity * (m_maxDailyRisk / 100.0);
-    return std::abs(m_dailyPnL) >= dailyRiskLimit;
+    return dailyRiskExceeded(*getSnapshot());
 }
 
 bool RiskManager::isDrawdownExceeded()
 {
-    QMutexLocker locker(&m_mutex);
-    double drawdownLimit = m_initialEquity * (m_maxDrawdownPercent / 100.0);
-    return m_maxDrawdown >= drawdownLimit;
+    return drawdownExceeded(*getSnapshot());
 }
 
 bool RiskManager::isMaxTradesReached()
 {
-    QMutexLocker locker(&m_mutex);
-    return m_dailyTradeCount >= m_maxTradesPerDay;
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
+    return snapshot->dailyTradeCount >= snapshot->maxTradesPerDay;
 }
 
 void RiskManager::addPosition(const Position &position)
 {
     QMutexLocker locker(&m_mutex);
-    m_openPositions.push_back(position);
-    m_positionMap[position.orderId] = position;
-    emit positionOpened(position);
+    int slot = openPositionLocked(position);
+    rebuildPortfolioRisk();
+    refreshMetrics(true);
+    Position marked = markedPosition(slot);
+    if (TradeJournal *journal = m_journal.load(std::memory_order_acquire)) {
+        journal->recordPositionOpen(marked);
+    }
+    BreachEvents events = takeBreachEvents();
+    // Signals go out after the writer lock is released so slots may call back in
+    locker.unlock();
+    emit positionOpened(marked);
+    emitBreachEvents(events);
+}
+
+int RiskManager::openPositionLocked(const Position &position)
+{
+    Position opened = position;
+    opened.isOpen = true;
+    if (opened.currentPrice <= 0.0) opened.currentPrice = opened.entryPrice;
+    opened.unrealizedPnL = calculateUnrealizedPnL(opened);
+    opened.margin = m_instruments->marginRequirement(opened.symbol, opened.size, opened.entryPrice,
+                                                     opened.side == "SELL");
+    
+    // Replacing a live id must not double count it
+    if (const Position *existing = m_positions.find(opened.orderId)) {
+        applyPositionContribution(*existing, -1.0);
+    }
+    
+    int slot = m_positions.open(opened);
+    const Position *stored = m_positions.at(slot);
+    applyPositionContribution(*stored, 1.0);
+    // A position opened before any quote seeds the symbol's mark
+    if (m_book.price(stored->symbolId) <= 0.0) {
+        m_book.setPrice(stored->symbolId, stored->currentPrice);
+        m_instruments->setMark(stored->symbol, stored->currentPrice);
+        onSymbolPrice(stored->symbolId, stored->currentPrice);
+    }
+    // The book works in units of the base, positions in lots
+    m_book.setRow(slot, stored->symbolId, stored->size * m_instruments->contractSize(stored->symbol),
+                  stored->entryPrice, PositionStore::sideSign(stored->side));
+    return slot;
 }
 
 void RiskManager::updatePosition(const QString &positionId, double currentPrice)
 {
     QMutexLocker locker(&m_mutex);
     
-    auto it = m_positionMap.find(positionId);
-    if (it != m_positionMap.end()) {
-        it->second.currentPrice = currentPrice;
-        // Update unrealized P&L
-        it->second.unrealizedPnL = calculateUnrealizedPnL(it->second);
-        emit positionUpdated(it->second);
-    }
+    int slot = m_positions.findSlot(positionId);
+    if (slot < 0) return;
+    // Prices are per symbol: this re-marks every position in it
+    m_book.setPrice(m_positions.at(slot)->symbolId, currentPrice);
+    m_instruments->setMark(m_positions.at(slot)->symbol, currentPrice);
+    onSymbolPrice(m_positions.at(slot)->symbolId, currentPrice);
+    refreshMetrics(false);
+    Position marked = markedPosition(slot);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emit positionUpdated(marked);
+    emitBreachEvents(events);
 }
 
 void RiskManager::closePosition(const QString &positionId, double closePrice)
 {
     QMutexLocker locker(&m_mutex);
     
-    auto it = m_positionMap.find(positionId);
-    if (it != m_positionMap.end()) {
-        Position &position = it->second;
-        position.currentPrice = closePrice;
-        position.closeTime = QDateTime::currentDateTime();
-        position.isOpen = false;
-        
-        // Calculate realized P&L
-        double pnl = calculateUnrealizedPnL(position);
-        position.realizedPnL = pnl;
-        
-        // Update statistics
-        m_dailyPnL += pnl;
-        m_totalTrades++;
-        m_dailyTradeCount++;
-        
-        if (pnl > 0) {
-            m_winningTrades++;
-            m_totalProfit += pnl;
-            if (pnl > m_largestWin) {
-                m_largestWin = pnl;
-            }
-        } else {
-            m_totalLoss += std::abs(pnl);
-            if (std::abs(pnl) > m_largestLoss) {
-                m_largestLoss = std::abs(pnl);
+    int slot = m_positions.findSlot(positionId);
+    if (slot < 0) return;
+    applyPositionContribution(*m_positions.at(slot), -1.0);
+    m_book.setPrice(m_positions.at(slot)->symbolId, closePrice);
+    m_book.clearRow(slot);
+    const QString symbol = m_positions.at(slot)->symbol;
+    m_instruments->setMark(symbol, closePrice);
+    onSymbolPrice(m_positions.at(slot)->symbolId, closePrice);
+    
+    // The store computes realized P&L and moves the position to the trade history
+    Position position;
+    m_positions.close(positionId, closePrice, QDateTime::currentDateTime(), position,
+                      m_instruments->contractSize(symbol));
+    double pnl = position.realizedPnL;
+    
+    // Update statistics
+    m_equity += pnl;
+    m_dailyPnL += pnl;
+    m_totalTrades++;
+    m_dailyTradeCount++;
+    
+    bool counterClosed = false;
+    CounterStats completedCounter;
+    if (m_counterTradingEnabled) {
+        qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+        if (m_counters.recordTrade(pnl, m_equity, nowMs)) {
+            completedCounter = m_counters.finish(m_equity, nowMs);
+            counterClosed = true;
+        }
+    }
+    
+    if (pnl > 0) {
+        m_winningTrades++;
+        m_totalProfit += pnl;
+        if (pnl > m_largestWin) {
+            m_largestWin = pnl;
+        }
+    } else {
+        m_totalLoss += std::abs(pnl);
+        if (std::abs(pnl) > m_largestLoss) {
+            m_largestLoss = std::abs(pnl);
+        }
+    }
+    
+    updateLimitThresholds();
+    rebuildPortfolioRisk();
+    refreshMetrics(true);
+    if (TradeJournal *journal = m_journal.load(std::memory_order_acquire)) {
+        journal->recordPositionClose(position, m_equity);
+    }
+    BreachEvents events = takeBreachEvents();
+    double capitalScale = m_counters.capitalScale();
+    locker.unlock();
+    emit positionClosed(position);
+    if (counterClosed) {
+        emit counterCompleted(completedCounter.counterNumber, completedCounter.netPnL);
+        emit counterStatsCompleted(completedCounter);
+        emit capitalReassessed(capitalScale);
+    }
+    emitBreachEvents(events);
+}
+
+void RiskManager::reducePosition(const QString &positionId, double quantity, double closePrice)
+{
+    QString closing = positionId;
+    {
+        QMutexLocker locker(&m_mutex);
+        const Position *open = m_positions.find(positionId);
+        if (!open || quantity <= 0.0) return;
+        if (quantity < open->size * (1.0 - 1e-9)) {
+            Position rest = *open;
+            Position slice = *open;
+            rest.size -= quantity;
+            slice.size = quantity;
+            slice.orderId = positionId + "#" + QString::number(m_positions.history().size() + 1);
+            closing = slice.orderId;
+            openPositionLocked(rest);
+            openPositionLocked(slice);
+            if (TradeJournal *journal = m_journal.load(std::memory_order_acquire)) {
+                journal->recordPositionOpen(rest);
+                journal->recordPositionOpen(slice);
             }
         }
-        
-        // Move to closed positions
-        m_closedPositions.push_back(position);
-        
-        // Remove from open positions
-        m_openPositions.erase(
-            std::remove_if(m_openPositions.begin(), m_openPositions.end(),
-                [&positionId](const Position &p) { return p.orderId == positionId; }),
-            m_openPositions.end()
-        );
-        
-        emit positionClosed(position);
     }
+    closePosition(closing, closePrice);
 }
 
 void RiskManager::clearAllPositions()
 {
     QMutexLocker locker(&m_mutex);
-    m_openPositions.clear();
-    m_positionMap.clear();
+    m_positions.clear();
+    m_book.clearRows();
+    m_totalRisk = 0.0;
+    m_usedMargin = 0.0;
+    rebuildPortfolioRisk();
+    refreshMetrics(true);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
+}
+
+void RiskManager::setJournal(TradeJournal *journal)
+{
+    m_journal.store(journal, std::memory_order_release);
+}
+
+void RiskManager::restoreFromJournal(const JournalState &state)
+{
+    QMutexLocker locker(&m_mutex);
+    m_equity = state.equity;
+    m_initialEquity = state.initialEquity;
+    // Day statistics only carry over within the same day; the counters persist themselves
+    if (state.day == QDate::currentDate()) {
+        m_dailyTradeCount = state.dailyTrades;
+        m_dailyPnL = state.dailyPnL;
+        m_totalTrades = state.dailyTrades;
+        m_winningTrades = state.winningTrades;
+        m_totalProfit = state.grossProfit;
+        m_totalLoss = state.grossLoss;
+        m_largestWin = state.largestWin;
+        m_largestLoss = state.largestLoss;
+        m_lastTradingDay = QDateTime::currentDateTime();
+    }
+    m_positions.clear();
+    m_book.clearRows();
+    m_totalRisk = 0.0;
+    m_usedMargin = 0.0;
+    for (const auto &entry : state.openPositions) {
+        openPositionLocked(entry.second);
+    }
+    // The peak and worst drawdown outlive the restart, so a tripped drawdown limit stays tripped
+    m_stats.reset(QDateTime::currentMSecsSinceEpoch(), m_equity);
+    m_stats.restoreDrawdown(state.peakEquity, state.maxDrawdown, state.maxDrawdownPercent);
+    // The day's realized loss still counts against the daily limit; marks restart from here
+    m_stats.setDailyPnL(m_dailyPnL);
+    m_maxDrawdown = m_stats.maxDrawdown();
+    m_warnedDrawdown = m_maxDrawdown;
+    m_journaledDrawdown = m_maxDrawdown;
+    updateLimitThresholds();
+    rebuildPortfolioRisk();
+    refreshMetrics(true);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
+}
+
+void RiskManager::setCapitalAllocator(CapitalAllocator *allocator)
+{
+    QMutexLocker locker(&m_mutex);
+    m_counters.setCapitalAllocator(allocator);
+}
+
+bool RiskManager::openCounterHistory(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    bool opened = m_counters.openHistory(path);
+    m_counters.start(m_equity, QDateTime::currentMSecsSinceEpoch());
+    refreshMetrics(false);
+    return opened;
 }
 
 void RiskManager::startNewCounter()
 {
+    // Discards the trades counted so far in the current counter
     QMutexLocker locker(&m_mutex);
-    m_counterNumber++;
-    m_currentCounterTrades = 0;
-    m_counterStartEquity = m_equity;
+    m_counters.start(m_equity, QDateTime::currentMSecsSinceEpoch());
+    refreshMetrics(false);
 }
 
 void RiskManager::endCurrentCounter()
 {
+    // Closes the current counter early, with whatever trades it has
     QMutexLocker locker(&m_mutex);
-    double counterPnL = m_equity - m_counterStartEquity;
-    m_counterResults.push_back(counterPnL);
-    emit counterCompleted(m_counterNumber, counterPnL);
+    if (m_counters.current().trades == 0) return;
+    CounterStats completed = m_counters.finish(m_equity, QDateTime::currentMSecsSinceEpoch());
+    double capitalScale = m_counters.capitalScale();
+    refreshMetrics(false);
+    locker.unlock();
+    emit counterCompleted(completed.counterNumber, completed.netPnL);
+    emit counterStatsCompleted(completed);
+    emit capitalReassessed(capitalScale);
 }
 
-bool RiskManager::isCounterComplete()
+CounterStats RiskManager::getCurrentCounter() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_currentCounterTrades >= m_tradesPerCounter;
+    return m_counters.current();
 }
 
-bool RiskManager::shouldContinueTrading()
+std::vector<CounterStats> RiskManager::getCounterHistory() const
 {
     QMutexLocker locker(&m_mutex);
+    return std::vector<CounterStats>(m_counters.history().begin(), m_counters.history().end());
+}
+
+CounterSummary RiskManager::getCounterSummary() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_counters.summary();
+}
+
+bool RiskManager::isCounterComplete()
+{
+    return counterComplete(*getSnapshot());
+}
+
+bool RiskManager::shouldContinueTrading()
+{
+    std::shared_ptr<const RiskSnapshot> snapshot = getSnapshot();
     
-    // Check if counter trading is enabled and counter is complete
-    if (m_counterTradingEnabled && isCounterComplete()) {
-        double counterPnL = m_equity - m_counterStartEquity;
-        return counterPnL > 0; // Continue only if counter was profitable
+    // Counters roll over as they complete: continue only if the last one was profitable
+    if (snapshot->counterTradingEnabled && snapshot->completedCounters > 0) {
+        return snapshot->lastCounterPnL > 0;
     }
     
     return true; // Default to continue
@@ -301,162 +655,367 @@ bool RiskManager::shouldContinueTrading()
 
 RiskMetrics RiskManager::getRiskMetrics() const
 {
-    QMutexLocker locker(&m_mutex);
-    
-    RiskMetrics metrics;
-    metrics.totalEquity = m_equity;
-    metrics.availableMargin = m_equity * 0.8; // Assume 80% available
-    metrics.usedMargin = m_equity * 0.2; // Assume 20% used
-    metrics.dailyPnL = m_dailyPnL;
-    metrics.weeklyPnL = m_weeklyPnL;
-    metrics.monthlyPnL = m_monthlyPnL;
-    metrics.maxDrawdown = m_maxDrawdown;
-    metrics.riskUsed = m_riskUsed;
-    metrics.riskRemaining = 100.0 - m_riskUsed;
-    metrics.openPositions = static_cast<int>(m_openPositions.size());
-    metrics.dailyTrades = m_dailyTradeCount;
-    metrics.winRate = m_totalTrades > 0 ? (double)m_winningTrades / m_totalTrades * 100.0 : 0.0;
-    metrics.profitFactor = m_totalLoss > 0 ? m_totalProfit / m_totalLoss : 0.0;
-    metrics.sharpeRatio = 0.0; // Stub
-    metrics.lastUpdate = QDateTime::currentDateTime();
-    
-    return metrics;
+    return getSnapshot()->metrics;
 }
 
 std::vector<Position> RiskManager::getOpenPositions() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_openPositions;
+    std::vector<Position> positions;
+    positions.reserve(m_positions.openCount());
+    for (int slot : m_positions.openSlots()) {
+        positions.push_back(markedPosition(slot));
+    }
+    return positions;
 }
 
 std::vector<Position> RiskManager::getClosedPositions() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_closedPositions;
+    return m_positions.closedPositions();
 }
 
 Position RiskManager::getPosition(const QString &positionId) const
 {
     QMutexLocker locker(&m_mutex);
     
-    auto it = m_positionMap.find(positionId);
-    if (it != m_positionMap.end()) {
-        return it->second;
+    int slot = m_positions.findSlot(positionId);
+    if (slot >= 0) {
+        return markedPosition(slot);
+    }
+    if (const ClosedTrade *trade = m_positions.findClosed(positionId)) {
+        return m_positions.toPosition(*trade);
     }
     
     return Position(); // Return empty position if not found
 }
 
-void RiskManager::onUpdateRiskMetrics()
+void RiskManager::updateMarketPrice(const QString &symbol, double price)
+{
+    QMutexLocker locker(&m_mutex);
+    int symbolId = m_positions.symbolId(symbol);
+    m_book.setPrice(symbolId, price);
+    m_instruments->setMark(symbol, price);
+    onSymbolPrice(symbolId, price);
+    refreshMetrics(false);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
+}
+
+void RiskManager::markToMarket()
 {
-    calculateRiskMetrics();
+    QMutexLocker locker(&m_mutex);
+    m_book.revalue();
+    // Exposures drift with price between fills; the periodic sweep picks that up
+    rebuildPortfolioRisk();
+    refreshMetrics(false);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
 }
 
-void RiskManager::onCheckRiskLimits()
+void RiskManager::updateDailyStatistics()
 {
-    checkRiskLimits();
+    // This would be called at the end of each trading day
+    // Reset daily counters, move to weekly/monthly stats, etc.
 }
 
-void RiskManager::onUpdatePositions()
+bool RiskManager::updateDrawdown()
 {
-    // Update all open positions
-    for (auto &position : m_openPositions) {
-        position.unrealizedPnL = calculateUnrealizedPnL(position);
+    // Called with m_mutex held from takeBreachEvents; drawdownWarning goes out with the breaches.
+    // m_maxDrawdown itself is kept current by refreshMetrics from the running peak
+    if (m_maxDrawdown > m_warnedDrawdown) {
+        m_warnedDrawdown = m_maxDrawdown;
+        return true;
     }
+    return false;
 }
 
-void RiskManager::calculateRiskMetrics()
+void RiskManager::resetDailyCounters()
 {
     QMutexLocker locker(&m_mutex);
-    
-    // Calculate current drawdown
-    updateDrawdown();
-    
-    // Calculate risk usage
-    double totalRisk = 0.0;
-    for (const auto &position : m_openPositions) {
-        totalRisk += calculatePositionRisk(position);
-    }
-    
-    m_riskUsed = (totalRisk / m_equity) * 100.0;
-    
-    // Emit updated metrics
-    emit riskMetricsUpdated(getRiskMetrics());
+    m_dailyTradeCount = 0;
+    m_dailyPnL = 0.0;
+    m_stats.setDailyPnL(0.0);
+    m_lastTradingDay = QDateTime::currentDateTime();
+    refreshMetrics(true);
+    BreachEvents events = takeBreachEvents();
+    locker.unlock();
+    emitBreachEvents(events);
 }
 
-void RiskManager::updateDailyStatistics()
+bool RiskManager::isNewTradingDay()
 {
-    // This would be called at the end of each trading day
-    // Reset daily counters, move to weekly/monthly stats, etc.
+    QDateTime now = QDateTime::currentDateTime();
+    return m_lastTradingDay.date() != now.date();
 }
 
-void RiskManager::updateDrawdown()
+double RiskManager::calculateUnrealizedPnL(const Position &position) const
 {
-    double currentDrawdown = m_initialEquity - m_equity;
-    if (currentDrawdown > m_maxDrawdown) {
-        m_maxDrawdown = currentDrawdown;
-        emit drawdownWarning(currentDrawdown);
+    // Same terms as the book row and PositionStore::close: signed side, lots in units of the base
+    return (position.currentPrice - position.entryPrice) * PositionStore::sideSign(position.side)
+           * position.size * m_instruments->contractSize(position.symbol);
+}
+
+double RiskManager::calculatePositionRisk(const Position &position) const
+{
+    // Calculate the risk for this position
+    double stopLossDistance = std::abs(position.entryPrice - position.stopLoss);
+    return stopLossDistance * position.size * m_instruments->contractSize(position.symbol);
+}
+
+void RiskManager::applyPositionContribution(const Position &position, double sign)
+{
+    // Called with m_mutex held
+    m_totalRisk += sign * calculatePositionRisk(position);
+    m_usedMargin += sign * position.margin;
+}
+
+void RiskManager::onSymbolPrice(int symbolId, double price)
+{
+    // Called with m_mutex held; the covariance only moves when a sample period closes
+    if (m_portfolioRisk.onPrice(symbolId, price, QDateTime::currentMSecsSinceEpoch())) {
+        rebuildPortfolioRisk();
     }
 }
 
-void RiskManager::checkRiskLimits()
+void RiskManager::rebuildPortfolioRisk()
 {
-    if (isDailyRiskExceeded()) {
-        emit riskLimitReached("Daily risk limit exceeded");
-        emit tradingHalted("Daily risk limit exceeded");
+    // Called with m_mutex held. O(symbols^2), run on fills, covariance samples and the
+    // periodic sweep rather than per tick; dozens of symbols is a few microseconds
+    std::vector<double> exposure(m_positions.symbolCount(), 0.0);
+    for (int id = 0; id < static_cast<int>(exposure.size()); ++id) {
+        double net = m_book.netSize(id);
+        if (net != 0.0) {
+            exposure[id] = net * m_book.price(id) * m_instruments->quoteConversion(m_positions.symbolName(id));
+        }
     }
+    m_portfolioRisk.setExposures(exposure);
+    m_portfolioView = m_portfolioRisk.view(m_positions.symbolIds());
+}
+
+Position RiskManager::markedPosition(int slot) const
+{
+    // Called with m_mutex held; the stored Position keeps entry data, the book holds the mark
+    Position position = *m_positions.at(slot);
+    position.currentPrice = m_book.price(position.symbolId);
+    position.unrealizedPnL = m_book.rowUnrealizedPnL(slot);
+    return position;
+}
+
+void RiskManager::refreshMetrics(bool stampTime)
+{
+    // Called with m_mutex held; O(1) regardless of how many positions are open. Every
+    // writer ends here, so this is also where the new snapshot is published
+    if (m_positions.openCount() == 0) {
+        // Drop accumulated rounding once the book is flat
+        m_totalRisk = 0.0;
+        m_usedMargin = 0.0;
+    }
+    BookTotals book = m_book.totals();
+    m_riskUsed = m_equity > 0.0 ? (m_totalRisk / m_equity) * 100.0 : 0.0;
+    
+    // Streaming stats over marked equity: peak, drawdown, calendar buckets, period returns
+    int rolled = m_stats.update(QDateTime::currentMSecsSinceEpoch(), m_equity + book.unrealizedPnL);
+    if (rolled & PerformanceStats::DAY_ROLLED) {
+        m_dailyTradeCount = 0;
+        m_dailyPnL = 0.0;
+        m_lastTradingDay = QDateTime::currentDateTime();
+    }
+    PnLBuckets buckets = m_stats.pnlBuckets();
+    m_markedDailyPnL = buckets.daily;
+    m_weeklyPnL = buckets.weekly;
+    m_monthlyPnL = buckets.monthly;
+    evaluateLimits();
     
-    if (isDrawdownExceeded()) {
-        emit riskLimitReached("Maximum drawdown exceeded");
-        emit tradingHalted("Maximum drawdown exceeded");
+    m_metrics.totalEquity = m_equity;
+    m_metrics.usedMargin = m_usedMargin;
+    m_metrics.availableMargin = m_equity + book.unrealizedPnL - m_usedMargin;
+    m_metrics.dailyPnL = m_markedDailyPnL;
+    m_metrics.weeklyPnL = m_weeklyPnL;
+    m_metrics.monthlyPnL = m_monthlyPnL;
+    m_metrics.maxDrawdown = m_maxDrawdown;
+    m_metrics.currentDrawdown = m_stats.currentDrawdown();
+    m_metrics.exposure = book.exposure;
+    m_metrics.unrealizedPnL = book.unrealizedPnL;
+    m_metrics.riskUsed = m_riskUsed;
+    m_metrics.riskRemaining = 100.0 - m_riskUsed;
+    m_metrics.openPositions = m_positions.openCount();
+    m_metrics.dailyTrades = m_dailyTradeCount;
+    m_metrics.winRate = m_totalTrades > 0 ? (double)m_winningTrades / m_totalTrades * 100.0 : 0.0;
+    m_metrics.profitFactor = m_totalLoss > 0 ? m_totalProfit / m_totalLoss : 0.0;
+    m_metrics.sharpeRatio = m_stats.sharpe(0);
+    m_metrics.sortinoRatio = m_stats.sortino(0);
+    m_metrics.portfolioVaR = m_portfolioView->valueAtRisk;
+    if (stampTime) {
+        m_metrics.lastUpdate = QDateTime::currentDateTime();
     }
+    METRIC_EQUITY.set(m_equity);
+    METRIC_UNREALIZED.set(book.unrealizedPnL);
+    METRIC_DAILY_PNL.set(m_markedDailyPnL);
+    METRIC_DRAWDOWN.set(m_metrics.currentDrawdown);
+    METRIC_MAX_DRAWDOWN.set(m_maxDrawdown);
+    METRIC_OPEN_POSITIONS.set(m_metrics.openPositions);
+    METRIC_EXPOSURE.set(book.exposure);
     
-    if (isMaxTradesReached()) {
-        emit riskLimitReached("Maximum daily trades reached");
-        emit tradingHalted("Maximum daily trades reached");
+    // Publish: readers holding the previous snapshot keep it alive until they drop it. The one
+    // published before that is refilled in place once no reader holds it any more
+    std::shared_ptr<RiskSnapshot> snapshot;
+    if (m_spareSnapshot && m_spareSnapshot.use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        snapshot = std::move(m_spareSnapshot);
+    } else {
+        snapshot = std::make_shared<RiskSnapshot>();
     }
+    snapshot->equity = m_equity;
+    snapshot->initialEquity = m_initialEquity;
+    snapshot->maxRiskPerTrade = m_maxRiskPerTrade;
+    snapshot->maxDailyRisk = m_maxDailyRisk;
+    snapshot->maxOpenPositions = m_maxOpenPositions;
+    snapshot->maxDrawdownPercent = m_maxDrawdownPercent;
+    snapshot->maxTradesPerDay = m_maxTradesPerDay;
+    snapshot->counterTradingEnabled = m_counterTradingEnabled;
+    snapshot->tradesPerCounter = m_tradesPerCounter;
+    snapshot->currentCounterTrades = m_counters.current().trades;
+    snapshot->counterStartEquity = m_counters.current().startEquity;
+    snapshot->completedCounters = m_counters.summary().counters;
+    snapshot->lastCounterPnL = m_counters.history().empty() ? 0.0 : m_counters.history().back().netPnL;
+    snapshot->dailyPnL = m_markedDailyPnL;
+    snapshot->maxDrawdown = m_maxDrawdown;
+    snapshot->riskUsed = m_riskUsed;
+    snapshot->usedMargin = m_usedMargin;
+    snapshot->maxPortfolioVaR = m_maxPortfolioVaR;
+    snapshot->portfolio = m_portfolioView;
+    snapshot->instruments = m_instruments;
+    snapshot->openPositions = m_positions.openCount();
+    snapshot->dailyTradeCount = m_dailyTradeCount;
+    snapshot->breaches = m_breaches;
+    snapshot->metrics = m_metrics;
+    snapshot->version = ++m_snapshotVersion;
+    std::atomic_store(&m_snapshot, std::shared_ptr<const RiskSnapshot>(snapshot));
+    m_spareSnapshot = std::move(m_liveSnapshot);
+    m_liveSnapshot = std::move(snapshot);
+}
+
+void RiskManager::updateLimitThresholds()
+{
+    // Called with m_mutex held whenever equity or a limit changes, not per tick
+    m_dailyLossLimit = m_equity * (m_maxDailyRisk / 100.0);
+    m_drawdownLimit = m_initialEquity * (m_maxDrawdownPercent / 100.0);
+}
+
+void RiskManager::evaluateLimits()
+{
+    // Called from refreshMetrics with m_mutex held, after the drawdown has been updated
+    // from the latest mark. Same conditions as the snapshot checks below
+    m_maxDrawdown = m_stats.maxDrawdown();
+    // Journaled as it grows, in steps of a hundredth of the limit and always once it trips,
+    // so a restart picks up the drawdown instead of starting from zero
+    if (m_maxDrawdown > m_journaledDrawdown
+        && (m_maxDrawdown - m_journaledDrawdown >= m_drawdownLimit * DRAWDOWN_JOURNAL_STEP
+            || (m_maxDrawdown >= m_drawdownLimit && m_journaledDrawdown < m_drawdownLimit))) {
+        if (TradeJournal *journal = m_journal.load(std::memory_order_acquire)) {
+            journal->recordDrawdown(m_stats.peakEquity(), m_maxDrawdown, m_stats.maxDrawdownPercent());
+            m_journaledDrawdown = m_maxDrawdown;
+        }
+    }
+    int breaches = BREACH_NONE;
+    if (-m_markedDailyPnL >= m_dailyLossLimit) breaches |= BREACH_DAILY_RISK;
+    if (m_maxDrawdown >= m_drawdownLimit) breaches |= BREACH_DRAWDOWN;
+    if (m_dailyTradeCount >= m_maxTradesPerDay) breaches |= BREACH_MAX_TRADES;
+    if (breaches == m_breaches) return;
+    
+    int raised = breaches & ~m_breaches;
+    int cleared = m_breaches & ~breaches;
+    // A limit that flips back before anyone saw it cancels out
+    m_pendingBreaches.cleared = (m_pendingBreaches.cleared & ~raised) | (cleared & ~m_pendingBreaches.raised);
+    m_pendingBreaches.raised = (m_pendingBreaches.raised & ~cleared) | raised;
+    if (m_breaches == BREACH_NONE && breaches != BREACH_NONE) {
+        m_pendingBreaches.halted = true;
+    }
+    m_breaches = breaches;
 }
 
-void RiskManager::resetDailyCounters()
+RiskManager::BreachEvents RiskManager::takeBreachEvents()
 {
-    QMutexLocker locker(&m_mutex);
-    m_dailyTradeCount = 0;
-    m_dailyPnL = 0.0;
-    m_lastTradingDay = QDateTime::currentDateTime();
+    // Called with m_mutex held
+    BreachEvents events = m_pendingBreaches;
+    m_pendingBreaches = BreachEvents{BREACH_NONE, BREACH_NONE, false, 0.0};
+    if (updateDrawdown()) events.drawdownWarning = m_maxDrawdown;
+    return events;
 }
 
-bool RiskManager::isNewTradingDay()
+void RiskManager::emitBreachEvents(const BreachEvents &events)
 {
-    QDateTime now = QDateTime::currentDateTime();
-    return m_lastTradingDay.date() != now.date();
+    // Called without m_mutex, after every change the writer has published
+    if (events.drawdownWarning > 0.0) {
+        emit drawdownWarning(events.drawdownWarning);
+    }
+    // Per tick on the price path, so the metrics copy is only made for a listener
+    static const QMetaMethod metricsUpdated = QMetaMethod::fromSignal(&RiskManager::riskMetricsUpdated);
+    if (isSignalConnected(metricsUpdated)) {
+        emit riskMetricsUpdated(getSnapshot()->metrics);
+    }
+    if (events.raised == BREACH_NONE && events.cleared == BREACH_NONE) return;
+    QString haltReason;
+    for (int breach = BREACH_DAILY_RISK; breach <= BREACH_MAX_TRADES; breach <<= 1) {
+        if (events.raised & breach) {
+            emit riskLimitReached(breachReason(breach));
+            if (haltReason.isEmpty()) haltReason = breachReason(breach);
+        }
+        if (events.cleared & breach) {
+            emit riskLimitCleared(breachReason(breach));
+        }
+    }
+    if (events.halted && !haltReason.isEmpty()) {
+        emit tradingHalted(haltReason);
+    }
 }
 
-double RiskManager::calculateUnrealizedPnL(const Position &position) const
+QString RiskManager::breachReason(int breach)
 {
-    // Simplified P&L calculation
-    double priceDiff = position.currentPrice - position.entryPrice;
-    if (position.side == "SELL") {
-        priceDiff = -priceDiff;
+    switch (breach) {
+    case BREACH_DAILY_RISK: return "Daily risk limit exceeded";
+    case BREACH_DRAWDOWN: return "Maximum drawdown exceeded";
+    case BREACH_MAX_TRADES: return "Maximum daily trades reached";
+    default: return QString();
     }
-    return priceDiff * position.size;
 }
 
-double RiskManager::calculatePositionRisk(const Position &position) const
+bool RiskManager::dailyRiskExceeded(const RiskSnapshot &snapshot)
 {
-    // Calculate the risk for this position
-    double stopLossDistance = std::abs(position.entryPrice - position.stopLoss);
-    return stopLossDistance * position.size;
+    double dailyRiskLimit = snapshot.equity * (snapshot.maxDailyRisk / 100.0);
+    return -snapshot.dailyPnL >= dailyRiskLimit;
+}
+
+bool RiskManager::drawdownExceeded(const RiskSnapshot &snapshot)
+{
+    double drawdownLimit = snapshot.initialEquity * (snapshot.maxDrawdownPercent / 100.0);
+    return snapshot.maxDrawdown >= drawdownLimit;
+}
+
+bool RiskManager::counterComplete(const RiskSnapshot &snapshot)
+{
+    return snapshot.currentCounterTrades >= snapshot.tradesPerCounter;
+}
+
+bool RiskManager::portfolioRiskAcceptable(const RiskSnapshot &snapshot, const QString &symbol, double deltaNotional)
+{
+    if (snapshot.maxPortfolioVaR <= 0.0) return true;
+    double limit = snapshot.equity * (snapshot.maxPortfolioVaR / 100.0);
+    double after = snapshot.portfolio->valueAtRiskAfter(symbol, deltaNotional);
+    // Orders that reduce VaR stay allowed even while the book is over the limit
+    return after <= limit || after <= snapshot.portfolio->valueAtRisk;
 }
 
 double RiskManager::getPipValue(const QString &symbol) const
 {
-    Q_UNUSED(symbol)
-    return 1.0; // Stub implementation
+    // Account currency per pip for one lot
+    return getSnapshot()->instruments->pipValue(symbol, 1.0);
 }
 
 double RiskManager::getMarginRequirement(const QString &symbol, double lotSize) const
 {
-    Q_UNUSED(symbol)
-    Q_UNUSED(lotSize)
-    return 100.0; // Stub implementation
+    return getSnapshot()->instruments->marginRequirement(symbol, lotSize);
 } 
\ No newline at end of file
@@ -0,0 +1,346 @@
+#include "SmartOrderRouter.h"
+#include "OrderManager.h"
+#include <QTimer>
+#include <algorithm>
+
+SmartOrderRouter::SmartOrderRouter(QObject *parent)
+    : QObject(parent)
+    , m_orderManager(nullptr)
+    , m_telemetry(nullptr)
+    , m_latencyPenaltyBps(DEFAULT_LATENCY_PENALTY_BPS)
+    , m_bookDepth(DEFAULT_BOOK_DEPTH)
+    , m_childTimeoutMs(DEFAULT_CHILD_TIMEOUT_MS)
+    , m_idGenerator("SOR")
+{
+}
+
+void SmartOrderRouter::setOrderManager(OrderManager *orderManager)
+{
+    QMutexLocker locker(&m_mutex);
+    m_orderManager = orderManager;
+}
+
+int SmartOrderRouter::addVenue(ExchangeConnector *connector, double latencyEstimateMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_venues.push_back({connector, latencyEstimateMs});
+    connect(connector, &ExchangeConnector::orderFilled,
+            this, &SmartOrderRouter::onChildFilled, Qt::DirectConnection);
+    connect(connector, &ExchangeConnector::orderCancelled,
+            this, &SmartOrderRouter::onChildCancelled, Qt::DirectConnection);
+    connect(connector, &ExchangeConnector::orderRejected,
+            this, &SmartOrderRouter::onChildRejected, Qt::DirectConnection);
+    return static_cast<int>(m_venues.size()) - 1;
+}
+
+void SmartOrderRouter::removeVenue(ExchangeConnector *connector)
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto &venue : m_venues) {
+        if (venue.connector == connector) {
+            QObject::disconnect(connector, nullptr, this, nullptr);
+            // Keep the slot so venue indices of in-flight children stay valid
+            venue.connector = nullptr;
+        }
+    }
+}
+
+void SmartOrderRouter::setExecutionTelemetry(const ExecutionTelemetry *telemetry)
+{
+    QMutexLocker locker(&m_mutex);
+    m_telemetry = telemetry;
+}
+
+void SmartOrderRouter::setLatencyPenaltyBps(double bpsPerMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_latencyPenaltyBps = bpsPerMs;
+}
+
+void SmartOrderRouter::setBookDepth(int depth)
+{
+    QMutexLocker locker(&m_mutex);
+    m_bookDepth = depth;
+}
+
+void SmartOrderRouter::setChildTimeout(int ms)
+{
+    QMutexLocker locker(&m_mutex);
+    m_childTimeoutMs = ms > 0 ? ms : DEFAULT_CHILD_TIMEOUT_MS;
+}
+
+void SmartOrderRouter::loadConfig(const QJsonObject &config)
+{
+    QJsonObject routing = config["routing"].toObject();
+    setLatencyPenaltyBps(routing["latencyPenaltyBps"].toDouble(DEFAULT_LATENCY_PENALTY_BPS));
+    setBookDepth(routing["bookDepth"].toInt(DEFAULT_BOOK_DEPTH));
+    setChildTimeout(routing["childTimeoutMs"].toInt(DEFAULT_CHILD_TIMEOUT_MS));
+}
+
+QString SmartOrderRouter::routeOrder(const QString &symbol, OrderSide side, double quantity, double limitPrice,
+                                    qint64 signalTimeNs, qint64 riskPassTimeNs)
+{
+    struct Placed {
+        QString childId;
+        int venueIndex;
+        double quantity;
+    };
+    std::vector<Placed> placed;
+    QStringList errors;
+    QString parentId;
+    {
+        QMutexLocker locker(&m_mutex);
+        parentId = m_idGenerator.next();
+        if (!m_orderManager || !m_orderManager->isOrderGateOpen()) {
+            locker.unlock();
+            emit routingError(parentId, m_orderManager ? "Order gate closed" : "No order manager");
+            return QString();
+        }
+        std::vector<VenueQuote> quotes;
+        for (size_t i = 0; i < m_venues.size(); ++i) {
+            if (!m_venues[i].connector || !m_venues[i].connector->isConnected()) continue;
+            // A venue with no book on the side this order takes shows no liquidity to route to
+            VenueQuote quote = snapshotVenue(static_cast<int>(i), symbol);
+            if ((side == OrderSide::BUY ? quote.book.asks : quote.book.bids).empty()) continue;
+            quotes.push_back(quote);
+        }
+
+        std::vector<ChildAllocation> children = allocate(side, quantity, limitPrice, quotes, m_latencyPenaltyBps);
+        if (children.empty()) {
+            locker.unlock();
+            emit routingError(parentId, "No connected venue can take the order");
+            return QString();
+        }
+
+        ParentOrder parent;
+        parent.parentId = parentId;
+        parent.symbol = symbol;
+        parent.side = side;
+        parent.quantity = quantity;
+        parent.limitPrice = limitPrice;
+        parent.filledQuantity = 0.0;
+        parent.averagePrice = 0.0;
+        parent.commission = 0.0;
+        parent.openChildren = 0;
+        parent.complete = false;
+        m_parents[parentId] = parent;
+
+        int childNumber = 0;
+        for (const auto &child : children) {
+            OrderRequest request;
+            request.symbol = symbol;
+            request.type = OrderType::LIMIT;
+            request.side = side;
+            request.quantity = child.quantity;
+            request.price = child.limitPrice;
+            request.stopPrice = 0.0;
+            // Takes the levels we priced and no more: whatever is left expires at the venue
+            request.timeInForce = TimeInForce::IOC;
+            request.clientOrderId = QString("%1-%2").arg(parentId).arg(++childNumber);
+            request.feedTimeNs = 0;
+            request.signalTimeNs = signalTimeNs;
+            request.riskPassTimeNs = riskPassTimeNs;
+
+            // Reports never arrive synchronously, so the child is registered before its first one
+            QString childId = m_orderManager->submitOrder(request, m_venues[child.venueIndex].connector);
+            if (childId.isEmpty()) {
+                errors.append(QString("Child order rejected by venue %1").arg(child.venueIndex));
+                continue;
+            }
+            m_children[childId] = { parentId, child.venueIndex, child.quantity, 0.0, 0.0, 0.0, false };
+            m_parents[parentId].openChildren++;
+            placed.push_back({ childId, child.venueIndex, child.quantity });
+            QTimer::singleShot(m_childTimeoutMs, this, [this, childId]() { onChildTimeout(childId); });
+        }
+
+        if (m_parents[parentId].openChildren == 0) m_parents.erase(parentId);
+    }
+
+    for (const QString &error : errors) emit routingError(parentId, error);
+    for (const auto &child : placed) emit childOrderPlaced(parentId, child.childId, child.venueIndex, child.quantity);
+    return placed.empty() ? QString() : parentId;
+}
+
+ParentOrder SmartOrderRouter::getParentOrder(const QString &parentId) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_parents.find(parentId);
+    if (it != m_parents.end()) {
+        return it->second;
+    }
+    return ParentOrder();
+}
+
+std::vector<ChildAllocation> SmartOrderRouter::allocate(OrderSide side, double quantity, double limitPrice,
+                                                        const std::vector<VenueQuote> &venues, double latencyPenaltyBps)
+{
+    struct Candidate {
+        int venueIndex;
+        double price;
+        double quantity;
+        double effectivePrice;
+    };
+
+    const bool buy = side == OrderSide::BUY;
+    std::vector<Candidate> candidates;
+    for (const auto &venue : venues) {
+        const auto &levels = buy ? venue.book.asks : venue.book.bids;
+        // Fees and expected latency both make a venue's price worse for us
+        double cost = venue.feeRate + venue.latencyMs * latencyPenaltyBps / 10000.0;
+        for (const auto &level : levels) {
+            if (level.quantity <= 0.0) continue;
+            if (limitPrice > 0.0 && (buy ? level.price > limitPrice : level.price < limitPrice)) break;
+            double effective = buy ? level.price * (1.0 + cost) : level.price * (1.0 - cost);
+            candidates.push_back({venue.venueIndex, level.price, level.quantity, effective});
+        }
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [buy](const Candidate &a, const Candidate &b) {
+        if (a.effectivePrice != b.effectivePrice) {
+            return buy ? a.effectivePrice < b.effectivePrice : a.effectivePrice > b.effectivePrice;
+        }
+        return a.venueIndex < b.venueIndex;
+    });
+
+    std::map<int, ChildAllocation> perVenue;
+    double remaining = quantity;
+    for (const auto &candidate : candidates) {
+        if (remaining <= 0.0) break;
+        double take = std::min(candidate.quantity, remaining);
+        auto it = perVenue.find(candidate.venueIndex);
+        if (it == perVenue.end()) {
+            it = perVenue.emplace(candidate.venueIndex,
+                                  ChildAllocation{candidate.venueIndex, 0.0, candidate.price, 0.0}).first;
+        }
+        ChildAllocation &child = it->second;
+        child.quantity += take;
+        child.limitPrice = buy ? std::max(child.limitPrice, candidate.price) : std::min(child.limitPrice, candidate.price);
+        child.expectedCost += take * candidate.effectivePrice;
+        remaining -= take;
+    }
+
+    // Visible depth exhausted: the rest goes to the cheapest venue at the limit (or its worst taken level)
+    if (remaining > 1e-12 && !candidates.empty()) {
+        const Candidate &best = candidates.front();
+        auto it = perVenue.find(best.venueIndex);
+        ChildAllocation &child = it->second;
+        child.quantity += remaining;
+        if (limitPrice > 0.0) child.limitPrice = limitPrice;
+        child.expectedCost += remaining * child.limitPrice;
+    }
+
+    std::vector<ChildAllocation> result;
+    for (const auto &entry : perVenue) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+VenueQuote SmartOrderRouter::snapshotVenue(int index, const QString &symbol)
+{
+    // Called with m_mutex held
+    ExchangeConnector *connector = m_venues[index].connector;
+    VenueQuote quote;
+    quote.venueIndex = index;
+    quote.book = connector->getOrderBook(symbol, m_bookDepth);
+    quote.feeRate = connector->getCommissionRate(symbol);
+    quote.latencyMs = m_venues[index].latencyEstimateMs;
+    if (m_telemetry) {
+        const LatencyHistogram &ack = m_telemetry->histogram(connector->getCurrentExchange(), OrderType::LIMIT,
+                                                             LatencySegment::WIRE_TO_ACK);
+        if (ack.count() > 0) {
+            quote.latencyMs = ack.percentile(0.5) / 1e6;
+        }
+    }
+    return quote;
+}
+
+void SmartOrderRouter::onChildFilled(const OrderResponse &response)
+{
+    // PARTIALLY_FILLED is the only report that leaves an IOC child open
+    applyReport(response.orderId, &response, response.status != OrderStatus::PARTIALLY_FILLED);
+}
+
+void SmartOrderRouter::onChildCancelled(const QString &orderId)
+{
+    applyReport(orderId, nullptr, true);
+}
+
+void SmartOrderRouter::onChildRejected(const QString &orderId, const QString &reason)
+{
+    Q_UNUSED(reason)
+    applyReport(orderId, nullptr, true);
+}
+
+void SmartOrderRouter::onChildTimeout(const QString &childId)
+{
+    ExchangeConnector *connector = nullptr;
+    OrderManager *orderManager = nullptr;
+    QString parentId;
+    bool giveUp = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto child = m_children.find(childId);
+        if (child == m_children.end()) return;
+        parentId = child->second.parentId;
+        if (child->second.cancelRequested) {
+            giveUp = true;
+        } else {
+            // First timeout: ask the venue to cancel, and wait one more period for the verdict
+            child->second.cancelRequested = true;
+            connector = m_venues[child->second.venueIndex].connector;
+            orderManager = m_orderManager;
+            QTimer::singleShot(m_childTimeoutMs, this, [this, childId]() { onChildTimeout(childId); });
+        }
+    }
+    if (!giveUp) {
+        if (connector && orderManager) orderManager->cancelOrder(childId, connector);
+        return;
+    }
+    // Second timeout: close the child on what it reported so far
+    emit routingError(parentId, QString("Child %1 unresolved; closed with its reported fills").arg(childId));
+    applyReport(childId, nullptr, true);
+}
+
+void SmartOrderRouter::applyReport(const QString &childId, const OrderResponse *fill, bool final)
+{
+    ParentOrder snapshot;
+    bool updated = false;
+    bool completed = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto child = m_children.find(childId);
+        if (child == m_children.end()) return;
+        auto it = m_parents.find(child->second.parentId);
+        if (it == m_parents.end()) {
+            m_children.erase(child);
+            return;
+        }
+        ParentOrder &parent = it->second;
+        ChildOrder &state = child->second;
+        if (fill && fill->filledQuantity > state.filledQuantity) {
+            const double notional = fill->averagePrice * fill->filledQuantity;
+            const double total = parent.filledQuantity + fill->filledQuantity - state.filledQuantity;
+            parent.averagePrice = (parent.averagePrice * parent.filledQuantity + notional - state.notional) / total;
+            parent.filledQuantity = total;
+            parent.commission += fill->commission - state.commission;
+            state.filledQuantity = fill->filledQuantity;
+            state.notional = notional;
+            state.commission = fill->commission;
+            updated = true;
+        }
+        if (final || state.filledQuantity >= state.quantity) {
+            m_children.erase(child);
+            parent.openChildren--;
+            updated = true;
+            if (parent.openChildren <= 0) {
+                parent.complete = true;
+                completed = true;
+            }
+        }
+        snapshot = parent;
+        if (completed) m_parents.erase(it);
+    }
+    if (updated) emit parentOrderUpdated(snapshot);
+    if (completed) emit parentOrderCompleted(snapshot);
+}
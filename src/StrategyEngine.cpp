@@ -1,7 +1,15 @@
 #include "StrategyEngine.h"
+#include "ExchangeConnector.h"
+#include "LatencyProbe.h"
+#include "Logger.h"
+#include "Metrics.h"
 #include <QDebug>
 #include <QJsonObject>
 
+static MetricCounter &METRIC_TICKS = Metrics::counter("mmt_ticks_total", "Price ticks processed by the strategy");
+static MetricCounter &METRIC_BRICKS = Metrics::counter("mmt_bricks_total", "Renko bricks formed");
+static MetricCounter &METRIC_SIGNALS = Metrics::counter("mmt_signals_total", "Validated trading signals emitted");
+
 StrategyEngine::StrategyEngine(QObject *parent)
     : QObject(parent)
     , m_symbol("BTCUSD")
@@ -14,12 +22,14 @@ StrategyEngine::StrategyEngine(QObject *parent)
     , m_paused(false)
     , m_initialized(false)
     , m_currentPrice(0.0)
+    , m_feedTimeNs(0)
     , m_inPattern(false)
     , m_patternBrickCount(0)
     , m_patternHighClose(0.0)
     , m_patternLowOpen(0.0)
     , m_totalSignals(0)
     , m_successfulSignals(0)
+    , m_logger(nullptr)
 {
     initializeEngine();
 }
@@ -129,15 +139,28 @@ void StrategyEngine::onValidateSignal()
     // Stub implementation
 }
 
-void StrategyEngine::processPriceData(double price, const QDateTime &timestamp)
+void StrategyEngine::onMarketData(const MarketData &data)
+{
+    if (!m_running || m_paused || data.symbol != m_symbol) return;
+    // Last trade when the venue sends one, otherwise the mid
+    double price = data.last > 0.0 ? data.last : (data.bid + data.ask) / 2.0;
+    if (price <= 0.0) return;
+    processPriceData(price, data.timestamp.isValid() ? data.timestamp : QDateTime::currentDateTime(),
+                     data.receiveTimeNs);
+}
+
+void StrategyEngine::processPriceData(double price, const QDateTime &timestamp, qint64 feedTimeNs)
 {
     QMutexLocker locker(&m_mutex);
+    METRIC_TICKS.increment();
     m_currentPrice = price;
+    m_feedTimeNs = feedTimeNs;
     formRenkoBrick(price, timestamp);
 }
 
 void StrategyEngine::formRenkoBrick(double price, const QDateTime &timestamp)
 {
+    LATENCY_PROBE(ProbeStage::BRICK_FORMATION);
     if (m_renkoBricks.empty()) {
         RenkoBrick firstBrick;
         firstBrick.open = price;
@@ -155,6 +178,9 @@ void StrategyEngine::formRenkoBrick(double price, const QDateTime &timestamp)
     RenkoBrick &lastBrick = m_renkoBricks.back();
     double diff = price - lastBrick.close;
     int bricksToForm = static_cast<int>(std::abs(diff) / m_brickSize);
+    LOG_DEBUG(m_logger, QString("%1 tick %2: %3 from last close %4, %5 brick(s)")
+                            .arg(m_symbol).arg(price, 0, 'f', 5).arg(diff, 0, 'f', 5)
+                            .arg(lastBrick.close, 0, 'f', 5).arg(bricksToForm));
     if (bricksToForm == 0) return;
     for (int i = 0; i < bricksToForm; ++i) {
         RenkoBrick newBrick;
@@ -173,9 +199,13 @@ void StrategyEngine::formRenkoBrick(double price, const QDateTime &timestamp)
         newBrick.timestamp = timestamp;
         newBrick.formationPercentage = 1.0;
         m_renkoBricks.push_back(newBrick);
+        METRIC_BRICKS.increment();
         if (m_renkoBricks.size() > MAX_BRICK_HISTORY) {
             m_renkoBricks.erase(m_renkoBricks.begin());
         }
+        LOG_DEBUG(m_logger, QString("%1 %2 brick %3 -> %4")
+                                .arg(m_symbol).arg(newBrick.isGreen ? "green" : "red")
+                                .arg(newBrick.open, 0, 'f', 5).arg(newBrick.close, 0, 'f', 5));
         emit brickFormed(newBrick);
         analyzeRenkoPattern();
     }
@@ -183,6 +213,7 @@ void StrategyEngine::formRenkoBrick(double price, const QDateTime &timestamp)
 
 void StrategyEngine::analyzeRenkoPattern()
 {
+    LATENCY_PROBE(ProbeStage::PATTERN_MATCH);
     TradingSignal signal;
     if (m_setup1Enabled && detectTwoRedOneGreen()) {
         signal = analyzeSetup1();
@@ -198,6 +229,7 @@ void StrategyEngine::analyzeRenkoPattern()
             m_signalHistory.erase(m_signalHistory.begin());
         }
         ++m_totalSignals;
+        METRIC_SIGNALS.increment();
         emit newSignal(signal);
         logSignal(signal);
     }
@@ -235,6 +267,9 @@ TradingSignal StrategyEngine::analyzeSetup1()
     signal.takeProfit = calculateTakeProfit(signal);
     signal.isValid = true;
     signal.description = "Setup1: Two red, one green pattern detected.";
+    signal.feedTimeNs = m_feedTimeNs;
+    signal.signalTimeNs = LatencyClock::nowNs();
+    signal.riskPassTimeNs = 0;
     return signal;
 }
 
@@ -251,6 +286,9 @@ TradingSignal StrategyEngine::analyzeSetup2()
     signal.takeProfit = calculateTakeProfit(signal);
     signal.isValid = true;
     signal.description = "Setup2: Three green bricks pattern detected.";
+    signal.feedTimeNs = m_feedTimeNs;
+    signal.signalTimeNs = LatencyClock::nowNs();
+    signal.riskPassTimeNs = 0;
     return signal;
 }
 
@@ -309,8 +347,10 @@ void StrategyEngine::updatePatternHistory()
 
 void StrategyEngine::logSignal(const TradingSignal &signal)
 {
-    Q_UNUSED(signal)
-    // Stub implementation
+    LOG_INFO(m_logger, QString("Signal %1 %2 @ %3, lot %4, SL %5, TP %6: %7")
+                           .arg(signal.type == TradingSignal::BUY ? "BUY" : signal.type == TradingSignal::SELL ? "SELL" : "CLOSE")
+                           .arg(signal.symbol).arg(signal.price, 0, 'f', 5).arg(signal.lotSize)
+                           .arg(signal.stopLoss).arg(signal.takeProfit).arg(signal.description));
 }
 
 void StrategyEngine::loadConfig(const QJsonObject &config)
@@ -0,0 +1,621 @@
+#include "TradeJournal.h"
+#include "Crc32.h"
+#include <QDir>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QDeadlineTimer>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const int FRAME_HEADER_SIZE = 8;        // length + CRC
+static const quint32 MAX_PAYLOAD_SIZE = 1 << 20;
+
+// Field codec: PODs verbatim (host byte order), strings as uint16 length + UTF-8
+struct FieldWriter {
+    QByteArray data;
+
+    template<typename T>
+    void put(T value) { data.append(reinterpret_cast<const char *>(&value), sizeof(T)); }
+    void putString(const QString &text)
+    {
+        const QByteArray utf8 = text.toUtf8();
+        put(static_cast<quint16>(std::min<int>(utf8.size(), 0xFFFF)));
+        data.append(utf8.constData(), std::min<int>(utf8.size(), 0xFFFF));
+    }
+};
+
+struct FieldReader {
+    const char *pos;
+    const char *end;
+    bool ok;
+
+    FieldReader(const char *data, int size) : pos(data), end(data + size), ok(true) {}
+
+    template<typename T>
+    T get()
+    {
+        T value = T();
+        if (end - pos < static_cast<qint64>(sizeof(T))) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+    QString getString()
+    {
+        const quint16 length = get<quint16>();
+        if (!ok || end - pos < length) {
+            ok = false;
+            return QString();
+        }
+        QString text = QString::fromUtf8(pos, length);
+        pos += length;
+        return text;
+    }
+};
+
+static void putPosition(FieldWriter &w, const Position &position)
+{
+    w.putString(position.orderId);
+    w.putString(position.symbol);
+    w.putString(position.side);
+    w.put(position.size);
+    w.put(position.entryPrice);
+    w.put(position.currentPrice);
+    w.put(position.stopLoss);
+    w.put(position.takeProfit);
+    w.put(position.openTime.toMSecsSinceEpoch());
+}
+
+static Position getPosition(FieldReader &r)
+{
+    Position position;
+    position.orderId = r.getString();
+    position.symbol = r.getString();
+    position.side = r.getString();
+    position.size = r.get<double>();
+    position.entryPrice = r.get<double>();
+    position.currentPrice = r.get<double>();
+    position.stopLoss = r.get<double>();
+    position.takeProfit = r.get<double>();
+    position.openTime = QDateTime::fromMSecsSinceEpoch(r.get<qint64>());
+    position.unrealizedPnL = 0.0;
+    position.realizedPnL = 0.0;
+    position.isOpen = true;
+    position.symbolId = -1;
+    position.margin = 0.0;
+    return position;
+}
+
+static void putBracket(FieldWriter &w, const BracketOrder &bracket)
+{
+    w.putString(bracket.groupId);
+    w.putString(bracket.symbol);
+    w.put(static_cast<quint8>(bracket.entrySide));
+    w.put(bracket.quantity);
+    w.put(bracket.entryPrice);
+    w.put(bracket.stopLossPrice);
+    w.put(bracket.takeProfitPrice);
+    w.putString(bracket.entryOrderId);
+    w.putString(bracket.stopLossOrderId);
+    w.putString(bracket.takeProfitOrderId);
+    w.put(static_cast<quint8>(bracket.nativeOco));
+    w.put(static_cast<quint8>(bracket.state));
+    w.put(bracket.entryFilledQuantity);
+    w.put(bracket.entryAveragePrice);
+    w.put(bracket.exitFilledQuantity);
+    w.put(static_cast<quint8>(bracket.entryDone));
+    w.put(static_cast<qint32>(bracket.exitRevision));
+}
+
+static BracketOrder getBracket(FieldReader &r)
+{
+    BracketOrder bracket;
+    bracket.groupId = r.getString();
+    bracket.symbol = r.getString();
+    bracket.entrySide = static_cast<OrderSide>(r.get<quint8>());
+    bracket.quantity = r.get<double>();
+    bracket.entryPrice = r.get<double>();
+    bracket.stopLossPrice = r.get<double>();
+    bracket.takeProfitPrice = r.get<double>();
+    bracket.entryOrderId = r.getString();
+    bracket.stopLossOrderId = r.getString();
+    bracket.takeProfitOrderId = r.getString();
+    bracket.nativeOco = r.get<quint8>() != 0;
+    bracket.state = static_cast<BracketState>(r.get<quint8>());
+    bracket.entryFilledQuantity = r.get<double>();
+    bracket.entryAveragePrice = r.get<double>();
+    bracket.exitFilledQuantity = r.get<double>();
+    bracket.entryDone = r.get<quint8>() != 0;
+    bracket.exitRevision = r.get<qint32>();
+    return bracket;
+}
+
+// The single definition of what each record does to the state, used both while appending
+// and during recovery so the two can never disagree
+static void applyRecord(JournalState &state, JournalRecordType type, FieldReader &r)
+{
+    switch (type) {
+    case JournalRecordType::CHECKPOINT:
+        state.resetDay(QDate::fromJulianDay(r.get<qint64>()));
+        state.openPositions.clear();
+        state.brackets.clear();
+        break;
+    case JournalRecordType::EQUITY:
+        state.equity = r.get<double>();
+        state.initialEquity = r.get<double>();
+        break;
+    case JournalRecordType::DRAWDOWN: {
+        const double peakEquity = r.get<double>();
+        const double maxDrawdown = r.get<double>();
+        const double maxDrawdownPercent = r.get<double>();
+        if (!r.ok) break;
+        state.peakEquity = peakEquity;
+        state.maxDrawdown = maxDrawdown;
+        state.maxDrawdownPercent = maxDrawdownPercent;
+        break;
+    }
+    case JournalRecordType::POSITION_OPEN: {
+        Position position = getPosition(r);
+        if (r.ok) state.openPositions[position.orderId] = position;
+        break;
+    }
+    case JournalRecordType::POSITION_CLOSE: {
+        const QString positionId = r.getString();
+        r.get<double>(); // close price
+        const double pnl = r.get<double>();
+        r.get<qint64>(); // close time
+        const double equityAfter = r.get<double>();
+        if (!r.ok) break;
+        state.openPositions.erase(positionId);
+        state.equity = equityAfter;
+        state.dailyTrades++;
+        state.dailyPnL += pnl;
+        if (pnl > 0.0) {
+            state.winningTrades++;
+            state.grossProfit += pnl;
+            state.largestWin = std::max(state.largestWin, pnl);
+        } else {
+            state.grossLoss += -pnl;
+            state.largestLoss = std::max(state.largestLoss, -pnl);
+        }
+        break;
+    }
+    case JournalRecordType::BRACKET: {
+        BracketOrder bracket = getBracket(r);
+        if (!r.ok) break;
+        if (bracket.state == BracketState::PENDING_ENTRY || bracket.state == BracketState::ACTIVE) {
+            state.brackets[bracket.groupId] = bracket;
+        } else {
+            state.brackets.erase(bracket.groupId);
+        }
+        break;
+    }
+    default:
+        // Orders, acks, fills, cancels and risk decisions are audit records
+        break;
+    }
+}
+
+static bool syncToDisk(QFile &file)
+{
+    if (!file.flush()) return false;
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+JournalState::JournalState()
+    : equity(0.0)
+    , initialEquity(0.0)
+    , peakEquity(0.0)
+    , maxDrawdown(0.0)
+    , maxDrawdownPercent(0.0)
+    , lastSequence(0)
+{
+    resetDay(QDate());
+}
+
+void JournalState::resetDay(const QDate &date)
+{
+    day = date;
+    dailyTrades = 0;
+    winningTrades = 0;
+    dailyPnL = 0.0;
+    grossProfit = 0.0;
+    grossLoss = 0.0;
+    largestWin = 0.0;
+    largestLoss = 0.0;
+}
+
+TradeJournal::TradeJournal(QObject *parent)
+    : QObject(parent)
+    , m_groupCommitMs(DEFAULT_GROUP_COMMIT_MS)
+    , m_nextDayMs(0)
+    , m_flushRequested(false)
+    , m_commitThread(nullptr)
+    , m_open(false)
+    , m_stopping(false)
+    , m_durableSequence(0)
+{
+}
+
+TradeJournal::~TradeJournal()
+{
+    close();
+}
+
+void TradeJournal::loadConfig(const QJsonObject &config)
+{
+    QJsonObject journal = config["journal"].toObject();
+    if (journal.contains("directory")) m_directory = journal["directory"].toString();
+    if (journal.contains("groupCommitMs")) setGroupCommitInterval(journal["groupCommitMs"].toInt());
+}
+
+void TradeJournal::setGroupCommitInterval(int ms)
+{
+    QMutexLocker locker(&m_mutex);
+    m_groupCommitMs = std::max(0, ms);
+}
+
+QString TradeJournal::pathFor(const QDate &date) const
+{
+    return QDir(m_directory).filePath("journal-" + date.toString("yyyyMMdd") + ".jnl");
+}
+
+JournalRecovery TradeJournal::recover(const QString &directory)
+{
+    QElapsedTimer timer;
+    timer.start();
+    JournalRecovery recovery;
+    recovery.records = 0;
+    recovery.truncatedBytes = 0;
+
+    // Newest day first; a day whose checkpoint never completed falls back to the day before
+    QDir dir(directory);
+    QStringList files = dir.entryList(QStringList{"journal-*.jnl"}, QDir::Files, QDir::Name);
+    for (int i = files.size() - 1; i >= 0; --i) {
+        QFile file(dir.filePath(files[i]));
+        if (!file.open(QIODevice::ReadWrite)) continue;
+        const QByteArray data = file.readAll();
+
+        JournalState state;
+        bool checkpointComplete = false;
+        qint64 records = 0;
+        qint64 offset = 0;
+        while (data.size() - offset >= FRAME_HEADER_SIZE) {
+            quint32 length;
+            quint32 crc;
+            std::memcpy(&length, data.constData() + offset, 4);
+            std::memcpy(&crc, data.constData() + offset + 4, 4);
+            if (length < 17 || length > MAX_PAYLOAD_SIZE || data.size() - offset - FRAME_HEADER_SIZE < length) break;
+            const char *payload = data.constData() + offset + FRAME_HEADER_SIZE;
+            if (Crc32::compute(payload, length) != crc) break;
+
+            FieldReader reader(payload, static_cast<int>(length));
+            const JournalRecordType type = static_cast<JournalRecordType>(reader.get<quint8>());
+            state.lastSequence = reader.get<quint64>();
+            reader.get<qint64>(); // time
+            applyRecord(state, type, reader);
+            if (type == JournalRecordType::CHECKPOINT_END) checkpointComplete = true;
+            records++;
+            offset += FRAME_HEADER_SIZE + length;
+        }
+
+        // A torn or corrupt tail is cut so appends continue from the last good record
+        if (offset < data.size()) {
+            recovery.truncatedBytes += data.size() - offset;
+            file.resize(offset);
+        }
+        file.close();
+        recovery.records += records;
+        if (checkpointComplete) {
+            recovery.state = state;
+            recovery.file = file.fileName();
+            break;
+        }
+    }
+    recovery.elapsedMs = timer.nsecsElapsed() / 1e6;
+    return recovery;
+}
+
+bool TradeJournal::open(const QString &directory, const JournalState &recovered)
+{
+    close();
+    if (!QDir().mkpath(directory)) return false;
+
+    QMutexLocker locker(&m_mutex);
+    m_directory = directory;
+    m_state = recovered;
+    m_pending.clear();
+    m_stopping.store(false, std::memory_order_release);
+    m_durableSequence.store(m_state.lastSequence, std::memory_order_release);
+
+    const QDate today = QDate::currentDate();
+    if (m_state.day == today && QFile::exists(pathFor(today))) {
+        // Recovery has already cut any torn tail
+        m_currentPath = pathFor(today);
+        m_nextDayMs = today.addDays(1).startOfDay().toMSecsSinceEpoch();
+    } else {
+        startDayLocked(today);
+    }
+
+    m_open.store(true, std::memory_order_release);
+    m_commitThread = QThread::create([this]() { this->commitLoop(); });
+    m_commitThread->start();
+    return true;
+}
+
+void TradeJournal::close()
+{
+    if (!m_commitThread) return;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_open.store(false, std::memory_order_release);
+        m_stopping.store(true, std::memory_order_release);
+        m_commitWake.wakeAll();
+    }
+    // The commit thread drains what is pending before it exits
+    m_commitThread->wait();
+    delete m_commitThread;
+    m_commitThread = nullptr;
+    if (m_file.isOpen()) {
+        syncToDisk(m_file);
+        m_file.close();
+    }
+}
+
+void TradeJournal::startDayLocked(const QDate &date)
+{
+    const JournalState carried = m_state;
+    m_currentPath = pathFor(date);
+    m_nextDayMs = date.addDays(1).startOfDay().toMSecsSinceEpoch();
+
+    // Each day file restates the carried-over book so recovery reads a single file
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    FieldWriter checkpoint;
+    checkpoint.put(static_cast<qint64>(date.toJulianDay()));
+    writeRecordLocked(JournalRecordType::CHECKPOINT, checkpoint.data, nowMs);
+
+    FieldWriter equity;
+    equity.put(carried.equity);
+    equity.put(carried.initialEquity);
+    writeRecordLocked(JournalRecordType::EQUITY, equity.data, nowMs);
+    FieldWriter drawdown;
+    drawdown.put(carried.peakEquity);
+    drawdown.put(carried.maxDrawdown);
+    drawdown.put(carried.maxDrawdownPercent);
+    writeRecordLocked(JournalRecordType::DRAWDOWN, drawdown.data, nowMs);
+    for (const auto &entry : carried.openPositions) {
+        FieldWriter w;
+        putPosition(w, entry.second);
+        writeRecordLocked(JournalRecordType::POSITION_OPEN, w.data, nowMs);
+    }
+    for (const auto &entry : carried.brackets) {
+        FieldWriter w;
+        putBracket(w, entry.second);
+        writeRecordLocked(JournalRecordType::BRACKET, w.data, nowMs);
+    }
+    writeRecordLocked(JournalRecordType::CHECKPOINT_END, QByteArray(), nowMs);
+}
+
+void TradeJournal::append(JournalRecordType type, const QByteArray &fields)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    QMutexLocker locker(&m_mutex);
+    if (!m_open.load(std::memory_order_relaxed)) return;
+    if (nowMs >= m_nextDayMs) {
+        startDayLocked(QDateTime::fromMSecsSinceEpoch(nowMs).date());
+    }
+    writeRecordLocked(type, fields, nowMs);
+}
+
+void TradeJournal::writeRecordLocked(JournalRecordType type, const QByteArray &fields, qint64 timeMs)
+{
+    FieldWriter payload;
+    payload.data.reserve(17 + fields.size());
+    payload.put(static_cast<quint8>(type));
+    payload.put(++m_state.lastSequence);
+    payload.put(timeMs);
+    payload.data.append(fields);
+
+    FieldReader reader(fields.constData(), fields.size());
+    applyRecord(m_state, type, reader);
+
+    const quint32 length = static_cast<quint32>(payload.data.size());
+    const quint32 crc = Crc32::compute(payload.data.constData(), length);
+    if (m_pending.empty() || m_pending.back().path != m_currentPath) {
+        Chunk chunk;
+        chunk.path = m_currentPath;
+        m_pending.push_back(chunk);
+        // First record since the last commit opens a new group-commit window
+        if (m_pending.size() == 1) m_commitWake.wakeOne();
+    }
+    Chunk &chunk = m_pending.back();
+    chunk.data.append(reinterpret_cast<const char *>(&length), 4);
+    chunk.data.append(reinterpret_cast<const char *>(&crc), 4);
+    chunk.data.append(payload.data);
+    chunk.lastSequence = m_state.lastSequence;
+}
+
+void TradeJournal::commitLoop()
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        while (m_pending.empty() && !m_stopping.load(std::memory_order_relaxed)) {
+            m_commitWake.wait(&m_mutex);
+        }
+        if (m_pending.empty()) break;
+        // Group-commit window: records appended meanwhile share this write and fsync
+        if (m_groupCommitMs > 0 && !m_flushRequested && !m_stopping.load(std::memory_order_relaxed)) {
+            m_commitWake.wait(&m_mutex, m_groupCommitMs);
+        }
+        m_flushRequested = false;
+        std::vector<Chunk> chunks;
+        chunks.swap(m_pending);
+        locker.unlock();
+
+        QString error;
+        for (const Chunk &chunk : chunks) {
+            if (!m_file.isOpen() || m_file.fileName() != chunk.path) {
+                if (m_file.isOpen()) {
+                    syncToDisk(m_file);
+                    m_file.close();
+                }
+                m_file.setFileName(chunk.path);
+                if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+                    error = "Cannot open journal " + chunk.path;
+                    break;
+                }
+            }
+            if (m_file.write(chunk.data) != chunk.data.size()) {
+                error = "Journal write failed: " + m_file.errorString();
+                break;
+            }
+        }
+        if (error.isEmpty() && !syncToDisk(m_file)) error = "Journal fsync failed";
+
+        locker.relock();
+        if (error.isEmpty()) {
+            m_durableSequence.store(chunks.back().lastSequence, std::memory_order_release);
+        }
+        m_durableWake.wakeAll();
+        if (!error.isEmpty()) {
+            locker.unlock();
+            emit journalError(error);
+            locker.relock();
+        }
+    }
+}
+
+quint64 TradeJournal::lastSequence() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_state.lastSequence;
+}
+
+bool TradeJournal::waitForDurable(quint64 sequence, int timeoutMs)
+{
+    QDeadlineTimer deadline(timeoutMs);
+    QMutexLocker locker(&m_mutex);
+    if (durableSequence() >= sequence) return true;
+    m_flushRequested = true;
+    m_commitWake.wakeOne();
+    while (durableSequence() < sequence) {
+        if (!m_open.load(std::memory_order_relaxed)) return false;
+        if (!m_durableWake.wait(&m_mutex, deadline)) return durableSequence() >= sequence;
+    }
+    return true;
+}
+
+void TradeJournal::recordEquity(double equity, double initialEquity)
+{
+    FieldWriter w;
+    w.put(equity);
+    w.put(initialEquity);
+    append(JournalRecordType::EQUITY, w.data);
+}
+
+void TradeJournal::recordDrawdown(double peakEquity, double maxDrawdown, double maxDrawdownPercent)
+{
+    FieldWriter w;
+    w.put(peakEquity);
+    w.put(maxDrawdown);
+    w.put(maxDrawdownPercent);
+    append(JournalRecordType::DRAWDOWN, w.data);
+}
+
+void TradeJournal::recordPositionOpen(const Position &position)
+{
+    FieldWriter w;
+    putPosition(w, position);
+    append(JournalRecordType::POSITION_OPEN, w.data);
+}
+
+void TradeJournal::recordPositionClose(const Position &closed, double equityAfter)
+{
+    FieldWriter w;
+    w.putString(closed.orderId);
+    w.put(closed.currentPrice);
+    w.put(closed.realizedPnL);
+    w.put(closed.closeTime.toMSecsSinceEpoch());
+    w.put(equityAfter);
+    append(JournalRecordType::POSITION_CLOSE, w.data);
+}
+
+void TradeJournal::recordOrderRequest(const OrderRequest &request)
+{
+    FieldWriter w;
+    w.putString(request.clientOrderId);
+    w.putString(request.symbol);
+    w.put(static_cast<quint8>(request.side));
+    w.put(static_cast<quint8>(request.type));
+    w.put(request.quantity);
+    w.put(request.price);
+    w.put(request.stopPrice);
+    append(JournalRecordType::ORDER_REQUEST, w.data);
+}
+
+void TradeJournal::recordOrderAck(const QString &clientOrderId, const QString &orderId)
+{
+    FieldWriter w;
+    w.putString(clientOrderId);
+    w.putString(orderId);
+    append(JournalRecordType::ORDER_ACK, w.data);
+}
+
+void TradeJournal::recordOrderReject(const QString &clientOrderId, bool held)
+{
+    FieldWriter w;
+    w.putString(clientOrderId);
+    w.put(static_cast<quint8>(held));
+    append(JournalRecordType::ORDER_REJECT, w.data);
+}
+
+void TradeJournal::recordOrderFill(const OrderResponse &response)
+{
+    FieldWriter w;
+    w.putString(response.orderId);
+    w.putString(response.clientOrderId);
+    w.put(static_cast<quint8>(response.status));
+    w.put(response.filledQuantity);
+    w.put(response.averagePrice);
+    w.put(response.commission);
+    append(JournalRecordType::ORDER_FILL, w.data);
+}
+
+void TradeJournal::recordOrderCancel(const QString &orderId)
+{
+    FieldWriter w;
+    w.putString(orderId);
+    append(JournalRecordType::ORDER_CANCEL, w.data);
+}
+
+void TradeJournal::recordBracket(const BracketOrder &bracket)
+{
+    FieldWriter w;
+    putBracket(w, bracket);
+    append(JournalRecordType::BRACKET, w.data);
+}
+
+void TradeJournal::recordRiskDecision(const QString &symbol, const QString &side, double lotSize, bool accepted,
+                                      const QString &reason)
+{
+    FieldWriter w;
+    w.putString(symbol);
+    w.putString(side);
+    w.put(lotSize);
+    w.put(static_cast<quint8>(accepted));
+    w.putString(reason);
+    append(JournalRecordType::RISK_DECISION, w.data);
+}
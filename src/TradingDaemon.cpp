@@ -0,0 +1,428 @@
+#include "TradingDaemon.h"
+#include "Logger.h"
+#include "TradeJournal.h"
+#include "RiskManager.h"
+#include "CapitalAllocator.h"
+#include "ExchangeConnector.h"
+#include "ExecutionTelemetry.h"
+#include "OrderManager.h"
+#include "StrategyEngine.h"
+#include "KillSwitch.h"
+#include "SmartOrderRouter.h"
+#include "ExecutionAlgoScheduler.h"
+#include "MetricsServer.h"
+#include "LatencyProbe.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QJsonDocument>
+
+TradingDaemon::TradingDaemon(QObject *parent)
+    : QObject(parent)
+    , m_logger(new Logger(this))
+    , m_journal(new TradeJournal(this))
+    , m_risk(new RiskManager(this))
+    , m_allocator(new CapitalAllocator(this))
+    , m_connector(new ExchangeConnector(this))
+    , m_orders(new OrderManager(this))
+    , m_strategy(new StrategyEngine(this))
+    , m_killSwitch(new KillSwitch(this))
+    , m_router(new SmartOrderRouter(this))
+    , m_algos(new ExecutionAlgoScheduler(this))
+    , m_metrics(new MetricsServer(this))
+    , m_server(new QLocalServer(this))
+    , m_statusTimer(new QTimer(this))
+    , m_socketName("mastermind-trader")
+    , m_journalEnabled(false)
+    , m_startupMs(0)
+{
+    connect(m_server, &QLocalServer::newConnection, this, &TradingDaemon::onNewClient);
+    connect(m_statusTimer, &QTimer::timeout, this, &TradingDaemon::pushStatus);
+}
+
+TradingDaemon::~TradingDaemon()
+{
+    shutdown();
+}
+
+bool TradingDaemon::initialize(const QJsonObject &config)
+{
+    QElapsedTimer startup;
+    startup.start();
+
+    m_logger->loadConfig(config);
+
+    // Replay the journal before any component can append to it
+    QJsonObject journalConfig = config["journal"].toObject();
+    m_journalEnabled = journalConfig["enabled"].toBool(false);
+    m_journal->loadConfig(config);
+    JournalRecovery recovery;
+    if (m_journalEnabled) recovery = TradeJournal::recover(m_journal->directory());
+
+    m_allocator->loadConfig(config);
+    m_risk->setCapitalAllocator(m_allocator);
+    m_risk->loadConfig(config);
+    m_strategy->loadConfig(config);
+
+    if (m_journalEnabled) {
+        JournalState state = recovery.state;
+        if (recovery.file.isEmpty()) {
+            state.equity = m_risk->getEquity();
+            state.initialEquity = state.equity;
+        } else {
+            m_risk->restoreFromJournal(state);
+            m_orders->restoreFromJournal(state);
+            m_logger->info(QString("Journal recovered from %1: %2 records, %3 bytes truncated, %4 ms")
+                               .arg(recovery.file).arg(recovery.records)
+                               .arg(recovery.truncatedBytes).arg(recovery.elapsedMs, 0, 'f', 1));
+        }
+        if (m_journal->open(m_journal->directory(), state)) {
+            m_risk->setJournal(m_journal);
+            m_orders->setJournal(m_journal);
+        } else {
+            m_logger->error("Cannot open trade journal in " + m_journal->directory());
+        }
+    }
+
+    // Venue
+    QJsonObject trading = config["trading"].toObject();
+    m_exchangeName = trading["defaultExchange"].toString("Binance");
+    for (int v = 0; v <= static_cast<int>(ExchangeType::METATRADER5); ++v) {
+        ExchangeType venue = static_cast<ExchangeType>(v);
+        if (ExecutionTelemetry::venueName(venue).compare(m_exchangeName, Qt::CaseInsensitive) == 0) {
+            m_connector->setExchange(venue);
+            break;
+        }
+    }
+    QJsonObject exchange = config["exchanges"].toObject()[m_exchangeName].toObject();
+    m_connector->setApiCredentials(exchange["apiKey"].toString(), exchange["apiSecret"].toString(),
+                                   exchange["passphrase"].toString());
+    m_connector->setEndpoints(exchange["baseUrl"].toString(), exchange["wsUrl"].toString());
+    m_connector->setTestMode(trading["paperTradingMode"].toBool(true) || exchange["testMode"].toBool(false));
+
+    m_orders->setLogger(m_logger);
+    m_orders->setExchangeConnector(m_connector);
+    m_strategy->setLogger(m_logger);
+
+    // Routed orders go through the same gate, journal and telemetry as bracket entries
+    m_router->setOrderManager(m_orders);
+    m_router->setExecutionTelemetry(m_orders->getExecutionTelemetry());
+    m_router->loadConfig(config);
+    m_router->addVenue(m_connector, config["routing"].toObject()["latencyEstimateMs"].toDouble(DEFAULT_ROUTING_LATENCY_MS));
+    connect(m_router, &SmartOrderRouter::routingError, this, [this](const QString &parentId, const QString &error) {
+        m_logger->warning(QString("Routing %1: %2").arg(parentId, error));
+    });
+    connect(m_router, &SmartOrderRouter::parentOrderUpdated, this, &TradingDaemon::onRoutedFill);
+
+    // Algo slices go through the same gate; the feed records today's volume profile
+    m_algos->setOrderManager(m_orders);
+    m_volumeProfileFile = config["execution"].toObject()["volumeProfileFile"].toString();
+    if (!m_volumeProfileFile.isEmpty() && !m_algos->loadVolumeProfiles(m_volumeProfileFile)) {
+        m_logger->warning("No volume profile loaded from " + m_volumeProfileFile + "; VWAP runs as TWAP");
+    }
+    connect(m_connector, &ExchangeConnector::marketDataReceived, m_algos, &ExecutionAlgoScheduler::onMarketData);
+
+    m_killSwitch->setOrderManager(m_orders);
+    m_killSwitch->setRiskManager(m_risk);
+    m_killSwitch->addVenue(m_connector, true);
+    m_killSwitch->loadConfig(config);
+
+    // Feed -> strategy and marks; signal -> risk -> orders
+    connect(m_connector, &ExchangeConnector::marketDataReceived, m_strategy, &StrategyEngine::onMarketData);
+    connect(m_connector, &ExchangeConnector::marketDataReceived, this, [this](const MarketData &data) {
+        double price = data.last > 0.0 ? data.last : (data.bid + data.ask) / 2.0;
+        if (price > 0.0) m_risk->updateMarketPrice(data.symbol, price);
+    });
+    connect(m_strategy, &StrategyEngine::newSignal, this, &TradingDaemon::onSignal);
+    // Bracket fills open and close the risk book's positions, which journals them
+    connect(m_orders, &OrderManager::bracketEntryFilled, this, &TradingDaemon::onEntryFilled);
+    connect(m_orders, &OrderManager::bracketExitFilled, this, &TradingDaemon::onExitFilled);
+    connect(m_killSwitch, &KillSwitch::engaged, this, [this](const QString &reason) {
+        m_logger->error("Kill switch engaged: " + reason);
+        stop();
+    });
+
+    m_metrics->loadConfig(config);
+    if (m_metrics->isEnabled() && !m_metrics->start()) {
+        m_logger->warning(QString("Metrics endpoint disabled: port %1 unavailable").arg(m_metrics->port()));
+    }
+
+    // Control channel
+    QJsonObject daemon = config["daemon"].toObject();
+    m_socketName = daemon["socketName"].toString(m_socketName);
+    m_statusTimer->setInterval(daemon["statusIntervalMs"].toInt(DEFAULT_STATUS_INTERVAL_MS));
+    // Execution latency report in the log; 0 turns it off
+    ExecutionTelemetry *telemetry = m_orders->getExecutionTelemetry();
+    connect(telemetry, &ExecutionTelemetry::telemetryReport, this, [this](const QString &report) {
+        m_logger->info("Execution latency\n" + report.trimmed());
+    });
+    const int telemetryDumpMs = daemon["telemetryDumpIntervalMs"].toInt(DEFAULT_TELEMETRY_DUMP_INTERVAL_MS);
+    if (telemetryDumpMs > 0) telemetry->startPeriodicDump(telemetryDumpMs);
+    // A socket left behind by a crashed daemon would make listen() fail
+    QLocalServer::removeServer(m_socketName);
+    if (!m_server->listen(m_socketName)) {
+        m_logger->error(QString("Cannot listen on control socket %1: %2").arg(m_socketName, m_server->errorString()));
+        return false;
+    }
+
+    m_startupMs = startup.elapsed();
+    m_logger->info(QString("Daemon ready in %1 ms on %2 (%3 %4)")
+                       .arg(m_startupMs).arg(m_socketName, m_exchangeName, m_strategy->getSymbol()));
+    return true;
+}
+
+bool TradingDaemon::isTrading() const
+{
+    return m_strategy->isRunning();
+}
+
+void TradingDaemon::start()
+{
+    if (isTrading() || m_killSwitch->isEngaged()) return;
+    if (!m_connector->isConnected()) {
+        m_connector->connect();
+        m_connector->subscribeToMarketData(m_strategy->getSymbol());
+    }
+    m_strategy->start();
+    m_logger->info(QString("Trading started on %1 for %2").arg(m_exchangeName, m_strategy->getSymbol()));
+    emit tradingStateChanged(true);
+    pushStatus();
+}
+
+void TradingDaemon::stop()
+{
+    if (!isTrading()) return;
+    m_strategy->stop();
+    m_logger->info("Trading stopped");
+    emit tradingStateChanged(false);
+    pushStatus();
+}
+
+void TradingDaemon::shutdown()
+{
+    stop();
+    m_statusTimer->stop();
+    m_orders->getExecutionTelemetry()->stopPeriodicDump();
+    m_server->close();
+    m_metrics->stop();
+    if (m_connector->isConnected()) m_connector->disconnect();
+    if (!m_volumeProfileFile.isEmpty() && !m_algos->saveVolumeProfiles(m_volumeProfileFile)) {
+        m_logger->warning("Cannot save volume profile to " + m_volumeProfileFile);
+    }
+    m_journal->close();
+}
+
+void TradingDaemon::onSignal(const TradingSignal &signal)
+{
+    const QString side = signal.type == TradingSignal::BUY ? "BUY" : "SELL";
+    if (!m_risk->canOpenPosition(signal.symbol, side, signal.lotSize)) return;
+    TradingSignal cleared = signal;
+    cleared.riskPassTimeNs = LatencyClock::nowNs();
+    m_orders->placeBracketOrder(cleared);
+}
+
+void TradingDaemon::onEntryFilled(const BracketOrder &bracket, const OrderResponse &fill, double quantity, double price)
+{
+    // One position per bracket group; a partly filled entry grows it fill by fill
+    if (price <= 0.0) price = bracket.entryPrice;
+    const Position existing = m_risk->getPosition(bracket.groupId);
+    Position position;
+    if (existing.isOpen && existing.orderId == bracket.groupId) {
+        position = existing;
+        position.entryPrice = (existing.size * existing.entryPrice + quantity * price) / (existing.size + quantity);
+        position.size = existing.size + quantity;
+    } else {
+        position.symbol = bracket.symbol;
+        position.side = bracket.entrySide == OrderSide::BUY ? "BUY" : "SELL";
+        position.size = quantity;
+        position.entryPrice = price;
+        position.currentPrice = price;
+        position.stopLoss = bracket.stopLossPrice;
+        position.takeProfit = bracket.takeProfitPrice;
+        position.unrealizedPnL = 0.0;
+        position.realizedPnL = 0.0;
+        position.openTime = fill.timestamp;
+        position.isOpen = true;
+        position.orderId = bracket.groupId;
+        position.symbolId = -1;
+        position.margin = 0.0;
+    }
+    m_risk->addPosition(position);
+    m_logger->info(QString("Opened %1 %2 %3 @ %4 (%5, %6 open)")
+                       .arg(position.side, position.symbol).arg(quantity).arg(price)
+                       .arg(bracket.groupId).arg(position.size));
+}
+
+void TradingDaemon::onExitFilled(const BracketOrder &bracket, const OrderResponse &fill, double quantity, double price)
+{
+    const bool stopped = fill.clientOrderId.startsWith(bracket.groupId + "-SL");
+    if (price <= 0.0) price = stopped ? bracket.stopLossPrice : bracket.takeProfitPrice;
+    // Closes in full only once the exits have taken everything the entry filled
+    m_risk->reducePosition(bracket.groupId, quantity, price);
+    m_logger->info(QString("Closed %1 of %2 %3 @ %4 on %5%6")
+                       .arg(quantity).arg(bracket.symbol, bracket.groupId).arg(price)
+                       .arg(stopped ? "stop loss" : "take profit")
+                       .arg(bracket.state == BracketState::CLOSED ? QString() : QString(" (partial)")));
+}
+
+void TradingDaemon::onRoutedFill(const ParentOrder &order)
+{
+    // Child fills across venues add up to one position per parent order, so routed
+    // exposure counts against the same limits as bracket entries; no exits are attached
+    if (order.filledQuantity <= 0.0) return;
+    const Position existing = m_risk->getPosition(order.parentId);
+    const bool open = existing.isOpen && existing.orderId == order.parentId;
+    const double added = order.filledQuantity - (open ? existing.size : 0.0);
+    if (added <= 1e-9) return;
+    Position position;
+    if (open) {
+        position = existing;
+    } else {
+        position.symbol = order.symbol;
+        position.side = order.side == OrderSide::BUY ? "BUY" : "SELL";
+        position.currentPrice = order.averagePrice;
+        position.stopLoss = 0.0;
+        position.takeProfit = 0.0;
+        position.unrealizedPnL = 0.0;
+        position.realizedPnL = 0.0;
+        position.openTime = QDateTime::currentDateTime();
+        position.isOpen = true;
+        position.orderId = order.parentId;
+        position.symbolId = -1;
+        position.margin = 0.0;
+    }
+    // The parent's cumulative average is already the size-weighted entry
+    position.size = order.filledQuantity;
+    position.entryPrice = order.averagePrice;
+    m_risk->addPosition(position);
+    m_logger->info(QString("Routed fill %1 %2 %3 @ %4 (%5, %6 open)")
+                       .arg(position.side, position.symbol).arg(added).arg(order.averagePrice)
+                       .arg(order.parentId).arg(position.size));
+}
+
+QString TradingDaemon::routeOrder(const QJsonObject &command)
+{
+    // Same pre-trade check as a strategy signal; the router then splits across venues
+    const QString symbol = command["symbol"].toString(m_strategy->getSymbol());
+    const QString side = command["side"].toString().toUpper();
+    const double quantity = command["quantity"].toDouble();
+    if ((side != "BUY" && side != "SELL") || quantity <= 0.0) return QString();
+    const qint64 signalTimeNs = LatencyClock::nowNs();
+    if (!m_risk->canOpenPosition(symbol, side, quantity)) return QString();
+    return m_router->routeOrder(symbol, side == "BUY" ? OrderSide::BUY : OrderSide::SELL, quantity,
+                                command["limitPrice"].toDouble(0.0), signalTimeNs, LatencyClock::nowNs());
+}
+
+QJsonObject TradingDaemon::status() const
+{
+    std::shared_ptr<const RiskSnapshot> snapshot = m_risk->getSnapshot();
+    QJsonObject root;
+    root["trading"] = isTrading();
+    root["connected"] = m_connector->isConnected();
+    root["exchange"] = m_exchangeName;
+    root["symbol"] = m_strategy->getSymbol();
+    const MarketData quote = m_connector->getMarketData(m_strategy->getSymbol());
+    root["price"] = quote.last > 0.0 ? quote.last : (quote.bid + quote.ask) / 2.0;
+    root["connectionStatus"] = m_connector->getConnectionStatus();
+    root["equity"] = snapshot->equity;
+    root["dailyPnL"] = snapshot->dailyPnL;
+    root["openPositions"] = snapshot->openPositions;
+    root["dailyTrades"] = snapshot->dailyTradeCount;
+    root["drawdown"] = snapshot->metrics.currentDrawdown;
+    root["maxDrawdown"] = snapshot->maxDrawdown;
+    root["riskUsed"] = snapshot->riskUsed;
+    root["winRate"] = snapshot->metrics.winRate;
+    root["profitFactor"] = snapshot->metrics.profitFactor;
+    root["totalSignals"] = m_strategy->getTotalSignals();
+    root["killSwitch"] = m_killSwitch->isEngaged();
+    root["orderGateOpen"] = m_orders->isOrderGateOpen();
+    root["startupMs"] = m_startupMs;
+    root["latency"] = LatencyProbes::toJson();
+    root["time"] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+    return root;
+}
+
+void TradingDaemon::onNewClient()
+{
+    while (m_server->hasPendingConnections()) {
+        QLocalSocket *client = m_server->nextPendingConnection();
+        connect(client, &QLocalSocket::readyRead, this, [this, client]() { onClientReadyRead(client); });
+        connect(client, &QLocalSocket::disconnected, this, [this, client]() {
+            m_subscribers.removeAll(client);
+            if (m_subscribers.isEmpty()) m_statusTimer->stop();
+            client->deleteLater();
+        });
+    }
+}
+
+void TradingDaemon::onClientReadyRead(QLocalSocket *client)
+{
+    while (client->canReadLine()) {
+        const QByteArray line = client->readLine().trimmed();
+        if (line.isEmpty()) continue;
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            QJsonObject reply;
+            reply["ok"] = false;
+            reply["error"] = "malformed command: " + error.errorString();
+            sendLine(client, reply);
+            continue;
+        }
+        sendLine(client, handleCommand(client, doc.object()));
+    }
+    // A peer that never sends a newline does not get to grow the buffer forever
+    if (client->bytesAvailable() > MAX_COMMAND_BYTES) client->disconnectFromServer();
+}
+
+QJsonObject TradingDaemon::handleCommand(QLocalSocket *client, const QJsonObject &command)
+{
+    const QString cmd = command["cmd"].toString();
+    QJsonObject reply;
+    reply["reply"] = cmd;
+    reply["ok"] = true;
+
+    if (cmd == "status") {
+        reply["status"] = status();
+    } else if (cmd == "start") {
+        start();
+        reply["ok"] = isTrading();
+        if (!isTrading()) reply["error"] = m_killSwitch->isEngaged() ? "kill switch engaged" : "not started";
+    } else if (cmd == "stop") {
+        stop();
+    } else if (cmd == "route") {
+        const QString parentId = routeOrder(command);
+        reply["ok"] = !parentId.isEmpty();
+        if (parentId.isEmpty()) reply["error"] = "not routed";
+        else reply["parentId"] = parentId;
+    } else if (cmd == "kill") {
+        m_killSwitch->trigger(command["reason"].toString("operator"));
+    } else if (cmd == "subscribe") {
+        if (!m_subscribers.contains(client)) m_subscribers.append(client);
+        if (!m_statusTimer->isActive()) m_statusTimer->start();
+        reply["status"] = status();
+    } else if (cmd == "unsubscribe") {
+        m_subscribers.removeAll(client);
+        if (m_subscribers.isEmpty()) m_statusTimer->stop();
+    } else {
+        reply["ok"] = false;
+        reply["error"] = "unknown command";
+    }
+    return reply;
+}
+
+void TradingDaemon::pushStatus()
+{
+    if (m_subscribers.isEmpty()) return;
+    QJsonObject message;
+    message["status"] = status();
+    for (QLocalSocket *client : m_subscribers) sendLine(client, message);
+}
+
+void TradingDaemon::sendLine(QLocalSocket *client, const QJsonObject &object)
+{
+    client->write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    client->write("\n");
+}
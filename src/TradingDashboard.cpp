@@ -1,6 +1,4 @@
 #include "TradingDashboard.h"
-#include <QChart>
-#include <QChartView>
 #include <QColor>
 
 // Chart colors
@@ -3,10 +3,9 @@
 #include <QDir>
 #include <QFont>
 #include <QFontDatabase>
-#include <QSplashScreen>
-#include <QPixmap>
-#include <QTimer>
-#include <QScreen>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include "ConfigManager.h"
 #include "MainWindow.h"
 
 int main(int argc, char *argv[])
@@ -19,9 +18,15 @@ int main(int argc, char *argv[])
     app.setOrganizationName("MasterMind Trading Systems");
     app.setOrganizationDomain("mastermindtrader.com");
     
-    // Enable high DPI support
-    app.setAttribute(Qt::AA_EnableHighDpiScaling);
-    app.setAttribute(Qt::AA_UseHighDpiPixmaps);
+    // --attach controls a running MasterMindTraderd; without it the window runs its own simulation
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption attachOption("attach", "Attach to a running trading daemon.");
+    QCommandLineOption socketOption("socket", "Daemon control socket name (default daemon.socketName).", "name");
+    parser.addOption(attachOption);
+    parser.addOption(socketOption);
+    parser.process(app);
     
     // Set modern dark theme
     app.setStyle(QStyleFactory::create("Fusion"));
@@ -46,36 +51,16 @@ int main(int argc, char *argv[])
     QFont font("Segoe UI", 9);
     app.setFont(font);
     
-    // Create splash screen
-    QPixmap splashPixmap(400, 300);
-    splashPixmap.fill(QColor(25, 25, 25));
-    QSplashScreen splash(splashPixmap, Qt::WindowStaysOnTopHint);
-    splash.setFont(QFont("Segoe UI", 12, QFont::Bold));
-    
-    splash.show();
-    app.processEvents();
-    
-    splash.showMessage("Loading MasterMind Trader...", Qt::AlignCenter | Qt::AlignBottom, Qt::white);
-    QTimer::singleShot(1000, [&]() {
-        splash.showMessage("Initializing Trading Engine...", Qt::AlignCenter | Qt::AlignBottom, Qt::white);
-    });
-    
-    QTimer::singleShot(2000, [&]() {
-        splash.showMessage("Connecting to Exchanges...", Qt::AlignCenter | Qt::AlignBottom, Qt::white);
-    });
-    
-    QTimer::singleShot(3000, [&]() {
-        splash.showMessage("Loading Configuration...", Qt::AlignCenter | Qt::AlignBottom, Qt::white);
-    });
-    
     // Create main window
     MainWindow window;
+    window.show();
     
-    // Show main window after splash
-    QTimer::singleShot(4000, [&]() {
-        splash.finish(&window);
-        window.show();
-    });
+    if (parser.isSet(attachOption) || parser.isSet(socketOption)) {
+        ConfigManager configManager;
+        configManager.loadConfig("config.json");
+        QString socketName = configManager.getConfig()["daemon"].toObject()["socketName"].toString("mastermind-trader");
+        window.attachToDaemon(parser.isSet(socketOption) ? parser.value(socketOption) : socketName);
+    }
     
     return app.exec();
 } 
\ No newline at end of file
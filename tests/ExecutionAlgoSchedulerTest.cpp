@@ -0,0 +1,339 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QDir>
+#include <vector>
+
+#include "ExecutionAlgoScheduler.h"
+#include "OrderManager.h"
+#include "ExchangeConnector.h"
+
+// Child schedules of the execution algos, driven step by step through advanceTo: TWAP slices,
+// VWAP on a loaded profile and its TWAP fallback, POV on per-update trade volume, limit
+// children, the order gate, slices held for a disconnected venue, and the recorded volume
+// profile saved and loaded as the next session's
+class ExecutionAlgoSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void twapSlicesEvenly();
+    void vwapFollowsLoadedProfile();
+    void vwapWithoutProfileRunsAsTwap();
+    void povParticipatesInPrintedVolume();
+    void limitPriceRestsChildOrders();
+    void closedGateCancelsAlgo();
+    void heldSlicesCountAsSent();
+    void volumeProfileRoundTrip();
+
+private:
+    static ExecutionAlgoParams params(ExecutionAlgoType type, double quantity, qint64 durationMs, qint64 sliceMs);
+    static MarketData print(const QString &symbol, double quantity);
+    static void startTestVenue(ExchangeConnector &connector);
+    static void stepTo(ExecutionAlgoScheduler &scheduler, qint64 startMs, qint64 endMs, qint64 stepMs);
+};
+
+ExecutionAlgoParams ExecutionAlgoSchedulerTest::params(ExecutionAlgoType type, double quantity, qint64 durationMs,
+                                                       qint64 sliceMs)
+{
+    ExecutionAlgoParams params;
+    params.type = type;
+    params.symbol = "BTCUSD";
+    params.side = OrderSide::BUY;
+    params.totalQuantity = quantity;
+    params.durationMs = durationMs;
+    params.sliceIntervalMs = sliceMs;
+    params.participationRate = 0.0;
+    params.minSliceQuantity = 0.0;
+    params.limitPrice = 0.0;
+    return params;
+}
+
+MarketData ExecutionAlgoSchedulerTest::print(const QString &symbol, double quantity)
+{
+    MarketData data;
+    data.symbol = symbol;
+    data.bid = 99.0;
+    data.ask = 100.0;
+    data.last = 100.0;
+    data.volume = quantity;
+    data.timestamp = QDateTime::currentDateTime();
+    data.receiveTimeNs = 0;
+    return data;
+}
+
+void ExecutionAlgoSchedulerTest::startTestVenue(ExchangeConnector &connector)
+{
+    connector.setTestMode(true);
+    connector.connect();
+    OrderBook book;
+    book.symbol = "BTCUSD";
+    book.bids.push_back({ 99.0, 100.0 });
+    book.asks.push_back({ 100.0, 100.0 });
+    book.timestamp = QDateTime::currentDateTime();
+    connector.setSimulatedOrderBook(book);
+}
+
+void ExecutionAlgoSchedulerTest::stepTo(ExecutionAlgoScheduler &scheduler, qint64 startMs, qint64 endMs, qint64 stepMs)
+{
+    for (qint64 t = startMs + stepMs; t <= endMs; t += stepMs) {
+        scheduler.advanceTo(t);
+    }
+}
+
+void ExecutionAlgoSchedulerTest::twapSlicesEvenly()
+{
+    ExchangeConnector connector;
+    startTestVenue(connector);
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    ExecutionAlgoScheduler scheduler;
+    scheduler.setOrderManager(&orders);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+    std::vector<double> completed;
+    connect(&scheduler, &ExecutionAlgoScheduler::algoCompleted, this,
+            [&completed](quint64, double sent) { completed.push_back(sent); });
+
+    const quint64 id = scheduler.startAlgo(params(ExecutionAlgoType::TWAP, 1.0, 1000, 100));
+    QVERIFY(id != 0);
+    const qint64 start = scheduler.getAlgoStatus(id).startMs;
+    stepTo(scheduler, start, start + 1000, 100);
+
+    QCOMPARE(submitted.size(), size_t(10));
+    double total = 0.0;
+    for (const OrderRequest &request : submitted) {
+        QCOMPARE(request.type, OrderType::MARKET);
+        QVERIFY(qAbs(request.quantity - 0.1) < 1e-9);
+        total += request.quantity;
+    }
+    QVERIFY(qAbs(total - 1.0) < 1e-9);
+    QCOMPARE(completed.size(), size_t(1));
+    QCOMPARE(scheduler.getActiveAlgoCount(), 0);
+}
+
+void ExecutionAlgoSchedulerTest::vwapFollowsLoadedProfile()
+{
+    ExchangeConnector connector;
+    startTestVenue(connector);
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    ExecutionAlgoScheduler scheduler;
+    scheduler.setOrderManager(&orders);
+
+    // One-second buckets: no historical volume for the next few seconds, flat after that.
+    // The quiet stretch is wide enough that a bucket boundary falling between this clock read
+    // and the algo's start does not matter
+    const int buckets = 24 * 60 * 60;
+    const int current = static_cast<int>((QDateTime::currentMSecsSinceEpoch() % (24LL * 60 * 60 * 1000)) / 1000);
+    std::vector<double> weights(buckets, 1.0);
+    for (int i = -1; i <= 2; ++i) weights[(current + i + buckets) % buckets] = 0.0;
+    scheduler.setVolumeProfile("BTCUSD", weights);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+
+    const quint64 id = scheduler.startAlgo(params(ExecutionAlgoType::VWAP, 1.0, 6000, 100));
+    const qint64 start = scheduler.getAlgoStatus(id).startMs;
+    // A TWAP would have sent a sixth by now; the profile says the volume is still to come
+    stepTo(scheduler, start, start + 1000, 100);
+    QVERIFY(submitted.empty());
+
+    stepTo(scheduler, start + 1000, start + 6000, 100);
+    double total = 0.0;
+    for (const OrderRequest &request : submitted) total += request.quantity;
+    QVERIFY(qAbs(total - 1.0) < 1e-9);
+    QCOMPARE(scheduler.getActiveAlgoCount(), 0);
+}
+
+void ExecutionAlgoSchedulerTest::vwapWithoutProfileRunsAsTwap()
+{
+    ExchangeConnector connector;
+    startTestVenue(connector);
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    ExecutionAlgoScheduler scheduler;
+    scheduler.setOrderManager(&orders);
+
+    // Volume printed earlier today is recorded for the next session but not scheduled on
+    scheduler.onMarketData(print("BTCUSD", 5.0));
+    scheduler.onMarketData(print("BTCUSD", 0.0));
+    QVERIFY(scheduler.getVolumeProfile("BTCUSD").empty());
+    const std::vector<double> recorded = scheduler.getRecordedVolume("BTCUSD");
+    double recordedTotal = 0.0;
+    for (double volume : recorded) recordedTotal += volume;
+    QCOMPARE(recordedTotal, 5.0);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+
+    const quint64 id = scheduler.startAlgo(params(ExecutionAlgoType::VWAP, 1.0, 1000, 100));
+    const qint64 start = scheduler.getAlgoStatus(id).startMs;
+    stepTo(scheduler, start, start + 500, 100);
+    QCOMPARE(submitted.size(), size_t(5));
+    for (const OrderRequest &request : submitted) QVERIFY(qAbs(request.quantity - 0.1) < 1e-9);
+}
+
+void ExecutionAlgoSchedulerTest::povParticipatesInPrintedVolume()
+{
+    ExchangeConnector connector;
+    startTestVenue(connector);
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    ExecutionAlgoScheduler scheduler;
+    scheduler.setOrderManager(&orders);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+
+    ExecutionAlgoParams pov = params(ExecutionAlgoType::POV, 10.0, 10000, 100);
+    pov.participationRate = 0.5;
+    const quint64 id = scheduler.startAlgo(pov);
+    const qint64 start = scheduler.getAlgoStatus(id).startMs;
+
+    // Each update's volume is a print of its own, not a running total; quotes add nothing
+    scheduler.onMarketData(print("BTCUSD", 2.0));
+    scheduler.onMarketData(print("BTCUSD", 0.0));
+    scheduler.onMarketData(print("BTCUSD", 3.0));
+    scheduler.onMarketData(print("ETHUSD", 4.0));
+    QCOMPARE(scheduler.getAlgoStatus(id).observedVolume, 5.0);
+
+    stepTo(scheduler, start, start + 100, 100);
+    QCOMPARE(submitted.size(), size_t(1));
+    QCOMPARE(submitted[0].quantity, 2.5);
+}
+
+void ExecutionAlgoSchedulerTest::limitPriceRestsChildOrders()
+{
+    ExchangeConnector connector;
+    startTestVenue(connector);
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    ExecutionAlgoScheduler scheduler;
+    scheduler.setOrderManager(&orders);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+    QStringList requested;
+    connect(&scheduler, &ExecutionAlgoScheduler::childOrderRequested, this,
+            [&requested](quint64, const QString &symbol, OrderSide, double) { requested.append(symbol); });
+
+    ExecutionAlgoParams twap = params(ExecutionAlgoType::TWAP, 1.0, 1000, 500);
+    twap.limitPrice = 99.5;
+    const quint64 id = scheduler.startAlgo(twap);
+    const qint64 start = scheduler.getAlgoStatus(id).startMs;
+    stepTo(scheduler, start, start + 1000, 500);
+
+    QCOMPARE(submitted.size(), size_t(2));
+    for (const OrderRequest &request : submitted) {
+        QCOMPARE(request.type, OrderType::LIMIT);
+        QCOMPARE(request.timeInForce, TimeInForce::GTC);
+        QCOMPARE(request.price, 99.5);
+        QCOMPARE(request.quantity, 0.5);
+    }
+    QCOMPARE(requested.size(), 2);
+}
+
+void ExecutionAlgoSchedulerTest::closedGateCancelsAlgo()
+{
+    ExchangeConnector connector;
+    startTestVenue(connector);
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    ExecutionAlgoScheduler scheduler;
+    scheduler.setOrderManager(&orders);
+
+    int submitted = 0;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this, [&submitted](const OrderRequest &) { ++submitted; });
+    std::vector<double> cancelled;
+    connect(&scheduler, &ExecutionAlgoScheduler::algoCancelled, this,
+            [&cancelled](quint64, double sent) { cancelled.push_back(sent); });
+
+    const quint64 id = scheduler.startAlgo(params(ExecutionAlgoType::TWAP, 1.0, 1000, 100));
+    const qint64 start = scheduler.getAlgoStatus(id).startMs;
+    stepTo(scheduler, start, start + 200, 100);
+    QCOMPARE(submitted, 2);
+
+    orders.setOrderGateOpen(false);
+    stepTo(scheduler, start + 200, start + 1000, 100);
+    QCOMPARE(submitted, 2);
+    QCOMPARE(cancelled.size(), size_t(1));
+    QVERIFY(qAbs(cancelled[0] - 0.2) < 1e-9);
+    QCOMPARE(scheduler.getActiveAlgoCount(), 0);
+}
+
+void ExecutionAlgoSchedulerTest::heldSlicesCountAsSent()
+{
+    // A live connector that never connected: every slice is held for the reconnect
+    ExchangeConnector connector;
+    connector.setTestMode(false);
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    ExecutionAlgoScheduler scheduler;
+    scheduler.setOrderManager(&orders);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+    std::vector<double> completed;
+    connect(&scheduler, &ExecutionAlgoScheduler::algoCompleted, this,
+            [&completed](quint64, double sent) { completed.push_back(sent); });
+
+    const quint64 id = scheduler.startAlgo(params(ExecutionAlgoType::TWAP, 1.0, 1000, 100));
+    const qint64 start = scheduler.getAlgoStatus(id).startMs;
+    stepTo(scheduler, start, start + 1000, 100);
+
+    // Each slice goes out once; none is refunded and sent again by the next one
+    QCOMPARE(submitted.size(), size_t(10));
+    double total = 0.0;
+    for (const OrderRequest &request : submitted) {
+        QVERIFY(qAbs(request.quantity - 0.1) < 1e-9);
+        total += request.quantity;
+    }
+    QVERIFY(qAbs(total - 1.0) < 1e-9);
+    QCOMPARE(completed.size(), size_t(1));
+    QVERIFY(qAbs(completed[0] - 1.0) < 1e-9);
+}
+
+void ExecutionAlgoSchedulerTest::volumeProfileRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = QDir(dir.path()).filePath("profiles/volume.json");
+
+    // Yesterday: one unit in every bucket
+    ExecutionAlgoScheduler yesterday;
+    yesterday.setVolumeProfile("BTCUSD", std::vector<double>(48, 1.0));
+    QVERIFY(yesterday.saveVolumeProfiles(path));
+
+    // Today: loaded at startup, then prints in the current bucket only
+    ExecutionAlgoScheduler today;
+    QVERIFY(today.loadVolumeProfiles(path));
+    QCOMPARE(today.getVolumeProfile("BTCUSD"), std::vector<double>(48, 1.0));
+    today.onMarketData(print("BTCUSD", 7.0));
+    QVERIFY(today.saveVolumeProfiles(path));
+
+    // Tomorrow sees today's volume where it printed and yesterday's everywhere else
+    ExecutionAlgoScheduler tomorrow;
+    QVERIFY(tomorrow.loadVolumeProfiles(path));
+    const std::vector<double> profile = tomorrow.getVolumeProfile("BTCUSD");
+    QCOMPARE(profile.size(), size_t(48));
+    int printed = 0;
+    for (double volume : profile) {
+        if (volume == 7.0) ++printed;
+        else QCOMPARE(volume, 1.0);
+    }
+    QCOMPARE(printed, 1);
+
+    QVERIFY(!tomorrow.loadVolumeProfiles(QDir(dir.path()).filePath("missing.json")));
+}
+
+QTEST_GUILESS_MAIN(ExecutionAlgoSchedulerTest)
+#include "ExecutionAlgoSchedulerTest.moc"
@@ -0,0 +1,352 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <vector>
+
+#include "KillSwitch.h"
+#include "OrderManager.h"
+#include "RiskManager.h"
+#include "ExchangeConnector.h"
+#include "SimulatedVenue.h"
+
+// Emergency stop: which risk limits trip it (a daily loss on marks alone included), cancel-all and flatten against test-mode venues
+// with a simulated ack delay (the flatten going through OrderManager past the closed gate),
+// an unreachable venue, and single and mass cancels at the simulated venue
+class KillSwitchTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void profitAndTradeCountDoNotTrip();
+    void dailyLossTrips();
+    void markedDailyLossTrips();
+    void cancelsThenFlattensThroughOrderManager();
+    void unreachableVenueFailsWithoutBlockingOthers();
+    void cancelsAgainstVenue();
+
+private:
+    static Position position(const QString &id, const QString &side, double size, double price);
+    static OrderRequest restingLimit(const QString &symbol, double quantity, double price);
+    static void startTestVenue(ExchangeConnector &connector, int cancelLatencyMs);
+    static void limitRisk(RiskManager &risk);
+};
+
+Position KillSwitchTest::position(const QString &id, const QString &side, double size, double price)
+{
+    Position position;
+    position.symbol = "BTCUSD";
+    position.side = side;
+    position.size = size;
+    position.entryPrice = price;
+    position.currentPrice = price;
+    position.stopLoss = 0.0;
+    position.takeProfit = 0.0;
+    position.unrealizedPnL = 0.0;
+    position.realizedPnL = 0.0;
+    position.openTime = QDateTime::currentDateTime();
+    position.isOpen = true;
+    position.orderId = id;
+    position.symbolId = -1;
+    position.margin = 0.0;
+    return position;
+}
+
+OrderRequest KillSwitchTest::restingLimit(const QString &symbol, double quantity, double price)
+{
+    OrderRequest request;
+    request.symbol = symbol;
+    request.type = OrderType::LIMIT;
+    request.side = OrderSide::BUY;
+    request.quantity = quantity;
+    request.price = price;
+    request.stopPrice = 0.0;
+    request.timeInForce = TimeInForce::GTC;
+    request.feedTimeNs = 0;
+    request.signalTimeNs = 0;
+    request.riskPassTimeNs = 0;
+    return request;
+}
+
+void KillSwitchTest::startTestVenue(ExchangeConnector &connector, int cancelLatencyMs)
+{
+    connector.setTestMode(true);
+    connector.connect();
+    connector.setSimulatedCancelLatency(cancelLatencyMs);
+    OrderBook book;
+    book.symbol = "BTCUSD";
+    book.bids.push_back({ 99.0, 10.0 });
+    book.asks.push_back({ 100.0, 10.0 });
+    book.timestamp = QDateTime::currentDateTime();
+    connector.setSimulatedOrderBook(book);
+}
+
+void KillSwitchTest::limitRisk(RiskManager &risk)
+{
+    // 2% daily loss on 10000; drawdown and position limits well out of the way
+    risk.setEquity(10000.0);
+    risk.setMaxDailyRisk(2.0);
+    risk.setMaxDrawdown(50.0);
+    risk.setMaxOpenPositions(10);
+}
+
+void KillSwitchTest::profitAndTradeCountDoNotTrip()
+{
+    RiskManager risk;
+    limitRisk(risk);
+    risk.setMaxTradesPerDay(1);
+    OrderManager orders;
+    KillSwitch killSwitch;
+    killSwitch.setOrderManager(&orders);
+    killSwitch.setRiskManager(&risk);
+    killSwitch.setArmed(true);
+
+    QStringList reached;
+    connect(&risk, &RiskManager::riskLimitReached, this, [&reached](const QString &type) { reached.append(type); });
+
+    // A day's worth of profit in one trade, which also uses up the trade count
+    risk.addPosition(position("P1", "BUY", 1.0, 100.0));
+    risk.closePosition("P1", 1100.0);
+
+    // RiskManager refuses further entries, but nothing is cancelled or flattened
+    QCOMPARE(reached, QStringList{ RiskManager::breachReason(BREACH_MAX_TRADES) });
+    QVERIFY(!risk.canOpenPosition("BTCUSD", 1.0));
+    QVERIFY(!killSwitch.isEngaged());
+    QVERIFY(orders.isOrderGateOpen());
+}
+
+void KillSwitchTest::dailyLossTrips()
+{
+    RiskManager risk;
+    limitRisk(risk);
+    OrderManager orders;
+    KillSwitch killSwitch;
+    killSwitch.setOrderManager(&orders);
+    killSwitch.setRiskManager(&risk);
+
+    // Disarmed, a breach is left to RiskManager
+    risk.addPosition(position("P1", "BUY", 1.0, 1000.0));
+    risk.closePosition("P1", 700.0);
+    QVERIFY(!killSwitch.isEngaged());
+
+    RiskManager armedRisk;
+    limitRisk(armedRisk);
+    killSwitch.setRiskManager(&armedRisk);
+    killSwitch.setArmed(true);
+    QStringList engaged;
+    connect(&killSwitch, &KillSwitch::engaged, this, [&engaged](const QString &reason) { engaged.append(reason); });
+
+    armedRisk.addPosition(position("P2", "BUY", 1.0, 1000.0));
+    armedRisk.closePosition("P2", 700.0);
+    QCOMPARE(engaged, QStringList{ RiskManager::breachReason(BREACH_DAILY_RISK) });
+    QVERIFY(killSwitch.isEngaged());
+    QVERIFY(!orders.isOrderGateOpen());
+    // No venues: the report is complete as soon as it is triggered
+    QVERIFY(killSwitch.lastReport().complete);
+}
+
+void KillSwitchTest::markedDailyLossTrips()
+{
+    RiskManager risk;
+    limitRisk(risk);
+    OrderManager orders;
+    KillSwitch killSwitch;
+    killSwitch.setOrderManager(&orders);
+    killSwitch.setRiskManager(&risk);
+    killSwitch.setArmed(true);
+    QStringList engaged;
+    connect(&killSwitch, &KillSwitch::engaged, this, [&engaged](const QString &reason) { engaged.append(reason); });
+
+    // Nothing closed: the open position marked 300 down is past the 200 limit by itself
+    risk.addPosition(position("P1", "BUY", 1.0, 1000.0));
+    risk.updateMarketPrice("BTCUSD", 900.0);
+    QVERIFY(engaged.isEmpty());
+    risk.updateMarketPrice("BTCUSD", 700.0);
+    QCOMPARE(engaged, QStringList{ RiskManager::breachReason(BREACH_DAILY_RISK) });
+    QVERIFY(killSwitch.isEngaged());
+
+    // The figure the limit checks is the one published
+    std::shared_ptr<const RiskSnapshot> snapshot = risk.getSnapshot();
+    QCOMPARE(snapshot->dailyPnL, -300.0);
+    QCOMPARE(snapshot->metrics.dailyPnL, snapshot->dailyPnL);
+    QVERIFY(snapshot->breaches & BREACH_DAILY_RISK);
+}
+
+void KillSwitchTest::cancelsThenFlattensThroughOrderManager()
+{
+    ExchangeConnector venue;
+    startTestVenue(venue, 50);
+    OrderManager orders;
+    orders.setExchangeConnector(&venue);
+    RiskManager risk;
+    limitRisk(risk);
+    // The test-mode venue reports no positions, so the primary venue flattens the risk book
+    risk.addPosition(position("P1", "BUY", 0.5, 100.0));
+
+    KillSwitch killSwitch;
+    killSwitch.setOrderManager(&orders);
+    killSwitch.setRiskManager(&risk);
+    killSwitch.addVenue(&venue, true);
+
+    QStringList cancelled;
+    connect(&venue, &ExchangeConnector::orderCancelled, this, [&cancelled](const QString &id) { cancelled.append(id); });
+    std::vector<OrderRequest> submitted;
+    connect(&venue, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+    QStringList placed;
+    connect(&orders, &OrderManager::orderPlaced, this, [&placed](const QString &id) { placed.append(id); });
+    std::vector<KillSwitchReport> completed;
+    connect(&killSwitch, &KillSwitch::completed, this,
+            [&completed](const KillSwitchReport &report) { completed.push_back(report); });
+
+    const QString restingId = orders.submitOrder(restingLimit("BTCUSD", 1.0, 90.0));
+    QVERIFY(!restingId.isEmpty());
+
+    killSwitch.trigger("Manual stop");
+    QVERIFY(!orders.isOrderGateOpen());
+    QVERIFY(orders.submitOrder(restingLimit("BTCUSD", 1.0, 90.0)).isEmpty());
+    // The resting order is gone at once; the ack comes after the simulated latency
+    QCOMPARE(cancelled, QStringList{ restingId });
+    QVERIFY(!killSwitch.lastReport().venues[0].cancelAcknowledged);
+
+    QTRY_COMPARE(completed.size(), size_t(1));
+    const KillSwitchReport &report = completed.front();
+    QCOMPARE(report.reason, QString("Manual stop"));
+    QVERIFY(report.complete);
+    QVERIFY(!report.timedOut);
+    QVERIFY(report.gateClosedUs >= 0.0);
+    QVERIFY(report.dispatchUs >= report.gateClosedUs);
+    QCOMPARE(report.venues.size(), size_t(1));
+    const VenueKillReport &entry = report.venues[0];
+    QVERIFY(entry.cancelSent);
+    QVERIFY(entry.cancelAcknowledged);
+    QCOMPARE(entry.cancelledOrders, 1);
+    QVERIFY(entry.cancelAckMs >= 50.0);
+    QCOMPARE(entry.flattenOrders, 1);
+    QCOMPARE(entry.flattenFills, 1);
+    QVERIFY(entry.flattenAckMs >= entry.cancelAckMs);
+    QVERIFY(entry.error.isEmpty());
+
+    // The flatten went out through OrderManager while its gate was shut
+    QCOMPARE(placed.size(), 2);
+    QCOMPARE(submitted.size(), size_t(2));
+    const OrderRequest &flatten = submitted.back();
+    QVERIFY(flatten.clientOrderId.startsWith("KS"));
+    QCOMPARE(flatten.type, OrderType::MARKET);
+    QCOMPARE(flatten.side, OrderSide::SELL);
+    QCOMPARE(flatten.quantity, 0.5);
+    QVERIFY(flatten.metadata["reduceOnly"].toBool());
+
+    // Engaged until reset
+    QVERIFY(killSwitch.isEngaged());
+    killSwitch.reset();
+    QVERIFY(orders.isOrderGateOpen());
+}
+
+void KillSwitchTest::unreachableVenueFailsWithoutBlockingOthers()
+{
+    ExchangeConnector venue;
+    startTestVenue(venue, 20);
+    ExchangeConnector unreachable;
+    unreachable.setTestMode(true);
+    OrderManager orders;
+    orders.setExchangeConnector(&venue);
+
+    KillSwitch killSwitch;
+    killSwitch.setOrderManager(&orders);
+    killSwitch.addVenue(&venue);
+    killSwitch.addVenue(&unreachable);
+    QStringList failed;
+    connect(&killSwitch, &KillSwitch::venueFailed, this,
+            [&failed](const QString &, const QString &error) { failed.append(error); });
+    std::vector<KillSwitchReport> completed;
+    connect(&killSwitch, &KillSwitch::completed, this,
+            [&completed](const KillSwitchReport &report) { completed.push_back(report); });
+
+    killSwitch.trigger("Manual stop");
+    QTRY_COMPARE(completed.size(), size_t(1));
+    QCOMPARE(failed, QStringList{ "Venue not connected" });
+    const KillSwitchReport &report = completed.front();
+    QVERIFY(!report.timedOut);
+    QVERIFY(report.venues[0].cancelAcknowledged);
+    QCOMPARE(report.venues[0].cancelledOrders, 0);
+    // Nothing open there: flat as of the ack
+    QCOMPARE(report.venues[0].flattenAckMs, report.venues[0].cancelAckMs);
+    QVERIFY(!report.venues[1].cancelAcknowledged);
+    QCOMPARE(report.venues[1].error, QString("Venue not connected"));
+}
+
+void KillSwitchTest::cancelsAgainstVenue()
+{
+    SimulatedVenue venue;
+    venue.setSymbol("BTCUSDT");
+    venue.setAnchorPrice(50000.0);
+    venue.setBrickSize(0.0);
+    venue.setSignalEvery(0);
+    QVERIFY(venue.listen());
+
+    ExchangeConnector connector;
+    connector.setExchange(ExchangeType::BINANCE);
+    connector.setTestMode(false);
+    connector.setEndpoints(venue.restUrl(), venue.webSocketUrl());
+    connector.connect();
+    QTRY_VERIFY(connector.isConnected());
+    // A quoted symbol is swept even once no order of ours is known to be open on it
+    connector.subscribeToMarketData("BTCUSDT");
+    QTRY_VERIFY(venue.subscriberCount() > 0);
+    venue.startFeed(1000);
+    QTRY_VERIFY(connector.getMarketData("BTCUSDT").receiveTimeNs > 0);
+    venue.stopFeed();
+
+    QStringList cancelled;
+    connect(&connector, &ExchangeConnector::orderCancelled, this, [&cancelled](const QString &id) { cancelled.append(id); });
+    QStringList errors;
+    connect(&connector, &ExchangeConnector::errorOccurred, this, [&errors](const QString &error) { errors.append(error); });
+
+    OrderRequest first = restingLimit("BTCUSDT", 0.5, 49000.0);
+    first.clientOrderId = "rest-1";
+    OrderRequest second = restingLimit("BTCUSDT", 0.5, 48900.0);
+    second.clientOrderId = "rest-2";
+    QCOMPARE(connector.placeOrder(first), QString("rest-1"));
+    QCOMPARE(connector.placeOrder(second), QString("rest-2"));
+    QTRY_COMPARE(venue.restingCount(), 2);
+
+    // One order by client id
+    QVERIFY(connector.cancelOrder("rest-1"));
+    QTRY_COMPARE(cancelled, QStringList{ "rest-1" });
+    QCOMPARE(venue.restingCount(), 1);
+    // Known to be closed: not sent again
+    QVERIFY(!connector.cancelOrder("rest-1"));
+
+    // The kill switch sweeps the rest with one mass cancel per symbol
+    KillSwitch killSwitch;
+    killSwitch.addVenue(&connector);
+    std::vector<KillSwitchReport> completed;
+    connect(&killSwitch, &KillSwitch::completed, this,
+            [&completed](const KillSwitchReport &report) { completed.push_back(report); });
+    killSwitch.trigger("Manual stop");
+    QTRY_COMPARE(completed.size(), size_t(1));
+    QCOMPARE(completed[0].venues[0].cancelledOrders, 1);
+    QVERIFY(completed[0].venues[0].error.isEmpty());
+    QCOMPARE(cancelled, (QStringList{ "rest-1", "rest-2" }));
+    QCOMPARE(venue.restingCount(), 0);
+
+    // Nothing left open: the venue's unknown-order answer is an ack of zero, not a failure
+    killSwitch.reset();
+    killSwitch.trigger("Manual stop");
+    QTRY_COMPARE(completed.size(), size_t(2));
+    QCOMPARE(completed[1].venues[0].cancelledOrders, 0);
+    QVERIFY(completed[1].venues[0].error.isEmpty());
+
+    QList<SimulatedVenue::OrderArrival> arrivals = venue.takeArrivals();
+    QCOMPARE(arrivals.size(), 5);
+    QCOMPARE(arrivals[0].type, QString("LIMIT"));
+    QCOMPARE(arrivals[1].type, QString("LIMIT"));
+    QCOMPARE(arrivals[2].type, QString("CANCEL"));
+    QCOMPARE(arrivals[2].clientOrderId, QString("rest-1"));
+    QCOMPARE(arrivals[3].type, QString("CANCEL_ALL"));
+    QCOMPARE(arrivals[3].clientOrderId, QString("BTCUSDT"));
+    QCOMPARE(arrivals[4].type, QString("CANCEL_ALL"));
+    QVERIFY(errors.size() == 1 && errors[0].startsWith("No open order"));
+}
+
+QTEST_GUILESS_MAIN(KillSwitchTest)
+#include "KillSwitchTest.moc"
@@ -0,0 +1,401 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <vector>
+
+#include "OrderManager.h"
+#include "ExchangeConnector.h"
+#include "SimulatedVenue.h"
+
+// Bracket orders: exit legs sized from the entry fill, the entry and exit fill reports, OCO
+// linking of the two exits, exits resized on partial entry and exit fills, the native
+// Binance OCO list sent to the simulated venue and closed from its user-data stream, and
+// brackets refused where no fills would be reported, the ack latency stamped from the
+// venue's acceptance rather than from placeOrder returning, and an order the venue answered
+// with a 503 resent under the same client id
+class OrderManagerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emulatedBracketSizesExitsFromFill();
+    void emulatedBracketCancelsSiblingOnExitFill();
+    void partialEntryFillsGrowExits();
+    void partialExitFillShrinksSibling();
+    void nativeOcoBracketAgainstVenue();
+    void bracketRefusedWithoutOrderUpdates();
+    void ackStampedFromVenueReport();
+    void transientFailureRetriedUnderSameId();
+
+private:
+    static OrderBook thinBook(const QString &symbol, double askQuantity);
+    static OrderResponse report(const QString &orderId, OrderStatus status, double filledQuantity, double averagePrice);
+};
+
+OrderBook OrderManagerTest::thinBook(const QString &symbol, double askQuantity)
+{
+    OrderBook book;
+    book.symbol = symbol;
+    book.bids.push_back({ 99.0, 10.0 });
+    book.asks.push_back({ 100.0, askQuantity });
+    book.timestamp = QDateTime::currentDateTime();
+    return book;
+}
+
+OrderResponse OrderManagerTest::report(const QString &orderId, OrderStatus status, double filledQuantity,
+                                       double averagePrice)
+{
+    OrderResponse response;
+    response.orderId = orderId;
+    response.clientOrderId = orderId;
+    response.status = status;
+    response.filledQuantity = filledQuantity;
+    response.averagePrice = averagePrice;
+    response.commission = 0.0;
+    response.timestamp = QDateTime::currentDateTime();
+    return response;
+}
+
+void OrderManagerTest::emulatedBracketSizesExitsFromFill()
+{
+    ExchangeConnector connector;
+    connector.setTestMode(true);
+    connector.connect();
+    // Only 0.4 of the 1.0 entry can fill; the simulated market order expires the remainder
+    connector.setSimulatedOrderBook(thinBook("BTCUSD", 0.4));
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+    QStringList placed;
+    connect(&orders, &OrderManager::orderPlaced, this, [&placed](const QString &id) { placed.append(id); });
+    QStringList activated;
+    connect(&orders, &OrderManager::bracketActivated, this, [&activated](const QString &id) { activated.append(id); });
+    std::vector<OrderResponse> entryFills;
+    connect(&orders, &OrderManager::bracketEntryFilled, this,
+            [&entryFills](const BracketOrder &, const OrderResponse &fill) { entryFills.push_back(fill); });
+
+    const QString groupId = orders.placeBracketOrder("BTCUSD", "BUY", 1.0, 100.0, 95.0, 110.0);
+    QVERIFY(!groupId.isEmpty());
+    QCOMPARE(placed.size(), 1);
+    QTRY_COMPARE(activated.size(), 1);
+    QCOMPARE(activated.first(), groupId);
+    // Reported before the exits are announced, with what actually filled
+    QCOMPARE(entryFills.size(), size_t(1));
+    QCOMPARE(entryFills[0].filledQuantity, 0.4);
+
+    const BracketOrder bracket = orders.getBracketOrder(groupId);
+    QCOMPARE(bracket.state, BracketState::ACTIVE);
+    QVERIFY(!bracket.nativeOco);
+    QVERIFY(!bracket.stopLossOrderId.isEmpty());
+    QVERIFY(!bracket.takeProfitOrderId.isEmpty());
+    // Both exit legs are announced like any other order
+    QVERIFY(placed.contains(bracket.stopLossOrderId));
+    QVERIFY(placed.contains(bracket.takeProfitOrderId));
+
+    int exitLegs = 0;
+    for (const OrderRequest &request : submitted) {
+        if (request.clientOrderId == groupId + "-SL" || request.clientOrderId == groupId + "-TP") {
+            QCOMPARE(request.quantity, 0.4);
+            QCOMPARE(request.side, OrderSide::SELL);
+            ++exitLegs;
+        }
+    }
+    QCOMPARE(exitLegs, 2);
+}
+
+void OrderManagerTest::emulatedBracketCancelsSiblingOnExitFill()
+{
+    ExchangeConnector connector;
+    connector.setTestMode(true);
+    connector.connect();
+    connector.setSimulatedOrderBook(thinBook("BTCUSD", 10.0));
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+
+    QStringList cancelled;
+    connect(&connector, &ExchangeConnector::orderCancelled, this, [&cancelled](const QString &id) { cancelled.append(id); });
+    QStringList closed;
+    connect(&orders, &OrderManager::bracketClosed, this,
+            [&closed](const QString &groupId, const QString &exitOrderId) { closed.append(groupId + "/" + exitOrderId); });
+    std::vector<BracketOrder> exited;
+    connect(&orders, &OrderManager::bracketExitFilled, this,
+            [&exited](const BracketOrder &bracket, const OrderResponse &) { exited.push_back(bracket); });
+
+    const QString groupId = orders.placeBracketOrder("BTCUSD", "BUY", 1.0, 100.0, 95.0, 110.0);
+    QTRY_COMPARE(orders.getBracketOrder(groupId).state, BracketState::ACTIVE);
+    const BracketOrder bracket = orders.getBracketOrder(groupId);
+
+    // The venue reports the stop leg filled: the take-profit leg must be cancelled at once
+    OrderResponse stopFill;
+    stopFill.orderId = bracket.stopLossOrderId;
+    stopFill.clientOrderId = groupId + "-SL";
+    stopFill.status = OrderStatus::FILLED;
+    stopFill.filledQuantity = 1.0;
+    stopFill.averagePrice = 95.0;
+    stopFill.commission = 0.0;
+    stopFill.timestamp = QDateTime::currentDateTime();
+    emit connector.orderFilled(stopFill);
+
+    QCOMPARE(cancelled, QStringList{ bracket.takeProfitOrderId });
+    QCOMPARE(closed, QStringList{ groupId + "/" + bracket.stopLossOrderId });
+    QCOMPARE(orders.getBracketOrder(groupId).state, BracketState::CLOSED);
+    QCOMPARE(exited.size(), size_t(1));
+    QCOMPARE(exited[0].groupId, groupId);
+    QCOMPARE(exited[0].stopLossPrice, 95.0);
+
+    // A late report for the cancelled sibling no longer belongs to any group
+    OrderResponse lateFill = stopFill;
+    lateFill.orderId = bracket.takeProfitOrderId;
+    emit connector.orderFilled(lateFill);
+    QCOMPARE(closed.size(), 1);
+    QCOMPARE(exited.size(), size_t(1));
+    QCOMPARE(cancelled.size(), 1);
+}
+
+void OrderManagerTest::partialEntryFillsGrowExits()
+{
+    ExchangeConnector connector;
+    connector.setTestMode(true);
+    connector.connect();
+    // No asks: the market entry rests and its fills are reported below
+    OrderBook book = thinBook("BTCUSD", 0.0);
+    book.asks.clear();
+    connector.setSimulatedOrderBook(book);
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+    QStringList cancelled;
+    connect(&connector, &ExchangeConnector::orderCancelled, this, [&cancelled](const QString &id) { cancelled.append(id); });
+    std::vector<std::pair<double, double>> entryFills;
+    connect(&orders, &OrderManager::bracketEntryFilled, this,
+            [&entryFills](const BracketOrder &, const OrderResponse &, double quantity, double price) {
+                entryFills.push_back(std::make_pair(quantity, price));
+            });
+
+    const QString groupId = orders.placeBracketOrder("BTCUSD", "BUY", 1.0, 100.0, 95.0, 110.0);
+    QVERIFY(!groupId.isEmpty());
+    const QString entryId = orders.getBracketOrder(groupId).entryOrderId;
+
+    // First part: exits for 0.4, the entry still open
+    emit connector.orderFilled(report(entryId, OrderStatus::PARTIALLY_FILLED, 0.4, 100.0));
+    const BracketOrder first = orders.getBracketOrder(groupId);
+    QCOMPARE(first.state, BracketState::ACTIVE);
+    QVERIFY(!first.entryDone);
+    QCOMPARE(submitted.back().quantity, 0.4);
+
+    // The rest at 101: the 0.4 exits are replaced by 1.0 exits under new ids
+    emit connector.orderFilled(report(entryId, OrderStatus::FILLED, 1.0, 100.6));
+    const BracketOrder grown = orders.getBracketOrder(groupId);
+    QCOMPARE(grown.state, BracketState::ACTIVE);
+    QVERIFY(grown.entryDone);
+    QCOMPARE(grown.entryFilledQuantity, 1.0);
+    QCOMPARE(grown.exitRevision, 1);
+    QVERIFY(cancelled.contains(first.stopLossOrderId));
+    QVERIFY(cancelled.contains(first.takeProfitOrderId));
+    QVERIFY(grown.stopLossOrderId != first.stopLossOrderId);
+    int resized = 0;
+    for (const OrderRequest &request : submitted) {
+        if (request.clientOrderId == groupId + "-SL1" || request.clientOrderId == groupId + "-TP1") {
+            QCOMPARE(request.quantity, 1.0);
+            ++resized;
+        }
+    }
+    QCOMPARE(resized, 2);
+
+    QCOMPARE(entryFills.size(), size_t(2));
+    QCOMPARE(entryFills[0].first, 0.4);
+    QCOMPARE(entryFills[0].second, 100.0);
+    QVERIFY(qAbs(entryFills[1].first - 0.6) < 1e-9);
+    QVERIFY(qAbs(entryFills[1].second - 101.0) < 1e-9);
+}
+
+void OrderManagerTest::partialExitFillShrinksSibling()
+{
+    ExchangeConnector connector;
+    connector.setTestMode(true);
+    connector.connect();
+    connector.setSimulatedOrderBook(thinBook("BTCUSD", 10.0));
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+
+    std::vector<OrderRequest> submitted;
+    connect(&connector, &ExchangeConnector::orderSubmitted, this,
+            [&submitted](const OrderRequest &request) { submitted.push_back(request); });
+    QStringList cancelled;
+    connect(&connector, &ExchangeConnector::orderCancelled, this, [&cancelled](const QString &id) { cancelled.append(id); });
+    QStringList closed;
+    connect(&orders, &OrderManager::bracketClosed, this,
+            [&closed](const QString &groupId, const QString &) { closed.append(groupId); });
+    std::vector<double> exitFills;
+    connect(&orders, &OrderManager::bracketExitFilled, this,
+            [&exitFills](const BracketOrder &, const OrderResponse &, double quantity, double) {
+                exitFills.push_back(quantity);
+            });
+
+    const QString groupId = orders.placeBracketOrder("BTCUSD", "BUY", 1.0, 100.0, 95.0, 110.0);
+    QTRY_COMPARE(orders.getBracketOrder(groupId).state, BracketState::ACTIVE);
+    const BracketOrder bracket = orders.getBracketOrder(groupId);
+
+    // 0.3 of the stop fills: the stop rests on with 0.7 and the take-profit shrinks to 0.7
+    emit connector.orderFilled(report(bracket.stopLossOrderId, OrderStatus::PARTIALLY_FILLED, 0.3, 95.0));
+    const BracketOrder partly = orders.getBracketOrder(groupId);
+    QCOMPARE(partly.state, BracketState::ACTIVE);
+    QCOMPARE(partly.stopLossOrderId, bracket.stopLossOrderId);
+    QVERIFY(partly.takeProfitOrderId != bracket.takeProfitOrderId);
+    QCOMPARE(cancelled, QStringList{ bracket.takeProfitOrderId });
+    QCOMPARE(submitted.back().clientOrderId, groupId + "-TP1");
+    QVERIFY(qAbs(submitted.back().quantity - 0.7) < 1e-9);
+    QVERIFY(closed.isEmpty());
+
+    // The rest of the stop fills: flat, so the group closes and the new take-profit goes
+    emit connector.orderFilled(report(bracket.stopLossOrderId, OrderStatus::FILLED, 1.0, 95.0));
+    QCOMPARE(orders.getBracketOrder(groupId).state, BracketState::CLOSED);
+    QCOMPARE(closed, QStringList{ groupId });
+    QCOMPARE(cancelled, (QStringList{ bracket.takeProfitOrderId, partly.takeProfitOrderId }));
+    QCOMPARE(exitFills.size(), size_t(2));
+    QCOMPARE(exitFills[0], 0.3);
+    QVERIFY(qAbs(exitFills[1] - 0.7) < 1e-9);
+}
+
+void OrderManagerTest::nativeOcoBracketAgainstVenue()
+{
+    SimulatedVenue venue;
+    venue.setSymbol("BTCUSDT");
+    venue.setAnchorPrice(50000.0);
+    QVERIFY(venue.listen());
+
+    ExchangeConnector connector;
+    connector.setExchange(ExchangeType::BINANCE);
+    connector.setTestMode(false);
+    connector.setEndpoints(venue.restUrl(), venue.webSocketUrl());
+    connector.connect();
+    QTRY_VERIFY(connector.isConnected());
+    QVERIFY(connector.supportsNativeOco());
+    // Exit fills only reach the connector over the user-data stream
+    QTRY_VERIFY(connector.hasOrderUpdates());
+
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    QStringList errors;
+    connect(&orders, &OrderManager::bracketError, this,
+            [&errors](const QString &, const QString &error) { errors.append(error); });
+
+    const QString groupId = orders.placeBracketOrder("BTCUSDT", "BUY", 0.5, 50000.0, 49900.0, 50100.0);
+    QVERIFY(!groupId.isEmpty());
+    QTRY_COMPARE(orders.getBracketOrder(groupId).state, BracketState::ACTIVE);
+
+    const BracketOrder bracket = orders.getBracketOrder(groupId);
+    QVERIFY(bracket.nativeOco);
+    QCOMPARE(bracket.stopLossOrderId, groupId + "-SL");
+    QCOMPARE(bracket.takeProfitOrderId, groupId + "-TP");
+
+    // Entry, then one OCO list carrying both legs; the venue rests them and reports them NEW
+    QList<SimulatedVenue::OrderArrival> arrivals;
+    QTRY_VERIFY((arrivals += venue.takeArrivals()).size() >= 3);
+    QCOMPARE(arrivals.size(), 3);
+    QCOMPARE(arrivals[0].clientOrderId, groupId + "-E");
+    QCOMPARE(arrivals[0].type, QString("MARKET"));
+    QCOMPARE(arrivals[1].clientOrderId, groupId + "-SL");
+    QCOMPARE(arrivals[1].type, QString("STOP_LOSS"));
+    QCOMPARE(arrivals[2].clientOrderId, groupId + "-TP");
+    QCOMPARE(arrivals[2].type, QString("LIMIT_MAKER"));
+    QVERIFY(errors.isEmpty());
+
+    // The take-profit trades and the venue expires the stop; the stream reports both
+    QTRY_COMPARE(venue.restingCount(), 2);
+    QVERIFY(venue.fillResting(groupId + "-TP", 0.5));
+    QTRY_COMPARE(orders.getBracketOrder(groupId).state, BracketState::CLOSED);
+    QCOMPARE(orders.getBracketOrder(groupId).exitFilledQuantity, 0.5);
+    QCOMPARE(venue.restingCount(), 0);
+    QVERIFY(errors.isEmpty());
+}
+
+void OrderManagerTest::bracketRefusedWithoutOrderUpdates()
+{
+    // Live without a stream: orders could go out, but nothing would report the exits filling
+    ExchangeConnector connector;
+    connector.setExchange(ExchangeType::BINANCE);
+    connector.setTestMode(false);
+    connector.connect();
+    QVERIFY(connector.isConnected());
+    QVERIFY(!connector.hasOrderUpdates());
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    QStringList errors;
+    connect(&orders, &OrderManager::bracketError, this,
+            [&errors](const QString &, const QString &error) { errors.append(error); });
+
+    QVERIFY(orders.placeBracketOrder("BTCUSDT", "BUY", 0.5, 50000.0, 49900.0, 50100.0).isEmpty());
+    QCOMPARE(errors.size(), 1);
+}
+
+void OrderManagerTest::ackStampedFromVenueReport()
+{
+    ExchangeConnector connector;
+    connector.setTestMode(true);
+    connector.connect();
+    connector.setSimulatedOrderBook(thinBook("BTCUSD", 10.0));
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    const ExecutionTelemetry *telemetry = orders.getExecutionTelemetry();
+    const ExchangeType venue = connector.getCurrentExchange();
+    QStringList filled;
+    connect(&orders, &OrderManager::orderFilled, this, [&filled](const QString &id) { filled.append(id); });
+
+    orders.placeOrder("BTCUSD", "BUY", 1.0, 100.0);
+    // placeOrder has returned, but the venue has not said anything yet
+    QCOMPARE(telemetry->histogram(venue, OrderType::MARKET, LatencySegment::WIRE_TO_ACK).count(), uint64_t(0));
+    QTRY_COMPARE(telemetry->histogram(venue, OrderType::MARKET, LatencySegment::WIRE_TO_ACK).count(), uint64_t(1));
+    QCOMPARE(telemetry->histogram(venue, OrderType::MARKET, LatencySegment::ACK_TO_FILL).count(), uint64_t(0));
+    QTRY_COMPARE(filled.size(), 1);
+    QCOMPARE(telemetry->histogram(venue, OrderType::MARKET, LatencySegment::ACK_TO_FILL).count(), uint64_t(1));
+    // The simulated fill arrives a second after the ack
+    QVERIFY(telemetry->histogram(venue, OrderType::MARKET, LatencySegment::ACK_TO_FILL).min() > 500000000LL);
+}
+
+void OrderManagerTest::transientFailureRetriedUnderSameId()
+{
+    SimulatedVenue venue;
+    venue.setSymbol("BTCUSDT");
+    venue.setAnchorPrice(50000.0);
+    QVERIFY(venue.listen());
+
+    ExchangeConnector connector;
+    connector.setExchange(ExchangeType::BINANCE);
+    connector.setTestMode(false);
+    connector.setEndpoints(venue.restUrl(), venue.webSocketUrl());
+    connector.connect();
+    QTRY_VERIFY(connector.isConnected());
+    QTRY_VERIFY(connector.hasOrderUpdates());
+
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    QStringList filled;
+    connect(&orders, &OrderManager::orderFilled, this, [&filled](const QString &id) { filled.append(id); });
+    QStringList rejected;
+    connect(&connector, &ExchangeConnector::orderRejected, this,
+            [&rejected](const QString &id, const QString &) { rejected.append(id); });
+
+    // The venue fills the order but answers 503; the resend is refused as a duplicate, which
+    // means the first one got through
+    venue.failNextOrders(1);
+    orders.placeOrder("BTCUSDT", "BUY", 0.5, 50000.0);
+    QList<SimulatedVenue::OrderArrival> arrivals;
+    QTRY_VERIFY((arrivals += venue.takeArrivals()).size() >= 2);
+    QCOMPARE(arrivals.size(), 2);
+    QCOMPARE(arrivals[1].clientOrderId, arrivals[0].clientOrderId);
+    QTRY_COMPARE(filled.size(), 1);
+    // Long enough for the duplicate answer to come back
+    QTest::qWait(200);
+    QCOMPARE(filled.size(), 1);
+    QVERIFY(rejected.isEmpty());
+    QCOMPARE(venue.takeArrivals().size(), 0);
+}
+
+QTEST_GUILESS_MAIN(OrderManagerTest)
+#include "OrderManagerTest.moc"
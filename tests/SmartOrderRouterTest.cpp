@@ -0,0 +1,275 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <vector>
+
+#include "SmartOrderRouter.h"
+#include "OrderManager.h"
+#include "ExchangeConnector.h"
+#include "SimulatedVenue.h"
+
+// Child accounting of routed orders: IOC children, partial fills that expire, timeouts that
+// cancel, the order gate, venues without a book left out, and IOC fills and expiries at the
+// simulated venue priced off its depth stream
+class SmartOrderRouterTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void splitsAcrossVenuesAsIocChildren();
+    void partialIocFillCompletesParent();
+    void silentChildIsCancelledAfterTimeout();
+    void closedGateRoutesNothing();
+    void venueWithoutBookIsSkipped();
+    void iocChildrenAgainstVenue();
+
+private:
+    static OrderBook book(const QString &symbol, double askPrice, double askQuantity);
+    static void startTestVenue(ExchangeConnector &connector, const QString &symbol, double askPrice, double askQuantity);
+};
+
+OrderBook SmartOrderRouterTest::book(const QString &symbol, double askPrice, double askQuantity)
+{
+    OrderBook book;
+    book.symbol = symbol;
+    book.bids.push_back({ askPrice - 1.0, 10.0 });
+    book.asks.push_back({ askPrice, askQuantity });
+    book.timestamp = QDateTime::currentDateTime();
+    return book;
+}
+
+void SmartOrderRouterTest::startTestVenue(ExchangeConnector &connector, const QString &symbol, double askPrice,
+                                          double askQuantity)
+{
+    connector.setTestMode(true);
+    connector.connect();
+    connector.setSimulatedOrderBook(book(symbol, askPrice, askQuantity));
+}
+
+void SmartOrderRouterTest::splitsAcrossVenuesAsIocChildren()
+{
+    ExchangeConnector venueA;
+    ExchangeConnector venueB;
+    startTestVenue(venueA, "BTCUSD", 100.0, 0.6);
+    startTestVenue(venueB, "BTCUSD", 100.5, 1.0);
+    OrderManager orders;
+    orders.setExchangeConnector(&venueA);
+    SmartOrderRouter router;
+    router.setOrderManager(&orders);
+    router.addVenue(&venueA, 1.0);
+    router.addVenue(&venueB, 1.0);
+
+    std::vector<OrderRequest> submitted;
+    auto record = [&submitted](const OrderRequest &request) { submitted.push_back(request); };
+    connect(&venueA, &ExchangeConnector::orderSubmitted, this, record);
+    connect(&venueB, &ExchangeConnector::orderSubmitted, this, record);
+    std::vector<ParentOrder> completed;
+    connect(&router, &SmartOrderRouter::parentOrderCompleted, this,
+            [&completed](const ParentOrder &parent) { completed.push_back(parent); });
+    QStringList filled;
+    connect(&orders, &OrderManager::orderFilled, this, [&filled](const QString &id) { filled.append(id); });
+
+    const QString parentId = router.routeOrder("BTCUSD", OrderSide::BUY, 1.0);
+    QVERIFY(!parentId.isEmpty());
+    QCOMPARE(submitted.size(), size_t(2));
+    for (const OrderRequest &request : submitted) {
+        QCOMPARE(request.type, OrderType::LIMIT);
+        QCOMPARE(request.timeInForce, TimeInForce::IOC);
+    }
+    QCOMPARE(submitted[0].quantity, 0.6);
+    QCOMPARE(submitted[0].price, 100.0);
+    QCOMPARE(submitted[1].quantity, 0.4);
+    QCOMPARE(submitted[1].price, 100.5);
+
+    QTRY_COMPARE(completed.size(), size_t(1));
+    const ParentOrder &parent = completed.front();
+    QCOMPARE(parent.parentId, parentId);
+    QVERIFY(parent.complete);
+    QCOMPARE(parent.openChildren, 0);
+    QCOMPARE(parent.filledQuantity, 1.0);
+    QCOMPARE(parent.averagePrice, (0.6 * 100.0 + 0.4 * 100.5) / 1.0);
+    // Fills on the second venue are reported through the order manager as well
+    QCOMPARE(filled.size(), 2);
+}
+
+void SmartOrderRouterTest::partialIocFillCompletesParent()
+{
+    ExchangeConnector venue;
+    startTestVenue(venue, "BTCUSD", 100.0, 0.6);
+    OrderManager orders;
+    orders.setExchangeConnector(&venue);
+    SmartOrderRouter router;
+    router.setOrderManager(&orders);
+    router.addVenue(&venue, 1.0);
+
+    std::vector<ParentOrder> updates;
+    connect(&router, &SmartOrderRouter::parentOrderUpdated, this,
+            [&updates](const ParentOrder &parent) { updates.push_back(parent); });
+    std::vector<ParentOrder> completed;
+    connect(&router, &SmartOrderRouter::parentOrderCompleted, this,
+            [&completed](const ParentOrder &parent) { completed.push_back(parent); });
+
+    // Only 0.6 is visible; the rest of the 2.0 goes out at the limit and expires unfilled
+    const QString parentId = router.routeOrder("BTCUSD", OrderSide::BUY, 2.0, 101.0);
+    QVERIFY(!parentId.isEmpty());
+    QTRY_COMPARE(completed.size(), size_t(1));
+    QCOMPARE(completed.front().filledQuantity, 0.6);
+    QCOMPARE(completed.front().averagePrice, 100.0);
+    QCOMPARE(completed.front().quantity, 2.0);
+    // One report for the whole child: the partial fill and the expiry arrive together
+    QCOMPARE(updates.size(), size_t(1));
+    QCOMPARE(router.getParentOrder(parentId).parentId, QString());
+}
+
+void SmartOrderRouterTest::silentChildIsCancelledAfterTimeout()
+{
+    ExchangeConnector venue;
+    startTestVenue(venue, "BTCUSD", 100.0, 1.0);
+    OrderManager orders;
+    orders.setExchangeConnector(&venue);
+    SmartOrderRouter router;
+    router.setOrderManager(&orders);
+    router.addVenue(&venue, 1.0);
+    // Well inside the simulated venue's one-second report delay
+    router.setChildTimeout(50);
+
+    QStringList cancelled;
+    connect(&venue, &ExchangeConnector::orderCancelled, this, [&cancelled](const QString &id) { cancelled.append(id); });
+    QStringList children;
+    connect(&router, &SmartOrderRouter::childOrderPlaced, this,
+            [&children](const QString &, const QString &childId, int, double) { children.append(childId); });
+    std::vector<ParentOrder> completed;
+    connect(&router, &SmartOrderRouter::parentOrderCompleted, this,
+            [&completed](const ParentOrder &parent) { completed.push_back(parent); });
+
+    QVERIFY(!router.routeOrder("BTCUSD", OrderSide::BUY, 1.0).isEmpty());
+    QCOMPARE(children.size(), 1);
+    QTRY_COMPARE(completed.size(), size_t(1));
+    QCOMPARE(cancelled, children);
+    QCOMPARE(completed.front().filledQuantity, 0.0);
+
+    // The venue's late report belongs to no open child and changes nothing
+    QTest::qWait(1200);
+    QCOMPARE(completed.size(), size_t(1));
+}
+
+void SmartOrderRouterTest::closedGateRoutesNothing()
+{
+    ExchangeConnector venue;
+    startTestVenue(venue, "BTCUSD", 100.0, 1.0);
+    OrderManager orders;
+    orders.setExchangeConnector(&venue);
+    SmartOrderRouter router;
+    router.setOrderManager(&orders);
+    router.addVenue(&venue, 1.0);
+
+    int submitted = 0;
+    connect(&venue, &ExchangeConnector::orderSubmitted, this, [&submitted](const OrderRequest &) { ++submitted; });
+    QStringList errors;
+    connect(&router, &SmartOrderRouter::routingError, this,
+            [&errors](const QString &, const QString &error) { errors.append(error); });
+
+    orders.setOrderGateOpen(false);
+    QVERIFY(router.routeOrder("BTCUSD", OrderSide::BUY, 1.0).isEmpty());
+    QCOMPARE(submitted, 0);
+    QCOMPARE(errors, QStringList{ "Order gate closed" });
+
+    // Without an order manager nothing is sent either
+    SmartOrderRouter unwired;
+    unwired.addVenue(&venue, 1.0);
+    QVERIFY(unwired.routeOrder("BTCUSD", OrderSide::BUY, 1.0).isEmpty());
+    QCOMPARE(submitted, 0);
+}
+
+void SmartOrderRouterTest::venueWithoutBookIsSkipped()
+{
+    // Connected, but nothing has quoted BTCUSD on venueA
+    ExchangeConnector venueA;
+    venueA.setTestMode(true);
+    venueA.connect();
+    ExchangeConnector venueB;
+    startTestVenue(venueB, "BTCUSD", 100.5, 1.0);
+    QVERIFY(venueA.getOrderBook("BTCUSD").asks.empty());
+    OrderManager orders;
+    orders.setExchangeConnector(&venueA);
+    SmartOrderRouter router;
+    router.setOrderManager(&orders);
+    router.addVenue(&venueA, 1.0);
+    router.addVenue(&venueB, 1.0);
+
+    int submittedA = 0;
+    connect(&venueA, &ExchangeConnector::orderSubmitted, this, [&submittedA](const OrderRequest &) { ++submittedA; });
+    std::vector<OrderRequest> submittedB;
+    connect(&venueB, &ExchangeConnector::orderSubmitted, this,
+            [&submittedB](const OrderRequest &request) { submittedB.push_back(request); });
+    QStringList errors;
+    connect(&router, &SmartOrderRouter::routingError, this,
+            [&errors](const QString &, const QString &error) { errors.append(error); });
+
+    QVERIFY(!router.routeOrder("BTCUSD", OrderSide::BUY, 1.0).isEmpty());
+    QCOMPARE(submittedA, 0);
+    QCOMPARE(submittedB.size(), size_t(1));
+    QCOMPARE(submittedB[0].quantity, 1.0);
+    QCOMPARE(submittedB[0].price, 100.5);
+
+    // A symbol no venue has a book for is not routed at all
+    QVERIFY(router.routeOrder("ETHUSD", OrderSide::BUY, 1.0).isEmpty());
+    QCOMPARE(errors, QStringList{ "No connected venue can take the order" });
+}
+
+void SmartOrderRouterTest::iocChildrenAgainstVenue()
+{
+    SimulatedVenue venue;
+    venue.setSymbol("BTCUSDT");
+    venue.setAnchorPrice(50000.0);
+    venue.setBrickSize(0.0); // a flat price: bid 49999.75, ask 50000.25
+    venue.setSignalEvery(0);
+    QVERIFY(venue.listen());
+
+    ExchangeConnector connector;
+    connector.setExchange(ExchangeType::BINANCE);
+    connector.setTestMode(false);
+    connector.setEndpoints(venue.restUrl(), venue.webSocketUrl());
+    connector.connect();
+    QTRY_VERIFY(connector.isConnected());
+    connector.subscribeToMarketData("BTCUSDT");
+    QTRY_VERIFY(venue.subscriberCount() > 0);
+    venue.startFeed(1000);
+    QTRY_VERIFY(connector.getMarketData("BTCUSDT").receiveTimeNs > 0);
+    // The book is the venue's REST snapshot with the depth diffs applied on top
+    QTRY_VERIFY(!connector.getOrderBook("BTCUSDT").asks.empty());
+    venue.stopFeed();
+    const OrderBook book = connector.getOrderBook("BTCUSDT");
+    QCOMPARE(book.asks.size(), size_t(1));
+    QCOMPARE(book.asks[0].price, 50000.25);
+    QCOMPARE(book.asks[0].quantity, 2.25);
+    QCOMPARE(book.bids.size(), size_t(1));
+    QCOMPARE(book.bids[0].price, 49999.75);
+
+    OrderManager orders;
+    orders.setExchangeConnector(&connector);
+    SmartOrderRouter router;
+    router.setOrderManager(&orders);
+    router.addVenue(&connector, 1.0);
+    std::vector<ParentOrder> completed;
+    connect(&router, &SmartOrderRouter::parentOrderCompleted, this,
+            [&completed](const ParentOrder &parent) { completed.push_back(parent); });
+
+    // Priced at the ask the venue is showing: fills in full
+    QVERIFY(!router.routeOrder("BTCUSDT", OrderSide::BUY, 0.5).isEmpty());
+    QTRY_COMPARE(completed.size(), size_t(1));
+    QCOMPARE(completed[0].filledQuantity, 0.5);
+    QCOMPARE(completed[0].averagePrice, 50000.0);
+
+    // The venue moves away before the child arrives: it expires and the parent closes unfilled
+    venue.setAnchorPrice(50100.0);
+    QVERIFY(!router.routeOrder("BTCUSDT", OrderSide::BUY, 0.5).isEmpty());
+    QTRY_COMPARE(completed.size(), size_t(2));
+    QCOMPARE(completed[1].filledQuantity, 0.0);
+
+    QList<SimulatedVenue::OrderArrival> arrivals = venue.takeArrivals();
+    QCOMPARE(arrivals.size(), 2);
+    for (const auto &arrival : arrivals) QCOMPARE(arrival.type, QString("LIMIT"));
+}
+
+QTEST_GUILESS_MAIN(SmartOrderRouterTest)
+#include "SmartOrderRouterTest.moc"
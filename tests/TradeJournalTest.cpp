@@ -0,0 +1,203 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+#include "TradeJournal.h"
+#include "RiskManager.h"
+
+// Recovery of a journal directory: a torn tail is cut and appends continue after the last
+// good record, a record with a bad checksum ends the replay there, and a day file whose
+// checkpoint never completed falls back to the day before. A tripped drawdown limit is still
+// tripped after a restart
+class TradeJournalTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void truncatedTailIsCut();
+    void corruptRecordEndsReplay();
+    void incompleteDayFallsBack();
+    void drawdownSurvivesRestart();
+
+private:
+    static Position position(const QString &id, double size, double price);
+    static qint64 fileSize(const QString &path);
+};
+
+Position TradeJournalTest::position(const QString &id, double size, double price)
+{
+    Position position;
+    position.symbol = "BTCUSD";
+    position.side = "BUY";
+    position.size = size;
+    position.entryPrice = price;
+    position.currentPrice = price;
+    position.stopLoss = 0.0;
+    position.takeProfit = 0.0;
+    position.unrealizedPnL = 0.0;
+    position.realizedPnL = 0.0;
+    position.openTime = QDateTime::currentDateTime();
+    position.isOpen = true;
+    position.orderId = id;
+    position.symbolId = -1;
+    position.margin = 0.0;
+    return position;
+}
+
+qint64 TradeJournalTest::fileSize(const QString &path)
+{
+    return QFileInfo(path).size();
+}
+
+void TradeJournalTest::truncatedTailIsCut()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        TradeJournal journal;
+        QVERIFY(journal.open(dir.path(), JournalState()));
+        journal.recordEquity(10000.0, 10000.0);
+        journal.recordPositionOpen(position("P1", 1.0, 100.0));
+        QVERIFY(journal.flush());
+        journal.close();
+    }
+    const JournalRecovery clean = TradeJournal::recover(dir.path());
+    QVERIFY(!clean.file.isEmpty());
+    const qint64 goodSize = fileSize(clean.file);
+
+    // A crash mid-append leaves part of a frame header and payload behind
+    {
+        QFile file(clean.file);
+        QVERIFY(file.open(QIODevice::Append));
+        file.write(QByteArray("\x40\x00\x00\x00\x12\x34", 6));
+    }
+    const JournalRecovery torn = TradeJournal::recover(dir.path());
+    QCOMPARE(torn.file, clean.file);
+    QCOMPARE(torn.truncatedBytes, qint64(6));
+    QCOMPARE(torn.records, clean.records);
+    QCOMPARE(fileSize(torn.file), goodSize);
+    QCOMPARE(torn.state.equity, 10000.0);
+    QCOMPARE(torn.state.openPositions.size(), size_t(1));
+    QCOMPARE(torn.state.lastSequence, clean.state.lastSequence);
+
+    // Appends continue from the last good record and replay cleanly
+    {
+        TradeJournal journal;
+        QVERIFY(journal.open(dir.path(), torn.state));
+        journal.recordPositionOpen(position("P2", 2.0, 101.0));
+        QVERIFY(journal.flush());
+        journal.close();
+    }
+    const JournalRecovery resumed = TradeJournal::recover(dir.path());
+    QCOMPARE(resumed.truncatedBytes, qint64(0));
+    QCOMPARE(resumed.records, clean.records + 1);
+    QCOMPARE(resumed.state.openPositions.size(), size_t(2));
+    QCOMPARE(resumed.state.openPositions.at("P2").size, 2.0);
+    QCOMPARE(resumed.state.lastSequence, clean.state.lastSequence + 1);
+}
+
+void TradeJournalTest::corruptRecordEndsReplay()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path;
+    qint64 beforeLast = 0;
+    {
+        TradeJournal journal;
+        QVERIFY(journal.open(dir.path(), JournalState()));
+        journal.recordEquity(10000.0, 10000.0);
+        journal.recordPositionOpen(position("P1", 1.0, 100.0));
+        QVERIFY(journal.flush());
+        path = QDir(dir.path()).filePath(QDir(dir.path()).entryList(QStringList{ "journal-*.jnl" }).value(0));
+        beforeLast = fileSize(path);
+        journal.recordPositionOpen(position("P2", 2.0, 101.0));
+        QVERIFY(journal.flush());
+        journal.close();
+    }
+    const qint64 fullSize = fileSize(path);
+    QVERIFY(fullSize > beforeLast);
+
+    // One flipped bit in the last record's payload fails its checksum
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(fullSize - 1));
+        char byte = 0;
+        QVERIFY(file.getChar(&byte));
+        QVERIFY(file.seek(fullSize - 1));
+        QVERIFY(file.putChar(static_cast<char>(byte ^ 0x01)));
+    }
+    const JournalRecovery recovery = TradeJournal::recover(dir.path());
+    QCOMPARE(recovery.file, path);
+    QCOMPARE(recovery.truncatedBytes, fullSize - beforeLast);
+    QCOMPARE(fileSize(path), beforeLast);
+    QCOMPARE(recovery.state.openPositions.size(), size_t(1));
+    QVERIFY(recovery.state.openPositions.count("P1") == 1);
+}
+
+void TradeJournalTest::incompleteDayFallsBack()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        TradeJournal journal;
+        QVERIFY(journal.open(dir.path(), JournalState()));
+        journal.recordEquity(12000.0, 10000.0);
+        QVERIFY(journal.flush());
+        journal.close();
+    }
+    const JournalRecovery today = TradeJournal::recover(dir.path());
+    QVERIFY(!today.file.isEmpty());
+
+    // A later day whose file holds nothing but a torn first record
+    const QString nextDay = QDir(dir.path()).filePath(
+        "journal-" + QDate::currentDate().addDays(1).toString("yyyyMMdd") + ".jnl");
+    {
+        QFile file(nextDay);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(24, '\xff'));
+    }
+    const JournalRecovery recovery = TradeJournal::recover(dir.path());
+    QCOMPARE(recovery.file, today.file);
+    QCOMPARE(recovery.truncatedBytes, qint64(24));
+    QCOMPARE(fileSize(nextDay), qint64(0));
+    QCOMPARE(recovery.state.equity, 12000.0);
+    QCOMPARE(recovery.state.initialEquity, 10000.0);
+}
+
+void TradeJournalTest::drawdownSurvivesRestart()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        TradeJournal journal;
+        QVERIFY(journal.open(dir.path(), JournalState()));
+        RiskManager risk;
+        risk.setJournal(&journal);
+        risk.setEquity(10000.0);
+        risk.setMaxDrawdown(10.0);
+        risk.addPosition(position("P1", 100.0, 100.0));
+        // 1500 below the peak against a 1000 limit, then a partial recovery
+        risk.updateMarketPrice("BTCUSD", 85.0);
+        risk.updateMarketPrice("BTCUSD", 95.0);
+        QVERIFY(risk.getSnapshot()->breaches & BREACH_DRAWDOWN);
+        risk.setJournal(nullptr);
+        QVERIFY(journal.flush());
+        journal.close();
+    }
+    const JournalRecovery recovery = TradeJournal::recover(dir.path());
+    QCOMPARE(recovery.state.peakEquity, 10000.0);
+    QCOMPARE(recovery.state.maxDrawdown, 1500.0);
+
+    RiskManager restarted;
+    restarted.setMaxDrawdown(10.0);
+    restarted.restoreFromJournal(recovery.state);
+    QCOMPARE(restarted.getMaxDrawdown(), 1500.0);
+    QVERIFY(restarted.getSnapshot()->breaches & BREACH_DRAWDOWN);
+}
+
+QTEST_GUILESS_MAIN(TradeJournalTest)
+#include "TradeJournalTest.moc"
@@ -0,0 +1,97 @@
+// Compares two Google Benchmark JSON reports (--benchmark_out_format=json) by benchmark
+// name and fails when any benchmark got slower than the threshold.
+//
+//   BenchCompare <baseline.json> <current.json> [--threshold PERCENT]
+//
+// Times are compared as real_time normalized to nanoseconds. Benchmarks missing from the
+// baseline are listed as new and never fail the run; the exit code is 1 on a regression or
+// when the baseline holds no results, since then nothing could have been flagged.
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static double toNanoseconds(double value, const QString &unit)
+{
+    if (unit == "us") return value * 1e3;
+    if (unit == "ms") return value * 1e6;
+    if (unit == "s") return value * 1e9;
+    return value;
+}
+
+// Per-iteration runs only; repetition aggregates keep only their mean
+static bool loadReport(const char *path, QMap<QString, double> &times)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        std::fprintf(stderr, "%s: %s\n", path, qPrintable(error.errorString()));
+        return false;
+    }
+    for (const QJsonValue &value : doc.object()["benchmarks"].toArray()) {
+        QJsonObject run = value.toObject();
+        const QString runType = run["run_type"].toString("iteration");
+        if (runType == "aggregate" && run["aggregate_name"].toString() != "mean") continue;
+        const QString name = runType == "aggregate" ? run["run_name"].toString() : run["name"].toString();
+        times[name] = toNanoseconds(run["real_time"].toDouble(), run["time_unit"].toString("ns"));
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <baseline.json> <current.json> [--threshold PERCENT]\n", argv[0]);
+        return 2;
+    }
+    double threshold = 10.0;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--threshold") == 0) threshold = std::strtod(argv[i + 1], nullptr);
+    }
+
+    QMap<QString, double> baseline;
+    QMap<QString, double> current;
+    if (!loadReport(argv[1], baseline) || !loadReport(argv[2], current)) return 2;
+
+    int regressions = 0;
+    std::printf("%-56s %14s %14s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        const QByteArray name = it.key().toUtf8();
+        if (!baseline.contains(it.key())) {
+            std::printf("%-56s %14s %14.1f %9s\n", name.constData(), "-", it.value(), "new");
+            continue;
+        }
+        const double before = baseline.value(it.key());
+        const double change = before > 0.0 ? (it.value() - before) / before * 100.0 : 0.0;
+        const bool regressed = change > threshold;
+        if (regressed) ++regressions;
+        std::printf("%-56s %14.1f %14.1f %+8.1f%%%s\n", name.constData(), before, it.value(), change,
+                    regressed ? "  REGRESSION" : "");
+    }
+    for (auto it = baseline.constBegin(); it != baseline.constEnd(); ++it) {
+        if (!current.contains(it.key())) std::printf("%-56s %14.1f %14s %9s\n", it.key().toUtf8().constData(), it.value(), "-", "missing");
+    }
+
+    if (baseline.isEmpty()) {
+        std::printf("baseline %s has no results: record one with the bench-baseline target\n", argv[1]);
+        return 1;
+    }
+    if (regressions > 0) {
+        std::printf("%d benchmark(s) slower than the %.1f%% threshold\n", regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Renders a binary log (.blog) written by Logger::log() as text, in the same line format
+// as the text log.
+//
+//   BinaryLogDecoder <file.blog> [--level DEBUG|INFO|WARNING|ERROR] [--thread N]
+
+#include "BinaryLog.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int parseLevel(const char *name)
+{
+    for (int level = 0; level < 4; ++level) {
+        if (std::strcmp(name, BinaryLog::levelName(level)) == 0) return level;
+    }
+    return -1;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file.blog> [--level LEVEL] [--thread N]\n", argv[0]);
+        return 2;
+    }
+    int minLevel = 0;
+    long threadFilter = -1;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--level") == 0) {
+            minLevel = parseLevel(argv[i + 1]);
+            if (minLevel < 0) {
+                std::fprintf(stderr, "unknown level %s\n", argv[i + 1]);
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--thread") == 0) {
+            threadFilter = std::strtol(argv[i + 1], nullptr, 10);
+        }
+    }
+
+    FILE *file = std::fopen(argv[1], "rb");
+    if (!file) {
+        std::perror(argv[1]);
+        return 1;
+    }
+    BinaryLog::FileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || !BinaryLog::isValidHeader(header)) {
+        std::fprintf(stderr, "%s: not a binary log or unsupported version\n", argv[1]);
+        std::fclose(file);
+        return 1;
+    }
+
+    // Formats are re-defined by each run that appends to the file; the latest one wins
+    std::vector<std::string> formats;
+    long records = 0;
+    int kind;
+    while ((kind = std::fgetc(file)) != EOF) {
+        if (kind == BinaryLog::FRAME_FORMAT) {
+            uint16_t id;
+            uint8_t level;
+            uint16_t length;
+            if (std::fread(&id, sizeof(id), 1, file) != 1 || std::fread(&level, sizeof(level), 1, file) != 1
+                || std::fread(&length, sizeof(length), 1, file) != 1) break;
+            std::string text(length, '\0');
+            if (length > 0 && std::fread(&text[0], 1, length, file) != length) break;
+            if (id >= formats.size()) formats.resize(id + 1);
+            formats[id] = text;
+        } else if (kind == BinaryLog::FRAME_RECORD) {
+            BinaryLogRecord record;
+            if (std::fread(&record, sizeof(record), 1, file) != 1) break; // torn tail
+            ++records;
+            if (record.level < minLevel) continue;
+            if (threadFilter >= 0 && record.threadId != static_cast<uint32_t>(threadFilter)) continue;
+            const char *format = record.formatId < formats.size() ? formats[record.formatId].c_str() : "<unknown format>";
+            std::printf("[%s] %s: %s\n", BinaryLog::formatTimestamp(record.timestampNs / 1000000).c_str(),
+                        BinaryLog::levelName(record.level), BinaryLog::render(format, record).c_str());
+        } else {
+            std::fprintf(stderr, "%s: corrupt frame after %ld records\n", argv[1], records);
+            std::fclose(file);
+            return 1;
+        }
+    }
+    std::fclose(file);
+    return 0;
+}